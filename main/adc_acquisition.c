@@ -0,0 +1,298 @@
+/**
+ * @file adc_acquisition.c
+ * @brief DMA-driven continuous ADC acquisition with ISR mux sequencing
+ */
+
+#include "adc_acquisition.h"
+#include "driver/gpio.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+#if ADC_ACQ_USE_DMA
+
+// Measurement frames per mux slot after settling. Slots 6/7 carry CT1/CT2
+// on mux B and need several whole mains cycles for a stable RMS.
+static const uint8_t s_slot_frames[ADC_ACQ_MUX_SLOTS] = {
+    1, 1, 1, 1, 1, 1, ADC_ACQ_CT_FRAMES, ADC_ACQ_CT_FRAMES
+};
+
+static const adc_channel_t s_channels[ADC_ACQ_INPUT_COUNT] = {
+    ADC_CHANNEL_0,  // GPIO36 - mux A
+    ADC_CHANNEL_3,  // GPIO39 - mux B
+    ADC_CHANNEL_6,  // GPIO34 - CT3
+    ADC_CHANNEL_7,  // GPIO35 - CT4
+};
+
+static adc_continuous_handle_t s_handle = NULL;
+static bool s_running = false;
+static int s_sel_pins[3] = {-1, -1, -1};
+
+// Sequencer state (owned by the ISR once started)
+static uint8_t s_slot = 0;
+static uint8_t s_frame_in_slot = 0;
+static uint32_t s_seq = 0;
+static uint32_t s_dropped = 0;
+
+// Double-buffered sweeps: ISR fills s_sweeps[s_write_idx], readers copy s_ready_idx
+static adc_sweep_t s_sweeps[2];
+static uint8_t s_write_idx = 0;
+static uint8_t s_ready_idx = 1;
+static bool s_ready_pending = false;
+static TaskHandle_t s_consumer = NULL;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ========================================
+// ISR HELPERS
+// ========================================
+
+static inline void IRAM_ATTR acq_accumulate(adc_acq_stats_t *s, uint16_t v)
+{
+    s->sum += v;
+    s->sumsq += (uint32_t)v * v;
+    s->count++;
+    if (v < s->min) s->min = v;
+    if (v > s->max) s->max = v;
+}
+
+static void IRAM_ATTR acq_reset_sweep(adc_sweep_t *sweep)
+{
+    memset(sweep, 0, sizeof(*sweep));
+    for (int slot = 0; slot < ADC_ACQ_MUX_SLOTS; slot++) {
+        sweep->mux[slot][ADC_ACQ_INPUT_MUX_A].min = UINT16_MAX;
+        sweep->mux[slot][ADC_ACQ_INPUT_MUX_B].min = UINT16_MAX;
+    }
+    sweep->direct[0].min = UINT16_MAX;
+    sweep->direct[1].min = UINT16_MAX;
+}
+
+static inline void IRAM_ATTR acq_select_mux(uint8_t slot)
+{
+    gpio_set_level(s_sel_pins[0], (slot & 0x01));
+    gpio_set_level(s_sel_pins[1], (slot & 0x02) >> 1);
+    gpio_set_level(s_sel_pins[2], (slot & 0x04) >> 2);
+}
+
+static bool IRAM_ATTR acq_on_conv_done(adc_continuous_handle_t handle,
+                                       const adc_continuous_evt_data_t *edata,
+                                       void *user_data)
+{
+    BaseType_t woken = pdFALSE;
+    adc_sweep_t *sweep = &s_sweeps[s_write_idx];
+    adc_acq_stats_t *slot = sweep->mux[s_slot];
+    bool measuring = (s_frame_in_slot >= ADC_ACQ_SETTLE_FRAMES);
+
+    const adc_digi_output_data_t *out = (const adc_digi_output_data_t *)edata->conv_frame_buffer;
+    uint32_t n = edata->size / SOC_ADC_DIGI_RESULT_BYTES;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint16_t value = out[i].type1.data;
+        switch (out[i].type1.channel) {
+            case ADC_CHANNEL_0:
+                if (measuring) acq_accumulate(&slot[ADC_ACQ_INPUT_MUX_A], value);
+                break;
+            case ADC_CHANNEL_3:
+                if (measuring) acq_accumulate(&slot[ADC_ACQ_INPUT_MUX_B], value);
+                break;
+            case ADC_CHANNEL_6:
+                acq_accumulate(&sweep->direct[0], value);
+                break;
+            case ADC_CHANNEL_7:
+                acq_accumulate(&sweep->direct[1], value);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (++s_frame_in_slot < ADC_ACQ_SETTLE_FRAMES + s_slot_frames[s_slot]) {
+        return false;
+    }
+
+    // Slot complete - advance the mux; the next frame is discarded while it settles
+    s_frame_in_slot = 0;
+    if (++s_slot >= ADC_ACQ_MUX_SLOTS) {
+        s_slot = 0;
+        sweep->seq = ++s_seq;
+        sweep->timestamp_us = esp_timer_get_time();
+
+        portENTER_CRITICAL_ISR(&s_lock);
+        if (s_ready_pending) {
+            s_dropped++;
+        }
+        sweep->dropped = s_dropped;
+        s_ready_idx = s_write_idx;
+        s_write_idx ^= 1;
+        s_ready_pending = true;
+        portEXIT_CRITICAL_ISR(&s_lock);
+
+        acq_reset_sweep(&s_sweeps[s_write_idx]);
+
+        if (s_consumer) {
+            vTaskNotifyGiveFromISR(s_consumer, &woken);
+        }
+    }
+    acq_select_mux(s_slot);
+
+    return (woken == pdTRUE);
+}
+
+// ========================================
+// PUBLIC API
+// ========================================
+
+esp_err_t adc_acquisition_init(int s0, int s1, int s2)
+{
+    if (s_running) {
+        return ESP_OK;
+    }
+
+    s_sel_pins[0] = s0;
+    s_sel_pins[1] = s1;
+    s_sel_pins[2] = s2;
+
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = ADC_ACQ_STORE_BYTES,
+        .conv_frame_size = ADC_ACQ_FRAME_BYTES,
+    };
+    esp_err_t ret = adc_continuous_new_handle(&handle_cfg, &s_handle);
+    if (ret != ESP_OK) {
+        printf("[ADC_ACQ] Continuous handle creation failed: %s\n", esp_err_to_name(ret));
+        s_handle = NULL;
+        return ret;
+    }
+
+    adc_digi_pattern_config_t pattern[ADC_ACQ_INPUT_COUNT] = {0};
+    for (int i = 0; i < ADC_ACQ_INPUT_COUNT; i++) {
+        pattern[i].atten = ADC_ATTEN_DB_12;
+        pattern[i].channel = s_channels[i];
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = ADC_BITWIDTH_12;
+    }
+
+    adc_continuous_config_t dig_cfg = {
+        .pattern_num = ADC_ACQ_INPUT_COUNT,
+        .adc_pattern = pattern,
+        .sample_freq_hz = ADC_ACQ_SAMPLE_FREQ_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    };
+    ret = adc_continuous_config(s_handle, &dig_cfg);
+    if (ret != ESP_OK) {
+        printf("[ADC_ACQ] Continuous config failed: %s\n", esp_err_to_name(ret));
+        adc_acquisition_deinit();
+        return ret;
+    }
+
+    adc_continuous_evt_cbs_t cbs = {
+        .on_conv_done = acq_on_conv_done,
+    };
+    ret = adc_continuous_register_event_callbacks(s_handle, &cbs, NULL);
+    if (ret != ESP_OK) {
+        printf("[ADC_ACQ] Callback registration failed: %s\n", esp_err_to_name(ret));
+        adc_acquisition_deinit();
+        return ret;
+    }
+
+    s_slot = 0;
+    s_frame_in_slot = 0;
+    s_write_idx = 0;
+    s_ready_idx = 1;
+    s_ready_pending = false;
+    acq_reset_sweep(&s_sweeps[0]);
+    acq_reset_sweep(&s_sweeps[1]);
+    acq_select_mux(0);
+
+    ret = adc_continuous_start(s_handle);
+    if (ret != ESP_OK) {
+        printf("[ADC_ACQ] Continuous start failed: %s\n", esp_err_to_name(ret));
+        adc_acquisition_deinit();
+        return ret;
+    }
+
+    s_running = true;
+    printf("[ADC_ACQ] DMA acquisition started: %d Hz, %d-byte frames, %d mux slots\n",
+           ADC_ACQ_SAMPLE_FREQ_HZ, ADC_ACQ_FRAME_BYTES, ADC_ACQ_MUX_SLOTS);
+    return ESP_OK;
+}
+
+void adc_acquisition_deinit(void)
+{
+    if (s_handle == NULL) {
+        return;
+    }
+    if (s_running) {
+        adc_continuous_stop(s_handle);
+        s_running = false;
+    }
+    adc_continuous_deinit(s_handle);
+    s_handle = NULL;
+}
+
+bool adc_acquisition_is_running(void)
+{
+    return s_running;
+}
+
+esp_err_t adc_acquisition_wait_sweep(adc_sweep_t *out, uint32_t timeout_ms)
+{
+    if (!s_running || out == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Single consumer: the first task to wait owns the notification
+    if (s_consumer == NULL) {
+        s_consumer = xTaskGetCurrentTaskHandle();
+    }
+
+    bool ready;
+    portENTER_CRITICAL(&s_lock);
+    ready = s_ready_pending;
+    portEXIT_CRITICAL(&s_lock);
+
+    // Always consume the notification so a stale count cannot cause a repeat read
+    ulTaskNotifyTake(pdTRUE, ready ? 0 : pdMS_TO_TICKS(timeout_ms));
+
+    portENTER_CRITICAL(&s_lock);
+    if (!s_ready_pending) {
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_TIMEOUT;
+    }
+    memcpy(out, &s_sweeps[s_ready_idx], sizeof(*out));
+    s_ready_pending = false;
+    portEXIT_CRITICAL(&s_lock);
+
+    return ESP_OK;
+}
+
+#else // !ADC_ACQ_USE_DMA
+
+esp_err_t adc_acquisition_init(int s0, int s1, int s2)
+{
+    (void)s0;
+    (void)s1;
+    (void)s2;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void adc_acquisition_deinit(void)
+{
+}
+
+bool adc_acquisition_is_running(void)
+{
+    return false;
+}
+
+esp_err_t adc_acquisition_wait_sweep(adc_sweep_t *out, uint32_t timeout_ms)
+{
+    (void)out;
+    (void)timeout_ms;
+    return ESP_ERR_INVALID_STATE;
+}
+
+#endif // ADC_ACQ_USE_DMA
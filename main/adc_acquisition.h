@@ -0,0 +1,97 @@
+/**
+ * @file adc_acquisition.h
+ * @brief DMA-driven continuous ADC acquisition with ISR mux sequencing
+ *
+ * ADC1 runs in continuous (DMA) mode over the four analog inputs the board
+ * uses: mux A (GPIO36), mux B (GPIO39), CT3 (GPIO34) and CT4 (GPIO35).
+ * The conversion-done callback reduces every frame into per-slot integer
+ * statistics and steps the CD4051 select lines (s0..s2) itself, so a full
+ * 8-slot sweep completes in the background without the sensor task ever
+ * blocking on the ADC.
+ */
+
+#ifndef ADC_ACQUISITION_H
+#define ADC_ACQUISITION_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Set to 0 to build the legacy adc_oneshot polling path only
+#ifndef ADC_ACQ_USE_DMA
+#define ADC_ACQ_USE_DMA             1
+#endif
+
+// Acquisition Configuration
+#define ADC_ACQ_SAMPLE_FREQ_HZ      20000   // Total conversions/s (ESP32 minimum)
+#define ADC_ACQ_FRAME_BYTES         256     // 128 conversions = 6.4 ms per frame
+#define ADC_ACQ_STORE_BYTES         512     // Driver pool (unused, frames are reduced in the ISR)
+#define ADC_ACQ_SETTLE_FRAMES       1       // Frames discarded after a mux switch
+#define ADC_ACQ_MUX_SLOTS           8
+#define ADC_ACQ_CT_FRAMES           10      // CT1/CT2 slot window (64 ms, > 3 mains cycles)
+#define ADC_ACQ_SWEEP_TIMEOUT_MS    1000
+
+// Acquisition inputs, in pattern order
+typedef enum {
+    ADC_ACQ_INPUT_MUX_A = 0,    // ADC1 CH0 - water levels / IR sectors
+    ADC_ACQ_INPUT_MUX_B,        // ADC1 CH3 - solar / battery / CT1 / CT2
+    ADC_ACQ_INPUT_CT3,          // ADC1 CH6 - direct current sensor
+    ADC_ACQ_INPUT_CT4,          // ADC1 CH7 - direct current sensor
+    ADC_ACQ_INPUT_COUNT
+} adc_acq_input_t;
+
+// Raw statistics for one input over one measurement window
+typedef struct {
+    uint32_t sum;
+    uint64_t sumsq;             // Sum of squares for the RMS kernel
+    uint16_t count;
+    uint16_t min;
+    uint16_t max;
+} adc_acq_stats_t;
+
+// One complete pass over all mux slots
+typedef struct {
+    uint32_t seq;                                       // Sweep sequence number
+    int64_t timestamp_us;                               // esp_timer time at completion
+    adc_acq_stats_t mux[ADC_ACQ_MUX_SLOTS][2];          // [slot][MUX_A / MUX_B]
+    adc_acq_stats_t direct[2];                          // CT3, CT4 over the whole sweep
+    uint32_t dropped;                                   // Sweeps overwritten before being read
+} adc_sweep_t;
+
+/**
+ * @brief Create the continuous ADC driver and start the mux sequencer
+ * @param s0 Mux select bit 0 GPIO
+ * @param s1 Mux select bit 1 GPIO
+ * @param s2 Mux select bit 2 GPIO
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built without DMA
+ */
+esp_err_t adc_acquisition_init(int s0, int s1, int s2);
+
+/**
+ * @brief Stop the acquisition and release the continuous driver
+ */
+void adc_acquisition_deinit(void);
+
+/**
+ * @brief Check if DMA acquisition is running
+ * @return true if sweeps are being produced
+ */
+bool adc_acquisition_is_running(void);
+
+/**
+ * @brief Block until a new sweep is ready and copy it out
+ * @param out Destination sweep
+ * @param timeout_ms Maximum time to wait
+ * @return ESP_OK, ESP_ERR_TIMEOUT or ESP_ERR_INVALID_STATE
+ */
+esp_err_t adc_acquisition_wait_sweep(adc_sweep_t *out, uint32_t timeout_ms);
+
+/**
+ * @brief Mean raw code of a statistics block (0 if empty)
+ */
+static inline int adc_acq_mean(const adc_acq_stats_t *s)
+{
+    return s->count ? (int)(s->sum / s->count) : 0;
+}
+
+#endif // ADC_ACQUISITION_H
@@ -0,0 +1,111 @@
+/**
+ * @file adc_calibration.c
+ * @brief Precomputed integer ADC-to-engineering-unit conversion tables
+ */
+
+#include "adc_calibration.h"
+#include <math.h>
+#include <stddef.h>
+
+#define SEGMENT_SHIFT   (ADC_CAL_KNOT_SHIFT + ADC_CAL_RAW_FRAC_BITS)
+
+// Knot values in output units << ADC_CAL_OUT_FRAC_BITS. Knot deltas stay
+// well under 2^21 for every type, so interpolation fits in 32 bits.
+static int32_t s_tables[ADC_CAL_TYPE_COUNT][ADC_CAL_KNOTS];
+
+static float convert_from_mv(adc_cal_type_t type, float mv)
+{
+    switch (type) {
+        case ADC_CAL_IR_CENTIPCT:
+            return mv * 10000.0f / ADC_CAL_IR_FULL_SCALE_MV;
+        case ADC_CAL_WATER_CENTIPCT:
+            // Unclamped here; clamping after interpolation keeps the kink exact
+            return (mv - ADC_CAL_WATER_EMPTY_MV) * 10000.0f /
+                   (ADC_CAL_WATER_FULL_MV - ADC_CAL_WATER_EMPTY_MV);
+        case ADC_CAL_PACK_MILLIVOLTS:
+            return mv * ADC_CAL_PACK_RATIO + ADC_CAL_PACK_DIODE_MV;
+        case ADC_CAL_MILLIVOLTS:
+        default:
+            return mv;
+    }
+}
+
+// The calibration API only returns whole millivolts, so a knot taken from a
+// single sample would carry up to 0.5 mV of rounding into every code of its
+// segment. Fit a local least-squares line over the codes around each knot
+// instead and evaluate it at the knot for a sub-millivolt estimate.
+static bool fit_knot_mv(adc_cal_raw_to_mv_fn raw_to_mv, void *ctx, int knot_raw, float *knot_mv)
+{
+    const int half = 1 << (ADC_CAL_KNOT_SHIFT - 1);
+    int first = knot_raw - half < 0 ? 0 : knot_raw - half;
+    int last = knot_raw + half - 1 > ADC_CAL_RAW_MAX ? ADC_CAL_RAW_MAX : knot_raw + half - 1;
+    float sx = 0, sy = 0, sxx = 0, sxy = 0;
+    int n = 0;
+
+    for (int raw = first; raw <= last; raw++) {
+        int mv = 0;
+        if (raw_to_mv(ctx, raw, &mv) != 0) {
+            return false;
+        }
+        float x = (float)(raw - knot_raw);
+        sx += x;
+        sy += mv;
+        sxx += x * x;
+        sxy += x * mv;
+        n++;
+    }
+
+    float denom = n * sxx - sx * sx;
+    float slope = (denom != 0) ? (n * sxy - sx * sy) / denom : 0;
+    *knot_mv = (sy - slope * sx) / n;
+    return true;
+}
+
+bool adc_calibration_build(adc_cal_raw_to_mv_fn raw_to_mv, void *ctx)
+{
+    float knot_mv[ADC_CAL_KNOTS];
+    bool calibrated = (raw_to_mv != NULL);
+
+    for (int k = 0; k < ADC_CAL_KNOTS && calibrated; k++) {
+        calibrated = fit_knot_mv(raw_to_mv, ctx, k << ADC_CAL_KNOT_SHIFT, &knot_mv[k]);
+    }
+
+    // A partial curve is worse than none - fall back to the nominal VREF line
+    if (!calibrated) {
+        for (int k = 0; k < ADC_CAL_KNOTS; k++) {
+            knot_mv[k] = (float)(k << ADC_CAL_KNOT_SHIFT) * ADC_CAL_VREF_MV / ADC_CAL_RAW_MAX;
+        }
+    }
+
+    for (int type = 0; type < ADC_CAL_TYPE_COUNT; type++) {
+        for (int k = 0; k < ADC_CAL_KNOTS; k++) {
+            float value = convert_from_mv((adc_cal_type_t)type, knot_mv[k]);
+            s_tables[type][k] = (int32_t)lroundf(value * (1 << ADC_CAL_OUT_FRAC_BITS));
+        }
+    }
+
+    return calibrated;
+}
+
+int32_t adc_calibration_convert(adc_cal_type_t type, uint32_t raw_q4)
+{
+    if (type >= ADC_CAL_TYPE_COUNT) {
+        return 0;
+    }
+    if (raw_q4 > (ADC_CAL_RAW_MAX << ADC_CAL_RAW_FRAC_BITS)) {
+        raw_q4 = ADC_CAL_RAW_MAX << ADC_CAL_RAW_FRAC_BITS;
+    }
+
+    const int32_t *table = s_tables[type];
+    uint32_t idx = raw_q4 >> SEGMENT_SHIFT;
+    int32_t frac = (int32_t)(raw_q4 & ((1u << SEGMENT_SHIFT) - 1));
+    int32_t delta = table[idx + 1] - table[idx];
+
+    int32_t value = table[idx] + ((delta * frac + (1 << (SEGMENT_SHIFT - 1))) >> SEGMENT_SHIFT);
+    value = (value + (1 << (ADC_CAL_OUT_FRAC_BITS - 1))) >> ADC_CAL_OUT_FRAC_BITS;
+
+    if (type == ADC_CAL_WATER_CENTIPCT) {
+        value = value < 0 ? 0 : (value > 10000 ? 10000 : value);
+    }
+    return value;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file adc_calibration.h
+ * @brief Precomputed integer ADC-to-engineering-unit conversion tables
+ *
+ * The eFuse calibration curve and the per-channel scaling (IR %, water
+ * level %, pack voltage) are sampled once at init into small per-type knot
+ * tables. Conversions on the sensor path are then one table lookup plus an
+ * integer interpolation - no adc_cali call and no float math per sample.
+ *
+ * Inputs are raw codes in Q4 (raw << 4) so averaged samples keep their
+ * sub-LSB resolution.
+ */
+
+#ifndef ADC_CALIBRATION_H
+#define ADC_CALIBRATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Table Geometry
+#define ADC_CAL_RAW_MAX             4095    // 12-bit ADC
+#define ADC_CAL_KNOT_SHIFT          6       // One knot every 64 raw codes
+#define ADC_CAL_KNOTS               ((4096 >> ADC_CAL_KNOT_SHIFT) + 1)
+#define ADC_CAL_RAW_FRAC_BITS       4       // Q4 raw input
+#define ADC_CAL_OUT_FRAC_BITS       4       // Extra table precision, rounded off on output
+
+// Channel Scaling (millivolts at the ADC pin)
+#define ADC_CAL_VREF_MV             3300    // Fallback when no eFuse calibration
+#define ADC_CAL_IR_FULL_SCALE_MV    3300    // IR sensor 0-100 %
+#define ADC_CAL_WATER_EMPTY_MV      700     // Water probe 0 %
+#define ADC_CAL_WATER_FULL_MV       3000    // Water probe 100 %
+#define ADC_CAL_PACK_RATIO          12.11f  // Solar/battery divider
+#define ADC_CAL_PACK_DIODE_MV       300     // Reverse-protection diode drop
+
+// Conversion types
+typedef enum {
+    ADC_CAL_MILLIVOLTS = 0,     // Calibrated pin voltage, mV
+    ADC_CAL_IR_CENTIPCT,        // IR intensity, 0.01 %
+    ADC_CAL_WATER_CENTIPCT,     // Water level, 0.01 %, clamped to 0..10000
+    ADC_CAL_PACK_MILLIVOLTS,    // Solar/battery pack voltage, mV
+    ADC_CAL_TYPE_COUNT
+} adc_cal_type_t;
+
+/**
+ * @brief Raw code to millivolts provider (e.g. adc_cali_raw_to_voltage)
+ * @return 0 on success
+ */
+typedef int (*adc_cal_raw_to_mv_fn)(void *ctx, int raw, int *mv);
+
+/**
+ * @brief Build all conversion tables
+ * @param raw_to_mv Calibration curve, or NULL for the linear VREF fallback
+ * @param ctx Passed through to raw_to_mv
+ * @return true if the calibration curve was used
+ */
+bool adc_calibration_build(adc_cal_raw_to_mv_fn raw_to_mv, void *ctx);
+
+/**
+ * @brief Convert a Q4 raw code
+ * @param type Conversion type
+ * @param raw_q4 Raw code << ADC_CAL_RAW_FRAC_BITS
+ * @return Value in the type's integer unit
+ */
+int32_t adc_calibration_convert(adc_cal_type_t type, uint32_t raw_q4);
+
+/**
+ * @brief Q4 mean of an accumulated sample sum
+ */
+static inline uint32_t adc_calibration_mean_q4(uint32_t sum, uint32_t count)
+{
+    return count ? (uint32_t)((((uint64_t)sum << ADC_CAL_RAW_FRAC_BITS) + count / 2) / count) : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADC_CALIBRATION_H
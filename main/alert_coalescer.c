@@ -0,0 +1,154 @@
+/**
+ * @file alert_coalescer.c
+ * @brief Hold-down windows that merge repeated alerts into one
+ */
+
+#include "alert_coalescer.h"
+#include <string.h>
+
+static int find_slot(alert_coalescer_t *c, uint32_t key, int64_t now_ms)
+{
+    int reusable = -1;
+    for (int i = 0; i < ALERT_COALESCER_SLOTS; i++) {
+        alert_coalescer_slot_t *s = &c->slots[i];
+        if (s->used && s->key == key) {
+            return i;
+        }
+        // A slot whose window has ended with nothing held can be recycled
+        bool idle = !s->used || (s->pending == ALERT_POOL_NONE && now_ms >= s->window_end_ms);
+        if (idle && (reusable < 0 || !s->used)) {
+            reusable = i;
+        }
+    }
+    return reusable;
+}
+
+// Send now and open a fresh window
+static void open_window(alert_coalescer_slot_t *s, uint8_t severity, uint8_t rank, int64_t now_ms)
+{
+    s->sent_severity = severity;
+    s->sent_rank = rank;
+    s->window_end_ms = now_ms + s->hold_ms;
+    s->pending = ALERT_POOL_NONE;
+    s->held = 0;
+    s->flaps = 0;
+}
+
+void alert_coalescer_init(alert_coalescer_t *c)
+{
+    memset(c, 0, sizeof(*c));
+    for (int i = 0; i < ALERT_COALESCER_SLOTS; i++) {
+        c->slots[i].pending = ALERT_POOL_NONE;
+    }
+}
+
+bool alert_coalescer_offer(alert_coalescer_t *c, const alert_coalescer_event_t *ev,
+                           alert_pool_handle_t record, int64_t now_ms,
+                           alert_pool_handle_t *superseded, alert_coalescer_emit_t *out)
+{
+    *superseded = ALERT_POOL_NONE;
+    out->slot = find_slot(c, ev->key, now_ms);
+    out->record = record;
+    out->occurrences = 1;
+    out->flaps = 0;
+
+    if (out->slot < 0) {
+        c->untracked++;
+        return true;
+    }
+
+    alert_coalescer_slot_t *s = &c->slots[out->slot];
+    if (!s->used || s->key != ev->key) {
+        memset(s, 0, sizeof(*s));
+        s->used = true;
+        s->key = ev->key;
+        s->base_hold_ms = ev->hold_ms;
+        s->max_hold_ms = ev->max_hold_ms > ev->hold_ms ? ev->max_hold_ms : ev->hold_ms;
+        s->hold_ms = ev->hold_ms;
+        s->window_end_ms = now_ms;
+        s->pending = ALERT_POOL_NONE;
+    }
+
+    // First edge after a quiet window
+    if (s->pending == ALERT_POOL_NONE && now_ms >= s->window_end_ms) {
+        s->hold_ms = s->base_hold_ms;
+        s->last_edge = ev->edge;
+        open_window(s, ev->severity, ev->rank, now_ms);
+        c->sent++;
+        return true;
+    }
+
+    if (ev->edge != s->last_edge) {
+        s->flaps++;
+    }
+    s->last_edge = ev->edge;
+
+    // Escalation: send now, folding in anything held
+    if (ev->severity > s->sent_severity ||
+        (ev->severity == s->sent_severity && ev->rank > s->sent_rank)) {
+        *superseded = s->pending;
+        if (s->pending != ALERT_POOL_NONE) {
+            c->merged++;
+        }
+        out->occurrences = s->held + 1;
+        out->flaps = s->flaps;
+        c->sent++;
+        open_window(s, ev->severity, ev->rank, now_ms);
+        return true;
+    }
+
+    *superseded = s->pending;
+    if (s->pending != ALERT_POOL_NONE) {
+        c->merged++;
+    }
+    s->pending = record;
+    s->pending_severity = ev->severity;
+    s->pending_rank = ev->rank;
+    s->held++;
+    out->record = ALERT_POOL_NONE;
+    out->occurrences = s->held;
+    out->flaps = s->flaps;
+    return false;
+}
+
+bool alert_coalescer_due(alert_coalescer_t *c, int64_t now_ms, alert_coalescer_emit_t *out)
+{
+    for (int i = 0; i < ALERT_COALESCER_SLOTS; i++) {
+        alert_coalescer_slot_t *s = &c->slots[i];
+        if (!s->used || now_ms < s->window_end_ms) {
+            continue;
+        }
+        if (s->pending == ALERT_POOL_NONE) {
+            // Quiet window: the next alert is a first edge again
+            s->hold_ms = s->base_hold_ms;
+            s->flaps = 0;
+            continue;
+        }
+
+        out->slot = i;
+        out->record = s->pending;
+        out->occurrences = s->held;
+        out->flaps = s->flaps;
+
+        // Flapping keys get a longer window next time
+        if (s->flaps >= ALERT_COALESCER_FLAP_LIMIT) {
+            uint32_t longer = s->hold_ms * 2;
+            s->hold_ms = longer > s->max_hold_ms ? s->max_hold_ms : longer;
+        }
+        open_window(s, s->pending_severity, s->pending_rank, now_ms);
+        c->sent++;
+        return true;
+    }
+    return false;
+}
+
+int alert_coalescer_pending(const alert_coalescer_t *c)
+{
+    int n = 0;
+    for (int i = 0; i < ALERT_COALESCER_SLOTS; i++) {
+        if (c->slots[i].used && c->slots[i].pending != ALERT_POOL_NONE) {
+            n++;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file alert_coalescer.h
+ * @brief Hold-down windows that merge repeated alerts into one
+ *
+ * Each alert is offered with a key (what it is about, e.g. the fire in one
+ * sector), an edge (which side of a flap it reports, e.g. detected or
+ * cleared) and a severity. The first alert for a key goes out at once and
+ * opens a hold-down window. Later alerts in the window are held: only the
+ * newest is kept and the others are counted. When the window ends, the
+ * held alert goes out once, carrying the count, and a new window opens.
+ *
+ * An alert more severe than the last one sent for its key is never held.
+ * It goes out at once and replaces anything pending, so a fire that comes
+ * back is reported immediately. Between alerts of equal severity the rank
+ * decides the same way (e.g. more sectors on fire).
+ *
+ * If a window sees at least ALERT_COALESCER_FLAP_LIMIT edge changes, the
+ * next window is twice as long, up to the key's maximum. A quiet window
+ * resets it to the base length.
+ *
+ * Records are alert_pool handles. A held record belongs to the coalescer
+ * until it is returned as superseded or due. Not thread-safe: the alert
+ * task is the only user.
+ */
+
+#ifndef ALERT_COALESCER_H
+#define ALERT_COALESCER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "alert_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ALERT_COALESCER_SLOTS       8       // Keys tracked at once
+#define ALERT_COALESCER_FLAP_LIMIT  2       // Edge changes per window that trigger back-off
+
+typedef struct {
+    uint32_t key;               // Alerts with the same key coalesce
+    uint8_t edge;               // Side of the flap this alert reports
+    uint8_t severity;           // Higher than the last sent is never held
+    uint8_t rank;               // Same, between alerts of equal severity
+    uint32_t hold_ms;           // Base hold-down window
+    uint32_t max_hold_ms;       // Back-off ceiling while flapping
+} alert_coalescer_event_t;
+
+typedef struct {
+    bool used;
+    uint32_t key;
+    uint32_t base_hold_ms;
+    uint32_t max_hold_ms;
+    uint32_t hold_ms;           // Current window length (backed off while flapping)
+    int64_t window_end_ms;
+    uint8_t sent_severity;      // Severity of the last alert sent
+    uint8_t sent_rank;
+    uint8_t last_edge;
+    alert_pool_handle_t pending;    // Newest held record
+    uint8_t pending_severity;
+    uint8_t pending_rank;
+    uint16_t held;              // Alerts merged into the pending one
+    uint16_t flaps;             // Edge changes in this window
+} alert_coalescer_slot_t;
+
+typedef struct {
+    alert_coalescer_slot_t slots[ALERT_COALESCER_SLOTS];
+    uint32_t sent;              // Alerts passed straight through
+    uint32_t merged;            // Held alerts replaced by a newer one
+    uint32_t untracked;         // Passed through because every slot was busy
+} alert_coalescer_t;
+
+typedef struct {
+    int slot;                   // Slot the alert belongs to, -1 if untracked
+    alert_pool_handle_t record; // Record to send
+    uint16_t occurrences;       // Alerts the record stands for (1 = just itself)
+    uint16_t flaps;             // Edge changes among them
+} alert_coalescer_emit_t;
+
+void alert_coalescer_init(alert_coalescer_t *c);
+
+/**
+ * @brief Offer an alert record
+ * @param superseded Set to a held record the caller must release, or ALERT_POOL_NONE
+ * @param out Record to send now; when held, its slot and the count held so far
+ * @return true if out->record must be sent now, false if the record is held
+ */
+bool alert_coalescer_offer(alert_coalescer_t *c, const alert_coalescer_event_t *ev,
+                           alert_pool_handle_t record, int64_t now_ms,
+                           alert_pool_handle_t *superseded, alert_coalescer_emit_t *out);
+
+/**
+ * @brief Take the next held alert whose window has ended
+ * @return true if out was filled; call again until it returns false
+ */
+bool alert_coalescer_due(alert_coalescer_t *c, int64_t now_ms, alert_coalescer_emit_t *out);
+
+/**
+ * @brief Held alerts across all slots
+ */
+int alert_coalescer_pending(const alert_coalescer_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALERT_COALESCER_H
@@ -0,0 +1,224 @@
+/**
+ * @file alert_journal.c
+ * @brief Delivery journal for alerts, keyed by a monotonically increasing sequence
+ */
+
+#include "alert_journal.h"
+#include <string.h>
+
+static alert_journal_entry_t *find_entry(alert_journal_t *j, uint32_t seq)
+{
+    if (seq == 0) {
+        return NULL;
+    }
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        if (j->entries[i].state != ALERT_JOURNAL_FREE && j->entries[i].seq == seq) {
+            return &j->entries[i];
+        }
+    }
+    return NULL;
+}
+
+static alert_journal_entry_t *new_entry(alert_journal_t *j, uint32_t seq, bool stored)
+{
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        alert_journal_entry_t *e = &j->entries[i];
+        if (e->state == ALERT_JOURNAL_FREE) {
+            memset(e, 0, sizeof(*e));
+            e->seq = seq;
+            e->state = ALERT_JOURNAL_PENDING;
+            e->stored = stored;
+            e->msg_id = -1;
+            return e;
+        }
+    }
+    return NULL;
+}
+
+// Parked entries go as soon as the SPIFFS copy exists: the replay owns it
+static void free_if_parked(alert_journal_entry_t *e)
+{
+    if (e->state == ALERT_JOURNAL_PARKED && e->stored) {
+        e->state = ALERT_JOURNAL_FREE;
+    }
+}
+
+static bool take_early_ack(alert_journal_t *j, int msg_id)
+{
+    for (int i = 0; i < ALERT_JOURNAL_EARLY_ACKS; i++) {
+        if (j->early_acks[i] == msg_id) {
+            j->early_acks[i] = -1;
+            return true;
+        }
+    }
+    return false;
+}
+
+void alert_journal_init(alert_journal_t *j, uint32_t reserved_seq, uint32_t acked_seq)
+{
+    memset(j, 0, sizeof(*j));
+    for (int i = 0; i < ALERT_JOURNAL_EARLY_ACKS; i++) {
+        j->early_acks[i] = -1;
+    }
+    j->acked_seq = acked_seq;
+    // Numbers from a block reserved before the reboot may be in use
+    j->next_seq = reserved_seq > acked_seq ? reserved_seq : acked_seq + 1;
+    if (j->next_seq == 0) {
+        j->next_seq = 1;
+    }
+    j->reserved_seq = j->next_seq;
+}
+
+uint32_t alert_journal_open(alert_journal_t *j, bool *reserve)
+{
+    *reserve = false;
+    alert_journal_entry_t *e = new_entry(j, j->next_seq, false);
+    if (!e) {
+        j->full++;
+        return 0;
+    }
+    if (j->next_seq >= j->reserved_seq) {
+        j->reserved_seq = j->next_seq + ALERT_JOURNAL_SEQ_BLOCK;
+        *reserve = true;
+    }
+    return j->next_seq++;
+}
+
+bool alert_journal_track(alert_journal_t *j, uint32_t seq)
+{
+    if (seq == 0 || find_entry(j, seq)) {
+        return false;
+    }
+    alert_journal_entry_t *e = new_entry(j, seq, true);
+    if (!e) {
+        return false;
+    }
+    e->replayed = true;
+    // Stored copies outlive NVS: never hand this number out again
+    if (seq >= j->next_seq) {
+        j->next_seq = seq + 1;
+        j->reserved_seq = j->next_seq;
+    }
+    return true;
+}
+
+alert_journal_state_t alert_journal_state(const alert_journal_t *j, uint32_t seq)
+{
+    alert_journal_entry_t *e = find_entry((alert_journal_t *)j, seq);
+    return e ? (alert_journal_state_t)e->state : ALERT_JOURNAL_FREE;
+}
+
+void alert_journal_stored(alert_journal_t *j, uint32_t seq)
+{
+    alert_journal_entry_t *e = find_entry(j, seq);
+    if (e) {
+        e->stored = true;
+        free_if_parked(e);
+    }
+}
+
+void alert_journal_sent(alert_journal_t *j, uint32_t seq, int msg_id, int64_t now_ms)
+{
+    alert_journal_entry_t *e = find_entry(j, seq);
+    if (!e || e->state != ALERT_JOURNAL_PENDING) {
+        return;
+    }
+    e->msg_id = msg_id;
+    e->sent_ms = now_ms;
+    if (take_early_ack(j, msg_id)) {
+        e->state = ALERT_JOURNAL_ACKED;
+        j->acked++;
+    } else {
+        e->state = ALERT_JOURNAL_IN_FLIGHT;
+    }
+}
+
+void alert_journal_park(alert_journal_t *j, uint32_t seq)
+{
+    alert_journal_entry_t *e = find_entry(j, seq);
+    if (e && (e->state == ALERT_JOURNAL_PENDING || e->state == ALERT_JOURNAL_IN_FLIGHT)) {
+        e->state = ALERT_JOURNAL_PARKED;
+        free_if_parked(e);
+    }
+}
+
+bool alert_journal_acked(alert_journal_t *j, int msg_id)
+{
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        alert_journal_entry_t *e = &j->entries[i];
+        if (e->state == ALERT_JOURNAL_IN_FLIGHT && e->msg_id == msg_id) {
+            e->state = ALERT_JOURNAL_ACKED;
+            j->acked++;
+            return true;
+        }
+    }
+    // The PUBACK can beat alert_journal_sent() on a fast link
+    j->early_acks[j->early_next] = msg_id;
+    j->early_next = (uint8_t)((j->early_next + 1) % ALERT_JOURNAL_EARLY_ACKS);
+    return false;
+}
+
+uint32_t alert_journal_take_acked(alert_journal_t *j)
+{
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        alert_journal_entry_t *e = &j->entries[i];
+        // Wait for the copy to exist, or removing it would race the write
+        if (e->state == ALERT_JOURNAL_ACKED && e->stored) {
+            e->state = ALERT_JOURNAL_FREE;
+            return e->seq;
+        }
+    }
+    return 0;
+}
+
+int alert_journal_expire(alert_journal_t *j, int64_t now_ms, int64_t timeout_ms,
+                         uint32_t *replayed, int *replayed_count)
+{
+    int n = 0;
+    if (replayed_count) {
+        *replayed_count = 0;
+    }
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        alert_journal_entry_t *e = &j->entries[i];
+        if (e->state == ALERT_JOURNAL_IN_FLIGHT && now_ms - e->sent_ms >= timeout_ms) {
+            if (e->replayed && replayed && replayed_count) {
+                replayed[(*replayed_count)++] = e->seq;
+            }
+            e->state = ALERT_JOURNAL_PARKED;
+            free_if_parked(e);
+            j->expired++;
+            n++;
+        }
+    }
+    return n;
+}
+
+bool alert_journal_settle(alert_journal_t *j, uint32_t lowest_stored)
+{
+    uint32_t lowest = j->next_seq;
+    if (lowest_stored != 0 && lowest_stored < lowest) {
+        lowest = lowest_stored;
+    }
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        const alert_journal_entry_t *e = &j->entries[i];
+        if (e->state != ALERT_JOURNAL_FREE && e->seq < lowest) {
+            lowest = e->seq;
+        }
+    }
+    if (lowest - 1 > j->acked_seq) {
+        j->acked_seq = lowest - 1;
+        return true;
+    }
+    return false;
+}
+
+int alert_journal_tracked(const alert_journal_t *j)
+{
+    int n = 0;
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        if (j->entries[i].state != ALERT_JOURNAL_FREE) {
+            n++;
+        }
+    }
+    return n;
+}
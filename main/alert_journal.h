@@ -0,0 +1,147 @@
+/**
+ * @file alert_journal.h
+ * @brief Delivery journal for alerts, keyed by a monotonically increasing sequence
+ *
+ * Every alert gets a sequence number and one durable copy in SPIFFS. The
+ * journal follows the live copy from pending (queued for publish) to
+ * in-flight (handed to the MQTT client, msg_id known) to acknowledged
+ * (PUBACK seen). Only an acknowledged alert is removed from SPIFFS; a
+ * publish return code just means the client queued it.
+ *
+ * When a live send is given up (offline, publish failed, PUBACK timeout)
+ * the entry is parked and the SPIFFS copy is left for the backlog replay,
+ * which tracks it again under the same sequence. An alert is never both
+ * replayed and sent live. A replayed alert that times out is reported by
+ * alert_journal_expire so the caller can count it as a failed retry.
+ *
+ * acked_seq is a watermark: every sequence at or below it is resolved.
+ * It only moves past sequences that are neither tracked nor stored, so
+ * after a reboot the replay can drop any stored copy at or below it.
+ *
+ * Sequences are handed out from blocks of ALERT_JOURNAL_SEQ_BLOCK; the
+ * caller persists the end of the block whenever a new one is reserved,
+ * so numbers stay unique across reboots with one NVS write per block.
+ *
+ * Not thread-safe: callers serialise access.
+ */
+
+#ifndef ALERT_JOURNAL_H
+#define ALERT_JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ALERT_JOURNAL_SLOTS         32      // Alerts tracked at once
+#define ALERT_JOURNAL_SEQ_BLOCK     32      // Sequences reserved per NVS write
+#define ALERT_JOURNAL_EARLY_ACKS    4       // PUBACKs remembered before their msg_id is known
+
+typedef enum {
+    ALERT_JOURNAL_FREE = 0,     // Not tracked
+    ALERT_JOURNAL_PENDING,      // Waiting to be published
+    ALERT_JOURNAL_IN_FLIGHT,    // Published, waiting for PUBACK
+    ALERT_JOURNAL_ACKED,        // PUBACK seen, SPIFFS copy still to remove
+    ALERT_JOURNAL_PARKED        // Live send given up, waiting for the SPIFFS copy
+} alert_journal_state_t;
+
+typedef struct {
+    uint32_t seq;
+    uint8_t state;              // alert_journal_state_t
+    bool stored;                // SPIFFS copy written (or attempted)
+    bool replayed;              // Tracked again by the backlog replay
+    int msg_id;
+    int64_t sent_ms;
+} alert_journal_entry_t;
+
+typedef struct {
+    alert_journal_entry_t entries[ALERT_JOURNAL_SLOTS];
+    uint32_t next_seq;
+    uint32_t reserved_seq;      // First sequence of the next unreserved block
+    uint32_t acked_seq;         // Watermark: everything at or below is resolved
+    int early_acks[ALERT_JOURNAL_EARLY_ACKS];
+    uint8_t early_next;
+    uint32_t acked;             // PUBACKs matched
+    uint32_t expired;           // In-flight entries given up on
+    uint32_t full;              // Alerts sent untracked because every slot was taken
+} alert_journal_t;
+
+/**
+ * @brief Restore the journal after boot
+ * @param reserved_seq End of the last reserved block, as persisted
+ * @param acked_seq Watermark, as persisted
+ */
+void alert_journal_init(alert_journal_t *j, uint32_t reserved_seq, uint32_t acked_seq);
+
+/**
+ * @brief Give a new alert a sequence and track it as pending, not yet stored
+ * @param reserve Set when a new block was reserved; persist j->reserved_seq
+ *                before the sequence is used
+ * @return Sequence, or 0 if every slot is taken
+ */
+uint32_t alert_journal_open(alert_journal_t *j, bool *reserve);
+
+/**
+ * @brief Track a stored alert again for replay
+ * @return false if it is already tracked or every slot is taken
+ */
+bool alert_journal_track(alert_journal_t *j, uint32_t seq);
+
+alert_journal_state_t alert_journal_state(const alert_journal_t *j, uint32_t seq);
+
+/**
+ * @brief The SPIFFS copy has been written (or could not be)
+ */
+void alert_journal_stored(alert_journal_t *j, uint32_t seq);
+
+/**
+ * @brief The MQTT client accepted the publish
+ */
+void alert_journal_sent(alert_journal_t *j, uint32_t seq, int msg_id, int64_t now_ms);
+
+/**
+ * @brief Give up on the live send; the SPIFFS copy takes over
+ */
+void alert_journal_park(alert_journal_t *j, uint32_t seq);
+
+/**
+ * @brief PUBACK for msg_id (MQTT_EVENT_PUBLISHED)
+ * @return true if it matched an in-flight alert
+ */
+bool alert_journal_acked(alert_journal_t *j, int msg_id);
+
+/**
+ * @brief Take an acknowledged alert whose SPIFFS copy must now be removed
+ * @return Sequence, or 0 if none
+ */
+uint32_t alert_journal_take_acked(alert_journal_t *j);
+
+/**
+ * @brief Park in-flight alerts that have waited longer than timeout_ms
+ * @param replayed Receives the sequences of parked replays, ALERT_JOURNAL_SLOTS
+ *                 long; NULL if not needed
+ * @param replayed_count Number written to replayed
+ * @return Number parked
+ */
+int alert_journal_expire(alert_journal_t *j, int64_t now_ms, int64_t timeout_ms,
+                         uint32_t *replayed, int *replayed_count);
+
+/**
+ * @brief Move the watermark up to just below the lowest unresolved sequence
+ * @param lowest_stored Lowest sequence still in SPIFFS, 0 if none
+ * @return true if acked_seq moved and should be persisted
+ */
+bool alert_journal_settle(alert_journal_t *j, uint32_t lowest_stored);
+
+/**
+ * @brief Entries currently tracked
+ */
+int alert_journal_tracked(const alert_journal_t *j);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALERT_JOURNAL_H
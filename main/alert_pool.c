@@ -0,0 +1,243 @@
+/**
+ * @file alert_pool.c
+ * @brief Slab of fixed-size blocks holding variable-length encoded records
+ *
+ * Record layout: 16-bit little-endian token byte count, then tokens.
+ * Token t < 0x80 is followed by t + 1 literal bytes; t >= 0x80 stands for
+ * t - 0x7F zero bytes.
+ */
+
+#include "alert_pool.h"
+#include <string.h>
+
+#define RUN_MAX             128
+#define ZERO_RUN_MIN        3       // Shorter zero runs stay inside literals
+#define ZERO_TOKEN          0x80
+
+// ========================================
+// SEGMENT STREAM
+// ========================================
+
+static size_t segs_total(const alert_pool_seg_t *segs, int nsegs)
+{
+    size_t total = 0;
+    for (int i = 0; i < nsegs; i++) {
+        total += segs[i].len;
+    }
+    return total;
+}
+
+static uint8_t segs_byte(const alert_pool_seg_t *segs, int nsegs, size_t pos)
+{
+    for (int i = 0; i < nsegs; i++) {
+        if (pos < segs[i].len) {
+            return ((const uint8_t *)segs[i].ptr)[pos];
+        }
+        pos -= segs[i].len;
+    }
+    return 0;
+}
+
+static size_t zero_run(const alert_pool_seg_t *segs, int nsegs, size_t pos, size_t total)
+{
+    size_t n = 0;
+    while (pos + n < total && n < RUN_MAX && segs_byte(segs, nsegs, pos + n) == 0) {
+        n++;
+    }
+    return n;
+}
+
+// ========================================
+// BLOCK CHAIN WRITER / READER
+// ========================================
+
+typedef struct {
+    alert_pool_block_t *blocks;
+    uint16_t block;
+    uint16_t off;
+    size_t count;               // Bytes emitted (also used for sizing only)
+} chain_writer_t;
+
+static void put_byte(chain_writer_t *w, uint8_t b)
+{
+    w->count++;
+    if (w->blocks == NULL) {
+        return;
+    }
+    if (w->off == ALERT_POOL_BLOCK_DATA) {
+        w->block = w->blocks[w->block].next;
+        w->off = 0;
+    }
+    w->blocks[w->block].data[w->off++] = b;
+}
+
+typedef struct {
+    const alert_pool_block_t *blocks;
+    uint16_t block;
+    uint16_t off;
+} chain_reader_t;
+
+static uint8_t get_byte(chain_reader_t *r)
+{
+    if (r->off == ALERT_POOL_BLOCK_DATA) {
+        r->block = r->blocks[r->block].next;
+        r->off = 0;
+    }
+    return r->blocks[r->block].data[r->off++];
+}
+
+// Emits the tokens for the segments; returns the token byte count
+static size_t emit_tokens(chain_writer_t *w, const alert_pool_seg_t *segs, int nsegs)
+{
+    size_t start = w->count;
+    size_t total = segs_total(segs, nsegs);
+    size_t pos = 0;
+
+    while (pos < total) {
+        size_t zeros = zero_run(segs, nsegs, pos, total);
+        if (zeros >= ZERO_RUN_MIN || (zeros > 0 && pos + zeros == total)) {
+            put_byte(w, (uint8_t)(ZERO_TOKEN + zeros - 1));
+            pos += zeros;
+            continue;
+        }
+
+        // Literal up to the next worthwhile zero run
+        size_t len = 0;
+        while (pos + len < total && len < RUN_MAX) {
+            size_t z = zero_run(segs, nsegs, pos + len, total);
+            if (z >= ZERO_RUN_MIN || (z > 0 && pos + len + z == total)) {
+                break;
+            }
+            len += z ? z : 1;
+        }
+        if (len > RUN_MAX) {
+            len = RUN_MAX;
+        }
+        put_byte(w, (uint8_t)(len - 1));
+        for (size_t i = 0; i < len; i++) {
+            put_byte(w, segs_byte(segs, nsegs, pos + i));
+        }
+        pos += len;
+    }
+    return w->count - start;
+}
+
+// ========================================
+// POOL
+// ========================================
+
+void alert_pool_init(alert_pool_t *pool, alert_pool_block_t *blocks, uint16_t count)
+{
+    if (count == ALERT_POOL_NONE) {
+        count--;
+    }
+    pool->blocks = blocks;
+    pool->count = count;
+    for (uint16_t i = 0; i < count; i++) {
+        blocks[i].next = (i + 1 < count) ? (uint16_t)(i + 1) : ALERT_POOL_NONE;
+    }
+    pool->free_head = count ? 0 : ALERT_POOL_NONE;
+    pool->free_count = count;
+    pool->min_free = count;
+    pool->failed = 0;
+}
+
+size_t alert_pool_encoded_size(const alert_pool_seg_t *segs, int nsegs)
+{
+    chain_writer_t counter = { 0 };
+    return 2 + emit_tokens(&counter, segs, nsegs);
+}
+
+alert_pool_handle_t alert_pool_alloc(alert_pool_t *pool, size_t encoded_size)
+{
+    size_t needed = (encoded_size + ALERT_POOL_BLOCK_DATA - 1) / ALERT_POOL_BLOCK_DATA;
+    if (needed == 0) {
+        needed = 1;
+    }
+    if (needed > pool->free_count) {
+        pool->failed++;
+        return ALERT_POOL_NONE;
+    }
+
+    // Detach the first `needed` blocks of the free list as the record's chain
+    alert_pool_handle_t head = pool->free_head;
+    uint16_t last = head;
+    for (size_t i = 1; i < needed; i++) {
+        last = pool->blocks[last].next;
+    }
+    pool->free_head = pool->blocks[last].next;
+    pool->blocks[last].next = ALERT_POOL_NONE;
+
+    pool->free_count -= (uint16_t)needed;
+    if (pool->free_count < pool->min_free) {
+        pool->min_free = pool->free_count;
+    }
+    return head;
+}
+
+void alert_pool_free(alert_pool_t *pool, alert_pool_handle_t handle)
+{
+    if (handle == ALERT_POOL_NONE || handle >= pool->count) {
+        return;
+    }
+    uint16_t last = handle;
+    uint16_t n = 1;
+    while (pool->blocks[last].next != ALERT_POOL_NONE) {
+        last = pool->blocks[last].next;
+        n++;
+    }
+    pool->blocks[last].next = pool->free_head;
+    pool->free_head = handle;
+    pool->free_count += n;
+}
+
+void alert_pool_encode(alert_pool_t *pool, alert_pool_handle_t handle,
+                       const alert_pool_seg_t *segs, int nsegs)
+{
+    if (handle == ALERT_POOL_NONE) {
+        return;
+    }
+    size_t tokens = alert_pool_encoded_size(segs, nsegs) - 2;
+    chain_writer_t w = { pool->blocks, handle, 0, 0 };
+    put_byte(&w, (uint8_t)(tokens & 0xFF));
+    put_byte(&w, (uint8_t)(tokens >> 8));
+    emit_tokens(&w, segs, nsegs);
+}
+
+size_t alert_pool_decode(const alert_pool_t *pool, alert_pool_handle_t handle,
+                         const alert_pool_seg_t *segs, int nsegs)
+{
+    if (handle == ALERT_POOL_NONE || handle >= pool->count) {
+        return 0;
+    }
+    chain_reader_t r = { pool->blocks, handle, 0 };
+    size_t tokens = get_byte(&r);
+    tokens |= (size_t)get_byte(&r) << 8;
+
+    int seg = 0;
+    size_t off = 0;
+    size_t written = 0;
+    size_t consumed = 0;
+
+    while (consumed < tokens) {
+        uint8_t t = get_byte(&r);
+        consumed++;
+        size_t n = (t >= ZERO_TOKEN) ? (size_t)(t - ZERO_TOKEN + 1) : (size_t)(t + 1);
+        for (size_t i = 0; i < n; i++) {
+            uint8_t b = 0;
+            if (t < ZERO_TOKEN) {
+                b = get_byte(&r);
+                consumed++;
+            }
+            while (seg < nsegs && off == segs[seg].len) {
+                seg++;
+                off = 0;
+            }
+            if (seg < nsegs) {
+                ((uint8_t *)segs[seg].ptr)[off++] = b;
+                written++;
+            }
+        }
+    }
+    return written;
+}
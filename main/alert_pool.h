@@ -0,0 +1,92 @@
+/**
+ * @file alert_pool.h
+ * @brief Slab of fixed-size blocks holding variable-length encoded records
+ *
+ * A record is stored as a chain of blocks and named by the index of its
+ * first block, so a queue only has to carry a 16-bit handle. Records are
+ * encoded with zero-run compression. Zero-initialised structs with fixed
+ * char arrays mostly hold zeros, so a record takes only the blocks its
+ * used bytes need.
+ *
+ * The source is given as segments, so a caller can store a struct prefix
+ * plus a trailing member and skip the bytes in between. Decoding fills the
+ * same segments in order.
+ *
+ * Allocation and free touch the shared free list; callers serialise them.
+ * Encoding into and decoding from a record the caller owns needs no lock.
+ */
+
+#ifndef ALERT_POOL_H
+#define ALERT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pool Configuration
+#define ALERT_POOL_BLOCK_DATA       46      // Payload bytes per block (48-byte blocks)
+#define ALERT_POOL_NONE             0xFFFF  // No record / end of chain
+
+typedef uint16_t alert_pool_handle_t;
+
+typedef struct {
+    uint16_t next;
+    uint8_t data[ALERT_POOL_BLOCK_DATA];
+} alert_pool_block_t;
+
+typedef struct {
+    alert_pool_block_t *blocks;
+    uint16_t count;
+    uint16_t free_head;
+    uint16_t free_count;
+    uint16_t min_free;          // Low-water mark of free blocks
+    uint32_t failed;            // Allocations refused for lack of blocks
+} alert_pool_t;
+
+typedef struct {
+    void *ptr;
+    size_t len;
+} alert_pool_seg_t;
+
+/**
+ * @brief Set up a pool over caller-provided blocks (at most 0xFFFE)
+ */
+void alert_pool_init(alert_pool_t *pool, alert_pool_block_t *blocks, uint16_t count);
+
+/**
+ * @brief Encoded size of the segments, including the length prefix
+ */
+size_t alert_pool_encoded_size(const alert_pool_seg_t *segs, int nsegs);
+
+/**
+ * @brief Take a chain of blocks with room for an encoded record
+ * @return Handle, or ALERT_POOL_NONE if not enough blocks are free
+ */
+alert_pool_handle_t alert_pool_alloc(alert_pool_t *pool, size_t encoded_size);
+
+/**
+ * @brief Return a record's blocks to the pool
+ */
+void alert_pool_free(alert_pool_t *pool, alert_pool_handle_t handle);
+
+/**
+ * @brief Encode segments into a record allocated with their encoded size
+ */
+void alert_pool_encode(alert_pool_t *pool, alert_pool_handle_t handle,
+                       const alert_pool_seg_t *segs, int nsegs);
+
+/**
+ * @brief Decode a record into segments
+ * @return Bytes written; segment space past the record is left untouched
+ */
+size_t alert_pool_decode(const alert_pool_t *pool, alert_pool_handle_t handle,
+                         const alert_pool_seg_t *segs, int nsegs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALERT_POOL_H
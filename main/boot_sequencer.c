@@ -0,0 +1,100 @@
+/**
+ * @file boot_sequencer.c
+ * @brief Dependency-ordered boot stages that can run on several threads
+ */
+
+#include "boot_sequencer.h"
+#include <stdio.h>
+#include <string.h>
+
+static bool stage_ready(const boot_sequencer_t *seq, int i, uint32_t done)
+{
+    return (seq->stages[i].deps & ~done) == 0;
+}
+
+bool boot_sequencer_init(boot_sequencer_t *seq, const boot_stage_t *stages, int count, int64_t now_us)
+{
+    memset(seq, 0, sizeof(*seq));
+    if (count <= 0 || count > BOOT_SEQ_MAX_STAGES) {
+        return false;
+    }
+    seq->stages = stages;
+    seq->count = count;
+    seq->begin_us = now_us;
+
+    uint32_t all = BOOT_STAGE(count) - 1;
+    for (int i = 0; i < count; i++) {
+        if ((stages[i].deps & ~all) != 0 || (stages[i].deps & BOOT_STAGE(i)) != 0) {
+            printf("[BOOT] Stage '%s' has an invalid dependency\n", stages[i].name);
+            return false;
+        }
+    }
+
+    // Dry run: every stage must become ready
+    uint32_t done = 0;
+    bool progress = true;
+    while (done != all && progress) {
+        progress = false;
+        for (int i = 0; i < count; i++) {
+            if (!(done & BOOT_STAGE(i)) && stage_ready(seq, i, done)) {
+                done |= BOOT_STAGE(i);
+                progress = true;
+            }
+        }
+    }
+    if (done != all) {
+        printf("[BOOT] Boot stages have a dependency cycle\n");
+        return false;
+    }
+    return true;
+}
+
+int boot_sequencer_claim(boot_sequencer_t *seq, int64_t now_us)
+{
+    for (int i = 0; i < seq->count; i++) {
+        if (!(seq->started & BOOT_STAGE(i)) && stage_ready(seq, i, seq->done)) {
+            seq->started |= BOOT_STAGE(i);
+            seq->start_us[i] = now_us;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void boot_sequencer_complete(boot_sequencer_t *seq, int stage, int64_t now_us)
+{
+    if (stage < 0 || stage >= seq->count) {
+        return;
+    }
+    seq->done |= BOOT_STAGE(stage);
+    seq->end_us[stage] = now_us;
+}
+
+bool boot_sequencer_finished(const boot_sequencer_t *seq)
+{
+    return seq->count > 0 && seq->done == (BOOT_STAGE(seq->count) - 1);
+}
+
+int64_t boot_sequencer_done_after_us(const boot_sequencer_t *seq, int stage)
+{
+    if (stage < 0 || stage >= seq->count || !(seq->done & BOOT_STAGE(stage))) {
+        return -1;
+    }
+    return seq->end_us[stage] - seq->begin_us;
+}
+
+void boot_sequencer_print(const boot_sequencer_t *seq)
+{
+    printf("\n[BOOT] Boot stages (ms from start)\n");
+    printf("  %-14s %8s %8s %8s\n", "stage", "start", "end", "took");
+    for (int i = 0; i < seq->count; i++) {
+        if (!(seq->done & BOOT_STAGE(i))) {
+            printf("  %-14s %8s\n", seq->stages[i].name, "pending");
+            continue;
+        }
+        printf("  %-14s %8.1f %8.1f %8.1f\n", seq->stages[i].name,
+               (seq->start_us[i] - seq->begin_us) / 1000.0,
+               (seq->end_us[i] - seq->begin_us) / 1000.0,
+               (seq->end_us[i] - seq->start_us[i]) / 1000.0);
+    }
+}
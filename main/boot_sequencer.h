@@ -0,0 +1,88 @@
+/**
+ * @file boot_sequencer.h
+ * @brief Dependency-ordered boot stages that can run on several threads
+ *
+ * Each stage lists the stages it depends on as a bitmask. Workers claim
+ * the lowest-numbered stage whose dependencies are all done, run it, and
+ * mark it complete. Stage order is therefore priority order: put the
+ * safety chain first and it is never queued behind networking.
+ *
+ * The sequencer does no locking. Callers with several workers serialise
+ * claim/complete themselves and wake idle workers after each completion.
+ */
+
+#ifndef BOOT_SEQUENCER_H
+#define BOOT_SEQUENCER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_SEQ_MAX_STAGES         16
+#define BOOT_STAGE(id)              (1u << (id))
+
+typedef void (*boot_stage_fn_t)(void);
+
+typedef struct {
+    const char *name;
+    uint32_t deps;              // BOOT_STAGE() bits of prerequisite stages
+    boot_stage_fn_t run;
+} boot_stage_t;
+
+typedef struct {
+    const boot_stage_t *stages;
+    int count;
+    uint32_t started;
+    uint32_t done;
+    int64_t begin_us;
+    int64_t start_us[BOOT_SEQ_MAX_STAGES];
+    int64_t end_us[BOOT_SEQ_MAX_STAGES];
+} boot_sequencer_t;
+
+/**
+ * @brief Set up a sequencer over a stage table
+ * @param seq Sequencer
+ * @param stages Stage table (not copied)
+ * @param count Number of stages
+ * @param now_us Boot clock
+ * @return false if the table is too large, names a missing stage or has a
+ *         dependency cycle
+ */
+bool boot_sequencer_init(boot_sequencer_t *seq, const boot_stage_t *stages, int count, int64_t now_us);
+
+/**
+ * @brief Claim the next stage to run
+ * @return Lowest-numbered ready stage, now marked started; -1 if none is
+ *         ready (all started, or waiting on stages still running)
+ */
+int boot_sequencer_claim(boot_sequencer_t *seq, int64_t now_us);
+
+/**
+ * @brief Mark a claimed stage complete
+ */
+void boot_sequencer_complete(boot_sequencer_t *seq, int stage, int64_t now_us);
+
+/**
+ * @brief True once every stage is complete
+ */
+bool boot_sequencer_finished(const boot_sequencer_t *seq);
+
+/**
+ * @brief Time from boot_sequencer_init() to the end of a stage
+ * @return Microseconds, or -1 if the stage has not completed
+ */
+int64_t boot_sequencer_done_after_us(const boot_sequencer_t *seq, int stage);
+
+/**
+ * @brief Print each stage's start and end, relative to init, to the serial console
+ */
+void boot_sequencer_print(const boot_sequencer_t *seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_SEQUENCER_H
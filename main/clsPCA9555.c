@@ -554,10 +554,11 @@ bool pca9555_is_initialized(pca9555_t *dev) {
 
 
 #include "clsPCA9555.h"
-#include "driver/i2c.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -570,6 +571,118 @@ static const char *TAG = "PCA9555";
 #define I2C_MASTER_RX_BUF_DISABLE   0
 #define I2C_MASTER_TIMEOUT_MS       1000
 
+#if PCA9555_USE_I2C_MASTER
+//==========================================================================
+// I2C SCANNER - I2C_MASTER DRIVER
+//==========================================================================
+void pca9555_scan_devices(i2c_port_t i2c_port, gpio_num_t sda_gpio, gpio_num_t scl_gpio) {
+    i2c_master_bus_config_t bus_conf = {
+        .i2c_port = i2c_port,
+        .sda_io_num = sda_gpio,
+        .scl_io_num = scl_gpio,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = true,
+    };
+    i2c_master_bus_handle_t bus;
+    esp_err_t ret = i2c_new_master_bus(&bus_conf, &bus);
+    if (ret != ESP_OK) {
+        printf("[I2C SCANNER ERROR] I2C bus create failed: %s\n", esp_err_to_name(ret));
+        return;
+    }
+
+    int found_count = 0;
+    for (uint8_t address = 0x08; address < 0x78; address++) {
+        if (i2c_master_probe(bus, address, 50) == ESP_OK) {
+            printf("[I2C SCANNER] Found device at address: 0x%02X\n", address);
+            found_count++;
+        }
+    }
+
+    // Cleanup
+    i2c_del_master_bus(bus);
+
+    if (found_count == 0) {
+        printf("[I2C SCANNER] ✗ No I2C devices found!\n");
+    } else {
+        printf("[I2C SCANNER] Found %d device(s) total\n", found_count);
+    }
+    printf("[I2C SCANNER] Scan complete\n\n");
+}
+
+#if PCA9555_ASYNC_QUEUE_DEPTH > 0
+// Transfer completion (ISR). Blocking calls wait for the bus themselves.
+static bool pca9555_on_trans_done(i2c_master_dev_handle_t handle, const i2c_master_event_data_t *evt, void *user)
+{
+    pca9555_t *dev = (pca9555_t *)user;
+    if (dev->sync_active || dev->async_tail == dev->async_head) {
+        return false;
+    }
+    uint8_t slot = dev->async_tail % PCA9555_ASYNC_QUEUE_DEPTH;
+    pca9555_done_cb_t cb = dev->async_slot[slot].cb;
+    void *arg = dev->async_slot[slot].arg;
+    dev->async_tail++;
+    if (cb) {
+        cb(evt->event == I2C_EVENT_DONE ? ESP_OK : ESP_FAIL, arg);
+    }
+    return false;
+}
+#endif
+
+// Create the bus and register the device once; every transfer reuses the handle
+static esp_err_t pca9555_bus_open(pca9555_t *dev, gpio_num_t sda_gpio, gpio_num_t scl_gpio) {
+    i2c_master_bus_config_t bus_conf = {
+        .i2c_port = dev->i2c_port,
+        .sda_io_num = sda_gpio,
+        .scl_io_num = scl_gpio,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .trans_queue_depth = PCA9555_ASYNC_QUEUE_DEPTH,
+        .flags.enable_internal_pullup = true,
+    };
+    esp_err_t ret = i2c_new_master_bus(&bus_conf, &dev->bus);
+    if (ret != ESP_OK) {
+        printf("[PCA9555 ERROR] I2C bus create failed: %s\n", esp_err_to_name(ret));
+        return ret;
+    }
+
+    i2c_device_config_t dev_conf = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = dev->address,
+        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+    };
+    ret = i2c_master_bus_add_device(dev->bus, &dev_conf, &dev->handle);
+    if (ret != ESP_OK) {
+        printf("[PCA9555 ERROR] I2C device add failed: %s\n", esp_err_to_name(ret));
+        i2c_del_master_bus(dev->bus);
+        dev->bus = NULL;
+        return ret;
+    }
+
+#if PCA9555_ASYNC_QUEUE_DEPTH > 0
+    i2c_master_event_callbacks_t cbs = {
+        .on_trans_done = pca9555_on_trans_done,
+    };
+    ret = i2c_master_register_event_callbacks(dev->handle, &cbs, dev);
+    if (ret != ESP_OK) {
+        printf("[PCA9555 ERROR] I2C callback register failed: %s\n", esp_err_to_name(ret));
+    }
+#endif
+    return ret;
+}
+
+static void pca9555_bus_close(pca9555_t *dev) {
+    if (dev->handle) {
+        i2c_master_bus_rm_device(dev->handle);
+        dev->handle = NULL;
+    }
+    if (dev->bus) {
+        i2c_del_master_bus(dev->bus);
+        dev->bus = NULL;
+    }
+}
+
+#else
 //==========================================================================
 // I2C SCANNER - USING LEGACY DRIVER
 //==========================================================================
@@ -627,6 +740,34 @@ void pca9555_scan_devices(i2c_port_t i2c_port, gpio_num_t sda_gpio, gpio_num_t s
     printf("[I2C SCANNER] Scan complete\n\n");
 }
 
+static esp_err_t pca9555_bus_open(pca9555_t *dev, gpio_num_t sda_gpio, gpio_num_t scl_gpio) {
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = sda_gpio,
+        .scl_io_num = scl_gpio,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = I2C_MASTER_FREQ_HZ,
+    };
+
+    esp_err_t ret = i2c_param_config(dev->i2c_port, &conf);
+    if (ret != ESP_OK) {
+        printf("[PCA9555 ERROR] I2C config failed: %s\n", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = i2c_driver_install(dev->i2c_port, conf.mode, I2C_MASTER_RX_BUF_DISABLE, I2C_MASTER_TX_BUF_DISABLE, 0);
+    if (ret != ESP_OK) {
+        printf("[PCA9555 ERROR] I2C driver install failed: %s\n", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+static void pca9555_bus_close(pca9555_t *dev) {
+    i2c_driver_delete(dev->i2c_port);
+}
+#endif // PCA9555_USE_I2C_MASTER
+
 //==========================================================================
 // INITIALIZE PCA9555
 //==========================================================================
@@ -648,24 +789,8 @@ esp_err_t pca9555_init(pca9555_t *dev, uint8_t address, i2c_port_t i2c_port,
     pca9555_scan_devices(i2c_port, sda_gpio, scl_gpio);
 
     // Initialize I2C master
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = sda_gpio,
-        .scl_io_num = scl_gpio,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_MASTER_FREQ_HZ,
-    };
-
-    esp_err_t ret = i2c_param_config(i2c_port, &conf);
-    if (ret != ESP_OK) {
-        printf("[PCA9555 ERROR] I2C config failed: %s\n", esp_err_to_name(ret));
-        return ret;
-    }
-
-    ret = i2c_driver_install(i2c_port, conf.mode, I2C_MASTER_RX_BUF_DISABLE, I2C_MASTER_TX_BUF_DISABLE, 0);
+    esp_err_t ret = pca9555_bus_open(dev, sda_gpio, scl_gpio);
     if (ret != ESP_OK) {
-        printf("[PCA9555 ERROR] I2C driver install failed: %s\n", esp_err_to_name(ret));
         return ret;
     }
 
@@ -688,23 +813,120 @@ esp_err_t pca9555_init(pca9555_t *dev, uint8_t address, i2c_port_t i2c_port,
         if (ret == ESP_OK) {
             
             // Set all outputs to LOW for safety
-            pca9555_set_port0_output(dev, 0x00);
-            pca9555_set_port1_output(dev, 0x00);
+            pca9555_set_outputs(dev, 0x00, 0x00);
         } else {
             printf("[PCA9555 WARNING] Configuration failed: %s\n", esp_err_to_name(ret));
         }
         printf("[PCA9555] Testing Successfully Completed\n");
         
+#if PCA9555_BENCHMARK_ITERATIONS > 0
+        pca9555_benchmark(dev, PCA9555_BENCHMARK_ITERATIONS);
+#endif
         return ESP_OK;
     } else {
         printf("[PCA9555 ERROR] Communication test failed: %s\n", esp_err_to_name(ret));
         // Cleanup on failure
         dev->initialized = false;
-        i2c_driver_delete(i2c_port);
+        pca9555_bus_close(dev);
         return ret;
     }
 }
 
+#if PCA9555_USE_I2C_MASTER
+#if PCA9555_ASYNC_QUEUE_DEPTH > 0
+// An async bus queues every transfer; blocking calls drain it first and
+// wait for their own transfer, so stack buffers stay valid
+#define PCA9555_SYNC_BEGIN(dev)     do { i2c_master_bus_wait_all_done((dev)->bus, I2C_MASTER_TIMEOUT_MS); \
+                                         (dev)->sync_active = true; } while (0)
+#define PCA9555_SYNC_END(dev, ret)  do { if ((ret) == ESP_OK) { \
+                                             (ret) = i2c_master_bus_wait_all_done((dev)->bus, I2C_MASTER_TIMEOUT_MS); } \
+                                         (dev)->sync_active = false; } while (0)
+#else
+#define PCA9555_SYNC_BEGIN(dev)     do { } while (0)
+#define PCA9555_SYNC_END(dev, ret)  do { } while (0)
+#endif
+
+// Write reg followed by len data bytes (the chip auto-increments within a pair)
+static esp_err_t pca9555_transmit(pca9555_t *dev, uint8_t reg, const uint8_t *data, size_t len) {
+    uint8_t tx[3] = {reg};
+    memcpy(&tx[1], data, len);
+    
+    PCA9555_SYNC_BEGIN(dev);
+    esp_err_t ret = i2c_master_transmit(dev->handle, tx, len + 1, I2C_MASTER_TIMEOUT_MS);
+    PCA9555_SYNC_END(dev, ret);
+    return ret;
+}
+
+// Register address write, repeated start, len byte read
+static esp_err_t pca9555_receive(pca9555_t *dev, uint8_t reg, uint8_t *data, size_t len) {
+    PCA9555_SYNC_BEGIN(dev);
+    esp_err_t ret = i2c_master_transmit_receive(dev->handle, &reg, 1, data, len, I2C_MASTER_TIMEOUT_MS);
+    PCA9555_SYNC_END(dev, ret);
+    return ret;
+}
+
+//==========================================================================
+// WRITE REGISTER
+//==========================================================================
+esp_err_t pca9555_write_register(pca9555_t *dev, uint8_t reg, uint8_t value) {
+    if (dev == NULL) {
+        ESP_LOGE(TAG, "Write register: dev is NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!dev->initialized) {
+        ESP_LOGE(TAG, "Write register: device not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = pca9555_transmit(dev, reg, &value, 1);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Write register 0x%02X = 0x%02X failed: %s", reg, value, esp_err_to_name(ret));
+    } else {
+        ESP_LOGD(TAG, "Write register 0x%02X = 0x%02X - SUCCESS", reg, value);
+    }
+    
+    return ret;
+}
+
+//==========================================================================
+// READ REGISTER
+//==========================================================================
+esp_err_t pca9555_read_register(pca9555_t *dev, uint8_t reg, uint8_t *value) {
+    if (dev == NULL || value == NULL) {
+        ESP_LOGE(TAG, "Read register: NULL pointer (dev=%p, value=%p)", dev, value);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!dev->initialized) {
+        ESP_LOGE(TAG, "Read register: device not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = pca9555_receive(dev, reg, value, 1);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Read register 0x%02X failed: %s", reg, esp_err_to_name(ret));
+    } else {
+        ESP_LOGD(TAG, "Read register 0x%02X = 0x%02X - SUCCESS", reg, *value);
+    }
+    
+    return ret;
+}
+
+#else
+// Legacy driver: the burst helpers use the stack-buffered convenience calls
+static esp_err_t pca9555_transmit(pca9555_t *dev, uint8_t reg, const uint8_t *data, size_t len) {
+    uint8_t tx[3] = {reg};
+    memcpy(&tx[1], data, len);
+    return i2c_master_write_to_device(dev->i2c_port, dev->address, tx, len + 1,
+                                      pdMS_TO_TICKS(I2C_MASTER_TIMEOUT_MS));
+}
+
+static esp_err_t pca9555_receive(pca9555_t *dev, uint8_t reg, uint8_t *data, size_t len) {
+    return i2c_master_write_read_device(dev->i2c_port, dev->address, &reg, 1, data, len,
+                                        pdMS_TO_TICKS(I2C_MASTER_TIMEOUT_MS));
+}
+
 //==========================================================================
 // WRITE REGISTER
 //==========================================================================
@@ -840,6 +1062,102 @@ esp_err_t pca9555_read_register(pca9555_t *dev, uint8_t reg, uint8_t *value) {
     return ret;
 }
 
+#endif // PCA9555_USE_I2C_MASTER
+
+//==========================================================================
+// BURST REGISTER PAIR ACCESS
+//==========================================================================
+static bool pca9555_is_pair_register(uint8_t reg) {
+    return reg <= PCA9555_REG_CONFIG_0 && (reg & 1) == 0;
+}
+
+esp_err_t pca9555_write_register_pair(pca9555_t *dev, uint8_t reg, const uint8_t values[2]) {
+    if (dev == NULL || values == NULL || !pca9555_is_pair_register(reg)) {
+        ESP_LOGE(TAG, "write_register_pair: invalid arguments (reg=0x%02X)", reg);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!dev->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_err_t ret = pca9555_transmit(dev, reg, values, 2);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Write register pair 0x%02X failed: %s", reg, esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t pca9555_read_register_pair(pca9555_t *dev, uint8_t reg, uint8_t values[2]) {
+    if (dev == NULL || values == NULL || !pca9555_is_pair_register(reg)) {
+        ESP_LOGE(TAG, "read_register_pair: invalid arguments (reg=0x%02X)", reg);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!dev->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_err_t ret = pca9555_receive(dev, reg, values, 2);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Read register pair 0x%02X failed: %s", reg, esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+//==========================================================================
+// ASYNC TRANSFERS
+//==========================================================================
+esp_err_t pca9555_write_register_pair_async(pca9555_t *dev, uint8_t reg, const uint8_t values[2],
+                                            pca9555_done_cb_t cb, void *arg) {
+    if (dev == NULL || values == NULL || !pca9555_is_pair_register(reg)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!dev->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+#if PCA9555_USE_I2C_MASTER && PCA9555_ASYNC_QUEUE_DEPTH > 0
+    if ((uint8_t)(dev->async_head - dev->async_tail) >= PCA9555_ASYNC_QUEUE_DEPTH) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    uint8_t slot = dev->async_head % PCA9555_ASYNC_QUEUE_DEPTH;
+    dev->async_slot[slot].tx[0] = reg;
+    dev->async_slot[slot].tx[1] = values[0];
+    dev->async_slot[slot].tx[2] = values[1];
+    dev->async_slot[slot].cb = cb;
+    dev->async_slot[slot].arg = arg;
+    dev->async_head++;
+    
+    esp_err_t ret = i2c_master_transmit(dev->handle, dev->async_slot[slot].tx, 3, I2C_MASTER_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        // Never queued, so no completion will arrive
+        dev->async_head--;
+        ESP_LOGE(TAG, "Async write 0x%02X failed: %s", reg, esp_err_to_name(ret));
+    }
+    return ret;
+#else
+    esp_err_t ret = pca9555_write_register_pair(dev, reg, values);
+    if (cb) {
+        cb(ret, arg);
+    }
+    return ret;
+#endif
+}
+
+esp_err_t pca9555_wait_idle(pca9555_t *dev) {
+    if (dev == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#if PCA9555_USE_I2C_MASTER && PCA9555_ASYNC_QUEUE_DEPTH > 0
+    if (dev->initialized) {
+        return i2c_master_bus_wait_all_done(dev->bus, I2C_MASTER_TIMEOUT_MS);
+    }
+#endif
+    return ESP_OK;
+}
+
 //==========================================================================
 // CONFIGURATION FUNCTIONS
 //==========================================================================
@@ -945,6 +1263,30 @@ esp_err_t pca9555_read_port1_output(pca9555_t *dev, uint8_t *value) {
     return pca9555_read_register(dev, PCA9555_REG_OUTPUT_1, value);
 }
 
+esp_err_t pca9555_set_outputs(pca9555_t *dev, uint8_t port0, uint8_t port1) {
+    uint8_t values[2] = {port0, port1};
+    return pca9555_write_register_pair(dev, PCA9555_REG_OUTPUT_0, values);
+}
+
+esp_err_t pca9555_read_outputs(pca9555_t *dev, uint8_t *port0, uint8_t *port1) {
+    if (port0 == NULL || port1 == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t values[2];
+    esp_err_t ret = pca9555_read_register_pair(dev, PCA9555_REG_OUTPUT_0, values);
+    if (ret == ESP_OK) {
+        *port0 = values[0];
+        *port1 = values[1];
+    }
+    return ret;
+}
+
+esp_err_t pca9555_set_outputs_async(pca9555_t *dev, uint8_t port0, uint8_t port1,
+                                    pca9555_done_cb_t cb, void *arg) {
+    uint8_t values[2] = {port0, port1};
+    return pca9555_write_register_pair_async(dev, PCA9555_REG_OUTPUT_0, values, cb, arg);
+}
+
 //==========================================================================
 // PIN CONTROL FUNCTIONS
 //==========================================================================
@@ -1119,17 +1461,14 @@ esp_err_t pca9555_read_all_pins(pca9555_t *dev, uint8_t *port0_state, uint8_t *p
         return ESP_ERR_INVALID_STATE;
     }
     
-    esp_err_t ret = pca9555_read_register(dev, PCA9555_REG_INPUT_0, port0_state);
+    uint8_t values[2];
+    esp_err_t ret = pca9555_read_register_pair(dev, PCA9555_REG_INPUT_0, values);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "read_all_pins: failed to read PORT0");
-        return ret;
-    }
-    
-    ret = pca9555_read_register(dev, PCA9555_REG_INPUT_1, port1_state);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "read_all_pins: failed to read PORT1");
+        ESP_LOGE(TAG, "read_all_pins: failed to read input ports");
         return ret;
     }
+    *port0_state = values[0];
+    *port1_state = values[1];
     
     ESP_LOGD(TAG, "All pins state - PORT0: 0x%02X, PORT1: 0x%02X", *port0_state, *port1_state);
     return ESP_OK;
@@ -1173,6 +1512,98 @@ esp_err_t pca9555_debug_test(pca9555_t *dev) {
     return ESP_OK;
 }
 
+//==========================================================================
+// BENCHMARK
+//==========================================================================
+#if PCA9555_USE_I2C_MASTER && PCA9555_ASYNC_QUEUE_DEPTH > 0
+static void pca9555_benchmark_done(esp_err_t result, void *arg) {
+    if (result != ESP_OK) {
+        (*(volatile uint32_t *)arg)++;
+    }
+}
+#endif
+
+static void pca9555_benchmark_report(const char *name, int iterations, int failed, int64_t elapsed_us) {
+    printf("[PCA9555 BENCH] %-18s %6d ops  %8.1f ops/s  %6.1f us/op  %d failed\n",
+           name, iterations,
+           elapsed_us > 0 ? iterations * 1e6 / elapsed_us : 0.0,
+           iterations > 0 ? (double)elapsed_us / iterations : 0.0,
+           failed);
+}
+
+/**
+ * Uses the polarity inversion registers (inputs only) and output reads, so
+ * relay states are never changed.
+ */
+esp_err_t pca9555_benchmark(pca9555_t *dev, int iterations) {
+    if (dev == NULL || iterations <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!dev->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    uint8_t polarity[2];
+    esp_err_t ret = pca9555_read_register_pair(dev, PCA9555_REG_POLARITY_0, polarity);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    printf("\n[PCA9555 BENCH] %s driver, %d kHz\n",
+           PCA9555_USE_I2C_MASTER ? "i2c_master" : "legacy", I2C_MASTER_FREQ_HZ / 1000);
+    
+    int failed = 0;
+    uint8_t value;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        failed += pca9555_write_register(dev, PCA9555_REG_POLARITY_0, polarity[0]) != ESP_OK;
+    }
+    pca9555_benchmark_report("write register", iterations, failed, esp_timer_get_time() - start);
+    
+    failed = 0;
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        failed += pca9555_read_register(dev, PCA9555_REG_OUTPUT_1, &value) != ESP_OK;
+    }
+    pca9555_benchmark_report("read register", iterations, failed, esp_timer_get_time() - start);
+    
+    failed = 0;
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        failed += pca9555_write_register_pair(dev, PCA9555_REG_POLARITY_0, polarity) != ESP_OK;
+    }
+    pca9555_benchmark_report("write pair", iterations, failed, esp_timer_get_time() - start);
+    
+    uint8_t pair[2];
+    failed = 0;
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        failed += pca9555_read_register_pair(dev, PCA9555_REG_OUTPUT_0, pair) != ESP_OK;
+    }
+    pca9555_benchmark_report("read pair", iterations, failed, esp_timer_get_time() - start);
+    
+#if PCA9555_USE_I2C_MASTER && PCA9555_ASYNC_QUEUE_DEPTH > 0
+    // Submit as fast as the queue allows; time includes draining it
+    volatile uint32_t async_failed = 0;
+    failed = 0;
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        while ((ret = pca9555_write_register_pair_async(dev, PCA9555_REG_POLARITY_0, polarity,
+                                                         pca9555_benchmark_done, (void *)&async_failed))
+               == ESP_ERR_NOT_FINISHED) {
+            taskYIELD();
+        }
+        failed += ret != ESP_OK;
+    }
+    pca9555_wait_idle(dev);
+    pca9555_benchmark_report("write pair async", iterations, failed + (int)async_failed,
+                             esp_timer_get_time() - start);
+#endif
+    printf("\n");
+    return ESP_OK;
+}
+
 //==========================================================================
 // DEINITIALIZE
 //==========================================================================
@@ -1187,11 +1618,11 @@ esp_err_t pca9555_deinit(pca9555_t *dev) {
     }
     
     // Set all outputs to LOW before deinitializing for safety
-    pca9555_set_port0_output(dev, 0x00);
-    pca9555_set_port1_output(dev, 0x00);
+    pca9555_wait_idle(dev);
+    pca9555_set_outputs(dev, 0x00, 0x00);
     
-    // Delete I2C driver
-    i2c_driver_delete(dev->i2c_port);
+    // Release the bus
+    pca9555_bus_close(dev);
     
     dev->initialized = false;
     
@@ -73,10 +73,31 @@ bool pca9555_is_initialized(pca9555_t *dev);
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "driver/i2c.h"
 #include "esp_err.h"
 #include "driver/gpio.h"
 
+// Driver selection: 1 = i2c_master bus driver (persistent device handle, no
+// per-call allocation), 0 = legacy i2c_cmd_link driver
+#ifndef PCA9555_USE_I2C_MASTER
+#define PCA9555_USE_I2C_MASTER          1
+#endif
+
+// i2c_master only: transactions queued by the async API (0 = synchronous bus)
+#ifndef PCA9555_ASYNC_QUEUE_DEPTH
+#define PCA9555_ASYNC_QUEUE_DEPTH       0
+#endif
+
+// Run pca9555_benchmark() at the end of a successful init (0 = off)
+#ifndef PCA9555_BENCHMARK_ITERATIONS
+#define PCA9555_BENCHMARK_ITERATIONS    0
+#endif
+
+#if PCA9555_USE_I2C_MASTER
+#include "driver/i2c_master.h"
+#else
+#include "driver/i2c.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -98,11 +119,29 @@ extern "C" {
 #define PCA9555_I2C_MASTER_FREQ_HZ       100000
 #define PCA9555_I2C_MASTER_TIMEOUT_MS    1000
 
+// Async transfer completion (i2c_master: ISR context; otherwise the caller's task)
+typedef void (*pca9555_done_cb_t)(esp_err_t result, void *arg);
+
 // PCA9555 Device Structure
 typedef struct {
     uint8_t address;
     i2c_port_t i2c_port;
     bool initialized;
+#if PCA9555_USE_I2C_MASTER
+    i2c_master_bus_handle_t bus;
+    i2c_master_dev_handle_t handle;
+#if PCA9555_ASYNC_QUEUE_DEPTH > 0
+    // Queued transfers; buffers must outlive the call that submits them
+    struct {
+        uint8_t tx[3];
+        pca9555_done_cb_t cb;
+        void *arg;
+    } async_slot[PCA9555_ASYNC_QUEUE_DEPTH];
+    volatile uint8_t async_head;        // Next slot to submit
+    volatile uint8_t async_tail;        // Next slot to complete
+    volatile bool sync_active;          // Completion belongs to a blocking call
+#endif
+#endif
 } pca9555_t;
 
 // ==========================================================================
@@ -119,6 +158,18 @@ bool pca9555_is_initialized(pca9555_t *dev);
 esp_err_t pca9555_write_register(pca9555_t *dev, uint8_t reg, uint8_t value);
 esp_err_t pca9555_read_register(pca9555_t *dev, uint8_t reg, uint8_t *value);
 
+// Burst access to a port 0/1 register pair (reg must be the port 0 register)
+esp_err_t pca9555_write_register_pair(pca9555_t *dev, uint8_t reg, const uint8_t values[2]);
+esp_err_t pca9555_read_register_pair(pca9555_t *dev, uint8_t reg, uint8_t values[2]);
+
+// Queue a burst write and return; cb reports completion. Without an async
+// queue the write completes before returning and cb runs inline.
+esp_err_t pca9555_write_register_pair_async(pca9555_t *dev, uint8_t reg, const uint8_t values[2],
+                                            pca9555_done_cb_t cb, void *arg);
+
+// Block until queued async transfers have completed
+esp_err_t pca9555_wait_idle(pca9555_t *dev);
+
 // ==========================================================================
 // CONFIGURATION FUNCTIONS
 // ==========================================================================
@@ -134,6 +185,12 @@ esp_err_t pca9555_set_port1_output(pca9555_t *dev, uint8_t value);
 esp_err_t pca9555_read_port0_output(pca9555_t *dev, uint8_t *value);
 esp_err_t pca9555_read_port1_output(pca9555_t *dev, uint8_t *value);
 
+// Both output ports in one transaction
+esp_err_t pca9555_set_outputs(pca9555_t *dev, uint8_t port0, uint8_t port1);
+esp_err_t pca9555_read_outputs(pca9555_t *dev, uint8_t *port0, uint8_t *port1);
+esp_err_t pca9555_set_outputs_async(pca9555_t *dev, uint8_t port0, uint8_t port1,
+                                    pca9555_done_cb_t cb, void *arg);
+
 // ==========================================================================
 // PIN CONTROL FUNCTIONS
 // ==========================================================================
@@ -156,6 +213,9 @@ esp_err_t pca9555_read_all_pins(pca9555_t *dev, uint8_t *port0_state, uint8_t *p
 void pca9555_scan_devices(i2c_port_t i2c_port, gpio_num_t sda_gpio, gpio_num_t scl_gpio);
 esp_err_t pca9555_debug_test(pca9555_t *dev);
 
+// Transactions/s for single, burst and async access (leaves outputs untouched)
+esp_err_t pca9555_benchmark(pca9555_t *dev, int iterations);
+
 #ifdef __cplusplus
 }
 #endif
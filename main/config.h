@@ -6,6 +6,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include "sdkconfig.h"
+
 // ========================================
 // DEVICE CONFIGURATION
 // ========================================
@@ -31,35 +33,57 @@
 // ========================================
 // Task stack sizes
 #define TASK_SENSOR_STACK_SIZE      8192
-#define TASK_FIRE_DETECT_STACK_SIZE 8192
-#define TASK_PUMP_MGMT_STACK_SIZE   6144
-#define TASK_WATER_LOCK_STACK_SIZE  4096
+#define TASK_CONTROL_STACK_SIZE     8192
+#define TASK_SHADOW_REPORT_STACK_SIZE 6144
 #define TASK_MONITOR_STACK_SIZE     4096
-#define TASK_DOOR_STACK_SIZE        4096
-#define TASK_CMD_STACK_SIZE         8192
 #define TASK_MQTT_PUBLISH_STACK_SIZE 4096
 #define TASK_STATE_MACHINE_STACK_SIZE 6144
 #define TASK_ALERT_STACK_SIZE       4096
+#define TASK_OTA_STACK_SIZE         16384
+#define TASK_BOOT_WORKER_STACK_SIZE 6144    // Transient, deleted once boot completes
 
 // Task priorities
-#define TASK_PRIORITY_SENSOR        2
-#define TASK_PRIORITY_FIRE_DETECT   3
-#define TASK_PRIORITY_PUMP_MGMT     2
-#define TASK_PRIORITY_WATER_LOCK    2
+// Safety tasks sit above everything else on their core; network tasks
+// stay below the WiFi, TCP/IP and MQTT client tasks on theirs
+#define TASK_PRIORITY_SENSOR        4
+#define TASK_PRIORITY_CONTROL       5
+#define TASK_PRIORITY_SHADOW_REPORT 1
 #define TASK_PRIORITY_MONITOR       1
-#define TASK_PRIORITY_DOOR          1
-#define TASK_PRIORITY_CMD           2
 #define TASK_PRIORITY_MQTT_PUBLISH  1
 #define TASK_PRIORITY_STATE_MACHINE 3
 #define TASK_PRIORITY_ALERT         2
+#define TASK_PRIORITY_OTA           5
+#define TASK_PRIORITY_BOOT_WORKER   1       // Same as app_main
+
+// Task cores (menuconfig: Fire System Task Placement)
+#ifdef CONFIG_FIRE_TASK_PINNING
+#define TASK_CORE_SAFETY            CONFIG_FIRE_SAFETY_CORE
+#define TASK_CORE_NETWORK           CONFIG_FIRE_NETWORK_CORE
+#else
+#define TASK_CORE_SAFETY            tskNO_AFFINITY
+#define TASK_CORE_NETWORK           tskNO_AFFINITY
+#endif
+
+#define TASK_CORE_SENSOR            TASK_CORE_SAFETY
+#define TASK_CORE_CONTROL           TASK_CORE_SAFETY
+#define TASK_CORE_SHADOW_REPORT     TASK_CORE_NETWORK
+#define TASK_CORE_MONITOR           TASK_CORE_NETWORK
+#define TASK_CORE_MQTT_PUBLISH      TASK_CORE_NETWORK
+#define TASK_CORE_STATE_MACHINE     TASK_CORE_NETWORK
+#define TASK_CORE_ALERT             TASK_CORE_NETWORK
+#define TASK_CORE_OTA               TASK_CORE_NETWORK
+#define TASK_CORE_BOOT_WORKER       TASK_CORE_SAFETY    // app_main runs on CPU0
 
 // ========================================
 // TIMING CONFIGURATION (milliseconds)
 // ========================================
 #define HEARTBEAT_INTERVAL          60000
 #define SYSTEM_STATUS_INTERVAL      70000
+#define DIAGNOSTICS_INTERVAL        300000  // Task loop timing over MQTT
 #define SHADOW_UPDATE_INTERVAL      30000
 #define SENSOR_WARMUP_SECONDS       15      // Wait for sensors to stabilize
+#define FIRE_DETECT_STALE_MS        5000    // Control task warns if no sensor frame arrives
+#define SHADOW_REPORT_DELAY_MS      100     // Lets related changes settle into one shadow report
 
 // ========================================
 // NETWORK CONFIGURATION
@@ -83,6 +107,7 @@
 // ========================================
 #define MIN_FREE_HEAP_THRESHOLD     10240   // 10KB minimum free heap
 #define MAX_JSON_PAYLOAD_SIZE       1024    // Maximum JSON payload size
+#define SHADOW_JSON_BUFFER_SIZE     640     // Shadow report buffer, on the caller's stack
 #define MAX_TOPIC_LENGTH            128     // Maximum MQTT topic length
 #define MQTT_QOS_LEVEL              0       // Use QoS 0 for memory efficiency
 
@@ -91,6 +116,11 @@
 // ========================================
 #define ALERT_SYSTEM_ENABLED        1
 #define MAX_ALERT_RETRIES           3       // Max retries for failed alerts
+#define ALERT_HOLD_FIRE_MS          30000   // Fire detected/cleared hold-down window
+#define ALERT_HOLD_FIRE_MAX_MS      300000  // Hold-down ceiling while a sector flaps
+#define ALERT_HOLD_WATER_MS         60000   // Water lockout hold-down window
+#define ALERT_HOLD_WATER_MAX_MS     600000  // Hold-down ceiling while the level hovers
+#define ALERT_ACK_TIMEOUT_MS        60000   // Wait for PUBACK before leaving an alert to the replay
 
 
 // ========================================
@@ -105,7 +135,9 @@
 // QUEUE CONFIGURATION
 // ========================================
 #define MQTT_QUEUE_SIZE             4
-#define MQTT_PUBLISH_QUEUE_SIZE     6
+#define MQTT_PUBLISH_QUEUE_SIZE     10      // Slots shared by the priority lanes, see mqtt_lanes.h
+#define ALERT_QUEUE_SIZE            64      // Record handles; alert bodies live in the pool
+#define ALERT_POOL_BLOCKS           128     // 48-byte blocks, ~6 KB (was 10 full Alert copies)
 
 // ========================================
 // DEFAULT WIFI CREDENTIALS
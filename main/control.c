@@ -0,0 +1,151 @@
+/**
+ * @file control.c
+ * @brief Single-owner control core: command mailbox and state snapshot
+ */
+
+#include "control.h"
+#include "mpsc_queue.h"
+#include <stdio.h>
+#include <string.h>
+
+static control_request_t s_items[CONTROL_QUEUE_DEPTH];
+static uint32_t s_seqs[CONTROL_QUEUE_DEPTH];
+static mpsc_queue_t s_mailbox;
+static TaskHandle_t s_owner = NULL;
+static uint32_t s_dropped = 0;
+
+// Double-buffered snapshot, see sensor_frame.c for the scheme
+static ControlSnapshot s_snapshots[2];
+static uint32_t s_snapshot_seq[2];
+static uint32_t s_latest = 0;
+static uint32_t s_published = 0;
+
+// ========================================
+// MAILBOX
+// ========================================
+
+esp_err_t control_init(void)
+{
+    if (mpsc_queue_init(&s_mailbox, s_items, s_seqs, CONTROL_QUEUE_DEPTH, sizeof(control_request_t)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+void control_set_owner(TaskHandle_t task)
+{
+    s_owner = task;
+}
+
+bool control_is_owner(void)
+{
+    return s_owner != NULL && xTaskGetCurrentTaskHandle() == s_owner;
+}
+
+void control_notify(uint32_t events)
+{
+    if (s_owner != NULL) {
+        xTaskNotify(s_owner, events, eSetBits);
+    }
+}
+
+static esp_err_t control_enqueue(const control_request_t *req)
+{
+    // A full mailbox means the owner is behind; give it time rather than drop
+    TickType_t start = xTaskGetTickCount();
+    while (!mpsc_queue_push(&s_mailbox, req)) {
+        if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(CONTROL_SUBMIT_TIMEOUT_MS)) {
+            uint32_t dropped = __atomic_add_fetch(&s_dropped, 1, __ATOMIC_RELAXED);
+            printf("[CTRL] ERROR: Command %d dropped - mailbox full for %d ms (%lu dropped)\n",
+                   req->cmd.type, CONTROL_SUBMIT_TIMEOUT_MS, (unsigned long)dropped);
+            return ESP_ERR_TIMEOUT;
+        }
+        control_notify(CONTROL_EVENT_COMMAND);
+        vTaskDelay(1);
+    }
+    control_notify(CONTROL_EVENT_COMMAND);
+    return ESP_OK;
+}
+
+esp_err_t control_submit(const SystemCommand *cmd)
+{
+    control_request_t req = { .cmd = *cmd, .reply = NULL };
+    return control_enqueue(&req);
+}
+
+bool control_call(const SystemCommand *cmd)
+{
+    if (control_is_owner()) {
+        // Would wait on itself forever
+        printf("[CTRL] ERROR: control_call() from the control task (command %d)\n", cmd->type);
+        return false;
+    }
+
+    control_reply_t reply;
+    reply.done = xSemaphoreCreateBinaryStatic(&reply.done_buf);
+    reply.result = false;
+
+    control_request_t req = { .cmd = *cmd, .reply = &reply };
+    if (control_enqueue(&req) != ESP_OK) {
+        return false;
+    }
+
+    // The reply lives on this stack, so wait for it even if the owner is slow
+    xSemaphoreTake(reply.done, portMAX_DELAY);
+    return reply.result;
+}
+
+bool control_receive(control_request_t *out)
+{
+    return mpsc_queue_pop(&s_mailbox, out);
+}
+
+void control_complete(const control_request_t *req, bool result)
+{
+    if (req->reply != NULL) {
+        req->reply->result = result;
+        xSemaphoreGive(req->reply->done);
+    }
+}
+
+uint32_t control_dropped_commands(void)
+{
+    return __atomic_load_n(&s_dropped, __ATOMIC_RELAXED);
+}
+
+// ========================================
+// SNAPSHOT
+// ========================================
+
+void control_publish(const ControlSnapshot *snapshot)
+{
+    uint32_t idx = __atomic_load_n(&s_latest, __ATOMIC_RELAXED) ^ 1;
+    uint32_t seq = s_snapshot_seq[idx];
+
+    __atomic_store_n(&s_snapshot_seq[idx], seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    memcpy(&s_snapshots[idx], snapshot, sizeof(*snapshot));
+    s_snapshots[idx].seq = ++s_published;
+
+    __atomic_store_n(&s_snapshot_seq[idx], seq + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_latest, idx, __ATOMIC_RELEASE);
+}
+
+void control_snapshot_read(ControlSnapshot *out)
+{
+    for (;;) {
+        uint32_t idx = __atomic_load_n(&s_latest, __ATOMIC_ACQUIRE);
+        uint32_t before = __atomic_load_n(&s_snapshot_seq[idx], __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            continue;
+        }
+
+        memcpy(out, &s_snapshots[idx], sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&s_snapshot_seq[idx], __ATOMIC_RELAXED) == before) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file control.h
+ * @brief Single-owner control core: command mailbox and state snapshot
+ *
+ * One task (task_control in main.c) owns pumps[], water lockout, the
+ * active profile and emergency stop. Nothing else writes them. Other tasks
+ * and the MQTT handlers change state by submitting typed commands. The
+ * commands go through a lock-free MPSC queue, and a notification bit wakes
+ * the owner. Sensor frames and pump schedule kicks are plain notification
+ * bits.
+ *
+ * After every pass the owner publishes an immutable ControlSnapshot.
+ * Readers copy it without locking (the same double-buffered seqlock as
+ * sensor_frame), so a reader can never hold up the control loop.
+ *
+ * control_call() waits for the owner to run the command and returns its
+ * result, for handlers that must acknowledge what actually happened. The
+ * owner must never call it, and must never block on a task that may be
+ * waiting in it (for example an MQTT publish from the control task).
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include "fire_system.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Control Configuration
+#define CONTROL_QUEUE_DEPTH             16      // Power of two
+#define CONTROL_SUBMIT_TIMEOUT_MS       500     // Producer waits this long for a free slot
+#define CONTROL_WATER_PERIOD_MS         500     // Continuous feed and lockout check
+
+// Notification bits for the control task
+#define CONTROL_EVENT_COMMAND           (1u << 0)
+#define CONTROL_EVENT_FRAME             (1u << 1)   // New sensor frame published
+#define CONTROL_EVENT_KICK              (1u << 2)   // Pump state or deadline changed
+
+// Completion for a synchronous command
+typedef struct {
+    SemaphoreHandle_t done;
+    StaticSemaphore_t done_buf;
+    bool result;
+} control_reply_t;
+
+// One mailbox entry
+typedef struct {
+    SystemCommand cmd;
+    control_reply_t *reply;     // NULL for fire-and-forget
+} control_request_t;
+
+// Per-pump state as the control task last left it
+typedef struct {
+    PumpState state;
+    ActivationSource source;
+    bool isRunning;
+    bool timerProtected;
+    bool timerActive;           // Protected and not yet expired
+    unsigned long timerRemainingS;
+} ControlPumpSnapshot;
+
+// Published after every control pass
+typedef struct {
+    uint32_t seq;               // 0 = nothing published yet
+    SystemProfile profile;
+    bool emergencyStop;
+    bool waterLockout;
+    bool continuousFeed;
+    bool startAllPumps;
+    bool suppressionActive;
+    ControlPumpSnapshot pumps[4];
+} ControlSnapshot;
+
+/**
+ * @brief Set up the mailbox (before any task submits)
+ */
+esp_err_t control_init(void);
+
+/**
+ * @brief Register the task that owns control state and drains the mailbox
+ */
+void control_set_owner(TaskHandle_t task);
+
+/**
+ * @brief True when called from the owner task
+ */
+bool control_is_owner(void);
+
+/**
+ * @brief Queue a command without waiting for it to run
+ * @return ESP_OK, or ESP_ERR_TIMEOUT if the mailbox stayed full (logged and counted)
+ */
+esp_err_t control_submit(const SystemCommand *cmd);
+
+/**
+ * @brief Queue a command and wait until the owner has run it
+ * @return The command's result; false if it could not be queued
+ */
+bool control_call(const SystemCommand *cmd);
+
+/**
+ * @brief Wake the owner with event bits (any task)
+ */
+void control_notify(uint32_t events);
+
+/**
+ * @brief Take the next queued command (owner only)
+ */
+bool control_receive(control_request_t *out);
+
+/**
+ * @brief Report a command's result to a waiting control_call() (owner only)
+ */
+void control_complete(const control_request_t *req, bool result);
+
+/**
+ * @brief Publish the owner's current state (owner only)
+ */
+void control_publish(const ControlSnapshot *snapshot);
+
+/**
+ * @brief Copy the latest snapshot without blocking
+ */
+void control_snapshot_read(ControlSnapshot *out);
+
+/**
+ * @brief Commands refused because the mailbox stayed full
+ */
+uint32_t control_dropped_commands(void);
+
+#endif // CONTROL_H
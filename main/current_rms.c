@@ -0,0 +1,38 @@
+/**
+ * @file current_rms.c
+ * @brief Block-based true-RMS kernel for the CT current sensors
+ */
+
+#include "current_rms.h"
+#include <math.h>
+
+bool current_rms_compute(const current_rms_acc_t *acc, float amps_per_code, current_rms_t *out)
+{
+    out->rms = 0;
+    out->peak = 0;
+    out->crest = 0;
+    out->bias_codes = 0;
+
+    if (acc->count < CURRENT_RMS_MIN_SAMPLES) {
+        return false;
+    }
+
+    // n^2 * variance = n * sum(x^2) - sum(x)^2, exact in 64 bits for
+    // 12-bit codes and any block the uint32 sum can hold
+    uint64_t n = acc->count;
+    uint64_t sum = acc->sum;
+    uint64_t spread = n * acc->sumsq - sum * sum;
+
+    float bias = (float)acc->sum / acc->count;
+    float rms_codes = sqrtf((float)spread) / acc->count;
+    float above = acc->max - bias;
+    float below = bias - acc->min;
+
+    out->bias_codes = bias;
+    out->rms = rms_codes * amps_per_code;
+    out->peak = (above > below ? above : below) * amps_per_code;
+    if (out->rms >= CURRENT_RMS_CREST_FLOOR_A) {
+        out->crest = out->peak / out->rms;
+    }
+    return true;
+}
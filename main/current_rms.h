@@ -0,0 +1,82 @@
+/**
+ * @file current_rms.h
+ * @brief Block-based true-RMS kernel for the CT current sensors
+ *
+ * A block of raw ADC codes is reduced to four moments (count, sum, sum of
+ * squares, min/max) as it is captured - by the DMA callback or by the
+ * oneshot fallback - and turned into RMS, peak and crest factor once per
+ * block. The DC bias is removed exactly from the moments, so the result
+ * does not depend on the nominal 1.65 V midpoint.
+ */
+
+#ifndef CURRENT_RMS_H
+#define CURRENT_RMS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Kernel Configuration
+#define CURRENT_RMS_WINDOW_MS       100     // Oneshot capture window (5 mains cycles at 50 Hz)
+#define CURRENT_RMS_CYCLE_MS        20      // One 50 Hz mains cycle, sampled without a break
+#define CURRENT_RMS_MIN_SAMPLES     16      // Blocks smaller than this are rejected
+#define CURRENT_RMS_CREST_FLOOR_A   0.05f   // No crest factor below this RMS (noise floor)
+
+// Running moments of one block of raw codes
+typedef struct {
+    uint32_t count;
+    uint32_t sum;
+    uint64_t sumsq;
+    uint16_t min;
+    uint16_t max;
+} current_rms_acc_t;
+
+// Result for one block
+typedef struct {
+    float rms;          // AC RMS current, A
+    float peak;         // Largest excursion from the DC bias, A
+    float crest;        // peak / rms (0 below CURRENT_RMS_CREST_FLOOR_A)
+    float bias_codes;   // DC bias in raw codes
+} current_rms_t;
+
+/**
+ * @brief Clear an accumulator
+ */
+static inline void current_rms_reset(current_rms_acc_t *acc)
+{
+    acc->count = 0;
+    acc->sum = 0;
+    acc->sumsq = 0;
+    acc->min = UINT16_MAX;
+    acc->max = 0;
+}
+
+/**
+ * @brief Add one raw code to an accumulator
+ */
+static inline void current_rms_add(current_rms_acc_t *acc, uint16_t raw)
+{
+    acc->count++;
+    acc->sum += raw;
+    acc->sumsq += (uint32_t)raw * raw;
+    if (raw < acc->min) acc->min = raw;
+    if (raw > acc->max) acc->max = raw;
+}
+
+/**
+ * @brief Compute RMS, peak and crest factor of a block
+ * @param acc Block moments
+ * @param amps_per_code Sensor gain (calibrated volts per code / shunt / CT ratio)
+ * @param out Result
+ * @return false if the block has fewer than CURRENT_RMS_MIN_SAMPLES samples
+ */
+bool current_rms_compute(const current_rms_acc_t *acc, float amps_per_code, current_rms_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CURRENT_RMS_H
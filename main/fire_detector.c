@@ -0,0 +1,116 @@
+/**
+ * @file fire_detector.c
+ * @brief Per-sector flame confirmation with rate-of-rise fusion
+ */
+
+#include "fire_detector.h"
+#include <math.h>
+
+// Adjacent sectors in [N, S, E, W] order
+static const uint8_t s_neighbours[FIRE_DETECTOR_SECTORS][2] = {
+    {2, 3},     // N: E, W
+    {2, 3},     // S: E, W
+    {0, 1},     // E: N, S
+    {0, 1},     // W: N, S
+};
+
+static float clamp01(float x)
+{
+    return x < 0 ? 0 : (x > 1 ? 1 : x);
+}
+
+void fire_detector_reset(fire_detector_sector_t *sector)
+{
+    sector->validating = false;
+    sector->confirmed = false;
+    sector->confidence = 0;
+    sector->start_ms = 0;
+    sector->last_ms = 0;
+}
+
+int fire_detector_corroboration(const float level[FIRE_DETECTOR_SECTORS], int sector, float threshold)
+{
+    if (sector < 0 || sector >= FIRE_DETECTOR_SECTORS) {
+        return 0;
+    }
+    return (level[s_neighbours[sector][0]] > threshold) +
+           (level[s_neighbours[sector][1]] > threshold);
+}
+
+float fire_detector_confidence_rate(const fire_detector_params_t *params,
+                                    float level, float rate, int corroborating)
+{
+    float speedup = 1.0f;
+
+    if (params->mode == FIRE_DETECT_FUSED) {
+        float level_credit = clamp01((level - params->threshold) / (100.0f - params->threshold));
+        float rise_credit = params->rise_full_rate > 0 ? clamp01(rate / params->rise_full_rate) : 0;
+
+        speedup += params->level_gain * level_credit;
+        speedup += params->rise_gain * rise_credit;
+        speedup += params->neighbour_gain * corroborating;
+
+        // Never faster than min_confirm_ms
+        if (params->min_confirm_ms > 0) {
+            float max_speedup = (float)params->confirm_ms / params->min_confirm_ms;
+            if (speedup > max_speedup) {
+                speedup = max_speedup;
+            }
+        }
+    }
+
+    return params->confirm_ms ? speedup / params->confirm_ms : 1.0f;
+}
+
+fire_detect_event_t fire_detector_update(fire_detector_sector_t *sector,
+                                         const fire_detector_params_t *params,
+                                         float level, float rate, int corroborating,
+                                         uint32_t now_ms)
+{
+    if (level <= params->threshold) {
+        bool lost = sector->validating && !sector->confirmed;
+        fire_detector_reset(sector);
+        return lost ? FIRE_DETECT_EVENT_LOST : FIRE_DETECT_EVENT_NONE;
+    }
+
+    if (!sector->validating) {
+        sector->validating = true;
+        sector->confirmed = false;
+        sector->confidence = 0;
+        sector->start_ms = now_ms;
+        sector->last_ms = now_ms;
+        return FIRE_DETECT_EVENT_STARTED;
+    }
+
+    uint32_t dt_ms = now_ms - sector->last_ms;
+    sector->last_ms = now_ms;
+    if (sector->confirmed) {
+        return FIRE_DETECT_EVENT_NONE;
+    }
+
+    sector->confidence += dt_ms * fire_detector_confidence_rate(params, level, rate, corroborating);
+    // Tolerate float rounding so an exact confirm_ms window still confirms
+    if (sector->confidence >= 1.0f - 1e-4f) {
+        sector->confidence = 1.0f;
+        sector->confirmed = true;
+        return FIRE_DETECT_EVENT_CONFIRMED;
+    }
+    return FIRE_DETECT_EVENT_NONE;
+}
+
+uint32_t fire_detector_ms_to_confirm(const fire_detector_sector_t *sector,
+                                     const fire_detector_params_t *params,
+                                     float level, float rate, int corroborating,
+                                     uint32_t now_ms)
+{
+    if (!sector->validating || sector->confirmed || level <= params->threshold) {
+        return UINT32_MAX;
+    }
+
+    float per_ms = fire_detector_confidence_rate(params, level, rate, corroborating);
+    float remaining = (1.0f - sector->confidence) / per_ms;
+    uint32_t since = now_ms - sector->last_ms;
+    uint32_t needed = (uint32_t)ceilf(remaining);
+
+    return needed > since ? needed - since : 0;
+}
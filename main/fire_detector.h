@@ -0,0 +1,118 @@
+/**
+ * @file fire_detector.h
+ * @brief Per-sector flame confirmation with rate-of-rise fusion
+ *
+ * A sector above the flame threshold accumulates confidence until it
+ * reaches 1.0 and the flame is confirmed. In persistence mode confidence
+ * grows linearly, so a steady level confirms after exactly confirm_ms -
+ * the original fixed-window rule. In fused mode the growth rate is scaled
+ * up by how far the level is above threshold, how fast it is rising and
+ * how many neighbouring sectors also see flame, bounded so confirmation
+ * never takes less than min_confirm_ms. Dropping below threshold resets
+ * the sector.
+ */
+
+#ifndef FIRE_DETECTOR_H
+#define FIRE_DETECTOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIRE_DETECTOR_SECTORS       4       // N, S, E, W
+
+// Detector modes
+typedef enum {
+    FIRE_DETECT_PERSISTENCE = 0,    // Fixed confirmation window
+    FIRE_DETECT_FUSED               // Level + rate of rise + neighbour corroboration
+} fire_detect_mode_t;
+
+// Detector tuning (filled from ProfileConfig)
+typedef struct {
+    fire_detect_mode_t mode;
+    float threshold;                // IR % that counts as flame
+    uint32_t confirm_ms;            // Confirmation time with no supporting evidence
+    uint32_t min_confirm_ms;        // Fastest allowed confirmation (fused mode)
+    float rise_full_rate;           // %/s that earns full rate-of-rise credit
+    float rise_gain;                // Speed-up at full rate credit
+    float level_gain;               // Speed-up at 100 % IR
+    float neighbour_gain;           // Speed-up per corroborating neighbour
+} fire_detector_params_t;
+
+// Per-sector state
+typedef struct {
+    bool validating;
+    bool confirmed;
+    float confidence;               // 0..1, confirmed at 1
+    uint32_t start_ms;
+    uint32_t last_ms;
+} fire_detector_sector_t;
+
+// Result of one sector update
+typedef enum {
+    FIRE_DETECT_EVENT_NONE = 0,
+    FIRE_DETECT_EVENT_STARTED,      // Flame first seen, confirmation running
+    FIRE_DETECT_EVENT_CONFIRMED,    // Confidence reached 1.0
+    FIRE_DETECT_EVENT_LOST          // Flame lost before confirmation
+} fire_detect_event_t;
+
+/**
+ * @brief Clear a sector
+ */
+void fire_detector_reset(fire_detector_sector_t *sector);
+
+/**
+ * @brief Number of adjacent sectors above threshold
+ * @param level Conditioned IR levels [N, S, E, W]
+ * @param sector Sector index
+ * @param threshold Flame threshold
+ * @return 0..2 (N/S neighbour E/W and vice versa)
+ */
+int fire_detector_corroboration(const float level[FIRE_DETECTOR_SECTORS], int sector, float threshold);
+
+/**
+ * @brief Confidence gained per millisecond for the given evidence
+ * @return Confidence per ms (1 / effective confirmation time)
+ */
+float fire_detector_confidence_rate(const fire_detector_params_t *params,
+                                    float level, float rate, int corroborating);
+
+/**
+ * @brief Advance one sector
+ * @param sector Sector state
+ * @param params Detector tuning
+ * @param level Conditioned IR level in %
+ * @param rate IR rate of change in %/s
+ * @param corroborating Neighbours above threshold
+ * @param now_ms Current time in ms (wrap-safe)
+ * @return Transition caused by this update
+ */
+fire_detect_event_t fire_detector_update(fire_detector_sector_t *sector,
+                                         const fire_detector_params_t *params,
+                                         float level, float rate, int corroborating,
+                                         uint32_t now_ms);
+
+/**
+ * @brief Time until a validating sector confirms if its evidence holds
+ * @param sector Sector state
+ * @param params Detector tuning
+ * @param level Conditioned IR level in %
+ * @param rate IR rate of change in %/s
+ * @param corroborating Neighbours above threshold
+ * @param now_ms Current time in ms (wrap-safe)
+ * @return Milliseconds to the confirmation deadline (0 if already due),
+ *         or UINT32_MAX if the sector is not validating
+ */
+uint32_t fire_detector_ms_to_confirm(const fire_detector_sector_t *sector,
+                                     const fire_detector_params_t *params,
+                                     float level, float rate, int corroborating,
+                                     uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIRE_DETECTOR_H
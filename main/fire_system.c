@@ -1,32 +1,37 @@
 #include "fire_system.h"
+#include "adc_acquisition.h"
+#include "adc_calibration.h"
+#include "current_rms.h"
+#include "signal_conditioning.h"
+#include "fire_detector.h"
+#include "sensor_frame.h"
+#include "output_shadow.h"
+#include "input_events.h"
 #include "driver/gpio.h"
+#include "esp_timer.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <stdbool.h>
+#include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 #include <string.h>
 
 // ========================================
 // GLOBAL VARIABLE DEFINITIONS
 // ========================================
-#define DIODE_DROP 0.3f
-#define REVERSE_RATIO 12.11f
 
 // ADC Handles
 adc_oneshot_unit_handle_t adc1_handle = NULL;
 adc_cali_handle_t adc_cali_handle = NULL;
 
 // Hardware Constants
-const float VREF = 3.3;
-const int ADC_RES = 4095;
-const float BIAS_VOLTAGE = 1.65;
 const float R_SHUNT = 33.0;
 const float SCALE_RATIO = 0.0005;
-const unsigned long SAMPLE_WINDOW = 1000;
 
 // Pin Definitions
 const gpio_num_t CAMERA_ON_OFF = GPIO_NUM_32;
@@ -42,15 +47,16 @@ const gpio_num_t DOOR_SENSOR_PIN = GPIO_NUM_15;
 // Water Level Configuration
 uint8_t waterLevelChannels[4] = {1, 0, 2, 3};
 
-// Variable Definitions
-float adc_array1[8] = {0};
-float adc_array2[8] = {0};
-float waterLevels[4] = {0};
+// Acquisition working buffers in Q4 raw codes (sensor task only - consumers use SensorFrame)
+static uint32_t muxRawA[8] = {0};
+static uint32_t muxRawB[8] = {0};
+static uint32_t waterRaw[4] = {0};
 
-// Main Sensor Values
-float level_s = 0;
-float ir_s1 = 0, ir_s2 = 0, ir_s3 = 0, ir_s4 = 0;
-float sol_v = 0, bat_v = 0;
+// CT gain in amps per raw code, from the calibrated ADC slope
+static float ctAmpsPerCode = 0;
+
+// IR conditioning state per sector (sensor task only)
+static sigcond_channel_t irConditioning[4];
 
 // System State
 SystemProfile currentProfile = WILDLAND_STANDARD;
@@ -97,16 +103,23 @@ static unsigned long savedManualTimes[4] = {0};
 static unsigned long savedManualDurations[4] = {0};
 
 // Flame confirmation tracking
-static unsigned long flameStartTime[4] = {0, 0, 0, 0};
-static bool flameValidating[4] = {false, false, false, false};
+static fire_detector_sector_t flameDetectors[4];
 
 // Water stability tracking
 static float lastStableWaterLevel = 0;
 static unsigned long stableStartTime = 0;
 
+// Continuous feed history (last 6 readings = 1 minute)
+static float feedCheckLevels[6] = {0};
+static int feedCheckIndex = 0;
+
 // PCA9555 Device
 pca9555_t pca_dev;
 
+// Output port shadow; pumps are switched by committing the whole port
+static output_shadow_t pcaShadow;
+static const uint8_t pumpPcaPins[4] = {3, 2, 1, 0};    // North, South, East, West
+
 // ========================================
 // INITIALIZATION FUNCTIONS
 // ========================================
@@ -114,6 +127,9 @@ pca9555_t pca_dev;
 void initialize_arrays(void) {
     printf("[INIT] Initializing system arrays...\n");
     
+    // Outputs are assumed low until all_off() confirms it
+    output_shadow_init(&pcaShadow, 0x00, 0x00);
+    
     // Initialize Current Sensors
     currentSensors[0] = (CurrentSensor){"CT1", MUX_OUTPUT_PIN, true, 6, 0.0, 0.0, false, 0};
     currentSensors[1] = (CurrentSensor){"CT2", MUX_OUTPUT_PIN, true, 7, 0.0, 0.0, false, 0};
@@ -131,7 +147,9 @@ void initialize_arrays(void) {
         .maxRunCapFull = 15000,      // 3 minutes (Full system)
         .maxRunCapSector = 20000,    // 6 minutes (Sector)
         .name = "Wildland-Standard",
-        .cooldown = 30000
+        .cooldown = 30000,
+        .detectMode = FIRE_DETECT_PERSISTENCE,
+        .flameConfirmTime = FLAME_CONFIRMATION_TIME
     };
 
     // WILDLAND_HIGH_WIND - Section 10.2
@@ -141,7 +159,14 @@ void initialize_arrays(void) {
         .maxRunCapFull = 240000,      // 4 minutes (Full system)
         .maxRunCapSector = 480000,    // 8 minutes (Sector)
         .name = "Wildland-HighWind",
-        .cooldown = 30000
+        .cooldown = 30000,
+        .detectMode = FIRE_DETECT_FUSED,   // Wind-driven fronts rise fast across sectors
+        .flameConfirmTime = FLAME_CONFIRMATION_TIME,
+        .flameConfirmMinTime = 400,
+        .riseRateFull = 60.0,
+        .riseGain = 3.0,
+        .levelGain = 1.0,
+        .neighbourGain = 1.5
     };
 
     // INDUSTRIAL_HYDROCARBON - Section 10.3
@@ -151,7 +176,14 @@ void initialize_arrays(void) {
         .maxRunCapFull = 300000,      // 5 minutes (Full system)
         .maxRunCapSector = 600000,    // 10 minutes (Sector)
         .name = "Industrial-Hydrocarbon",
-        .cooldown = 30000
+        .cooldown = 30000,
+        .detectMode = FIRE_DETECT_FUSED,   // Hydrocarbon flash fires are near step inputs
+        .flameConfirmTime = FLAME_CONFIRMATION_TIME,
+        .flameConfirmMinTime = 300,
+        .riseRateFull = 80.0,
+        .riseGain = 4.0,
+        .levelGain = 1.5,
+        .neighbourGain = 1.5
     };
 
     // CRITICAL_ASSET - Section 10.4
@@ -161,7 +193,9 @@ void initialize_arrays(void) {
         .maxRunCapFull = 240000,      // 4 minutes (Full system)
         .maxRunCapSector = 480000,    // 8 minutes (Sector)
         .name = "Critical-Asset",
-        .cooldown = 30000
+        .cooldown = 30000,
+        .detectMode = FIRE_DETECT_PERSISTENCE,
+        .flameConfirmTime = FLAME_CONFIRMATION_TIME
     };
 
     // CONTINUOUS_FEED - Section 10.5
@@ -171,7 +205,9 @@ void initialize_arrays(void) {
         .maxRunCapFull = 0,           // NO LIMIT (caps lifted)
         .maxRunCapSector = 0,         // NO LIMIT (caps lifted)
         .name = "Continuous-Feed",
-        .cooldown = 0
+        .cooldown = 0,
+        .detectMode = FIRE_DETECT_PERSISTENCE,
+        .flameConfirmTime = FLAME_CONFIRMATION_TIME
     };
     
     
@@ -192,6 +228,7 @@ for (int i = 0; i < 4; i++) {
         .cooldownStartTime = 0,
         .cooldownDuration = 0,
         .currentIRValue = 0.0,
+        .currentIRRate = 0.0,
         .manualMode = false,
         .manualStartTime = 0,
         .manualDuration = 0,
@@ -232,6 +269,7 @@ void start_timer_protection(int index, unsigned long duration) {
     pumps[index].originalDuration = duration;
     pumps[index].timerDuration = duration;
     pumps[index].protectionTimeRemaining = duration;
+    pump_schedule_kick();
     
     printf("[TIMER] %s: Timer protection started for %lu seconds\n", 
            pumps[index].name, duration/1000);
@@ -359,9 +397,9 @@ void detect_continuous_feed(void) {
     
     lastContinuousFeedCheck = now;
     
-    float currentLevel = level_s;
-    static float feedCheckLevels[6] = {0};  // Track last 6 readings (1 minute)
-    static int feedCheckIndex = 0;
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    float currentLevel = frame.level;
     
     // Store current level
     feedCheckLevels[feedCheckIndex] = currentLevel;
@@ -395,6 +433,7 @@ void detect_continuous_feed(void) {
         if (continuousFeedConfidence <= 0) {
             continuousWaterFeed = false;
             printf("[FEED] Continuous feed LOST - MCRC restored\n");
+            pump_schedule_kick();
         }
     }
     
@@ -418,15 +457,20 @@ void pump_control(unsigned int pumpNum, bool state) {
 void all_off(void) {
     char log_msg[LOG_BUFFER_SIZE];
     
-    esp_err_t ret1 = pca9555_set_port0_output(&pca_dev, 0x00);
-    esp_err_t ret2 = pca9555_set_port1_output(&pca_dev, 0x00);
+    // Both ports in one burst write
+    esp_err_t ret = pca9555_set_outputs(&pca_dev, 0x00, 0x00);
     
-    if (ret1 == ESP_OK && ret2 == ESP_OK) {
-		
+    if (ret == ESP_OK) {
+		output_shadow_init(&pcaShadow, 0x00, 0x00);
 	} else {
-        snprintf(log_msg, LOG_BUFFER_SIZE, "[FIRE_SYSTEM] PCA9555 shutdown failed: Port0=%s, Port1=%s", 
-                esp_err_to_name(ret1), esp_err_to_name(ret2));
+        snprintf(log_msg, LOG_BUFFER_SIZE, "[FIRE_SYSTEM] PCA9555 shutdown failed: %s", 
+                esp_err_to_name(ret));
         printf("%s\n", log_msg);
+        
+        // Leave the pump port staged low so the control tick retries it
+        for (int i = 0; i < 4; i++) {
+            output_shadow_set(&pcaShadow, PUMP_PCA9555_PORT, pumpPcaPins[i], false);
+        }
     }
     
     for (int i = 0; i < 4; i++) {
@@ -455,6 +499,12 @@ void apply_system_profile(SystemProfile newProfile) {
            newConfig->maxRunCapFull, newConfig->maxRunCapFull/60000);
     printf("[FIRE_SYSTEM] - Max Run Cap Sector: %lu ms (%lu minutes)\n", 
            newConfig->maxRunCapSector, newConfig->maxRunCapSector/60000);
+    if (newConfig->detectMode == FIRE_DETECT_FUSED) {
+        printf("[FIRE_SYSTEM] - Flame Confirmation: fused, %lu-%lu ms\n", 
+               newConfig->flameConfirmMinTime, newConfig->flameConfirmTime);
+    } else {
+        printf("[FIRE_SYSTEM] - Flame Confirmation: %lu ms\n", newConfig->flameConfirmTime);
+    }
     
     if (oldProfile != newProfile) {
         if (newProfile == CONTINUOUS_FEED) {
@@ -480,10 +530,56 @@ void apply_system_profile(SystemProfile newProfile) {
         }
     }
     
+    // Run caps and no-flame timeouts may have moved
+    pump_schedule_kick();
+    
     printf("[FIRE_SYSTEM] Profile application COMPLETE\n");
     printf("[FIRE_SYSTEM] =====================================\n\n");
 }
 
+// Write the staged pump port in one transaction; pins are verified later
+static void commit_pump_outputs(void) {
+    if (!output_shadow_dirty(&pcaShadow, PUMP_PCA9555_PORT)) {
+        return;
+    }
+    
+    uint8_t previous = pcaShadow.committed[PUMP_PCA9555_PORT];
+    uint8_t value = pcaShadow.desired[PUMP_PCA9555_PORT];
+    esp_err_t ret = pca9555_set_port1_output(&pca_dev, value);
+    
+    // Either way the pump task has new deadlines (retry, read-back, run timers)
+    pump_schedule_kick();
+    
+    if (ret != ESP_OK) {
+        // Still dirty, so the next control tick retries
+        printf("[PUMP] CONTROL FAILED: Port 1 = 0x%02X - %s\n", value, esp_err_to_name(ret));
+        return;
+    }
+    output_shadow_committed(&pcaShadow, PUMP_PCA9555_PORT, value,
+                            xTaskGetTickCount() * portTICK_PERIOD_MS);
+    
+    int64_t relay_us = esp_timer_get_time();
+    for (int i = 0; i < 4; i++) {
+        uint8_t bit = 1 << pumpPcaPins[i];
+        if (((previous ^ value) & bit) == 0) {
+            continue;
+        }
+        bool on = (value & bit) != 0;
+        pumps[i].isRunning = on;
+        
+        // First energise after a confirmed flame closes the time-to-water trace
+        latency_trace_t* trace = &pumps[i].trace;
+        if (on && trace->confirm_us != 0 && trace->relay_us == 0) {
+            trace->relay_us = relay_us;
+            latency_trace_record(LATENCY_CONFIRM_TO_RELAY, trace->confirm_us, trace->relay_us);
+            latency_trace_record(LATENCY_SAMPLE_TO_RELAY, trace->sample_us, trace->relay_us);
+        }
+        
+        printf("[PUMP] SUCCESS: %s is %s (Port 1, Pin %d)\n",
+               pumps[i].name, on ? "ON" : "OFF", pumpPcaPins[i]);
+    }
+}
+
 void set_pump_hardware(int index, bool state) {
     if (index < 0 || index >= 4) {
         printf("[PUMP] ERROR: Invalid pump index %d\n", index);
@@ -497,53 +593,67 @@ void set_pump_hardware(int index, bool state) {
     
     printf("[PUMP] Setting %s to %s\n", pumps[index].name, state ? "ON" : "OFF");
     
-    uint8_t pca_pin;
-    switch(index) {
-        case 0: pca_pin = 3; break;  // North
-        case 1: pca_pin = 2; break;  // South
-        case 2: pca_pin = 1; break;  // East
-        case 3: pca_pin = 0; break;  // West
-        default: return;
+    output_shadow_set(&pcaShadow, PUMP_PCA9555_PORT, pumpPcaPins[index], state);
+    if (!output_shadow_batching(&pcaShadow)) {
+        commit_pump_outputs();
     }
+}
+
+/**
+ * Batch pump switching: set_pump_hardware() calls until the matching
+ * pump_outputs_end() are committed together in one port write.
+ */
+void pump_outputs_begin(void) {
+    output_shadow_begin(&pcaShadow);
+}
+
+void pump_outputs_end(void) {
+    if (output_shadow_end(&pcaShadow)) {
+        commit_pump_outputs();
+    }
+}
+
+/**
+ * Control tick: retry a failed commit and run the deferred read-back
+ */
+void pump_outputs_service(void) {
+    commit_pump_outputs();
     
-    esp_err_t ret = pca9555_set_pin_state(&pca_dev, 1, pca_pin, state);
-    
-    if (ret != ESP_OK) {
-        printf("[PUMP] CONTROL FAILED: %s - %s\n", pumps[index].name, esp_err_to_name(ret));
+    if (!output_shadow_verify_due(&pcaShadow, PUMP_PCA9555_PORT,
+                                  xTaskGetTickCount() * portTICK_PERIOD_MS)) {
         return;
     }
     
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
     uint8_t port_state;
-    ret = pca9555_read_port1_output(&pca_dev, &port_state);
+    esp_err_t ret = pca9555_read_port1_output(&pca_dev, &port_state);
+    if (ret != ESP_OK) {
+        // Drop this read-back; isRunning keeps the commanded state
+        printf("[PUMP] READBACK FAILED: Cannot read PCA9555 - %s\n", esp_err_to_name(ret));
+        output_shadow_verify(&pcaShadow, PUMP_PCA9555_PORT, pcaShadow.committed[PUMP_PCA9555_PORT]);
+        return;
+    }
     
-    if (ret == ESP_OK) {
-        bool actual_state = (port_state & (1 << pca_pin)) != 0;
-        pumps[index].isRunning = actual_state;
+    uint8_t commanded = pcaShadow.committed[PUMP_PCA9555_PORT];
+    uint8_t mismatch = output_shadow_verify(&pcaShadow, PUMP_PCA9555_PORT, port_state);
+    for (int i = 0; i < 4; i++) {
+        uint8_t bit = 1 << pumpPcaPins[i];
+        pumps[i].isRunning = (port_state & bit) != 0;
         
-        if (actual_state != state) {
+        if (mismatch & bit) {
             printf("[PUMP] VERIFICATION FAILED: %s commanded %s but PCA shows %s (Port 1, Pin %d)\n", 
-                   pumps[index].name, 
-                   state ? "ON" : "OFF",
-                   actual_state ? "ON" : "OFF",
-                   pca_pin);
+                   pumps[i].name, 
+                   (commanded & bit) ? "ON" : "OFF",
+                   (port_state & bit) ? "ON" : "OFF",
+                   pumpPcaPins[i]);
             
             // 🆕 SEND CRITICAL ALERT
-            send_alert_hardware_control_fail(index, "HW_VERIFY_FAIL");
-                   
-            printf("[PUMP] Attempting recovery...\n");
-            pca9555_set_pin_state(&pca_dev, 1, pca_pin, state);
-            vTaskDelay(pdMS_TO_TICKS(50));
-        } else {
-            printf("[PUMP] SUCCESS: %s is %s (Port 1, Pin %d)\n", 
-                   pumps[index].name, 
-                   state ? "ON" : "OFF",
-                   pca_pin);
+            send_alert_hardware_control_fail(i, "HW_VERIFY_FAIL");
         }
-    } else {
-        printf("[PUMP] READBACK FAILED: Cannot read PCA9555 - %s\n", esp_err_to_name(ret));
-        pumps[index].isRunning = state;
+    }
+    
+    if (mismatch) {
+        printf("[PUMP] Attempting recovery...\n");
+        commit_pump_outputs();
     }
 }
 
@@ -590,6 +700,7 @@ void emergency_stop_all_pumps(StopReason reason) {
     // ✅ FORCE STOP ALL PUMPS - Including timer-protected ones
     printf("[EMERGENCY] Stopping ALL pumps (including timer-protected)\n");
     
+    pump_outputs_begin();
     for (int i = 0; i < 4; i++) {
         if (pumps[i].state != PUMP_OFF && pumps[i].state != PUMP_DISABLED) {
             
@@ -607,6 +718,7 @@ void emergency_stop_all_pumps(StopReason reason) {
             deactivate_pump(i, reason_str);
         }
     }
+    pump_outputs_end();
     
     emergencyStopActive = true;
     
@@ -703,6 +815,9 @@ void restore_pumps_after_emergency(void) {
         }
     }
     
+    // Deadlines were frozen during the stop
+    pump_schedule_kick();
+    
     printf("[EMERGENCY] ===============================================\n");
 }
 
@@ -754,27 +869,9 @@ void process_shadow_emergency_stop(bool stopCommand) {
 // CURRENT SENSOR FUNCTIONS
 // ========================================
 
-void init_current_sensors(void) {
+static esp_err_t init_oneshot_adc(void) {
     char log_msg[LOG_BUFFER_SIZE];
     
-    gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << SENSOR1_PIN) | (1ULL << SENSOR2_PIN),
-        .mode = GPIO_MODE_INPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE
-    };
-    gpio_config(&io_conf);
-    
-    gpio_config_t mux_conf = {
-        .pin_bit_mask = (1ULL << s0) | (1ULL << s1) | (1ULL << s2),
-        .mode = GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE
-    };
-    gpio_config(&mux_conf);
-    
     adc_oneshot_unit_init_cfg_t init_config = {
         .unit_id = ADC_UNIT_1,
         .clk_src = ADC_RTC_CLK_SRC_DEFAULT,
@@ -785,7 +882,7 @@ void init_current_sensors(void) {
     if (ret != ESP_OK) {
         snprintf(log_msg, LOG_BUFFER_SIZE, "[FIRE_SYSTEM] ADC unit init failed: %s", esp_err_to_name(ret));
         printf("%s\n", log_msg);
-        return;
+        return ret;
     }
     
     adc_oneshot_chan_cfg_t channel_config = {
@@ -817,6 +914,51 @@ void init_current_sensors(void) {
         printf("%s\n", log_msg);
     }
     
+    return ESP_OK;
+}
+
+static int cali_raw_to_mv(void* ctx, int raw, int* mv) {
+    return adc_cali_raw_to_voltage((adc_cali_handle_t)ctx, raw, mv) == ESP_OK ? 0 : -1;
+}
+
+void init_current_sensors(void) {
+    char log_msg[LOG_BUFFER_SIZE];
+    
+    for (int i = 0; i < 4; i++) {
+        sigcond_init(&irConditioning[i], NULL);
+    }
+    
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << SENSOR1_PIN) | (1ULL << SENSOR2_PIN),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE
+    };
+    gpio_config(&io_conf);
+    
+    gpio_config_t mux_conf = {
+        .pin_bit_mask = (1ULL << s0) | (1ULL << s1) | (1ULL << s2),
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE
+    };
+    gpio_config(&mux_conf);
+    
+    // Prefer DMA acquisition; the oneshot driver cannot share ADC1 with it
+    esp_err_t ret = adc_acquisition_init(s0, s1, s2);
+    if (ret != ESP_OK) {
+        if (ret != ESP_ERR_NOT_SUPPORTED) {
+            snprintf(log_msg, LOG_BUFFER_SIZE, "[FIRE_SYSTEM] DMA acquisition failed (%s), using oneshot ADC", esp_err_to_name(ret));
+            printf("%s\n", log_msg);
+        }
+        ret = init_oneshot_adc();
+        if (ret != ESP_OK) {
+            return;
+        }
+    }
+    
     if (adc_cali_handle) {
         adc_cali_delete_scheme_line_fitting(adc_cali_handle);
         adc_cali_handle = NULL;
@@ -835,11 +977,23 @@ void init_current_sensors(void) {
         adc_cali_handle = NULL;
     } 
     
+    // Sample the eFuse curve once into integer conversion tables for the sensor path
+    bool calibrated = adc_calibration_build(adc_cali_handle ? cali_raw_to_mv : NULL, adc_cali_handle);
+    printf("[FIRE_SYSTEM] ADC conversion tables built (%s)\n",
+           calibrated ? "eFuse calibration" : "nominal VREF");
+    
+    // The bias cancels out of the RMS, so only the slope matters
+    int32_t span_mv = adc_calibration_convert(ADC_CAL_MILLIVOLTS, ADC_CAL_RAW_MAX << ADC_CAL_RAW_FRAC_BITS)
+                    - adc_calibration_convert(ADC_CAL_MILLIVOLTS, 0);
+    ctAmpsPerCode = (span_mv / 1000.0f / ADC_CAL_RAW_MAX) / R_SHUNT / SCALE_RATIO;
+    
     for (int i = 0; i < 4; i++) {
         currentSensors[i].currentValue = 0.0;
         currentSensors[i].averageValue = 0.0;
         currentSensors[i].fault = false;
         currentSensors[i].lastReadTime = 0;
+        currentSensors[i].peakValue = 0.0;
+        currentSensors[i].crestFactor = 0.0;
     }
     
 }
@@ -851,53 +1005,66 @@ void set_mux_channel(int channel) {
     vTaskDelay(pdMS_TO_TICKS(10));
 }
 
-float measure_current(int adc_channel) {
-    TickType_t startTime = xTaskGetTickCount();
-    uint32_t maxValue = 0;
-    uint32_t minValue = ADC_RES;
+static void record_current_sample(CurrentSensor* sensor, const current_rms_t* result);
 
-    while ((xTaskGetTickCount() - startTime) * portTICK_PERIOD_MS < SAMPLE_WINDOW) {
-        int adcVal = 0;
-        
-        esp_err_t ret = adc_oneshot_read(adc1_handle, adc_channel, &adcVal);
-        if (ret != ESP_OK) {
-            printf("[CURRENT] ADC read error: %s\n", esp_err_to_name(ret));
-            adcVal = 0;
+static adc_channel_t current_sensor_channel(const CurrentSensor* sensor) {
+    if (sensor->pin == GPIO_NUM_34) 
+        return ADC_CHANNEL_6;
+    else if (sensor->pin == GPIO_NUM_35) 
+        return ADC_CHANNEL_7;
+    else 
+        return ADC_CHANNEL_3;
+}
+
+// Oneshot fallback: sample up to four channels round-robin for one RMS window
+static void capture_current_block(const adc_channel_t* channels, current_rms_acc_t** accs, int count) {
+    uint32_t loops = 0;
+    int errors = 0;
+    
+    // Whole mains cycles with a tick's sleep between them: every phase is
+    // still covered, and lower-priority tasks on this core get to run
+    for (int cycle = 0; cycle < CURRENT_RMS_WINDOW_MS / CURRENT_RMS_CYCLE_MS; cycle++) {
+        if (cycle > 0) {
+            vTaskDelay(1);
+        }
+        int64_t start = esp_timer_get_time();
+        while (esp_timer_get_time() - start < CURRENT_RMS_CYCLE_MS * 1000LL) {
+            for (int c = 0; c < count; c++) {
+                int adcVal = 0;
+                if (adc_oneshot_read(adc1_handle, channels[c], &adcVal) != ESP_OK) {
+                    errors++;
+                    continue;
+                }
+                current_rms_add(accs[c], (uint16_t)adcVal);
+            }
+            // Let equal-priority tasks run without giving up a whole tick
+            if ((++loops & 0x1F) == 0) {
+                taskYIELD();
+            }
         }
-        
-        if (adcVal > maxValue) maxValue = adcVal;
-        if (adcVal < minValue) minValue = adcVal;
-        vTaskDelay(pdMS_TO_TICKS(1));
     }
+    
+    if (errors > 0) {
+        printf("[CURRENT] %d ADC read errors in capture window\n", errors);
+    }
+}
 
-    float Vmax = (maxValue * VREF) / ADC_RES - BIAS_VOLTAGE;
-    float Vmin = (minValue * VREF) / ADC_RES - BIAS_VOLTAGE;
-    float Vpp = Vmax - Vmin;
-    float Vpeak = Vpp / 2.0;
-    float Vrms = Vpeak * 0.7071;
-    float I_mapped = Vrms / R_SHUNT;
-    float I_load = I_mapped / SCALE_RATIO;
-
-    return I_load;
+float measure_current(int adc_channel) {
+    adc_channel_t channel = (adc_channel_t)adc_channel;
+    current_rms_acc_t acc;
+    current_rms_acc_t* accs[1] = {&acc};
+    current_rms_t result;
+    
+    current_rms_reset(&acc);
+    capture_current_block(&channel, accs, 1);
+    current_rms_compute(&acc, ctAmpsPerCode, &result);
+    return result.rms;
 }
 
 float read_current_sensor(int index) {
     CurrentSensor* sensor = &currentSensors[index];
     char log_msg[LOG_BUFFER_SIZE];
     
-    if (sensor->isMux) {
-        set_mux_channel(sensor->muxChannel);
-        vTaskDelay(pdMS_TO_TICKS(5));
-    }
-    
-    int adc_channel;
-    if (sensor->pin == GPIO_NUM_34) 
-        adc_channel = ADC_CHANNEL_6;
-    else if (sensor->pin == GPIO_NUM_35) 
-        adc_channel = ADC_CHANNEL_7;
-    else 
-        adc_channel = ADC_CHANNEL_3;
-    
     if (adc1_handle == NULL) {
         snprintf(log_msg, LOG_BUFFER_SIZE, "[FIRE_SYSTEM] ERROR: ADC not initialized for sensor %s", sensor->name);
         printf("%s\n", log_msg);
@@ -905,19 +1072,60 @@ float read_current_sensor(int index) {
         return 0.0;
     }
     
-    float current = measure_current(adc_channel);
+    if (sensor->isMux) {
+        set_mux_channel(sensor->muxChannel);
+    }
     
+    adc_channel_t channel = current_sensor_channel(sensor);
+    current_rms_acc_t acc;
+    current_rms_acc_t* accs[1] = {&acc};
+    current_rms_t result;
+    
+    current_rms_reset(&acc);
+    capture_current_block(&channel, accs, 1);
+    if (current_rms_compute(&acc, ctAmpsPerCode, &result)) {
+        record_current_sample(sensor, &result);
+    }
+    return result.rms;
+}
+
+static void record_current_sample(CurrentSensor* sensor, const current_rms_t* result) {
     if (sensor->averageValue == 0.0) {
-        sensor->averageValue = current;
+        sensor->averageValue = result->rms;
     } else {
-        sensor->averageValue = 0.9 * sensor->averageValue + 0.1 * current;
+        sensor->averageValue = 0.9 * sensor->averageValue + 0.1 * result->rms;
     }
     
-    sensor->currentValue = current;
+    sensor->currentValue = result->rms;
+    sensor->peakValue = result->peak;
+    sensor->crestFactor = result->crest;
     sensor->lastReadTime = xTaskGetTickCount() * portTICK_PERIOD_MS;
-    return current;
 }
 
+// CT1/CT2 come from mux B slots 6/7, CT3/CT4 are sampled for the whole sweep
+static void read_all_current_sensors_from_sweep(const adc_sweep_t* sweep) {
+    for (int i = 0; i < 4; i++) {
+        CurrentSensor* sensor = &currentSensors[i];
+        const adc_acq_stats_t* stats = sensor->isMux
+            ? &sweep->mux[sensor->muxChannel][ADC_ACQ_INPUT_MUX_B]
+            : &sweep->direct[i - 2];
+        current_rms_acc_t acc = {
+            .count = stats->count,
+            .sum = stats->sum,
+            .sumsq = stats->sumsq,
+            .min = stats->min,
+            .max = stats->max,
+        };
+        current_rms_t result;
+        
+        if (current_rms_compute(&acc, ctAmpsPerCode, &result)) {
+            record_current_sample(sensor, &result);
+        }
+    }
+}
+
+// Oneshot fallback: one window per mux sensor, with the direct sensors
+// sampled alongside in every window, instead of a window per sensor
 void read_all_current_sensors(void) {
     static unsigned long lastReadTime = 0;
     unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
@@ -927,9 +1135,42 @@ void read_all_current_sensors(void) {
     }
     lastReadTime = now;
     
+    if (adc1_handle == NULL) {
+        printf("[FIRE_SYSTEM] ERROR: ADC not initialized for current sensors\n");
+        for (int i = 0; i < 4; i++) {
+            currentSensors[i].fault = true;
+        }
+        return;
+    }
+    
+    current_rms_acc_t accs[4];
     for (int i = 0; i < 4; i++) {
-        read_current_sensor(i);
-        vTaskDelay(pdMS_TO_TICKS(2));
+        current_rms_reset(&accs[i]);
+    }
+    
+    for (int window = 0; window < 4; window++) {
+        if (!currentSensors[window].isMux) {
+            continue;
+        }
+        set_mux_channel(currentSensors[window].muxChannel);
+        
+        adc_channel_t channels[4];
+        current_rms_acc_t* targets[4];
+        int count = 0;
+        for (int i = 0; i < 4; i++) {
+            if (i == window || !currentSensors[i].isMux) {
+                channels[count] = current_sensor_channel(&currentSensors[i]);
+                targets[count++] = &accs[i];
+            }
+        }
+        capture_current_block(channels, targets, count);
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        current_rms_t result;
+        if (current_rms_compute(&accs[i], ctAmpsPerCode, &result)) {
+            record_current_sample(&currentSensors[i], &result);
+        }
     }
 }
 
@@ -953,7 +1194,7 @@ void check_current_sensor_faults(void) {
             sensor->fault = true;
         }
         
-        if (adc1_handle == NULL) {
+        if (adc1_handle == NULL && !adc_acquisition_is_running()) {
             sensor->fault = true;
         }
         
@@ -978,23 +1219,57 @@ void check_current_sensor_faults(void) {
 // COMPLETE SENSOR DATA ACQUISITION
 // ========================================
 
-void get_sensor_data(void) {
-   
+// DMA path: one completed mux sweep replaces the whole polling loop
+static bool acquire_sweep_data(int64_t* timestamp_us) {
+    static adc_sweep_t sweep;
+    static uint32_t lastDropped = 0;
+    
+    esp_err_t ret = adc_acquisition_wait_sweep(&sweep, ADC_ACQ_SWEEP_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        printf("[SENSOR] ERROR: No ADC sweep received: %s\n", esp_err_to_name(ret));
+        return false;
+    }
+    
+    if (sweep.dropped != lastDropped) {
+        printf("[SENSOR] WARNING: %lu ADC sweeps dropped (consumer too slow)\n",
+               (unsigned long)(sweep.dropped - lastDropped));
+        lastDropped = sweep.dropped;
+    }
+    *timestamp_us = sweep.timestamp_us;
+    
+    for (int channel = 0; channel < 8; channel++) {
+        const adc_acq_stats_t* a = &sweep.mux[channel][ADC_ACQ_INPUT_MUX_A];
+        const adc_acq_stats_t* b = &sweep.mux[channel][ADC_ACQ_INPUT_MUX_B];
+        muxRawA[channel] = adc_calibration_mean_q4(a->sum, a->count);
+        muxRawB[channel] = (channel < 6) ? adc_calibration_mean_q4(b->sum, b->count) : 0;
+    }
+    
+    read_all_current_sensors_from_sweep(&sweep);
+    
+    for (int i = 0; i < 4; i++) {
+        waterRaw[i] = muxRawA[waterLevelChannels[i]];
+    }
+    return true;
+}
+
+// Oneshot fallback: polls every mux channel with adc_oneshot_read
+static bool acquire_oneshot_data(int64_t* timestamp_us) {
     if (adc1_handle == NULL) {
         printf("[SENSOR] ERROR: ADC not initialized\n");
-        return;
+        return false;
     }
+    *timestamp_us = esp_timer_get_time();
     
     for (int i = 0; i < 8; i++) {
-        adc_array1[i] = 0;
-        adc_array2[i] = 0;
+        muxRawA[i] = 0;
+        muxRawB[i] = 0;
     }
 
     for (uint8_t channel = 0; channel < 8; channel++) {
         set_mux_channel(channel);
         vTaskDelay(pdMS_TO_TICKS(5));
 
-        float sum1 = 0, sum2 = 0;
+        uint32_t sum1 = 0, sum2 = 0;
         const int samples = 10;
 
         for (int i = 0; i < samples; i++) {
@@ -1017,21 +1292,9 @@ void get_sensor_data(void) {
             vTaskDelay(pdMS_TO_TICKS(1));
         }
 
-        if (adc_cali_handle) {
-            int voltage_mv1 = 0, voltage_mv2 = 0;
-            
-            adc_cali_raw_to_voltage(adc_cali_handle, (int)(sum1 / samples), &voltage_mv1);
-            adc_array1[channel] = voltage_mv1 / 1000.0;
-            
-            if (channel < 6) {
-                adc_cali_raw_to_voltage(adc_cali_handle, (int)(sum2 / samples), &voltage_mv2);
-                adc_array2[channel] = voltage_mv2 / 1000.0;
-            }
-        } else {
-            adc_array1[channel] = (sum1 / samples) * (VREF / ADC_RES);
-            if (channel < 6)
-                adc_array2[channel] = (sum2 / samples) * (VREF / ADC_RES);
-        }
+        muxRawA[channel] = adc_calibration_mean_q4(sum1, samples);
+        if (channel < 6)
+            muxRawB[channel] = adc_calibration_mean_q4(sum2, samples);
     }
 
     read_all_current_sensors();
@@ -1040,7 +1303,7 @@ void get_sensor_data(void) {
         set_mux_channel(waterLevelChannels[i]);
         vTaskDelay(pdMS_TO_TICKS(5));
 
-        float sum = 0;
+        uint32_t sum = 0;
         const int samples = 10;
 
         for (int j = 0; j < samples; j++) {
@@ -1055,40 +1318,78 @@ void get_sensor_data(void) {
             vTaskDelay(pdMS_TO_TICKS(1));
         }
 
-        float voltage = 0;
-        if (adc_cali_handle) {
-            int voltage_mv = 0;
-            adc_cali_raw_to_voltage(adc_cali_handle, (int)(sum / samples), &voltage_mv);
-            voltage = voltage_mv / 1000.0;
-        } else {
-            voltage = (sum / samples) * (VREF / ADC_RES);
-        }
-
-        float levelPercent = (voltage - 0.7) / (3.0 - 0.7) * 100.0;
-        levelPercent = levelPercent < 0.0 ? 0.0 : (levelPercent > 100.0 ? 100.0 : levelPercent);
+        waterRaw[i] = adc_calibration_mean_q4(sum, samples);
+    }
+    return true;
+}
 
-        waterLevels[i] = levelPercent;
+void get_sensor_data(void) {
+    static SensorFrame frame;
+    
+    bool acquired = adc_acquisition_is_running() ? acquire_sweep_data(&frame.timestamp_us)
+                                                 : acquire_oneshot_data(&frame.timestamp_us);
+    if (!acquired) {
+        return;
     }
 
-    level_s = (waterLevels[0] + waterLevels[1] + waterLevels[2] + waterLevels[3]) / 4.0;
+    // Integer table conversions; floats only appear once per published value
+    int32_t levelSum = 0;
+    for (int i = 0; i < 4; i++) {
+        int32_t level = adc_calibration_convert(ADC_CAL_WATER_CENTIPCT, waterRaw[i]);
+        levelSum += level;
+        frame.waterLevels[i] = level / 100.0f;
+    }
+    frame.level = levelSum / 400.0f;
 
-    ir_s1 = (adc_array1[4] / 3.3) * 100.0;
-    ir_s2 = (adc_array1[5] / 3.3) * 100.0;
-    ir_s3 = (adc_array1[6] / 3.3) * 100.0;
-    ir_s4 = (adc_array1[7] / 3.3) * 100.0;
+    // Despike, smooth and differentiate IR before anything thresholds it
+    for (int i = 0; i < 4; i++) {
+        sigcond_output_t conditioned;
+        frame.irRaw[i] = adc_calibration_convert(ADC_CAL_IR_CENTIPCT, muxRawA[4 + i]) / 100.0f;
+        sigcond_update(&irConditioning[i], frame.irRaw[i], frame.timestamp_us, &conditioned);
+        frame.ir[i] = conditioned.value;
+        frame.irRate[i] = conditioned.rate;
+    }
 
-    sol_v = (adc_array2[0] * REVERSE_RATIO) + DIODE_DROP;
-    bat_v = (adc_array2[1] * REVERSE_RATIO) + DIODE_DROP;
+    frame.solarVoltage = adc_calibration_convert(ADC_CAL_PACK_MILLIVOLTS, muxRawB[0]) / 1000.0f;
+    frame.batteryVoltage = adc_calibration_convert(ADC_CAL_PACK_MILLIVOLTS, muxRawB[1]) / 1000.0f;
 
     check_current_sensor_faults();
 
-    pumps[0].currentIRValue = ir_s1;
-    pumps[1].currentIRValue = ir_s2;
-    pumps[2].currentIRValue = ir_s3;
-    pumps[3].currentIRValue = ir_s4;
+    for (int i = 0; i < 4; i++) {
+        frame.current[i] = currentSensors[i].currentValue;
+        frame.currentPeak[i] = currentSensors[i].peakValue;
+        frame.currentCrest[i] = currentSensors[i].crestFactor;
+        frame.currentFault[i] = currentSensors[i].fault;
+    }
+    for (int channel = 0; channel < 8; channel++) {
+        frame.adc1[channel] = adc_calibration_convert(ADC_CAL_MILLIVOLTS, muxRawA[channel]) / 1000.0f;
+        frame.adc2[channel] = (channel < 6)
+            ? adc_calibration_convert(ADC_CAL_MILLIVOLTS, muxRawB[channel]) / 1000.0f
+            : 0;
+    }
 
-    check_water_lockout();
-    detect_continuous_feed();  // Added continuous feed detection
+    // Water lockout, continuous feed and pump IR values are evaluated by
+    // their own tasks from the published frame, under the pump/water locks
+    sensor_frame_publish(&frame);
+}
+
+void update_pump_ir_values(const SensorFrame* frame) {
+    bool manualSeesFire = false;
+    for (int i = 0; i < 4; i++) {
+        pumps[i].currentIRValue = frame->ir[i];
+        pumps[i].currentIRRate = frame->irRate[i];
+        pumps[i].irSampleUs = frame->timestamp_us;
+        
+        if (pumps[i].timerProtected && pumps[i].state == PUMP_MANUAL_ACTIVE &&
+            pumps[i].currentIRValue > 80.0) {
+            manualSeesFire = true;
+        }
+    }
+    
+    // Protected manual pump sees fire: update_pump_states() hands it to AUTO
+    if (manualSeesFire) {
+        pump_schedule_kick();
+    }
 }
 
 // ========================================
@@ -1098,11 +1399,14 @@ void get_sensor_data(void) {
 void check_water_lockout(void) {
     char log_msg[LOG_BUFFER_SIZE];
     unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    const float level = frame.level;
 
     // ========================================
     // SECTION 4.1: LOW WATER DETECTION
     // ========================================
-    if (level_s < LOW_LEVEL_THRESHOLD) {
+    if (level < LOW_LEVEL_THRESHOLD) {
         
         // ========================================
         // SECTION 4.3: CONTINUOUS FEED GRACE PERIOD
@@ -1110,10 +1414,10 @@ void check_water_lockout(void) {
         if (continuousWaterFeed && !waterLockout && !inGracePeriod) {
             inGracePeriod = true;
             gracePeriodStartTime = now;
-            gracePeriodWaterLevel = level_s;
+            gracePeriodWaterLevel = level;
             snprintf(log_msg, LOG_BUFFER_SIZE, 
                     "[WATER] Low water (%.1f%%) - Starting 20s grace period for continuous feed",
-                    level_s);
+                    level);
             printf("%s\n", log_msg);
             return;
         }
@@ -1123,10 +1427,10 @@ void check_water_lockout(void) {
         // ========================================
         if (inGracePeriod) {
             // Check if water is recovering during grace period
-            if (level_s > gracePeriodWaterLevel + 5.0) {
+            if (level > gracePeriodWaterLevel + 5.0) {
                 printf("[WATER] Water recovering during grace period: %.1f%% -> %.1f%%\n",
-                       gracePeriodWaterLevel, level_s);
-                gracePeriodWaterLevel = level_s;
+                       gracePeriodWaterLevel, level);
+                gracePeriodWaterLevel = level;
                 gracePeriodStartTime = now;
             }
             
@@ -1163,7 +1467,7 @@ void check_water_lockout(void) {
         if (!continuousWaterFeed && !waterLockout) {
             waterLockout = true;
             snprintf(log_msg, LOG_BUFFER_SIZE, 
-                    "[WATER] WATER LOCKOUT ACTIVATED - Level: %.1f%%", level_s);
+                    "[WATER] WATER LOCKOUT ACTIVATED - Level: %.1f%%", level);
             printf("%s\n", log_msg);
             
             // ✅ FORCE STOP ALL PUMPS
@@ -1192,35 +1496,35 @@ void check_water_lockout(void) {
     // ========================================
     // SECTION 4.2: WATER RECOVERY ABOVE AUTO RESUME
     // ========================================
-    else if (level_s > AUTO_RESUME_LEVEL) {
+    else if (level > AUTO_RESUME_LEVEL) {
         inGracePeriod = false;
 
         if (waterLockout) {
             // ========================================
             // SECTION 4.2: 5-SECOND STABILITY CHECK
             // ========================================
-            if (fabs(level_s - lastStableWaterLevel) < 2.0) {
+            if (fabs(level - lastStableWaterLevel) < 2.0) {
                 if (stableStartTime == 0) {
                     stableStartTime = now;
                     snprintf(log_msg, LOG_BUFFER_SIZE, 
                             "[WATER] Water stable at %.1f%%, starting 5s stability check", 
-                            level_s);
+                            level);
                     printf("%s\n", log_msg);
                 } else if (now - stableStartTime >= 5000) {
                     waterLockout = false;
                     stableStartTime = 0;
                     snprintf(log_msg, LOG_BUFFER_SIZE, 
                             "[WATER] Water stable for 5s, LOCKOUT RELEASED - Level: %.1f%%", 
-                            level_s);
+                            level);
                     printf("%s\n", log_msg);
                     on_water_lockout_released();
                 }
             } else {
                 stableStartTime = 0;
-                lastStableWaterLevel = level_s;
+                lastStableWaterLevel = level;
                 snprintf(log_msg, LOG_BUFFER_SIZE, 
                         "[WATER] Water unstable: %.1f%% -> %.1f%%, resetting stability timer",
-                        lastStableWaterLevel, level_s);
+                        lastStableWaterLevel, level);
                 printf("%s\n", log_msg);
             }
         }
@@ -1236,12 +1540,63 @@ void check_water_lockout(void) {
 // CORRECTED AUTOMATIC FIRE DETECTION
 // ========================================
 
+static void profile_detector_params(const ProfileConfig* profile, fire_detector_params_t* params) {
+    params->mode = profile->detectMode;
+    params->threshold = FIRE_THRESHOLD;
+    params->confirm_ms = profile->flameConfirmTime;
+    params->min_confirm_ms = profile->flameConfirmMinTime;
+    params->rise_full_rate = profile->riseRateFull;
+    params->rise_gain = profile->riseGain;
+    params->level_gain = profile->levelGain;
+    params->neighbour_gain = profile->neighbourGain;
+}
+
+unsigned long fire_detection_next_deadline_ms(void) {
+    if (!systemArmed) {
+        return ULONG_MAX;
+    }
+    
+    unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    fire_detector_params_t detector;
+    profile_detector_params(&profiles[currentProfile], &detector);
+    
+    float irLevels[4];
+    for (int i = 0; i < 4; i++) {
+        irLevels[i] = pumps[i].currentIRValue;
+    }
+    
+    // Same sectors check_automatic_activation() would evaluate
+    uint32_t earliest = UINT32_MAX;
+    for (int i = 0; i < 4; i++) {
+        if (pumps[i].sensorFault ||
+            pumps[i].state == PUMP_MANUAL_ACTIVE || pumps[i].state == PUMP_COOLDOWN) {
+            continue;
+        }
+        int corroborating = fire_detector_corroboration(irLevels, i, FIRE_THRESHOLD);
+        uint32_t remaining = fire_detector_ms_to_confirm(&flameDetectors[i], &detector,
+                                                         pumps[i].currentIRValue, pumps[i].currentIRRate,
+                                                         corroborating, now);
+        if (remaining < earliest) {
+            earliest = remaining;
+        }
+    }
+    return earliest == UINT32_MAX ? ULONG_MAX : earliest;
+}
+
 void check_automatic_activation(void) {
     char log_msg[LOG_BUFFER_SIZE];
     if (waterLockout || !systemArmed) return;
 
     unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
     
+    fire_detector_params_t detector;
+    profile_detector_params(&profiles[currentProfile], &detector);
+    
+    float irLevels[4];
+    for (int i = 0; i < 4; i++) {
+        irLevels[i] = pumps[i].currentIRValue;
+    }
+    
     // First, check each sensor for flame confirmation
     for (int i = 0; i < 4; i++) {
         if (pumps[i].sensorFault) {
@@ -1255,41 +1610,45 @@ void check_automatic_activation(void) {
         bool flameDetected = pumps[i].currentIRValue > FIRE_THRESHOLD;
 
         // ========================================
-        // SECTION 2(A): 2-SECOND FLAME CONFIRMATION
+        // SECTION 2(A): FLAME CONFIRMATION
         // ========================================
+        int corroborating = fire_detector_corroboration(irLevels, i, FIRE_THRESHOLD);
+        fire_detect_event_t event = fire_detector_update(&flameDetectors[i], &detector,
+                                                         pumps[i].currentIRValue, pumps[i].currentIRRate,
+                                                         corroborating, now);
+        if (event == FIRE_DETECT_EVENT_STARTED) {
+            // Response latency is measured from the frame that crossed threshold
+            pumps[i].trace = (latency_trace_t){ .sample_us = pumps[i].irSampleUs };
+            snprintf(log_msg, LOG_BUFFER_SIZE, 
+                    "[FIRE] %s: Flame detected (%.1f%%, %+.0f%%/s) - Starting confirmation",
+                    pumps[i].name, pumps[i].currentIRValue, pumps[i].currentIRRate);
+            printf("%s\n", log_msg);
+        } else if (event == FIRE_DETECT_EVENT_LOST) {
+            pumps[i].trace = (latency_trace_t){0};
+            snprintf(log_msg, LOG_BUFFER_SIZE, 
+                    "[FIRE] %s: Flame lost before confirmation", 
+                    pumps[i].name);
+            printf("%s\n", log_msg);
+        }
+
         if (flameDetected) {
             pumps[i].lastFlameSeenTime = now;
             
-            if (!flameValidating[i]) {
-                // First detection - start 2-second timer
-                flameStartTime[i] = now;
-                flameValidating[i] = true;
+            if (flameDetectors[i].confirmed && !pumps[i].flameConfirmed) {
+                pumps[i].flameConfirmed = true;
+                pumps[i].flameFirstDetectedTime = now;
+                pumps[i].trace.confirm_us = esp_timer_get_time();
+                latency_trace_record(LATENCY_SAMPLE_TO_CONFIRM,
+                                     pumps[i].trace.sample_us, pumps[i].trace.confirm_us);
                 snprintf(log_msg, LOG_BUFFER_SIZE, 
-                        "[FIRE] %s: Flame detected (%.1f%%) - Starting 2s confirmation",
-                        pumps[i].name, pumps[i].currentIRValue);
+                        "[FIRE] %s: FLAME CONFIRMED after %lu ms (%d neighbour%s)",
+                        pumps[i].name, (unsigned long)(now - flameDetectors[i].start_ms),
+                        corroborating, corroborating == 1 ? "" : "s");
                 printf("%s\n", log_msg);
-            } 
-            else if (now - flameStartTime[i] >= 2000) {  // 2 seconds confirmed
-                if (!pumps[i].flameConfirmed) {
-                    pumps[i].flameConfirmed = true;
-                    pumps[i].flameFirstDetectedTime = now;
-                    snprintf(log_msg, LOG_BUFFER_SIZE, 
-                            "[FIRE] %s: FLAME CONFIRMED (persisted 2+ seconds)",
-                            pumps[i].name);
-                    printf("%s\n", log_msg);
-                    on_flame_confirmed(i);
-                }
+                on_flame_confirmed(i);
             }
         } 
         else {
-            // Flame lost
-            if (flameValidating[i]) {
-                snprintf(log_msg, LOG_BUFFER_SIZE, 
-                        "[FIRE] %s: Flame lost before confirmation (< 2s)", 
-                        pumps[i].name);
-                printf("%s\n", log_msg);
-                flameValidating[i] = false;
-            }
             pumps[i].flameConfirmed = false;
             pumps[i].flameFirstDetectedTime = 0;
         }
@@ -1341,10 +1700,89 @@ void check_automatic_activation(void) {
 // CORRECTED PUMP STATE MANAGEMENT
 // ========================================
 
+// Auto pumps stop after this long without a flame
+static unsigned long no_flame_timeout(void) {
+    return currentProfile == WILDLAND_HIGH_WIND ? 45000 : 60000;
+}
+
+// Run cap for the current activation, 0 = unlimited
+static unsigned long max_run_cap(void) {
+    if (continuousWaterFeed) {
+        return 0; // No limit in continuous feed mode
+    }
+    ProfileConfig* profile = &profiles[currentProfile];
+    return profile->autoModeFull ? profile->maxRunCapFull : profile->maxRunCapSector;
+}
+
+// ========================================
+// PUMP DEADLINE SCHEDULING
+// ========================================
+
+static void earliest_deadline(unsigned long* best, unsigned long now, unsigned long due) {
+    long remaining = (long)(due - now);
+    if (remaining < 0) {
+        remaining = 0;
+    }
+    if ((unsigned long)remaining < *best) {
+        *best = (unsigned long)remaining;
+    }
+}
+
+/**
+ * @brief Time until update_pump_states() next has something to do
+ *
+ * Mirrors the checks in update_pump_states(): cooldown end, timer
+ * protection end, legacy manual timeout, no-flame timeout and run cap,
+ * plus the relay retry and read-back.
+ * @return Milliseconds from now (0 = already due), or ULONG_MAX if nothing is pending
+ */
+unsigned long pump_next_deadline_ms(void) {
+    unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    unsigned long best = ULONG_MAX;
+    
+    if (output_shadow_dirty(&pcaShadow, PUMP_PCA9555_PORT)) {
+        earliest_deadline(&best, now, now + PUMP_OUTPUT_RETRY_MS);
+    }
+    if (output_shadow_verify_pending(&pcaShadow, PUMP_PCA9555_PORT)) {
+        earliest_deadline(&best, now, pcaShadow.verify_due_ms);
+    }
+    
+    if (emergencyStopActive) {
+        return best;
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        if (pumps[i].stopPumpRequested) {
+            earliest_deadline(&best, now, now);
+            continue;
+        }
+        
+        if (pumps[i].state == PUMP_COOLDOWN) {
+            // Duration is drawn on the first tick in cooldown
+            earliest_deadline(&best, now, pumps[i].cooldownDuration == 0 ? now :
+                              pumps[i].cooldownStartTime + pumps[i].cooldownDuration);
+        } else if (pumps[i].timerProtected) {
+            earliest_deadline(&best, now, pumps[i].timerEndTime);
+        } else if (pumps[i].state == PUMP_MANUAL_ACTIVE) {
+            earliest_deadline(&best, now, pumps[i].manualStartTime + pumps[i].manualDuration);
+        } else if (pumps[i].state == PUMP_AUTO_ACTIVE) {
+            earliest_deadline(&best, now, pumps[i].lastFlameSeenTime + no_flame_timeout());
+            unsigned long maxRunCap = max_run_cap();
+            if (maxRunCap > 0) {
+                earliest_deadline(&best, now, pumps[i].pumpStartTime + maxRunCap);
+            }
+        }
+    }
+    return best;
+}
+
 void update_pump_states(void) {
     char log_msg[LOG_BUFFER_SIZE];
     unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
 
+    // Relay retries and read-back run every tick, even under emergency stop
+    pump_outputs_service();
+
     if (emergencyStopActive) {
         static unsigned long lastEmergencyCheck = 0;
         if (now - lastEmergencyCheck > 5000) {
@@ -1433,10 +1871,7 @@ void update_pump_states(void) {
         if (pumps[i].state != PUMP_AUTO_ACTIVE) continue;
 
         // NFT Check
-        unsigned long noFlameTimeout = 60000;
-        if (currentProfile == WILDLAND_HIGH_WIND) {
-            noFlameTimeout = 45000;
-        }
+        unsigned long noFlameTimeout = no_flame_timeout();
         
         unsigned long timeSinceFlame = now - pumps[i].lastFlameSeenTime;
         if (timeSinceFlame >= noFlameTimeout) {
@@ -1449,13 +1884,7 @@ void update_pump_states(void) {
         }
 
         // ✅ CORRECTED: MCRC Check - Uses ONLY current activation runtime
-        ProfileConfig* profile = &profiles[currentProfile];
-        unsigned long maxRunCap = profile->autoModeFull ? 
-                                  profile->maxRunCapFull : profile->maxRunCapSector;
-        
-        if (continuousWaterFeed) {
-            maxRunCap = 0; // No limit in continuous feed mode
-        }
+        unsigned long maxRunCap = max_run_cap();
 
         // Calculate runtime for THIS activation only
         unsigned long runTime = now - pumps[i].pumpStartTime;
@@ -1490,6 +1919,8 @@ void activate_pump(int index, bool activateAll) {
     if (pumps[index].state == PUMP_AUTO_ACTIVE) return;
 
     if (activateAll) {
+        bool activated[4] = {false};
+        pump_outputs_begin();
         for (int i = 0; i < 4; i++) {
             if (pumps[i].state == PUMP_OFF && !waterLockout) {
                 pumps[i].state = PUMP_AUTO_ACTIVE;
@@ -1499,6 +1930,14 @@ void activate_pump(int index, bool activateAll) {
                 pumps[i].activationSource = ACTIVATION_SOURCE_AUTO;
                 pumps[i].activatedInFullSystemMode = true;
                 set_pump_hardware(i, true);
+                activated[i] = true;
+            }
+        }
+        pump_outputs_end();
+        
+        // Alerts go out once the relays are actually switched
+        for (int i = 0; i < 4; i++) {
+            if (activated[i]) {
                 snprintf(log_msg, LOG_BUFFER_SIZE, 
                         "[FIRE_SYSTEM] Pump %s ACTIVATED (Full-System Mode)", 
                         pumps[i].name);
@@ -1566,7 +2005,7 @@ void deactivate_pump(int index, const char* reason) {
     pumps[index].flameFirstDetectedTime = 0;
     pumps[index].flameConfirmed = false;
     pumps[index].manualMode = false;
-    flameValidating[index] = false;
+    fire_detector_reset(&flameDetectors[index]);
     
     pumps[index].activationSource = ACTIVATION_SOURCE_NONE;
     
@@ -1587,6 +2026,7 @@ void deactivate_pump(int index, const char* reason) {
 void stop_all_pumps(const char* reason) {
     printf("[FIRE_SYSTEM] STOPPING ALL PUMPS - Reason: %s\n", reason);
 
+    pump_outputs_begin();
     for (int i = 0; i < 4; i++) {
         if (pumps[i].state != PUMP_OFF && pumps[i].state != PUMP_DISABLED) {
             StopReason stopReason = STOP_REASON_MANUAL;
@@ -1605,6 +2045,7 @@ void stop_all_pumps(const char* reason) {
             deactivate_pump(i, reason);
         }
     }
+    pump_outputs_end();
 }
 
 // ========================================
@@ -1680,6 +2121,7 @@ bool shadow_manual_stop_pump_override_timer(int index) {
     
     // Set the stop request flag
     pumps[index].stopPumpRequested = true;
+    pump_schedule_kick();
     
     snprintf(log_msg, LOG_BUFFER_SIZE,
             "[SHADOW-STOP] Stop request set for %s", pumps[index].name);
@@ -1701,8 +2143,10 @@ void print_current_sensor_status(void) {
     
     for (int i = 0; i < 4; i++) {
         printf("%s (%s):\n", currentSensors[i].name, pumps[i].name);
-        printf("  Current: %.3f A | Average: %.3f A\n", 
+        printf("  Current: %.3f A RMS | Average: %.3f A\n", 
                currentSensors[i].currentValue, currentSensors[i].averageValue);
+        printf("  Peak: %.3f A | Crest: %.2f\n", 
+               currentSensors[i].peakValue, currentSensors[i].crestFactor);
         printf("  Fault: %s | Mux: %s", 
                currentSensors[i].fault ? "YES" : "NO",
                currentSensors[i].isMux ? "YES" : "NO");
@@ -1785,12 +2229,14 @@ void manual_activate_all_pumps(void) {
     unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
     int activatedCount = 0;
 
+    // All four relays switch in one port write; a running pump is
+    // restarted in software and its relay simply stays closed
+    pump_outputs_begin();
     for (int i = 0; i < 4; i++) {
         // SECTION 3.7: Immediate restart allowed
         if (pumps[i].state == PUMP_AUTO_ACTIVE || 
             pumps[i].state == PUMP_MANUAL_ACTIVE) {
             deactivate_pump(i, "manual_all_override");
-            vTaskDelay(pdMS_TO_TICKS(50));
         }
 
         pumps[i].state = PUMP_MANUAL_ACTIVE;
@@ -1807,6 +2253,10 @@ void manual_activate_all_pumps(void) {
 
         set_pump_hardware(i, true);
         activatedCount++;
+    }
+    pump_outputs_end();
+    
+    for (int i = 0; i < 4; i++) {
         on_pump_activated(i, true);
     }
 
@@ -1927,9 +2377,11 @@ bool shadow_manual_activate_pump_with_duration(int index, unsigned long duration
     
     // Check for water lockout
     if (waterLockout) {
+        SensorFrame frame;
+        sensor_frame_read(&frame);
         snprintf(log_msg, LOG_BUFFER_SIZE, 
                 "[SHADOW-MANUAL] Blocked: %s - Water lockout active (Level: %.1f%%)", 
-                pumps[index].name, level_s);
+                pumps[index].name, frame.level);
         printf("%s\n", log_msg);
         return false;
     }
@@ -2257,6 +2709,30 @@ void on_flame_confirmed(int sensorIndex) {
 // DOOR MONITORING
 // ========================================
 
+// Door input bit from input_events, 0 if the edge interrupt could not be set up
+static uint32_t doorInputBit = 0;
+
+static void door_note_change(bool open, unsigned long now) {
+    char log_msg[LOG_BUFFER_SIZE];
+
+    doorOpen = open;
+    if (doorOpen) {
+        doorOpenTime = now;
+        printf("[FIRE_SYSTEM] Door OPENED\n");
+    } else {
+        unsigned long openDuration = (now - doorOpenTime) / 1000;
+        snprintf(log_msg, LOG_BUFFER_SIZE, 
+                "[FIRE_SYSTEM] Door CLOSED (was open for %lu seconds)", 
+                openDuration);
+        printf("%s\n", log_msg);
+    }
+}
+
+// Timer service task, after the debounce window
+static void door_input_changed(uint32_t changed, uint32_t state, void *arg) {
+    door_note_change((state & doorInputBit) != 0, xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
 void init_door_sensor(void) {
     gpio_config_t io_conf = {
         .pin_bit_mask = (1ULL << DOOR_SENSOR_PIN),
@@ -2269,7 +2745,19 @@ void init_door_sensor(void) {
     
     doorOpen = (gpio_get_level(DOOR_SENSOR_PIN) == 0);
     
-    
+    // Door switch pulls the pin low when open
+    uint32_t bit = 0;
+    if (input_events_add_gpio(DOOR_SENSOR_PIN, true, &bit) == ESP_OK &&
+        input_events_subscribe(bit, door_input_changed, NULL) == ESP_OK) {
+        doorInputBit = bit;
+        doorOpen = (input_events_state() & bit) != 0;
+    } else {
+        printf("[FIRE_SYSTEM] Door interrupt unavailable - falling back to polling\n");
+    }
+}
+
+uint32_t get_door_input_mask(void) {
+    return doorInputBit;
 }
 
 void update_camera_on_off(void) {
@@ -2296,28 +2784,15 @@ bool is_camera_active(void) {
 }
 
 void check_door_status(void) {
-    char log_msg[LOG_BUFFER_SIZE];
     unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
     
-    if (now - lastDoorCheck < DOOR_CHECK_INTERVAL) {
-        return;
-    }
-    lastDoorCheck = now;
-    
-    bool currentState = (gpio_get_level(DOOR_SENSOR_PIN) == 0);
-    
-    if (currentState != doorOpen) {
-        doorOpen = currentState;
+    // Only poll when the door interrupt is not running
+    if (doorInputBit == 0 && now - lastDoorCheck >= DOOR_CHECK_INTERVAL) {
+        lastDoorCheck = now;
         
-        if (doorOpen) {
-            doorOpenTime = now;
-            printf("[FIRE_SYSTEM] Door OPENED\n");
-        } else {
-            unsigned long openDuration = (now - doorOpenTime) / 1000;
-            snprintf(log_msg, LOG_BUFFER_SIZE, 
-                    "[FIRE_SYSTEM] Door CLOSED (was open for %lu seconds)", 
-                    openDuration);
-            printf("%s\n", log_msg);
+        bool currentState = (gpio_get_level(DOOR_SENSOR_PIN) == 0);
+        if (currentState != doorOpen) {
+            door_note_change(currentState, now);
         }
     }
     
@@ -2347,6 +2822,10 @@ void init_fire_suppression_system(void) {
     
     // Initialize arrays first
     initialize_arrays();
+    
+    if (input_events_init() != ESP_OK) {
+        printf("[FIRE_SYSTEM] Input interrupts unavailable\n");
+    }
   
     snprintf(log_msg, LOG_BUFFER_SIZE, 
             "[FIRE_SYSTEM] Initializing PCA9555");
@@ -2386,6 +2865,16 @@ void init_fire_suppression_system(void) {
         }
         
         all_off();
+        
+#if PCA9555_INT_GPIO >= 0
+        // Expander input changes arrive on INT instead of being polled
+        ret = input_events_add_pca9555(&pca_dev, (gpio_num_t)PCA9555_INT_GPIO);
+        if (ret == ESP_ERR_NOT_FOUND) {
+            printf("[FIRE_SYSTEM] PCA9555 has no input pins, INT not used\n");
+        } else if (ret != ESP_OK) {
+            printf("[FIRE_SYSTEM] PCA9555 INT not enabled: %s\n", esp_err_to_name(ret));
+        }
+#endif
     }
 
     for (int i = 0; i < 4; i++) {
@@ -2424,6 +2913,7 @@ void reset_system_to_defaults(void) {
     
     // 2. Force stop ALL pumps (override all protections)
     printf("[SYSTEM] Stopping all pumps...\n");
+    pump_outputs_begin();
     for (int i = 0; i < 4; i++) {
         if (pumps[i].state != PUMP_OFF) {
             // Clear timer protection
@@ -2455,6 +2945,7 @@ void reset_system_to_defaults(void) {
             printf("[SYSTEM] Pump %d (%s) reset to OFF\n", i+1, pumps[i].name);
         }
     }
+    pump_outputs_end();
     
     // 3. Reset profile to default (WILDLAND_STANDARD)
     printf("[SYSTEM] Resetting profile to WILDLAND_STANDARD...\n");
@@ -2469,11 +2960,15 @@ void reset_system_to_defaults(void) {
         inGracePeriod = false;
         gracePeriodStartTime = 0;
     }
+    stableStartTime = 0;
+    lastStableWaterLevel = 0;
     
     // 5. Reset continuous feed detection
     continuousWaterFeed = false;
     continuousFeedConfidence = 0;
     lastContinuousFeedCheck = 0;
+    memset(feedCheckLevels, 0, sizeof(feedCheckLevels));
+    feedCheckIndex = 0;
     
     // 6. Arm the system
     systemArmed = true;
@@ -2485,8 +2980,7 @@ void reset_system_to_defaults(void) {
     
     // 8. Reset flame validation states
     for (int i = 0; i < 4; i++) {
-        flameStartTime[i] = 0;
-        flameValidating[i] = false;
+        fire_detector_reset(&flameDetectors[i]);
     }
     
     printf("[SYSTEM] ===== SYSTEM RESET COMPLETE =====\n");
@@ -2525,7 +3019,9 @@ void update_fire_detection_info(void) {
     unsigned long now = xTaskGetTickCount() * portTICK_PERIOD_MS;
     
     // Get current IR sensor values
-    float sensorValues[4] = {ir_s1, ir_s2, ir_s3, ir_s4};
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    const float* sensorValues = frame.ir;
     const char* sectorNames[4] = {"N", "S", "E", "W"};
     
     // Reset fire info
@@ -5,6 +5,9 @@
 // INCLUDES
 // ========================================
 #include "clsPCA9555.h"
+#include "sensor_frame.h"
+#include "fire_detector.h"
+#include "latency_trace.h"
 #include "driver/gpio.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
@@ -30,6 +33,8 @@
 #define SENSOR_HEALTH_INTERVAL      300000
 #define DOOR_CHECK_INTERVAL         500
 #define DOOR_ALERT_DELAY            300000
+#define PUMP_OUTPUT_RETRY_MS        100     // Failed relay write retry
+#define PUMP_SCHEDULE_MAX_WAIT_MS   1000    // Pump task wakes at least this often
 
 // UNIFIED FIRE DETECTION THRESHOLD - Used by all fire detection logic
 #define FIRE_THRESHOLD              50.0
@@ -41,6 +46,8 @@
 #define PCA9555_I2C_PORT            I2C_NUM_0
 #define PCA9555_I2C_SDA_GPIO        21
 #define PCA9555_I2C_SCL_GPIO        22
+#define PUMP_PCA9555_PORT           1       // Pump relays on port 1, pins 3..0 = N, S, E, W
+#define PCA9555_INT_GPIO            -1      // Open-drain INT from the expander, -1 if not wired
 #define EXTEND_30S                  (30 * 1000)
 #define EXTEND_2MIN                 (120 * 1000)
 #define EXTEND_5MIN                 (300 * 1000)
@@ -76,7 +83,14 @@ typedef enum {
     CMD_STOP_ALL_PUMPS,
     CMD_EXTEND_TIME,
     CMD_CHANGE_PROFILE,
-    CMD_GET_STATUS
+    CMD_GET_STATUS,
+    CMD_EMERGENCY_STOP,         // value: 1 = stop, 0 = resume
+    CMD_SYSTEM_RESET,
+    CMD_SHADOW_START_ALL,
+    CMD_SHADOW_STOP_ALL,
+    CMD_SHADOW_STOP_PUMP,
+    CMD_SHADOW_MANUAL_PUMP,
+    CMD_SHADOW_EXTEND_TIME      // value: duration code
 } CommandType;
 
 // Stop Reason Enum
@@ -135,6 +149,15 @@ typedef struct {
     unsigned long maxRunCapSector;
     const char* name;
     unsigned long cooldown;
+    
+    // Flame confirmation (see fire_detector.h)
+    fire_detect_mode_t detectMode;
+    unsigned long flameConfirmTime;     // Steady-level confirmation window
+    unsigned long flameConfirmMinTime;  // Fastest confirmation (fused mode)
+    float riseRateFull;                 // IR %/s that earns full rise credit
+    float riseGain;                     // Speed-up at full rise credit
+    float levelGain;                    // Speed-up at 100% IR
+    float neighbourGain;                // Speed-up per adjacent sector in flame
 } ProfileConfig;
 
 // Pump Control Structure
@@ -152,6 +175,9 @@ typedef struct {
     unsigned long pumpStartTime;
     unsigned long cooldownStartTime;
     float currentIRValue;
+    float currentIRRate;
+    int64_t irSampleUs;                    // Capture time of currentIRValue
+    latency_trace_t trace;                 // Response timestamps for the current flame
     bool manualMode;
     unsigned long manualStartTime;
     unsigned long manualDuration;
@@ -187,6 +213,8 @@ typedef struct {
     float averageValue;
     bool fault;
     unsigned long lastReadTime;
+    float peakValue;        // Peak excursion of the last block, A
+    float crestFactor;      // peak / RMS of the last block
 } CurrentSensor;
 
 // Pump Status Structure for Shadow Reporting
@@ -214,16 +242,6 @@ const char* get_duration_code_string(int code);
 extern const gpio_num_t CAMERA_ON_OFF;
 extern const float CAMERA_FIRE_THRESHOLD;
 
-// Sensor Data Arrays
-extern float adc_array1[8];
-extern float adc_array2[8];
-extern float waterLevels[4];
-
-// Main Sensor Values
-extern float level_s;
-extern float ir_s1, ir_s2, ir_s3, ir_s4;
-extern float sol_v, bat_v;
-
 // System State
 extern SystemProfile currentProfile;
 extern bool systemArmed;
@@ -266,16 +284,19 @@ extern void send_alert_pca9555_fail(const char*, const char*);
 extern void send_alert_hardware_control_fail(int, const char*);
 extern void send_alert_current_sensor_fault(int, float);
 extern void send_alert_state_corruption(int, int);
+extern void pump_schedule_kick(void);    // Wake the pump task: state or deadlines changed
 
 // Initialization Functions
 void init_fire_suppression_system(void);
 void initialize_arrays(void);
 void init_current_sensors(void);
 void init_door_sensor(void);
+uint32_t get_door_input_mask(void);
 
 // Main System Functions
 void update_fire_suppression_system(void);
 void get_sensor_data(void);
+void update_pump_ir_values(const SensorFrame* frame);
 void apply_system_profile(SystemProfile newProfile);
 
 // Camera Functions
@@ -284,6 +305,7 @@ bool is_camera_active(void);
 
 // Fire Detection & Safety Functions
 void check_automatic_activation(void);
+unsigned long fire_detection_next_deadline_ms(void);
 void check_water_lockout(void);
 void check_sensor_health(void);
 bool is_sensor_healthy(int index);
@@ -301,6 +323,10 @@ FireDetectionInfo* get_fire_detection_info(void);
 void activate_pump(int index, bool activateAll);
 void deactivate_pump(int index, const char* reason);
 void set_pump_hardware(int index, bool state);
+void pump_outputs_begin(void);
+void pump_outputs_end(void);
+void pump_outputs_service(void);
+unsigned long pump_next_deadline_ms(void);
 void update_pump_states(void);
 void pump_control(unsigned int pumpNum, bool state);
 void all_off(void);
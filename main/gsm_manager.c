@@ -40,6 +40,7 @@ static int cached_signal_rssi = 0;  // Add this global variable
 static esp_modem_dce_t *dce = NULL;
 static esp_netif_t *ppp_netif = NULL;
 static EventGroupHandle_t gsm_event_group = NULL;
+static StaticEventGroup_t gsm_event_group_buf;
 static const int GSM_CONNECTED_BIT = BIT0;
 static const int GSM_DISCONNECTED_BIT = BIT1;
 
@@ -553,7 +554,7 @@ esp_err_t gsm_manager_init(void)
     printf("\n[GSM] Initializing GSM modem");
 
     // Create event group
-    gsm_event_group = xEventGroupCreate();
+    gsm_event_group = xEventGroupCreateStatic(&gsm_event_group_buf);
     if (gsm_event_group == NULL) {
         printf("\n[GSM]  Failed to create event group");
         return ESP_FAIL;
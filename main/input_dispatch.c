@@ -0,0 +1,50 @@
+/**
+ * @file input_dispatch.c
+ * @brief Digital input change detection and subscriber dispatch
+ */
+
+#include "input_dispatch.h"
+#include <stddef.h>
+#include <string.h>
+
+void input_dispatch_init(input_dispatch_t *d)
+{
+    memset(d, 0, sizeof(*d));
+}
+
+int input_dispatch_subscribe(input_dispatch_t *d, uint32_t mask, input_event_cb_t cb, void *arg)
+{
+    if (cb == NULL || d->count >= INPUT_DISPATCH_MAX_SUBSCRIBERS) {
+        return -1;
+    }
+    d->subs[d->count].mask = mask;
+    d->subs[d->count].cb = cb;
+    d->subs[d->count].arg = arg;
+    d->count++;
+    return 0;
+}
+
+void input_dispatch_seed(input_dispatch_t *d, uint32_t mask, uint32_t state)
+{
+    d->state = (d->state & ~mask) | (state & mask);
+}
+
+uint32_t input_dispatch_update(input_dispatch_t *d, uint32_t mask, uint32_t state)
+{
+    uint32_t next = (d->state & ~mask) | (state & mask);
+    uint32_t changed = next ^ d->state;
+    if (changed == 0) {
+        return 0;
+    }
+    d->state = next;
+    d->events++;
+
+    // Registration order, so earlier subscribers see the change first
+    for (uint8_t i = 0; i < d->count; i++) {
+        uint32_t mine = changed & d->subs[i].mask;
+        if (mine) {
+            d->subs[i].cb(mine, next, d->subs[i].arg);
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file input_dispatch.h
+ * @brief Digital input change detection and subscriber dispatch
+ *
+ * Inputs share one 32-bit state word (see input_events.h for the bit
+ * layout). Each update carries the bits a source owns and their new
+ * levels; the bits that changed are passed to every subscriber whose mask
+ * overlaps them.
+ *
+ * Not thread-safe: updates and dispatch run in one deferred context, and
+ * subscribers are registered before inputs are enabled.
+ */
+
+#ifndef INPUT_DISPATCH_H
+#define INPUT_DISPATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define INPUT_DISPATCH_MAX_SUBSCRIBERS  6
+
+/**
+ * @brief Change callback
+ * @param changed Bits that changed (within the subscriber's mask)
+ * @param state Whole input state after the change
+ * @param arg Subscriber argument
+ */
+typedef void (*input_event_cb_t)(uint32_t changed, uint32_t state, void *arg);
+
+typedef struct {
+    uint32_t mask;
+    input_event_cb_t cb;
+    void *arg;
+} input_subscriber_t;
+
+typedef struct {
+    uint32_t state;                 // Active = 1
+    input_subscriber_t subs[INPUT_DISPATCH_MAX_SUBSCRIBERS];
+    uint8_t count;
+    uint32_t events;                // Updates that changed at least one bit
+} input_dispatch_t;
+
+void input_dispatch_init(input_dispatch_t *d);
+
+/**
+ * @brief Register a subscriber
+ * @return 0 on success, -1 if the table is full or cb is NULL
+ */
+int input_dispatch_subscribe(input_dispatch_t *d, uint32_t mask, input_event_cb_t cb, void *arg);
+
+/**
+ * @brief Set the initial level of some bits without notifying anyone
+ */
+void input_dispatch_seed(input_dispatch_t *d, uint32_t mask, uint32_t state);
+
+/**
+ * @brief Apply new levels for the bits in mask and notify subscribers
+ * @return Bits that changed
+ */
+uint32_t input_dispatch_update(input_dispatch_t *d, uint32_t mask, uint32_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_DISPATCH_H
@@ -0,0 +1,202 @@
+/**
+ * @file input_events.c
+ * @brief Interrupt-driven digital inputs: GPIO edges and the PCA9555 INT line
+ */
+
+#include "input_events.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#include <stdio.h>
+
+typedef struct {
+    gpio_num_t gpio;
+    bool active_low;
+    uint32_t bit;
+    TimerHandle_t debounce;
+    StaticTimer_t debounce_buf;
+} input_gpio_t;
+
+static input_dispatch_t s_dispatch;
+static input_gpio_t s_gpio[INPUT_EVENTS_MAX_GPIO];
+static uint8_t s_gpio_count = 0;
+
+static pca9555_t *s_pca = NULL;
+static uint32_t s_pca_inputs = 0;           // Expander pins configured as inputs
+static volatile bool s_pca_read_pending = false;
+
+// ========================================
+// GPIO INPUTS
+// ========================================
+
+static uint32_t gpio_input_state(const input_gpio_t *in)
+{
+    int level = gpio_get_level(in->gpio);
+    bool active = in->active_low ? (level == 0) : (level != 0);
+    return active ? in->bit : 0;
+}
+
+// Timer service task: no edge for INPUT_EVENTS_DEBOUNCE_MS, so the level has settled
+static void gpio_input_debounced(TimerHandle_t timer)
+{
+    input_gpio_t *in = (input_gpio_t *)pvTimerGetTimerID(timer);
+    input_dispatch_update(&s_dispatch, in->bit, gpio_input_state(in));
+}
+
+// Every edge restarts the debounce window
+static void IRAM_ATTR gpio_input_isr(void *arg)
+{
+    input_gpio_t *in = (input_gpio_t *)arg;
+    BaseType_t woken = pdFALSE;
+    xTimerResetFromISR(in->debounce, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// ========================================
+// PCA9555 INT
+// ========================================
+
+// Timer service task: one burst read of both input ports, which also releases INT
+static void pca_read_inputs(void *arg1, uint32_t arg2)
+{
+    s_pca_read_pending = false;
+
+    uint8_t ports[2];
+    esp_err_t ret = pca9555_read_register_pair(s_pca, PCA9555_REG_INPUT_0, ports);
+    if (ret != ESP_OK) {
+        printf("[INPUT] PCA9555 input read failed: %s\n", esp_err_to_name(ret));
+        return;
+    }
+    input_dispatch_update(&s_dispatch, s_pca_inputs, (uint32_t)ports[0] | ((uint32_t)ports[1] << 8));
+}
+
+static void IRAM_ATTR pca_int_isr(void *arg)
+{
+    // A read already queued will see this change too
+    if (s_pca_read_pending) {
+        return;
+    }
+    s_pca_read_pending = true;
+
+    BaseType_t woken = pdFALSE;
+    if (xTimerPendFunctionCallFromISR(pca_read_inputs, NULL, 0, &woken) != pdPASS) {
+        s_pca_read_pending = false;
+    }
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// ========================================
+// PUBLIC API
+// ========================================
+
+esp_err_t input_events_init(void)
+{
+    input_dispatch_init(&s_dispatch);
+    s_gpio_count = 0;
+
+    // Shared ISR service; already installed is fine
+    esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        printf("[INPUT] GPIO ISR service install failed: %s\n", esp_err_to_name(ret));
+        return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t input_events_add_gpio(gpio_num_t gpio, bool active_low, uint32_t *bit_out)
+{
+    if (s_gpio_count >= INPUT_EVENTS_MAX_GPIO) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    input_gpio_t *in = &s_gpio[s_gpio_count];
+    in->gpio = gpio;
+    in->active_low = active_low;
+    in->bit = INPUT_EVENTS_GPIO_BIT(s_gpio_count);
+    in->debounce = xTimerCreateStatic("InputDb", pdMS_TO_TICKS(INPUT_EVENTS_DEBOUNCE_MS), pdFALSE,
+                                      in, gpio_input_debounced, &in->debounce_buf);
+    if (in->debounce == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    input_dispatch_seed(&s_dispatch, in->bit, gpio_input_state(in));
+
+    esp_err_t ret = gpio_set_intr_type(gpio, GPIO_INTR_ANYEDGE);
+    if (ret == ESP_OK) {
+        ret = gpio_isr_handler_add(gpio, gpio_input_isr, in);
+    }
+    if (ret != ESP_OK) {
+        printf("[INPUT] GPIO%d interrupt setup failed: %s\n", gpio, esp_err_to_name(ret));
+        xTimerDelete(in->debounce, 0);
+        return ret;
+    }
+
+    s_gpio_count++;
+    if (bit_out) {
+        *bit_out = in->bit;
+    }
+    printf("[INPUT] GPIO%d edge interrupt enabled (bit %d, %d ms debounce)\n",
+           gpio, 16 + s_gpio_count - 1, INPUT_EVENTS_DEBOUNCE_MS);
+    return ESP_OK;
+}
+
+esp_err_t input_events_add_pca9555(pca9555_t *dev, gpio_num_t int_gpio)
+{
+    if (dev == NULL || !pca9555_is_initialized(dev)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Config register bit = 1 means input; only those pins raise INT
+    uint8_t config[2];
+    esp_err_t ret = pca9555_read_register_pair(dev, PCA9555_REG_CONFIG_0, config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint32_t inputs = ((uint32_t)config[0] | ((uint32_t)config[1] << 8)) & INPUT_EVENTS_PCA_MASK;
+    if (inputs == 0) {
+        // All pins drive outputs: INT never fires, leave the pin alone
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_pca = dev;
+    s_pca_inputs = inputs;
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << int_gpio),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,       // INT is open drain
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
+    };
+    ret = gpio_config(&io_conf);
+    if (ret == ESP_OK) {
+        ret = gpio_isr_handler_add(int_gpio, pca_int_isr, NULL);
+    }
+    if (ret != ESP_OK) {
+        printf("[INPUT] PCA9555 INT on GPIO%d setup failed: %s\n", int_gpio, esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Seed the state; the read also releases an INT that was already asserted
+    uint8_t ports[2];
+    if (pca9555_read_register_pair(dev, PCA9555_REG_INPUT_0, ports) == ESP_OK) {
+        input_dispatch_seed(&s_dispatch, s_pca_inputs, (uint32_t)ports[0] | ((uint32_t)ports[1] << 8));
+    }
+
+    printf("[INPUT] PCA9555 INT on GPIO%d enabled (input pins 0x%04lX)\n",
+           int_gpio, (unsigned long)s_pca_inputs);
+    return ESP_OK;
+}
+
+esp_err_t input_events_subscribe(uint32_t mask, input_event_cb_t cb, void *arg)
+{
+    return input_dispatch_subscribe(&s_dispatch, mask, cb, arg) == 0 ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+uint32_t input_events_state(void)
+{
+    return s_dispatch.state;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file input_events.h
+ * @brief Interrupt-driven digital inputs: GPIO edges and the PCA9555 INT line
+ *
+ * GPIO inputs interrupt on both edges. Each edge restarts a one-shot
+ * debounce timer, and when it expires the settled level is sampled. The
+ * PCA9555 INT line (open drain, active low) triggers one burst read of
+ * both input ports, which also clears INT. Both run deferred in the
+ * FreeRTOS timer service task, never in the ISR, and report the bits that
+ * changed to input_dispatch subscribers.
+ *
+ * State bit layout:
+ *   bits 0..15  PCA9555 P0.0..P1.7 (pins configured as inputs only)
+ *   bits 16..   GPIO inputs, in the order they are added
+ *
+ * Subscribers run in the timer service task and must not block for long.
+ */
+
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "clsPCA9555.h"
+#include "input_dispatch.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Input Configuration
+#define INPUT_EVENTS_DEBOUNCE_MS        30
+#define INPUT_EVENTS_MAX_GPIO           4
+#define INPUT_EVENTS_PCA_MASK           0x0000FFFFu
+#define INPUT_EVENTS_GPIO_BIT(n)        (1u << (16 + (n)))
+
+/**
+ * @brief Install the GPIO ISR service and reset the input state
+ */
+esp_err_t input_events_init(void);
+
+/**
+ * @brief Add a debounced GPIO input (the pin must already be configured as an input)
+ * @param gpio Pin
+ * @param active_low true if the input is active when the pin reads 0
+ * @param bit_out Assigned state bit
+ * @return ESP_OK, or ESP_ERR_NO_MEM when all GPIO slots are used
+ */
+esp_err_t input_events_add_gpio(gpio_num_t gpio, bool active_low, uint32_t *bit_out);
+
+/**
+ * @brief Enable PCA9555 input change interrupts
+ * @param dev Initialised expander (input pins are taken from its config registers)
+ * @param int_gpio ESP32 pin wired to INT
+ * @return ESP_OK, or ESP_ERR_NOT_FOUND if no expander pin is an input
+ */
+esp_err_t input_events_add_pca9555(pca9555_t *dev, gpio_num_t int_gpio);
+
+/**
+ * @brief Register for changes on the bits in mask
+ */
+esp_err_t input_events_subscribe(uint32_t mask, input_event_cb_t cb, void *arg);
+
+/**
+ * @brief Current debounced state of all inputs
+ */
+uint32_t input_events_state(void);
+
+#endif // INPUT_EVENTS_H
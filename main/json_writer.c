@@ -0,0 +1,231 @@
+/**
+ * @file json_writer.c
+ * @brief Streaming JSON writer into a caller-provided buffer
+ *
+ * Escaping and number formatting follow cJSON's print_string_ptr and
+ * print_number so the two paths produce the same bytes.
+ */
+
+#include "json_writer.h"
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ========================================
+// OUTPUT
+// ========================================
+
+static void put(json_writer_t *w, const char *s, size_t n)
+{
+    if (!w->truncated) {
+        if (w->len + n < w->size) {
+            memcpy(w->buf + w->len, s, n);
+            w->buf[w->len + n] = '\0';
+        } else {
+            w->truncated = true;
+        }
+    }
+    w->len += n;
+}
+
+static void put_char(json_writer_t *w, char c)
+{
+    put(w, &c, 1);
+}
+
+static void put_escaped(json_writer_t *w, const char *s)
+{
+    put_char(w, '"');
+    const unsigned char *p = (const unsigned char *)(s ? s : "");
+    while (*p) {
+        // Copy the run that needs no escaping in one go
+        const unsigned char *run = p;
+        while (*p >= 32 && *p != '"' && *p != '\\') {
+            p++;
+        }
+        put(w, (const char *)run, (size_t)(p - run));
+        if (*p == '\0') {
+            break;
+        }
+
+        char esc[8];
+        switch (*p) {
+            case '"':  put(w, "\\\"", 2); break;
+            case '\\': put(w, "\\\\", 2); break;
+            case '\b': put(w, "\\b", 2); break;
+            case '\f': put(w, "\\f", 2); break;
+            case '\n': put(w, "\\n", 2); break;
+            case '\r': put(w, "\\r", 2); break;
+            case '\t': put(w, "\\t", 2); break;
+            default:
+                snprintf(esc, sizeof(esc), "\\u%04x", *p);
+                put(w, esc, 6);
+                break;
+        }
+        p++;
+    }
+    put_char(w, '"');
+}
+
+// Comma and key for the next member of the current container
+static void member(json_writer_t *w, const char *key)
+{
+    unsigned int bit = 1u << w->depth;
+    if (w->has_members & bit) {
+        put_char(w, ',');
+    }
+    w->has_members |= bit;
+    if (key) {
+        put_escaped(w, key);
+        put_char(w, ':');
+    }
+}
+
+static void open_container(json_writer_t *w, const char *key, char c)
+{
+    member(w, key);
+    put_char(w, c);
+    if (w->depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+        w->truncated = true;
+        return;
+    }
+    w->depth++;
+    w->has_members &= ~(1u << w->depth);
+}
+
+static void close_container(json_writer_t *w, char c)
+{
+    put_char(w, c);
+    if (w->depth > 0) {
+        w->depth--;
+    } else {
+        w->truncated = true;
+    }
+}
+
+// ========================================
+// API
+// ========================================
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size)
+{
+    w->buf = buf;
+    w->size = size;
+    w->len = 0;
+    w->depth = 0;
+    w->has_members = 0;
+    w->truncated = (size == 0);
+    if (size > 0) {
+        buf[0] = '\0';
+    }
+}
+
+void json_writer_begin_object(json_writer_t *w, const char *key)
+{
+    open_container(w, key, '{');
+}
+
+void json_writer_end_object(json_writer_t *w)
+{
+    close_container(w, '}');
+}
+
+void json_writer_begin_array(json_writer_t *w, const char *key)
+{
+    open_container(w, key, '[');
+}
+
+void json_writer_end_array(json_writer_t *w)
+{
+    close_container(w, ']');
+}
+
+void json_writer_string(json_writer_t *w, const char *key, const char *value)
+{
+    if (value == NULL) {
+        return;     // cJSON_AddStringToObject adds nothing for NULL
+    }
+    member(w, key);
+    put_escaped(w, value);
+}
+
+void json_writer_number(json_writer_t *w, const char *key, double value)
+{
+    char num[26];
+    int n;
+
+    // cJSON keeps a saturated int copy and prints that when it is exact
+    int as_int = 0;
+    if (value >= INT_MAX) {
+        as_int = INT_MAX;
+    } else if (value <= (double)INT_MIN) {
+        as_int = INT_MIN;
+    } else if (!isnan(value)) {
+        as_int = (int)value;
+    }
+
+    if (isnan(value) || isinf(value)) {
+        n = snprintf(num, sizeof(num), "null");
+    } else if (value == (double)as_int) {
+        n = snprintf(num, sizeof(num), "%d", as_int);
+    } else {
+        // 15 digits unless that loses precision, then 17
+        n = snprintf(num, sizeof(num), "%1.15g", value);
+        double test = 0;
+        double larger = fabs(value);
+        if (sscanf(num, "%lg", &test) != 1 ||
+            fabs(test - value) > (fabs(test) > larger ? fabs(test) : larger) * DBL_EPSILON) {
+            n = snprintf(num, sizeof(num), "%1.17g", value);
+        }
+    }
+
+    member(w, key);
+    put(w, num, (size_t)n);
+}
+
+void json_writer_bool(json_writer_t *w, const char *key, bool value)
+{
+    member(w, key);
+    if (value) {
+        put(w, "true", 4);
+    } else {
+        put(w, "false", 5);
+    }
+}
+
+json_writer_mark_t json_writer_mark(const json_writer_t *w)
+{
+    json_writer_mark_t mark = { w->len, w->depth, w->has_members, w->truncated };
+    return mark;
+}
+
+bool json_writer_keep(json_writer_t *w, const json_writer_mark_t *mark)
+{
+    // One closing bracket per open container, plus the NUL
+    if (!w->truncated && w->len + (size_t)w->depth < w->size) {
+        return true;
+    }
+    w->len = mark->len;
+    w->depth = mark->depth;
+    w->has_members = mark->has_members;
+    w->truncated = mark->truncated;
+    if (!w->truncated) {
+        w->buf[w->len] = '\0';
+    }
+    return false;
+}
+
+size_t json_writer_finish(json_writer_t *w)
+{
+    if (w->truncated || w->depth != 0) {
+        return 0;
+    }
+    return w->len;
+}
+
+size_t json_writer_needed(const json_writer_t *w)
+{
+    return w->len;
+}
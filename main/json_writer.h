@@ -0,0 +1,100 @@
+/**
+ * @file json_writer.h
+ * @brief Streaming JSON writer into a caller-provided buffer
+ *
+ * Writes compact JSON straight into a fixed buffer with no heap use. The
+ * output is byte-identical to building the same members with cJSON and
+ * printing them with cJSON_PrintUnformatted: same string escaping, same
+ * number formatting, and members appear in the order they are written.
+ * As with cJSON_AddStringToObject, a NULL string value leaves the member out.
+ *
+ * Writing past the end of the buffer marks the writer truncated. Later
+ * writes only count bytes, so json_writer_needed() still reports the full
+ * size. The buffer always holds a NUL-terminated prefix.
+ *
+ * Optional members can be bracketed with json_writer_mark() and
+ * json_writer_keep(): if they leave no room to close the document, they
+ * are taken back out and the rest of the message still fits.
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JSON_WRITER_MAX_DEPTH       16
+
+typedef struct {
+    char *buf;
+    size_t size;                // Buffer size including the terminating NUL
+    size_t len;                 // Bytes the output needs so far
+    int depth;
+    unsigned int has_members;   // Bit per depth: container already has a member
+    bool truncated;
+} json_writer_t;
+
+// Writer position saved before an optional section
+typedef struct {
+    size_t len;
+    int depth;
+    unsigned int has_members;
+    bool truncated;
+} json_writer_mark_t;
+
+/**
+ * @brief Start writing into buf (size includes room for the NUL)
+ */
+void json_writer_init(json_writer_t *w, char *buf, size_t size);
+
+/**
+ * @brief Open an object; key is NULL for the root or an array element
+ */
+void json_writer_begin_object(json_writer_t *w, const char *key);
+void json_writer_end_object(json_writer_t *w);
+
+/**
+ * @brief Open an array; key is NULL for the root or an array element
+ */
+void json_writer_begin_array(json_writer_t *w, const char *key);
+void json_writer_end_array(json_writer_t *w);
+
+/**
+ * @brief Members; key is NULL inside arrays
+ */
+void json_writer_string(json_writer_t *w, const char *key, const char *value);
+void json_writer_number(json_writer_t *w, const char *key, double value);
+void json_writer_bool(json_writer_t *w, const char *key, bool value);
+
+/**
+ * @brief Remember the current position, before an optional section
+ */
+json_writer_mark_t json_writer_mark(const json_writer_t *w);
+
+/**
+ * @brief Keep what was written since mark if the open containers can still
+ *        be closed in the buffer, otherwise roll the writer back to mark
+ * @return true if the section was kept
+ */
+bool json_writer_keep(json_writer_t *w, const json_writer_mark_t *mark);
+
+/**
+ * @brief Finish the document
+ * @return Length written, or 0 if the output did not fit or is unbalanced
+ */
+size_t json_writer_finish(json_writer_t *w);
+
+/**
+ * @brief Bytes the full output needs, excluding the NUL
+ */
+size_t json_writer_needed(const json_writer_t *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,119 @@
+/**
+ * @file latency_trace.c
+ * @brief End-to-end fire response latency histograms
+ */
+
+#include "latency_trace.h"
+#include <stdio.h>
+#include <string.h>
+
+static latency_histogram_t s_histograms[LATENCY_STAGE_COUNT];
+
+static const char *s_stage_names[LATENCY_STAGE_COUNT] = {
+    "sampleToConfirm",
+    "confirmToRelay",
+    "sampleToRelay",
+    "relayToQueued",
+    "queuedToPublished",
+    "sampleToPublished",
+};
+
+static int bucket_for(uint32_t us)
+{
+    int bucket = 0;
+    us >>= LATENCY_MIN_SHIFT;
+    while (us && bucket < LATENCY_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void latency_histogram_add(latency_histogram_t *h, uint32_t us)
+{
+    if (h->count == 0 || us < h->min_us) {
+        h->min_us = us;
+    }
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+    h->sum_us += us;
+    h->buckets[bucket_for(us)]++;
+    h->count++;
+}
+
+void latency_trace_record(latency_stage_t stage, int64_t start_us, int64_t end_us)
+{
+    if (stage >= LATENCY_STAGE_COUNT || start_us <= 0 || end_us < start_us) {
+        return;
+    }
+
+    int64_t delta = end_us - start_us;
+    latency_histogram_add(&s_histograms[stage], delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta);
+}
+
+void latency_trace_get(latency_stage_t stage, latency_histogram_t *out)
+{
+    if (stage >= LATENCY_STAGE_COUNT) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    memcpy(out, &s_histograms[stage], sizeof(*out));
+}
+
+uint32_t latency_trace_percentile(const latency_histogram_t *hist, uint8_t percent)
+{
+    if (hist->count == 0) {
+        return 0;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+
+    // Rank of the requested sample, rounded up (p100 = last sample)
+    uint64_t rank = ((uint64_t)hist->count * percent + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            uint64_t upper = (1ULL << (LATENCY_MIN_SHIFT + b)) - 1;
+            return upper < hist->max_us ? (uint32_t)upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+const char *latency_trace_stage_name(latency_stage_t stage)
+{
+    return stage < LATENCY_STAGE_COUNT ? s_stage_names[stage] : "unknown";
+}
+
+void latency_trace_reset(void)
+{
+    memset(s_histograms, 0, sizeof(s_histograms));
+}
+
+void latency_trace_print(void)
+{
+    printf("\n[LATENCY] Fire response latency (ms)\n");
+    printf("  %-18s %6s %9s %9s %9s %9s\n", "stage", "n", "min", "p50", "p95", "max");
+
+    for (int s = 0; s < LATENCY_STAGE_COUNT; s++) {
+        latency_histogram_t h;
+        latency_trace_get((latency_stage_t)s, &h);
+        if (h.count == 0) {
+            printf("  %-18s %6s\n", s_stage_names[s], "-");
+            continue;
+        }
+        printf("  %-18s %6lu %9.1f %9.1f %9.1f %9.1f\n", s_stage_names[s],
+               (unsigned long)h.count,
+               h.min_us / 1000.0,
+               latency_trace_percentile(&h, 50) / 1000.0,
+               latency_trace_percentile(&h, 95) / 1000.0,
+               h.max_us / 1000.0);
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file latency_trace.h
+ * @brief End-to-end fire response latency histograms
+ *
+ * A fire response is stamped (esp_timer microseconds) as it moves through
+ * the system: the IR sample that first crossed threshold, flame
+ * confirmation, the pump relay being energised, the alert being queued and
+ * the alert being handed to MQTT. Each stage interval is folded into a
+ * fixed log2 histogram kept in RAM, so percentiles can be reported without
+ * storing individual events.
+ *
+ * Each stage has a single writer (the task that owns the later timestamp);
+ * readers take a snapshot and may see one event partly applied.
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Histogram Geometry
+#define LATENCY_MIN_SHIFT       6       // First bucket: < 64 us
+#define LATENCY_BUCKETS         22      // Last bucket: >= 2^26 us (~67 s)
+
+// Timestamps carried with one fire response (0 = not reached)
+typedef struct {
+    int64_t sample_us;          // Frame in which IR first crossed threshold
+    int64_t confirm_us;         // Flame confirmed
+    int64_t relay_us;           // Pump relay energised
+    int64_t queued_us;          // Alert queued
+} latency_trace_t;
+
+// Measured intervals
+typedef enum {
+    LATENCY_SAMPLE_TO_CONFIRM = 0,
+    LATENCY_CONFIRM_TO_RELAY,
+    LATENCY_SAMPLE_TO_RELAY,        // Time to water
+    LATENCY_RELAY_TO_QUEUED,
+    LATENCY_QUEUED_TO_PUBLISHED,
+    LATENCY_SAMPLE_TO_PUBLISHED,    // Time to notification
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+// Histogram for one interval
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[LATENCY_BUCKETS];
+} latency_histogram_t;
+
+/**
+ * @brief Record an interval between two trace points
+ * @param stage Interval being measured
+ * @param start_us Earlier timestamp (ignored if 0)
+ * @param end_us Later timestamp (ignored if 0 or before start)
+ */
+void latency_trace_record(latency_stage_t stage, int64_t start_us, int64_t end_us);
+
+/**
+ * @brief Add one sample to a caller-owned histogram
+ */
+void latency_histogram_add(latency_histogram_t *hist, uint32_t us);
+
+/**
+ * @brief Copy one stage's histogram
+ */
+void latency_trace_get(latency_stage_t stage, latency_histogram_t *out);
+
+/**
+ * @brief Upper bound of the bucket holding a percentile
+ * @param hist Histogram
+ * @param percent 0..100
+ * @return Latency in us (clamped to the observed max), 0 if empty
+ */
+uint32_t latency_trace_percentile(const latency_histogram_t *hist, uint8_t percent);
+
+/**
+ * @brief Short stage name for reports
+ */
+const char *latency_trace_stage_name(latency_stage_t stage);
+
+/**
+ * @brief Clear all histograms
+ */
+void latency_trace_reset(void);
+
+/**
+ * @brief Print a per-stage summary to the serial console
+ */
+void latency_trace_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_TRACE_H
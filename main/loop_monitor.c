@@ -0,0 +1,99 @@
+/**
+ * @file loop_monitor.c
+ * @brief Per-task loop timing: execution time, deadline misses and jitter
+ */
+
+#include "loop_monitor.h"
+#include <stdio.h>
+#include <string.h>
+
+void loop_monitor_init(loop_monitor_t *m, const char *name, uint32_t period_ms, bool safety)
+{
+    memset(m, 0, sizeof(*m));
+    m->name = name;
+    m->period_us = period_ms * 1000;
+    m->slack_us = m->period_us / LOOP_MONITOR_SLACK_DIV;
+    if (m->slack_us < LOOP_MONITOR_MIN_SLACK_US) {
+        m->slack_us = LOOP_MONITOR_MIN_SLACK_US;
+    }
+    m->safety = safety;
+}
+
+void loop_monitor_start(loop_monitor_t *m, int64_t now_us)
+{
+    m->prev_start_us = m->start_us;
+    m->start_us = now_us;
+}
+
+bool loop_monitor_end(loop_monitor_t *m, int64_t now_us)
+{
+    if (m->start_us == 0 || now_us < m->start_us) {
+        return false;
+    }
+
+    int64_t exec = now_us - m->start_us;
+    uint32_t exec_us = exec > UINT32_MAX ? UINT32_MAX : (uint32_t)exec;
+    bool missed = false;
+
+    m->iterations++;
+    m->exec_sum_us += exec_us;
+    if (exec_us > m->exec_max_us) {
+        m->exec_max_us = exec_us;
+    }
+    if (exec_us > m->period_us) {
+        m->overruns++;
+        missed = true;
+    }
+
+    // Start-to-start gap, from the second iteration on
+    if (m->prev_start_us != 0 && m->start_us > m->prev_start_us) {
+        int64_t gap = m->start_us - m->prev_start_us;
+        uint32_t interval_us = gap > UINT32_MAX ? UINT32_MAX : (uint32_t)gap;
+        if (interval_us > m->interval_max_us) {
+            m->interval_max_us = interval_us;
+        }
+
+        uint32_t late_us = interval_us > m->period_us ? interval_us - m->period_us : 0;
+        latency_histogram_add(&m->lateness, late_us);
+        if (late_us > m->slack_us) {
+            m->late_starts++;
+            missed = true;
+        }
+    }
+
+    if (!missed) {
+        m->consecutive = 0;
+        return false;
+    }
+
+    m->consecutive++;
+    if (m->consecutive > m->consecutive_max) {
+        m->consecutive_max = m->consecutive;
+    }
+    return m->safety && m->consecutive == LOOP_MONITOR_ALERT_MISSES;
+}
+
+uint32_t loop_monitor_avg_exec_us(const loop_monitor_t *m)
+{
+    return m->iterations ? (uint32_t)(m->exec_sum_us / m->iterations) : 0;
+}
+
+void loop_monitor_print(const loop_monitor_t *monitors, int count)
+{
+    printf("\n[LOOPS] Task loop timing (ms)\n");
+    printf("  %-8s %6s %7s %8s %8s %6s %6s %8s %8s\n",
+           "task", "period", "n", "avgExec", "maxExec", "over", "late", "lateP99", "maxRun");
+
+    for (int i = 0; i < count; i++) {
+        const loop_monitor_t *m = &monitors[i];
+        printf("  %-8s %6lu %7lu %8.1f %8.1f %6lu %6lu %8.1f %8lu\n", m->name,
+               (unsigned long)(m->period_us / 1000),
+               (unsigned long)m->iterations,
+               loop_monitor_avg_exec_us(m) / 1000.0,
+               m->exec_max_us / 1000.0,
+               (unsigned long)m->overruns,
+               (unsigned long)m->late_starts,
+               latency_trace_percentile(&m->lateness, 99) / 1000.0,
+               (unsigned long)m->consecutive_max);
+    }
+}
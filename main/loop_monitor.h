@@ -0,0 +1,89 @@
+/**
+ * @file loop_monitor.h
+ * @brief Per-task loop timing: execution time, deadline misses and jitter
+ *
+ * A task brackets each iteration of its main loop with loop_monitor_start()
+ * and loop_monitor_end(). Each monitor has a period. For vTaskDelayUntil
+ * loops this is the delay period. For event-driven loops it is the longest
+ * time the loop may go without running.
+ *
+ * An iteration misses its deadline when it runs longer than the period, or
+ * when it starts more than the period plus a slack after the previous
+ * start. Start lateness is kept in a log2 histogram (latency_trace buckets)
+ * as the jitter figure.
+ *
+ * Each monitor has a single writer, its own task. Readers copy it and may
+ * see one iteration partly applied.
+ */
+
+#ifndef LOOP_MONITOR_H
+#define LOOP_MONITOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "latency_trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Monitor Configuration
+#define LOOP_MONITOR_SLACK_DIV          10      // Start may slip period/10 before it counts as late
+#define LOOP_MONITOR_MIN_SLACK_US       20000   // ...but never less than two 10 ms ticks
+#define LOOP_MONITOR_ALERT_MISSES       3       // Consecutive misses that raise an alert (safety tasks)
+
+typedef struct {
+    const char *name;
+    uint32_t period_us;
+    uint32_t slack_us;
+    bool safety;                // Alert after LOOP_MONITOR_ALERT_MISSES consecutive misses
+
+    int64_t start_us;           // Current iteration (0 = not started)
+    int64_t prev_start_us;
+    uint32_t iterations;
+    uint32_t exec_max_us;
+    uint64_t exec_sum_us;
+    uint32_t overruns;          // Ran longer than the period
+    uint32_t late_starts;       // Started more than period + slack after the previous start
+    uint32_t consecutive;       // Current run of missed iterations
+    uint32_t consecutive_max;
+    uint32_t interval_max_us;   // Longest start-to-start gap
+    latency_histogram_t lateness;
+} loop_monitor_t;
+
+/**
+ * @brief Set up a monitor
+ * @param m Monitor
+ * @param name Task name for reports (not copied)
+ * @param period_ms Loop period, or the longest allowed gap for event loops
+ * @param safety Raise alerts on consecutive misses
+ */
+void loop_monitor_init(loop_monitor_t *m, const char *name, uint32_t period_ms, bool safety);
+
+/**
+ * @brief Stamp the start of an iteration
+ */
+void loop_monitor_start(loop_monitor_t *m, int64_t now_us);
+
+/**
+ * @brief Stamp the end of an iteration
+ * @return true exactly once per run of misses, when a safety task reaches
+ *         LOOP_MONITOR_ALERT_MISSES consecutive misses
+ */
+bool loop_monitor_end(loop_monitor_t *m, int64_t now_us);
+
+/**
+ * @brief Mean execution time in us (0 before the first iteration)
+ */
+uint32_t loop_monitor_avg_exec_us(const loop_monitor_t *m);
+
+/**
+ * @brief Print a summary table to the serial console
+ */
+void loop_monitor_print(const loop_monitor_t *monitors, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOOP_MONITOR_H
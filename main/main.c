@@ -5024,13 +5024,17 @@ void app_main(void) {
 #include <time.h>
 #include <sys/time.h>
 #include <string.h>
+#include <limits.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/projdefs.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "freertos/queue.h"
+#include "freertos/timers.h"
 #include "esp_system.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "driver/gpio.h"
 #include "nvs_flash.h"
 #include "esp_wifi.h"
@@ -5043,6 +5047,19 @@ void app_main(void) {
 
 #include "spiffs_handler.h"
 #include "fire_system.h"
+#include "sensor_history.h"
+#include "input_events.h"
+#include "control.h"
+#include "loop_monitor.h"
+#include "ram_budget.h"
+#include "task_profiler.h"
+#include "boot_sequencer.h"
+#include "alert_pool.h"
+#include "json_writer.h"
+#include "alert_coalescer.h"
+#include "mqtt_lanes.h"
+#include "alert_journal.h"
+#include "adc_acquisition.h"
 #include "wifi_config.h"
 #include "time_manager.h"
 #include "gsm_manager.h"
@@ -5155,6 +5172,13 @@ typedef enum {
 typedef struct {
     char topic[128];
     char payload[1024];  // Reduced from 2048
+    uint8_t qos;
+    bool persist;        // Kept in SPIFFS if it cannot be sent
+    uint8_t retries;
+    uint32_t seq;        // Alert journal sequence, 0 for untracked messages
+    int64_t sample_us;   // Alert latency trace, 0 for other messages
+    int64_t queued_us;
+    uint16_t len;        // Binary payload length, 0 for a text payload
 } mqtt_publish_message_t;
 
 
@@ -5391,7 +5415,8 @@ typedef struct {
     
     } data;
     
-    
+    // Fire response timestamps (fire alerts only, zero otherwise)
+    latency_trace_t trace;
     
 } Alert;
 
@@ -5456,6 +5481,10 @@ static bool certs_created = false;
 static esp_mqtt_client_handle_t mqtt_client = NULL;
 static bool mqtt_connected = false;
 
+// Boot milestones (esp_timer us since power-on, 0 = not reached)
+static int64_t bootArmedUs = 0;
+static int64_t bootConnectedUs = 0;
+
 // Profile from Shadow
 static int shadow_profile = 0;  // Profile received from shadow
 
@@ -5486,8 +5515,6 @@ extern PumpControl pumps[4];
 extern CurrentSensor currentSensors[4];
 extern bool doorOpen;
 extern bool waterLockout;
-extern float level_s, bat_v, sol_v;
-extern float ir_s1, ir_s2, ir_s3, ir_s4;
 extern bool emergencyStopActive; 
 
 
@@ -5587,27 +5614,117 @@ static int convert_profile_enum_to_number(SystemProfile profile) {
 
 // FreeRTOS Task Handles
 TaskHandle_t taskSensorHandle = NULL;
-TaskHandle_t taskFireDetectionHandle = NULL;
-TaskHandle_t taskPumpManagementHandle = NULL;
-TaskHandle_t taskWaterLockoutHandle = NULL;
+TaskHandle_t taskControlHandle = NULL;
+TaskHandle_t taskShadowReportHandle = NULL;
 TaskHandle_t taskMonitorHandle = NULL;
-TaskHandle_t taskDoorHandle = NULL;
-TaskHandle_t taskCommandHandle = NULL;
 TaskHandle_t taskMqttPublishHandle = NULL;
 TaskHandle_t taskStateMachineHandle = NULL;
 TaskHandle_t taskAlertHandle = NULL;
 
 // FreeRTOS Mutexes
-SemaphoreHandle_t mutexSensorData = NULL;
-SemaphoreHandle_t mutexPumpState = NULL;
-SemaphoreHandle_t mutexWaterState = NULL;
-SemaphoreHandle_t mutexSystemState = NULL;
+// Pump, water and system state belong to task_control (see control.h)
+SemaphoreHandle_t mutexSensorHistory = NULL;
 SemaphoreHandle_t alert_mutex = NULL;
 
+// Loop timing for the periodic tasks; each monitor is written by its own task
+typedef enum {
+    LOOP_SENSOR = 0,
+    LOOP_CONTROL,
+    LOOP_ALERT,
+    LOOP_STATE,
+    LOOP_MONITOR,
+    LOOP_COUNT
+} LoopId;
+static loop_monitor_t loopMonitors[LOOP_COUNT];
+
+// Stack and CPU profile of every task, sampled by the serial monitor task
+static task_profiler_t taskProfiler;
+
+// Multi-resolution sensor history (fixed ~54 KB), guarded by mutexSensorHistory
+static sensor_history_t sensorHistory;
+
 // Queues
-QueueHandle_t commandQueue = NULL;
 QueueHandle_t alert_queue = NULL;
-QueueHandle_t mqtt_publish_queue = NULL;
+
+// ==========================================
+// STATIC RTOS ALLOCATION
+// ==========================================
+// Long-lived tasks, queues and mutexes are reserved here from the sizes in
+// config.h, so they never take heap from WiFi/TLS/MQTT/cJSON. Each one is
+// registered with ram_budget for the boot report. The OTA and time sync
+// tasks are transient and stay on the heap.
+// StackType_t is one byte on ESP-IDF, so stack sizes are in bytes.
+#define STATIC_TASK(name, stackBytes) \
+    static StackType_t name##Stack[stackBytes]; \
+    static StaticTask_t name##Tcb
+
+STATIC_TASK(sensorTask, TASK_SENSOR_STACK_SIZE);
+STATIC_TASK(controlTask, TASK_CONTROL_STACK_SIZE);
+STATIC_TASK(shadowReportTask, TASK_SHADOW_REPORT_STACK_SIZE);
+STATIC_TASK(monitorTask, TASK_MONITOR_STACK_SIZE);
+STATIC_TASK(mqttPublishTask, TASK_MQTT_PUBLISH_STACK_SIZE);
+STATIC_TASK(stateMachineTask, TASK_STATE_MACHINE_STACK_SIZE);
+STATIC_TASK(alertTask, TASK_ALERT_STACK_SIZE);
+
+// Alerts are encoded into the pool; the queue carries 16-bit record handles
+static uint8_t alertQueueStorage[ALERT_QUEUE_SIZE * sizeof(alert_pool_handle_t)];
+static StaticQueue_t alertQueueBuf;
+static alert_pool_block_t alertPoolBlocks[ALERT_POOL_BLOCKS];
+static alert_pool_t alertPool;
+static portMUX_TYPE alertPoolLock = portMUX_INITIALIZER_UNLOCKED;
+static alert_coalescer_t alertCoalescer;   // Alert task only
+static alert_journal_t alertJournal;       // Guarded by alertJournalMutex
+static SemaphoreHandle_t alertJournalMutex = NULL;
+static StaticSemaphore_t alertJournalMutexBuf;
+
+// Outbound messages wait in slots, ordered by priority lane; see mqtt_lanes.h
+static mqtt_publish_message_t mqttLaneSlots[MQTT_PUBLISH_QUEUE_SIZE];
+static mqtt_lanes_t mqttLanes;                  // Guarded by mqttLaneMutex
+static SemaphoreHandle_t mqttLaneMutex = NULL;
+static SemaphoreHandle_t mqttLaneSignal = NULL; // Given on every enqueue
+static StaticSemaphore_t mqttLaneMutexBuf;
+static StaticSemaphore_t mqttLaneSignalBuf;
+
+static StaticSemaphore_t provisioningMutexBuf;
+static StaticSemaphore_t sensorHistoryMutexBuf;
+static StaticSemaphore_t alertMutexBuf;
+
+// Boot stages run on two workers; the RAM budget and profiler tables they
+// fill are guarded by bootMutex
+static SemaphoreHandle_t bootMutex = NULL;
+
+static void boot_lock(void) {
+    if (bootMutex) xSemaphoreTake(bootMutex, portMAX_DELAY);
+}
+
+static void boot_unlock(void) {
+    if (bootMutex) xSemaphoreGive(bootMutex);
+}
+
+static TaskHandle_t create_static_task(const char *subsystem, TaskFunction_t fn, const char *name,
+                                       StackType_t *stack, uint32_t stackSize, UBaseType_t priority,
+                                       StaticTask_t *tcb, BaseType_t core) {
+    boot_lock();
+    task_profiler_register(&taskProfiler, name, stackSize);
+    ram_budget_add_static(subsystem, stackSize + sizeof(StaticTask_t));
+    boot_unlock();
+    return xTaskCreateStaticPinnedToCore(fn, name, stackSize, NULL, priority, stack, tcb, core);
+}
+
+static QueueHandle_t create_static_queue(const char *subsystem, UBaseType_t length, UBaseType_t itemSize,
+                                         uint8_t *storage, StaticQueue_t *buf) {
+    boot_lock();
+    ram_budget_add_static(subsystem, length * itemSize + sizeof(StaticQueue_t));
+    boot_unlock();
+    return xQueueCreateStatic(length, itemSize, storage, buf);
+}
+
+static SemaphoreHandle_t create_static_mutex(const char *subsystem, StaticSemaphore_t *buf) {
+    boot_lock();
+    ram_budget_add_static(subsystem, sizeof(StaticSemaphore_t));
+    boot_unlock();
+    return xSemaphoreCreateMutexStatic(buf);
+}
 
 // ==========================================
 // FORWARD DECLARATIONS
@@ -5616,16 +5733,25 @@ static esp_err_t mqtt_connect(const char *client_id, const char *cert, const cha
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
                                       int32_t event_id, void *event_data);
 static void subscribe_to_topics(void);
+static void request_sensor_history(int tier);
+static void serve_history_export(void);
 static void send_registration(void);
 static void send_heartbeat(void);
 void send_ota_alert(const char *otastatus, const char *version);
 static void send_system_status(void);
+static void send_diagnostics(void);
+static void send_task_profile(void);
 bool enqueue_mqtt_publish(const char *topic, const char *payload);
+static bool enqueue_mqtt_publish_lane(const char *topic, const char *payload, mqtt_lane_t lane,
+                                      int qos, bool persist, const latency_trace_t *trace, uint32_t seq);
+static bool enqueue_mqtt_publish_blob(const char *topic, const uint8_t *data, size_t len, mqtt_lane_t lane);
+static void serve_mqtt_lanes(mqtt_lane_t below);
 static void check_provisioning_status(void);
 static esp_err_t start_provisioning(void);
 static void get_mac_address(void);
 void display_system_status(void);
 static void update_shadow_state(void);
+static void request_shadow_report(void);
 static SystemProfile convert_profile_number_to_enum(int profile_num);
 static int convert_profile_enum_to_number(SystemProfile profile);
 static void perform_periodic_tasks(void);
@@ -5636,6 +5762,7 @@ static void check_and_reset_start_all_pumps(void);
 static void check_battery_status(void);
 
 // Alert System Functions
+static void init_alert_queue(void);
 static void init_alert_system(void);
 static void check_state_changes(void);
 static void monitor_fire_sectors(void);
@@ -5689,6 +5816,7 @@ void send_alert_solar_fault(float solarVoltage, const char* reason);
 void send_alert_provisioning_failed(const char* reason, int retryCount);
 void send_alert_state_corruption(int pumpIndex, int corruptValue);
 void send_alert_task_failure(const char* taskName, const char* reason);
+static void send_alert_task_deadline_miss(const loop_monitor_t *monitor);
 // Memory optimization functions
 static void clear_mqtt_outbox(void);
 static char* create_compact_json_string(cJSON *json);
@@ -5696,15 +5824,18 @@ static char* create_compact_json_string(cJSON *json);
 // System Tasks
 void task_serial_monitor(void *parameter);
 void task_sensor_reading(void *parameter);
-void task_fire_detection(void *parameter);
-void task_pump_management(void *parameter);
-void task_water_lockout(void *parameter);
-void task_door_monitoring(void *parameter);
-void task_command_processor(void *parameter);
+void task_control(void *parameter);
+void task_shadow_report(void *parameter);
+#ifdef CONFIG_FIRE_JITTER_MEASURE
+static void print_detect_jitter(void);
+#endif
 void task_mqtt_publish(void *parameter);
 void task_state_machine(void *parameter);
-static void store_alert_to_spiffs(const char* topic, const char* payload);
+static esp_err_t store_alert_to_spiffs(const char* topic, const char* payload);
+static esp_err_t store_alert_to_spiffs_seq(const char* topic, const char* payload, uint32_t seq);
+static void park_alert_seq(uint32_t seq);
 static void send_pending_alerts_from_storage(void);
+static void request_pending_alert_replay(void);
 static void check_and_send_pending_alerts(bool force_check);
 
 void debug_wifi_status(void);
@@ -5870,20 +6001,196 @@ static char* create_compact_json_string(cJSON *json) {
     return json_str;
 }
 
+// Frequent messages (alerts, heartbeat, status, shadow) are written with
+// json_writer straight into fixed buffers; output matches the cJSON path.
+#define JSON_BUFFER_SIZE    (MAX_JSON_PAYLOAD_SIZE + 1)
+
+// Root fields shared by device event messages; leaves the root object open
+static void json_begin_event(json_writer_t *w, const char *event, const char *timestamp) {
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "macAddress", mac_address);
+    json_writer_string(w, "event", event);
+    json_writer_string(w, "devicetype", "G");
+    json_writer_string(w, "timestamp", timestamp);
+}
+
+// Close the root object; false (and a log line) if the message did not fit
+static bool json_end(json_writer_t *w, const char *what) {
+    json_writer_end_object(w);
+    if (json_writer_finish(w) == 0) {
+        printf("\n[JSON] %s payload too large (%d bytes), dropped", what, (int)json_writer_needed(w));
+        return false;
+    }
+    return true;
+}
+
+// ========================================
+// ALERT DELIVERY JOURNAL
+// ========================================
+// Each alert gets a sequence number and one SPIFFS copy, removed only on
+// PUBACK (MQTT_EVENT_PUBLISHED); see alert_journal.h. The sequence block
+// and the acknowledged watermark are kept in NVS.
+
+static void journal_lock(void) {
+    xSemaphoreTake(alertJournalMutex, portMAX_DELAY);
+}
+
+static void journal_unlock(void) {
+    xSemaphoreGive(alertJournalMutex);
+}
+
+static void save_alert_journal_value(const char *key, uint32_t value) {
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open("alert_journal", NVS_READWRITE, &nvs_handle);
+    if (err == ESP_OK) {
+        nvs_set_u32(nvs_handle, key, value);
+        nvs_commit(nvs_handle);
+        nvs_close(nvs_handle);
+    } else {
+        printf("\n[ALERT] Failed to save journal %s: %s", key, esp_err_to_name(err));
+    }
+}
+
+static void init_alert_journal(void) {
+    uint32_t reserved = 0;
+    uint32_t acked = 0;
+    nvs_handle_t nvs_handle;
+    if (nvs_open("alert_journal", NVS_READONLY, &nvs_handle) == ESP_OK) {
+        nvs_get_u32(nvs_handle, "reserved", &reserved);
+        nvs_get_u32(nvs_handle, "acked", &acked);
+        nvs_close(nvs_handle);
+    }
+    alert_journal_init(&alertJournal, reserved, acked);
+    boot_lock();
+    ram_budget_add_static("Alerts", sizeof(alertJournal));
+    boot_unlock();
+    alertJournalMutex = create_static_mutex("Alerts", &alertJournalMutexBuf);
+    printf("\n[ALERT] Journal resumes at seq %lu (acknowledged through %lu)",
+           (unsigned long)alertJournal.next_seq, (unsigned long)acked);
+}
+
+// Returns 0 when every journal slot is taken; the alert then goes out untracked
+static uint32_t open_alert_seq(void) {
+    if (!alertJournalMutex) return 0;
+    
+    bool reserve;
+    journal_lock();
+    uint32_t seq = alert_journal_open(&alertJournal, &reserve);
+    uint32_t reserved = alertJournal.reserved_seq;
+    journal_unlock();
+    
+    // Persist the new block before any number from it is used
+    if (reserve) {
+        save_alert_journal_value("reserved", reserved);
+    }
+    return seq;
+}
+
+static alert_journal_state_t alert_seq_state(uint32_t seq) {
+    if (seq == 0 || !alertJournalMutex) return ALERT_JOURNAL_FREE;
+    journal_lock();
+    alert_journal_state_t state = alert_journal_state(&alertJournal, seq);
+    journal_unlock();
+    return state;
+}
+
+static void mark_alert_stored(uint32_t seq) {
+    if (seq == 0 || !alertJournalMutex) return;
+    journal_lock();
+    alert_journal_stored(&alertJournal, seq);
+    journal_unlock();
+}
+
+static void mark_alert_sent(uint32_t seq, int msg_id) {
+    if (seq == 0 || !alertJournalMutex) return;
+    journal_lock();
+    alert_journal_sent(&alertJournal, seq, msg_id, esp_timer_get_time() / 1000);
+    journal_unlock();
+}
+
+// Live send given up: the SPIFFS copy is left for the backlog replay
+static void park_alert_seq(uint32_t seq) {
+    if (seq == 0 || !alertJournalMutex) return;
+    journal_lock();
+    alert_journal_park(&alertJournal, seq);
+    journal_unlock();
+}
+
+static void settle_alert_watermark(uint32_t lowest_stored) {
+    journal_lock();
+    bool moved = alert_journal_settle(&alertJournal, lowest_stored);
+    uint32_t acked = alertJournal.acked_seq;
+    journal_unlock();
+    
+    if (moved) {
+        save_alert_journal_value("acked", acked);
+    }
+}
+
+/**
+ * @brief Remove acknowledged alerts from SPIFFS and give up on lost PUBACKs
+ *
+ * Runs on the publish task, so flash writes stay off the MQTT event task.
+ * Every acknowledged alert goes in one rewrite of the alerts file, after
+ * the emergency and critical lanes have been served. A replayed alert with
+ * no PUBACK counts as a failed retry, so it is not resent forever.
+ */
+static void settle_alert_journal(void) {
+    if (!alertJournalMutex) return;
+    
+    uint32_t seqs[ALERT_JOURNAL_SLOTS];
+    uint32_t replayed[ALERT_JOURNAL_SLOTS];
+    int count = 0;
+    int replayed_count;
+    
+    journal_lock();
+    int expired = alert_journal_expire(&alertJournal, esp_timer_get_time() / 1000, ALERT_ACK_TIMEOUT_MS,
+                                       replayed, &replayed_count);
+    while (count < ALERT_JOURNAL_SLOTS) {
+        uint32_t seq = alert_journal_take_acked(&alertJournal);
+        if (seq == 0) break;
+        seqs[count++] = seq;
+    }
+    journal_unlock();
+    
+    if (expired > 0) {
+        printf("\n[ALERT] No PUBACK for %d alert(s), left to the backlog replay", expired);
+    }
+    esp_err_t retry_ret = replayed_count > 0 ? spiffs_increment_alert_retry_seqs(replayed, replayed_count) : ESP_OK;
+    if (retry_ret != ESP_OK && retry_ret != ESP_ERR_NOT_FOUND) {
+        printf("\n[ALERT] Failed to increment retry counter for %d replayed alert(s)", replayed_count);
+    }
+    if (count == 0) return;
+    
+    // Urgent alerts must not wait behind the flash rewrite
+    serve_mqtt_lanes(MQTT_LANE_NORMAL);
+    
+    uint32_t lowest_stored;
+    if (spiffs_remove_alert_seqs(seqs, count, &lowest_stored) == ESP_OK) {
+        settle_alert_watermark(lowest_stored);
+    } else {
+        printf("\n[ALERT] Failed to remove %d delivered alert(s) from storage", count);
+    }
+}
+
 /**
  * @brief Store alert to SPIFFS with topic information
  */
-static void store_alert_to_spiffs(const char* topic, const char* payload) {
+static esp_err_t store_alert_to_spiffs(const char* topic, const char* payload) {
+    return store_alert_to_spiffs_seq(topic, payload, 0);
+}
+
+static esp_err_t store_alert_to_spiffs_seq(const char* topic, const char* payload, uint32_t seq) {
     if (!topic || !payload || strlen(topic) == 0 || strlen(payload) == 0) {
         printf("\n[ALERT] Cannot store empty alert to SPIFFS");
-        return;
+        return ESP_ERR_INVALID_ARG;
     }
     
     printf("\n[ALERT] Storing alert to persistent storage (SPIFFS)");
     printf("\n[ALERT] Topic: %s", topic);
     printf("\n[ALERT] Payload size: %d bytes", strlen(payload));
     
-    esp_err_t ret = spiffs_store_alert(topic, payload);
+    esp_err_t ret = spiffs_store_alert_seq(topic, payload, seq);
     if (ret == ESP_OK) {
         printf("\n[ALERT] Alert stored successfully to SPIFFS");
         
@@ -5894,16 +6201,34 @@ static void store_alert_to_spiffs(const char* topic, const char* payload) {
         printf("\n[ALERT] ERROR: Failed to store alert to SPIFFS: %s", 
                esp_err_to_name(ret));
     }
+    return ret;
+}
+
+// Set by other tasks; the publish task runs the replay on its next round
+static volatile bool pendingReplayRequested = false;
+
+static void request_pending_alert_replay(void) {
+    pendingReplayRequested = true;
+    if (mqttLaneSignal) {
+        xSemaphoreGive(mqttLaneSignal);
+    }
 }
 
 /**
  * @brief Send all pending alerts from SPIFFS storage
+ *
+ * Publish task only: it serves the lanes between sends, so no other task
+ * may drain them. Other tasks call request_pending_alert_replay().
  */
 static void send_pending_alerts_from_storage(void) {
     if (!mqtt_connected || !mqtt_client) {
         printf("\n[ALERT] Cannot send pending alerts - MQTT not connected");
         return;
     }
+    if (!alertJournalMutex) {
+        printf("\n[ALERT] Cannot send pending alerts - journal not ready");
+        return;
+    }
     
     printf("\n[ALERT] Checking for pending alerts in SPIFFS storage...");
     
@@ -5923,15 +6248,38 @@ static void send_pending_alerts_from_storage(void) {
     
     printf("\n[ALERT] Found %d pending alerts, attempting to send...", alert_count);
     
-    cJSON *sent_indices = cJSON_CreateArray();
+    // Entries are named by storage id: other tasks change the file while
+    // this runs, so array indices would not stay valid
+    uint32_t done_ids[MAX_ALERTS_IN_STORAGE];
+    int done_count = 0;
     int sent_count = 0;
     int failed_count = 0;
     int discarded_count = 0;
+    int skipped_count = 0;
+    
+    journal_lock();
+    uint32_t acked_seq = alertJournal.acked_seq;
+    journal_unlock();
     
     for (int i = 0; i < alert_count; i++) {
+        // Live traffic goes first; the backlog only fills the gaps
+        serve_mqtt_lanes(MQTT_LANE_BULK);
+        
         cJSON *alert = cJSON_GetArrayItem(pending_alerts, i);
         if (!alert) continue;
         
+        cJSON *id_obj = cJSON_GetObjectItem(alert, "id");
+        cJSON *seq_obj = cJSON_GetObjectItem(alert, "seq");
+        uint32_t id = cJSON_IsNumber(id_obj) ? (uint32_t)id_obj->valuedouble : 0;
+        uint32_t seq = cJSON_IsNumber(seq_obj) ? (uint32_t)seq_obj->valuedouble : 0;
+        if (id == 0) continue;
+        
+        // Acknowledged before a reboot, removal did not happen
+        if (seq != 0 && seq <= acked_seq) {
+            done_ids[done_count++] = id;
+            continue;
+        }
+        
         // Check retry count
         cJSON *retry_obj = cJSON_GetObjectItem(alert, "retry_count");
         int retry_count = retry_obj ? retry_obj->valueint : 0;
@@ -5940,8 +6288,7 @@ static void send_pending_alerts_from_storage(void) {
             printf("\n[ALERT] Alert %d exceeded max retries (%d), marking for removal", 
                    i, MAX_ALERT_RETRIES);
             // Mark for removal
-            cJSON *index = cJSON_CreateNumber(i);
-            cJSON_AddItemToArray(sent_indices, index);
+            done_ids[done_count++] = id;
             discarded_count++;
             continue;
         }
@@ -5960,6 +6307,22 @@ static void send_pending_alerts_from_storage(void) {
         
         if (!topic || !payload) continue;
         
+        // Skip alerts whose live copy is still queued or waiting for PUBACK
+        if (seq != 0) {
+            journal_lock();
+            bool live = alert_journal_state(&alertJournal, seq) != ALERT_JOURNAL_FREE;
+            bool tracked = !live && alert_journal_track(&alertJournal, seq);
+            journal_unlock();
+            if (live) {
+                skipped_count++;
+                continue;
+            }
+            if (!tracked) {
+                printf("\n[ALERT] Alert journal full, rest of the backlog waits");
+                break;
+            }
+        }
+        
         // Try to send
         printf("\n[ALERT] Sending pending alert %d/%d (retry %d)...", 
                i+1, alert_count, retry_count);
@@ -5970,50 +6333,59 @@ static void send_pending_alerts_from_storage(void) {
             printf("\n[ALERT] Pending alert sent successfully (msg_id: %d)", msg_id);
             sent_count++;
             
-            // Mark for removal from storage
-            cJSON *index = cJSON_CreateNumber(i);
-            cJSON_AddItemToArray(sent_indices, index);
+            // Journalled alerts stay stored until their PUBACK
+            if (seq != 0) {
+                mark_alert_sent(seq, msg_id);
+            } else {
+                done_ids[done_count++] = id;
+            }
             
-            // Small delay between sends to prevent flooding
-            vTaskDelay(pdMS_TO_TICKS(200));
+            // Small delay between sends to prevent flooding; a new message
+            // ends the wait early and is sent before the next stored one
+            if (mqttLaneSignal) {
+                xSemaphoreTake(mqttLaneSignal, pdMS_TO_TICKS(200));
+            } else {
+                vTaskDelay(pdMS_TO_TICKS(200));
+            }
         } else {
             printf("\n[ALERT] Failed to send pending alert (error: %d)", msg_id);
             failed_count++;
+            park_alert_seq(seq);
             
             // Increment retry counter in storage
-            esp_err_t retry_ret = spiffs_increment_alert_retry(i);
+            esp_err_t retry_ret = spiffs_increment_alert_retry_id(id);
             if (retry_ret != ESP_OK) {
                 printf("\n[ALERT] Failed to increment retry counter for alert %d", i);
             }
         }
     }
     
-    // Remove successfully sent alerts from storage
-    int sent_indices_count = cJSON_GetArraySize(sent_indices);
-    if (sent_indices_count > 0) {
-        esp_err_t ret = spiffs_remove_sent_alerts(sent_indices, sent_indices_count);
-        if (ret == ESP_OK) {
-            printf("\n[ALERT] Successfully removed %d alerts from storage", sent_indices_count);
-        } else {
-            printf("\n[ALERT] Failed to remove sent alerts from storage");
+    // Remove sent and resolved alerts; the lowest sequence left bounds the watermark
+    uint32_t lowest_stored;
+    if (spiffs_remove_alert_ids(done_ids, done_count, &lowest_stored) == ESP_OK) {
+        if (done_count > 0) {
+            printf("\n[ALERT] Successfully removed %d alerts from storage", done_count);
         }
+        settle_alert_watermark(lowest_stored);
+    } else {
+        printf("\n[ALERT] Failed to remove sent alerts from storage");
     }
     
-    cJSON_Delete(sent_indices);
     cJSON_Delete(pending_alerts);
     
     printf("\n[ALERT] Pending alerts processing complete:");
     printf("\n[ALERT]   Sent: %d", sent_count);
+    printf("\n[ALERT]   Skipped (live copy in flight): %d", skipped_count);
     printf("\n[ALERT]   Failed: %d", failed_count);
     printf("\n[ALERT]   Discarded (max retries): %d", discarded_count);
-    printf("\n[ALERT]   Remaining in storage: %d", alert_count - sent_count - discarded_count);
+    printf("\n[ALERT]   Remaining in storage: %d (sent ones until PUBACK)", alert_count - done_count);
     
     // Print updated summary
     spiffs_print_alert_summary();
 }
 
 /**
- * @brief Check and send pending alerts based on conditions
+ * @brief Ask the publish task to send pending alerts based on conditions
  * @param force_check If true, check immediately regardless of timing
  */
 static void check_and_send_pending_alerts(bool force_check) {
@@ -6039,7 +6411,7 @@ static void check_and_send_pending_alerts(bool force_check) {
     
     if (should_check && mqtt_connected && mqtt_client) {
         last_check_time = current_time;
-        send_pending_alerts_from_storage();
+        request_pending_alert_replay();
     }
 }
 
@@ -6207,8 +6579,7 @@ static void check_and_reset_start_all_pumps(void) {
            startAllPumpsActive = false;
             
             // ✅ IMPORTANT: Update shadow immediately (event-driven)
-            vTaskDelay(pdMS_TO_TICKS(100));
-            update_shadow_state();
+            request_shadow_report();
         }
     }
 }
@@ -6298,23 +6669,18 @@ static bool process_shadow_delta(cJSON *state) {
         state_changed = true;
     }
     
+    // State changes run on the control task; each call returns once applied
+    ControlSnapshot snap;
+    control_snapshot_read(&snap);
+    
     // 1. PROFILE CHANGE
     cJSON *currentProfileJson = cJSON_GetObjectItem(state, "currentProfile");
     if (currentProfileJson) {
         int profileNum = (int)cJSON_GetNumberValue(currentProfileJson);
-        SystemProfile newProfile = convert_profile_number_to_enum(profileNum);
         
-        if (xSemaphoreTake(mutexSystemState, pdMS_TO_TICKS(100)) == pdTRUE) {
-            if (newProfile != currentProfile) {
-                apply_system_profile(newProfile);
-                shadow_profile = profileNum;
-                state_changed = true;
-                
-                char alert_msg[128];
-                snprintf(alert_msg, sizeof(alert_msg),
-                        "Profile changed to %s via shadow", profiles[newProfile].name);
-            }
-            xSemaphoreGive(mutexSystemState);
+        SystemCommand cmd = { .type = CMD_CHANGE_PROFILE, .profileValue = (SystemProfile)profileNum };
+        if (control_call(&cmd)) {
+            state_changed = true;
         }
     }
     
@@ -6323,20 +6689,10 @@ static bool process_shadow_delta(cJSON *state) {
     if (emergencyStopJson) {
         bool stopCommand = cJSON_IsTrue(emergencyStopJson);
                
-        if (stopCommand != emergencyStopActive) {
-            if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-                if (xSemaphoreTake(mutexSystemState, pdMS_TO_TICKS(50)) == pdTRUE) {
-                    process_shadow_emergency_stop(stopCommand);
-                    state_changed = true;
-                    
-                    char alert_msg[128];
-                    snprintf(alert_msg, sizeof(alert_msg),
-                            "EMERGENCY STOP %s via shadow",
-                            stopCommand ? "ACTIVATED" : "DEACTIVATED");
-                    
-                    xSemaphoreGive(mutexSystemState);
-                }
-                xSemaphoreGive(mutexPumpState);
+        if (stopCommand != snap.emergencyStop) {
+            SystemCommand cmd = { .type = CMD_EMERGENCY_STOP, .value = stopCommand ? 1 : 0 };
+            if (control_call(&cmd)) {
+                state_changed = true;
             }
         }
     }
@@ -6348,42 +6704,28 @@ static bool process_shadow_delta(cJSON *state) {
                 
         if (resetCommand) {
             
-            if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-                if (xSemaphoreTake(mutexSystemState, pdMS_TO_TICKS(50)) == pdTRUE) {
-                    if (xSemaphoreTake(mutexWaterState, pdMS_TO_TICKS(50)) == pdTRUE) {
-                        
-                        reset_system_to_defaults();
-                        
-                        // Reset shadow tracking
-                        startAllPumpsActive = false;
-                        emergencyStopActive = false;
-                        last_shadow_profile = -1;
-                        last_shadow_emergency_stop = false;
-                        last_shadow_start_all_pumps = false;
-                        for (int i = 0; i < 4; i++) {
-                            last_shadow_pump_manual[i] = false;
-                            last_shadow_manual_mode[i] = false;
-                            last_shadow_extend_time[i] = -1;
-                            last_reported_extend_time[i] = -1;
-                            last_shadow_stop_pump[i] = false;
-                            pending_extend_ack[i] = -1;
-                            previous_extend_time[i] = -1;
-                        }
-                        
-                        state_changed = true;
-                        
-                        char alert_msg[128];
-                        snprintf(alert_msg, sizeof(alert_msg),
-                                "SYSTEM RESET COMPLETE - All defaults restored");
-                        // Clear pending alerts on system reset
-						spiffs_clear_all_alerts();
-						printf("\n[SYSTEM] Cleared all pending alerts from storage");       
-                        send_alert_system_reset();
-                        xSemaphoreGive(mutexWaterState);
-                    }
-                    xSemaphoreGive(mutexSystemState);
+            SystemCommand cmd = { .type = CMD_SYSTEM_RESET };
+            if (control_call(&cmd)) {
+                // Reset shadow tracking
+                last_shadow_profile = -1;
+                last_shadow_emergency_stop = false;
+                last_shadow_start_all_pumps = false;
+                for (int i = 0; i < 4; i++) {
+                    last_shadow_pump_manual[i] = false;
+                    last_shadow_manual_mode[i] = false;
+                    last_shadow_extend_time[i] = -1;
+                    last_reported_extend_time[i] = -1;
+                    last_shadow_stop_pump[i] = false;
+                    pending_extend_ack[i] = -1;
+                    previous_extend_time[i] = -1;
                 }
-                xSemaphoreGive(mutexPumpState);
+                
+                state_changed = true;
+                
+                // Clear pending alerts on system reset
+                spiffs_clear_all_alerts();
+                printf("\n[SYSTEM] Cleared all pending alerts from storage");       
+                send_alert_system_reset();
             }
             
             // Force immediate acknowledgement
@@ -6397,36 +6739,15 @@ static bool process_shadow_delta(cJSON *state) {
     if (startAllPumpsJson) {
         bool desiredStartAllPumps = cJSON_IsTrue(startAllPumpsJson);
         
-        if (desiredStartAllPumps != startAllPumpsActive) {
-            if (desiredStartAllPumps) {
-                
-                if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-                    if (xSemaphoreTake(mutexWaterState, pdMS_TO_TICKS(50)) == pdTRUE) {
-                        bool result = shadow_manual_activate_all_pumps();
-                        
-                        if (result) {
-                            startAllPumpsActive = true;
-                            startAllPumpsActivationTime = xTaskGetTickCount();
-                            state_changed = true;
-                            
-                            update_shadow_state();
-                            
-                            char alert_msg[128];
-                            snprintf(alert_msg, sizeof(alert_msg),
-                                    "ALL PUMPS activated via startAllPumps");
-                            
-                        }
-                        xSemaphoreGive(mutexWaterState);
-                    }
-                    xSemaphoreGive(mutexPumpState);
-                }
-            } else {
-                
-                if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-                    shadow_manual_stop_all_pumps();
-                    startAllPumpsActive = false;
-                    state_changed = true;
-                    xSemaphoreGive(mutexPumpState);
+        control_snapshot_read(&snap);
+        if (desiredStartAllPumps != snap.startAllPumps) {
+            SystemCommand cmd = {
+                .type = desiredStartAllPumps ? CMD_SHADOW_START_ALL : CMD_SHADOW_STOP_ALL
+            };
+            if (control_call(&cmd)) {
+                state_changed = true;
+                if (desiredStartAllPumps) {
+                    update_shadow_state();
                 }
             }
         }
@@ -6450,17 +6771,8 @@ static bool process_shadow_delta(cJSON *state) {
 					
 					if(stopPumpvalue){
 						//Process STOP Command
-						if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-                            extern bool shadow_manual_stop_pump_override_timer(int index);
-                            shadow_manual_stop_pump_override_timer(i);
-
-                            char alert_msg[128];
-                            snprintf(alert_msg, sizeof(alert_msg),
-                                    "User stopped %s via stopPump button", pumps[i].name);
-                            
-
-                            xSemaphoreGive(mutexPumpState);
-                        }
+						SystemCommand cmd = { .type = CMD_SHADOW_STOP_PUMP, .pumpIndex = i };
+						control_call(&cmd);
                         continue;
                         
 					}
@@ -6474,10 +6786,10 @@ static bool process_shadow_delta(cJSON *state) {
             
             
             //  CHECK IF PUMP IS TIMER-PROTECTED
-            if (pumps[i].timerProtected && !is_timer_expired(i)) {
-                unsigned long remaining = get_timer_remaining(i);
+            control_snapshot_read(&snap);
+            if (snap.pumps[i].timerActive) {
                 printf("\n[SHADOW] %s is TIMER-PROTECTED (%lu seconds remaining) - IGNORING manualMode changes",
-                       pumpNames[i], remaining);
+                       pumpNames[i], snap.pumps[i].timerRemainingS);
                 
                 // ONLY SKIP manualMode - Still process extendTime below!
             } else {
@@ -6485,7 +6797,7 @@ static bool process_shadow_delta(cJSON *state) {
 	cJSON *manualModeJson = cJSON_GetObjectItem(pumpObj, "manualMode");
 	if (manualModeJson) {
 	    bool desiredManualMode = cJSON_IsTrue(manualModeJson);
-	    bool currentManualMode = (pumps[i].state == PUMP_MANUAL_ACTIVE);
+	    bool currentManualMode = (snap.pumps[i].state == PUMP_MANUAL_ACTIVE);
 	    
 	    printf("\n[SHADOW] %s manualMode desired=%s, current=%s", 
 	           pumpNames[i],
@@ -6503,21 +6815,9 @@ static bool process_shadow_delta(cJSON *state) {
 	        
 	        // Only control hardware if going from false -> true
 	        if (desiredManualMode && !currentManualMode) {
-	            // Activate pump in hardware
-	            if (startAllPumpsActive) {
-	                printf("\n[SHADOW] BLOCKED: Cannot activate %s - startAllPumps active",
-	                       pumpNames[i]);
-	            } else if (can_activate_pump_manually(i)) {
-	                if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-	                    if (shadow_manual_activate_pump(i)) {
-	                        char alert_msg[128];
-	                        snprintf(alert_msg, sizeof(alert_msg),
-	                                "Manual activation: %s", pumps[i].name);
-	                       
-	                    }
-	                    xSemaphoreGive(mutexPumpState);
-	                }
-	            }
+	            // Activate pump in hardware (refused while startAllPumps is active)
+	            SystemCommand cmd = { .type = CMD_SHADOW_MANUAL_PUMP, .pumpIndex = i };
+	            control_call(&cmd);
 	        }
 	        // ✅ If going from true -> false, just acknowledge (don't stop pump)
 	        else if (!desiredManualMode && currentManualMode) {
@@ -6539,33 +6839,19 @@ static bool process_shadow_delta(cJSON *state) {
 	               pumpNames[i], last_shadow_extend_time[i], extendValue);
 	        
 	        // Only process extensions (0-3), not -1
-	        if (extendValue >= 0 && extendValue <= 3 && pumps[i].timerProtected) {
+	        if (extendValue >= 0 && extendValue <= 3 && snap.pumps[i].timerProtected) {
 	            printf("\n[SHADOW] Processing extension request for %s: code=%d", 
 	                   pumpNames[i], extendValue);
 	            
-	            if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-	                unsigned long extensionMs = get_duration_from_code(extendValue);
-	                
-	                if (extensionMs > 0) {
-					    // Get the current remaining time before extending
-					    unsigned long remaining = get_timer_remaining(i);
-					    
-					    extend_timer_protection(i, extensionMs);
-					    
-					    last_shadow_extend_time[i] = extendValue;
-					    last_reported_extend_time[i] = extendValue;
-					    state_changed = true;
-					    
-					    char alert_msg[128];
-					    snprintf(alert_msg, sizeof(alert_msg),
-					            "Extended %s by %s", 
-					            pumps[i].name, 
-					            get_duration_code_string(extendValue));
-					    send_alert_pump_extend_time(i, extensionMs / 1000, (int)remaining);              
-	                    printf("\n[SHADOW] %s: Extension applied, will report back extendTime=%d\n",
-	                           pumpNames[i], extendValue);
-	                }
-	                xSemaphoreGive(mutexPumpState);
+	            SystemCommand cmd = {
+	                .type = CMD_SHADOW_EXTEND_TIME, .pumpIndex = i, .value = (unsigned long)extendValue
+	            };
+	            if (control_call(&cmd)) {
+	                last_shadow_extend_time[i] = extendValue;
+	                last_reported_extend_time[i] = extendValue;
+	                state_changed = true;
+	                printf("\n[SHADOW] %s: Extension applied, will report back extendTime=%d\n",
+	                       pumpNames[i], extendValue);
 	            }
 	        }
 	        // ✅ When user sets back to -1, acknowledge it
@@ -6959,6 +7245,11 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
         case MQTT_EVENT_CONNECTED:
             printf("\n[MQTT] Connected to AWS IoT");
             mqtt_connected = true;
+            if (bootConnectedUs == 0) {
+                bootConnectedUs = esp_timer_get_time();
+                printf("\n[BOOT] Connected at %lld ms (armed at %lld ms)",
+                       (long long)(bootConnectedUs / 1000), (long long)(bootArmedUs / 1000));
+            }
             
             if (provisioning_state == PROV_STATE_CONNECTING) {
                 printf("\n[PROV] Provisioning mode - ready for certificate request");
@@ -7331,22 +7622,21 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
 				        }
         
 				        // Build reported state matching desired state
-				        if (xSemaphoreTake(mutexSystemState, pdMS_TO_TICKS(100)) == pdTRUE) {
-				            // Profile
-				            int profileNum = convert_profile_enum_to_number(currentProfile);
-				            cJSON_AddNumberToObject(ack_reported, "currentProfile", profileNum);
-				            
-				            // Emergency stop
-				            cJSON_AddBoolToObject(ack_reported, "emergencyStop", emergencyStopActive);
-				            
-				            // System reset
-				            cJSON_AddBoolToObject(ack_reported, "systemReset", false);
-				            
-				            // Report current startAllPumps state
-				            cJSON_AddBoolToObject(ack_reported, "startAllPumps", startAllPumpsActive);
-				            
-				            xSemaphoreGive(mutexSystemState);
-				        }
+				        ControlSnapshot snap;
+				        control_snapshot_read(&snap);
+				        
+				        // Profile
+				        int profileNum = convert_profile_enum_to_number(snap.profile);
+				        cJSON_AddNumberToObject(ack_reported, "currentProfile", profileNum);
+				        
+				        // Emergency stop
+				        cJSON_AddBoolToObject(ack_reported, "emergencyStop", snap.emergencyStop);
+				        
+				        // System reset
+				        cJSON_AddBoolToObject(ack_reported, "systemReset", false);
+				        
+				        // Report current startAllPumps state
+				        cJSON_AddBoolToObject(ack_reported, "startAllPumps", snap.startAllPumps);
 				        
 				        // Pump states
 				        const char* pumpNames[4] = {"NorthPump", "SouthPump", "EastPump", "WestPump"};
@@ -7408,6 +7698,11 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
                 else if (strstr(topic, "RegistrationDevice") != NULL) {
 					    handle_cloud_response(topic, event->data);
 					}
+                else if (strstr(topic, "/HistoryRequest") != NULL) {
+                    // {"tier":0|1|2}, default tier 0 (1 s rows)
+                    cJSON *tier = cJSON_GetObjectItem(json, "tier");
+                    request_sensor_history(cJSON_IsNumber(tier) ? tier->valueint : 0);
+                }
 				
                 else if (strstr(topic, "/shadow/get/accepted") != NULL) {
                     printf("\n[SHADOW] Get accepted - shadow retrieved");
@@ -7471,6 +7766,15 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
 
         case MQTT_EVENT_PUBLISHED:
             printf("\n[MQTT] Published, msg_id=%d", event->msg_id);
+            // PUBACK: the only point at which an alert counts as delivered
+            if (alertJournalMutex) {
+                journal_lock();
+                bool delivered = alert_journal_acked(&alertJournal, event->msg_id);
+                journal_unlock();
+                if (delivered) {
+                    printf("\n[ALERT] Delivery acknowledged (msg_id=%d)", event->msg_id);
+                }
+            }
             break;
 
         case MQTT_EVENT_BEFORE_CONNECT:
@@ -7498,23 +7802,26 @@ static void update_shadow_state(void) {
         return;
     }
     
+    ControlSnapshot snap;
+    control_snapshot_read(&snap);
+    
    // ✅ DETECT CHANGES
     bool changes_detected = false;
     
-    int current_profile = convert_profile_enum_to_number(currentProfile);
+    int current_profile = convert_profile_enum_to_number(snap.profile);
     if (current_profile != last_shadow_profile) {
         changes_detected = true;
         last_shadow_profile = current_profile;
     }
     
-    if (emergencyStopActive != last_shadow_emergency_stop) {
+    if (snap.emergencyStop != last_shadow_emergency_stop) {
         changes_detected = true;
-        last_shadow_emergency_stop = emergencyStopActive;
+        last_shadow_emergency_stop = snap.emergencyStop;
     }
     
-    if (startAllPumpsActive != last_shadow_start_all_pumps) {
+    if (snap.startAllPumps != last_shadow_start_all_pumps) {
         changes_detected = true;
-        last_shadow_start_all_pumps = startAllPumpsActive;
+        last_shadow_start_all_pumps = snap.startAllPumps;
     }
     
     // ✅ NEW: Check for manualMode changes that need reporting
@@ -7553,41 +7860,28 @@ static void update_shadow_state(void) {
     }
     
     // Create shadow update JSON
-    cJSON *root = cJSON_CreateObject();
-    if (!root) {
-        printf("\n[SHADOW] Failed to create JSON root");
-        return;
-    }
-    
-    cJSON *state = cJSON_AddObjectToObject(root, "state");
-    if (!state) {
-        cJSON_Delete(root);
-        printf("\n[SHADOW] Failed to create state object");
-        return;
-    }
-    
-    cJSON *reported = cJSON_AddObjectToObject(state, "reported");
-    if (!reported) {
-        cJSON_Delete(root);
-        printf("\n[SHADOW] Failed to create reported object");
-        return;
-    }
+    char json_str[SHADOW_JSON_BUFFER_SIZE];
+    json_writer_t w;
+    json_writer_init(&w, json_str, sizeof(json_str));
+    json_writer_begin_object(&w, NULL);
+    json_writer_begin_object(&w, "state");
+    json_writer_begin_object(&w, "reported");
     
     // Essential fields
-    int profileNum = convert_profile_enum_to_number(currentProfile);
+    int profileNum = convert_profile_enum_to_number(snap.profile);
     
-    cJSON_AddNumberToObject(reported, "currentProfile", profileNum);
-    cJSON_AddBoolToObject(reported, "emergencyStop", emergencyStopActive);
-    cJSON_AddBoolToObject(reported, "systemReset", false);
-    cJSON_AddBoolToObject(reported, "startAllPumps", startAllPumpsActive);
+    json_writer_number(&w, "currentProfile", profileNum);
+    json_writer_bool(&w, "emergencyStop", snap.emergencyStop);
+    json_writer_bool(&w, "systemReset", false);
+    json_writer_bool(&w, "startAllPumps", snap.startAllPumps);
     
     // ALWAYS report WiFi credentials as top-level fields
 	const char* current_password = get_current_wifi_password();
 	
 	if (current_ssid && current_password) {
 	    // Add as top-level fields (not nested object)
-	    cJSON_AddStringToObject(reported, "wifissid", current_ssid);
-	    cJSON_AddStringToObject(reported, "password", current_password);
+	    json_writer_string(&w, "wifissid", current_ssid);
+	    json_writer_string(&w, "password", current_password);
 	    // Don't log the actual password for security
 	} else {
 	    printf("\n[SHADOW] Warning: Cannot get WiFi credentials (ssid: %s, password: %s)", 
@@ -7598,80 +7892,105 @@ static void update_shadow_state(void) {
 const char* pumpNames[4] = {"NorthPump", "SouthPump", "EastPump", "WestPump"};
 
 for (int i = 0; i < 4; i++) {
-    cJSON *pumpObj = cJSON_CreateObject();
-    if (pumpObj) {
-        // ✅ MANUAL MODE - Report the last acknowledged desired state
-        bool reportedManualMode = last_shadow_manual_mode[i];
-        
-        cJSON_AddBoolToObject(pumpObj, "manualMode", reportedManualMode);
-        
-        // ✅ EXTEND TIME - Report the last acknowledged value
-        int reportedExtendTime = last_reported_extend_time[i];
-        
-        cJSON_AddNumberToObject(pumpObj, "extendTime", reportedExtendTime);
-        
-        // ✅ STOP PUMP
-        cJSON_AddBoolToObject(pumpObj, "stopPump", last_shadow_stop_pump[i]);
-        
-        cJSON_AddItemToObject(reported, pumpNames[i], pumpObj);
-    }
+    json_writer_begin_object(&w, pumpNames[i]);
+    
+    // ✅ MANUAL MODE - Report the last acknowledged desired state
+    json_writer_bool(&w, "manualMode", last_shadow_manual_mode[i]);
+    
+    // ✅ EXTEND TIME - Report the last acknowledged value
+    json_writer_number(&w, "extendTime", last_reported_extend_time[i]);
+    
+    // ✅ STOP PUMP
+    json_writer_bool(&w, "stopPump", last_shadow_stop_pump[i]);
+    
+    json_writer_end_object(&w);
 }
     
-    // Create compact JSON string
-    char *json_str = create_compact_json_string(root);
-    if (json_str) {
+    json_writer_end_object(&w);     // reported
+    json_writer_end_object(&w);     // state
+    if (json_end(&w, "Shadow update")) {
         char shadow_update_topic[128];
         snprintf(shadow_update_topic, sizeof(shadow_update_topic),
                  "$aws/things/%s/shadow/update", thing_name);
         
-        int msg_id = esp_mqtt_client_publish(mqtt_client, shadow_update_topic, 
-                                            json_str, 0, MQTT_QOS_LEVEL, 0);
-        
-        if (msg_id >= 0) {
-            printf("\nShadow update sent");
+        // Stale once offline, so not kept in SPIFFS
+        if (enqueue_mqtt_publish_lane(shadow_update_topic, json_str, MQTT_LANE_NORMAL,
+                                      MQTT_QOS_LEVEL, false, NULL, 0)) {
+            printf("\nShadow update queued");
         } else {
-            printf("\n[SHADOW] Failed to send shadow update (error: %d)", msg_id);
+            printf("\n[SHADOW] Failed to queue shadow update");
         }
-        
-        free(json_str);
     }
-    
-    cJSON_Delete(root);
   }
 
 // ========================================
 // MQTT FUNCTIONS - OPTIMIZED
 // ========================================
 
-bool enqueue_mqtt_publish(const char *topic, const char *payload) {
-
-    
-    if (mqtt_publish_queue == NULL) {
+// Text payloads are copied with their NUL; binary ones (len set) without
+static bool enqueue_mqtt_slot(const char *topic, const void *payload, size_t payload_len, bool binary,
+                              mqtt_lane_t lane, int qos, bool persist, const latency_trace_t *trace, uint32_t seq) {
+    if (mqttLaneMutex == NULL) {
         printf("\n[MQTT] Publish queue not initialized");
         return false;
     }
     
     // Check payload size
-    size_t payload_len = strlen(payload);
-    if (payload_len >= 1024) {
+    size_t copy_len = binary ? payload_len : payload_len + 1;
+    if (copy_len > sizeof(mqttLaneSlots[0].payload)) {
         printf("\n[MQTT] Payload too large (%d bytes)", payload_len);
         return false;
     }
     
-    mqtt_publish_message_t msg;
-    strncpy(msg.topic, topic, sizeof(msg.topic) - 1);
-    msg.topic[sizeof(msg.topic) - 1] = '\0';
-    strncpy(msg.payload, payload, sizeof(msg.payload) - 1);
-    msg.payload[sizeof(msg.payload) - 1] = '\0';
-    
-    if (xQueueSend(mqtt_publish_queue, &msg, pdMS_TO_TICKS(10)) != pdPASS) {
-        printf("\n[MQTT] Publish queue full");
+    if (xSemaphoreTake(mqttLaneMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        printf("\n[MQTT] Publish queue busy");
         return false;
     }
-    
+    // Alerts and messages that would be stored if unsendable never give up
+    // their slot; only plain telemetry is evicted
+    bool evicted;
+    int slot = mqtt_lanes_push(&mqttLanes, lane, persist || seq != 0, &evicted);
+    if (slot >= 0) {
+        // Filled under the lock so the publisher never sees a half-written slot
+        mqtt_publish_message_t *msg = &mqttLaneSlots[slot];
+        strncpy(msg->topic, topic, sizeof(msg->topic) - 1);
+        msg->topic[sizeof(msg->topic) - 1] = '\0';
+        memcpy(msg->payload, payload, copy_len);
+        msg->len = binary ? (uint16_t)payload_len : 0;
+        msg->qos = (uint8_t)qos;
+        msg->persist = persist;
+        msg->retries = 0;
+        msg->seq = seq;
+        msg->sample_us = trace ? trace->sample_us : 0;
+        msg->queued_us = trace ? trace->queued_us : 0;
+    }
+    xSemaphoreGive(mqttLaneMutex);
+    
+    if (slot < 0) {
+        printf("\n[MQTT] Publish queue full (%s lane)", mqtt_lane_name(lane));
+        return false;
+    }
+    if (evicted) {
+        printf("\n[MQTT] Dropped oldest telemetry for %s message", mqtt_lane_name(lane));
+    }
+    xSemaphoreGive(mqttLaneSignal);
     return true;
 }
 
+static bool enqueue_mqtt_publish_lane(const char *topic, const char *payload, mqtt_lane_t lane,
+                                      int qos, bool persist, const latency_trace_t *trace, uint32_t seq) {
+    return enqueue_mqtt_slot(topic, payload, strlen(payload), false, lane, qos, persist, trace, seq);
+}
+
+// Binary payloads are never kept in SPIFFS (the alert store holds text)
+static bool enqueue_mqtt_publish_blob(const char *topic, const uint8_t *data, size_t len, mqtt_lane_t lane) {
+    return enqueue_mqtt_slot(topic, data, len, true, lane, 1, false, NULL, 0);
+}
+
+bool enqueue_mqtt_publish(const char *topic, const char *payload) {
+    return enqueue_mqtt_publish_lane(topic, payload, MQTT_LANE_NORMAL, 1, true, NULL, 0);
+}
+
 static void subscribe_to_topics(void) {
     printf("\n[MQTT] ===== SUBSCRIBING TO TOPICS =====");
     
@@ -7714,6 +8033,12 @@ static void subscribe_to_topics(void) {
         esp_mqtt_client_subscribe(mqtt_client, shadow_update_rejected, 1);
         esp_mqtt_client_subscribe(mqtt_client, registration_response_topic, 1);
         
+        char history_request_topic[128];
+        snprintf(history_request_topic, sizeof(history_request_topic),
+                 "Response/%s/HistoryRequest", mac_address);
+        printf("\n %s", history_request_topic);
+        esp_mqtt_client_subscribe(mqtt_client, history_request_topic, 1);
+        
         // ========== OTA INITIALIZATION ==========
         printf("\n[OTA] Initializing OTA update system...");
         esp_err_t ota_ret = ota_job_init(thing_name, mqtt_client);
@@ -7772,19 +8097,166 @@ static void send_registration(void)
     cJSON_Delete(root);
 }
 
+// Heartbeat and periodic status; both run on the state machine task only
+static char periodic_json[JSON_BUFFER_SIZE];
+
 static void send_heartbeat(void) {        
+    json_writer_t w;
+    json_writer_init(&w, periodic_json, sizeof(periodic_json));
+    json_begin_event(&w, "heartbeat", get_custom_timestamp());
+    
+    if (json_end(&w, "Heartbeat")) {
+        char topic[128];
+        snprintf(topic, sizeof(topic), "Request/%s/heartBeatUpdate", mac_address);
+        enqueue_mqtt_publish(topic, periodic_json);
+    }
+}
+
+// =======================
+// DIAGNOSTICS FUNCTION
+// =======================
+
+static void send_diagnostics(void) {
     cJSON *root = cJSON_CreateObject();
-    if (root) {
+    if (!root) return;
+    
+    cJSON_AddStringToObject(root, "macAddress", mac_address);
+    cJSON_AddStringToObject(root, "event", "diagnostics");
+    cJSON_AddStringToObject(root, "devicetype", DEVICE_TYPE);
+    cJSON_AddStringToObject(root, "timestamp", get_custom_timestamp());
+    
+    cJSON *payload = cJSON_AddObjectToObject(root, "payload");
+    cJSON *loops = payload ? cJSON_AddObjectToObject(payload, "loops") : NULL;
+    if (loops) {
+        for (int i = 0; i < LOOP_COUNT; i++) {
+            // Copy first: the owning task keeps updating it
+            loop_monitor_t m = loopMonitors[i];
+            cJSON *loopObj = cJSON_AddObjectToObject(loops, m.name);
+            if (loopObj) {
+                cJSON_AddNumberToObject(loopObj, "periodMs", m.period_us / 1000);
+                cJSON_AddNumberToObject(loopObj, "n", m.iterations);
+                cJSON_AddNumberToObject(loopObj, "avgExecUs", loop_monitor_avg_exec_us(&m));
+                cJSON_AddNumberToObject(loopObj, "maxExecUs", m.exec_max_us);
+                cJSON_AddNumberToObject(loopObj, "overruns", m.overruns);
+                cJSON_AddNumberToObject(loopObj, "lateStarts", m.late_starts);
+                cJSON_AddNumberToObject(loopObj, "lateP99Ms", latency_trace_percentile(&m.lateness, 99) / 1000);
+                cJSON_AddNumberToObject(loopObj, "maxGapMs", m.interval_max_us / 1000);
+                cJSON_AddNumberToObject(loopObj, "maxConsecutiveMisses", m.consecutive_max);
+            }
+        }
+    }
+    
+    char *json_str = create_compact_json_string(root);
+    if (json_str) {
+        char topic[128];
+        snprintf(topic, sizeof(topic), "Request/%s/Diagnostics", mac_address);
+        enqueue_mqtt_publish_lane(topic, json_str, MQTT_LANE_BULK, 1, true, NULL, 0);
+        free(json_str);
+    }
+    cJSON_Delete(root);
+}
+
+// Fire response latency, stages with at least one event only. A message of
+// its own: six stages of four numbers stay well under the 1 KB publish limit.
+static void send_latency_report(void) {
+    cJSON *root = cJSON_CreateObject();
+    if (!root) return;
+    
+    cJSON_AddStringToObject(root, "macAddress", mac_address);
+    cJSON_AddStringToObject(root, "event", "latency");
+    cJSON_AddStringToObject(root, "devicetype", DEVICE_TYPE);
+    cJSON_AddStringToObject(root, "timestamp", get_custom_timestamp());
+    
+    cJSON *payload = cJSON_AddObjectToObject(root, "payload");
+    for (int s = 0; payload && s < LATENCY_STAGE_COUNT; s++) {
+        latency_histogram_t hist;
+        latency_trace_get((latency_stage_t)s, &hist);
+        if (hist.count == 0) {
+            continue;
+        }
+        cJSON *stageObj = cJSON_AddObjectToObject(payload, latency_trace_stage_name((latency_stage_t)s));
+        if (stageObj) {
+            cJSON_AddNumberToObject(stageObj, "n", hist.count);
+            cJSON_AddNumberToObject(stageObj, "p50Ms", latency_trace_percentile(&hist, 50) / 1000);
+            cJSON_AddNumberToObject(stageObj, "p95Ms", latency_trace_percentile(&hist, 95) / 1000);
+            cJSON_AddNumberToObject(stageObj, "maxMs", hist.max_us / 1000);
+        }
+    }
+    
+    char *json_str = create_compact_json_string(root);
+    if (json_str) {
+        char topic[128];
+        snprintf(topic, sizeof(topic), "Request/%s/Diagnostics", mac_address);
+        enqueue_mqtt_publish_lane(topic, json_str, MQTT_LANE_BULK, 1, true, NULL, 0);
+        free(json_str);
+    }
+    cJSON_Delete(root);
+}
+
+// Stack and CPU figures go out in parts to stay under the 1 KB publish limit.
+// Part 0 also carries the RAM budget.
+#define TASK_PROFILE_PER_MESSAGE    6
+
+static void send_task_profile(void) {
+#ifdef CONFIG_FIRE_TASK_PROFILER
+    int count = taskProfiler.count;
+#else
+    int count = 0;
+#endif
+    int parts = count > 0 ? (count + TASK_PROFILE_PER_MESSAGE - 1) / TASK_PROFILE_PER_MESSAGE : 1;
+    
+    for (int part = 0; part < parts; part++) {
+        cJSON *root = cJSON_CreateObject();
+        if (!root) return;
+        
         cJSON_AddStringToObject(root, "macAddress", mac_address);
-        cJSON_AddStringToObject(root, "event", "heartbeat");
-        cJSON_AddStringToObject(root, "devicetype", "G");
+        cJSON_AddStringToObject(root, "event", "taskProfile");
+        cJSON_AddStringToObject(root, "devicetype", DEVICE_TYPE);
         cJSON_AddStringToObject(root, "timestamp", get_custom_timestamp());
         
+        cJSON *payload = cJSON_AddObjectToObject(root, "payload");
+        if (payload) {
+            cJSON_AddNumberToObject(payload, "part", part);
+            cJSON_AddNumberToObject(payload, "parts", parts);
+        }
+        
+        cJSON *ram = (payload && part == 0) ? cJSON_AddObjectToObject(payload, "ram") : NULL;
+        if (ram) {
+            cJSON_AddNumberToObject(ram, "staticBytes", ram_budget_total_static());
+            cJSON_AddNumberToObject(ram, "bootHeapBytes", ram_budget_total_heap());
+            cJSON_AddNumberToObject(ram, "freeHeap", esp_get_free_heap_size());
+            cJSON_AddNumberToObject(ram, "minFreeHeap", esp_get_minimum_free_heap_size());
+            cJSON_AddNumberToObject(ram, "largestBlock", heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+#ifdef CONFIG_FIRE_TASK_PROFILER
+            cJSON_AddNumberToObject(ram, "stackReclaimable", task_profiler_reclaimable(&taskProfiler));
+#endif
+        }
+        
+        cJSON *boot = (payload && part == 0) ? cJSON_AddObjectToObject(payload, "boot") : NULL;
+        if (boot) {
+            cJSON_AddNumberToObject(boot, "armedMs", bootArmedUs / 1000);
+            cJSON_AddNumberToObject(boot, "connectedMs", bootConnectedUs / 1000);
+        }
+        
+        cJSON *tasks = (payload && count > 0) ? cJSON_AddObjectToObject(payload, "tasks") : NULL;
+        for (int i = part * TASK_PROFILE_PER_MESSAGE; tasks && i < count && i < (part + 1) * TASK_PROFILE_PER_MESSAGE; i++) {
+            // Copy first: the monitor task keeps updating it
+            task_profile_t t = taskProfiler.tasks[i];
+            cJSON *taskObj = cJSON_AddObjectToObject(tasks, t.name);
+            if (taskObj) {
+                cJSON_AddNumberToObject(taskObj, "stack", t.stack_size);
+                cJSON_AddNumberToObject(taskObj, "minFree", t.stack_free_min);
+                cJSON_AddNumberToObject(taskObj, "recommended", task_profiler_recommend(&t));
+                cJSON_AddNumberToObject(taskObj, "cpuPct", t.cpu_permille / 10.0);
+                cJSON_AddNumberToObject(taskObj, "cpuPeakPct", t.cpu_peak_permille / 10.0);
+            }
+        }
+        
         char *json_str = create_compact_json_string(root);
         if (json_str) {
             char topic[128];
-            snprintf(topic, sizeof(topic), "Request/%s/heartBeatUpdate", mac_address);
-            enqueue_mqtt_publish(topic, json_str);
+            snprintf(topic, sizeof(topic), "Request/%s/Diagnostics", mac_address);
+            enqueue_mqtt_publish_lane(topic, json_str, MQTT_LANE_BULK, 1, true, NULL, 0);
             free(json_str);
         }
         cJSON_Delete(root);
@@ -7822,7 +8294,7 @@ void send_ota_alert(const char *iostatus, const char *version)
         if (json_str) {
             char topic[128];
             snprintf(topic, sizeof(topic), "Request/%s/Alert", mac_address);
-            enqueue_mqtt_publish(topic, json_str);
+            enqueue_mqtt_publish_lane(topic, json_str, MQTT_LANE_CRITICAL, 1, true, NULL, 0);
             free(json_str);
             printf("\n[OTA] Alert queued for publishing");
         }
@@ -7847,72 +8319,53 @@ static void send_system_status(void) {
     PumpState pump_states[4] = {PUMP_OFF};
     bool pump_running[4] = {false};
     
-    if (xSemaphoreTake(mutexSystemState, pdMS_TO_TICKS(100)) == pdTRUE) {
-        profileNum = convert_profile_enum_to_number(currentProfile);
-        if (currentProfile >= WILDLAND_STANDARD && currentProfile <= CONTINUOUS_FEED) {
-            profileName = profiles[currentProfile].name;
-        }
-        xSemaphoreGive(mutexSystemState);
-    }
-    
-    if (xSemaphoreTake(mutexWaterState, pdMS_TO_TICKS(100)) == pdTRUE) {
-        lockout = waterLockout;
-        xSemaphoreGive(mutexWaterState);
+    // Control state as the control task last published it
+    ControlSnapshot snap;
+    control_snapshot_read(&snap);
+    profileNum = convert_profile_enum_to_number(snap.profile);
+    if (snap.profile >= WILDLAND_STANDARD && snap.profile <= CONTINUOUS_FEED) {
+        profileName = profiles[snap.profile].name;
     }
+    lockout = snap.waterLockout;
     
-    if (xSemaphoreTake(mutexSensorData, pdMS_TO_TICKS(100)) == pdTRUE) {
-        ir_values[0] = ir_s1;
-        ir_values[1] = ir_s2;
-        ir_values[2] = ir_s3;
-        ir_values[3] = ir_s4;
-        
-        // Extract current sensor values and fault status
-        for (int i = 0; i < 4; i++) {
-            current_values[i] = currentSensors[i].currentValue;
-            current_faults[i] = currentSensors[i].fault;
-        }
-        
-        xSemaphoreGive(mutexSensorData);
+    // Lock-free snapshot - never blocks the sensor task
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    for (int i = 0; i < 4; i++) {
+        ir_values[i] = frame.ir[i];
+        current_values[i] = frame.current[i];
+        current_faults[i] = frame.currentFault[i];
     }
     
     // Get pump states
-    if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(100)) == pdTRUE) {
-        for (int i = 0; i < 4; i++) {
-            pump_states[i] = pumps[i].state;
-            pump_running[i] = pumps[i].isRunning;
-        }
-        xSemaphoreGive(mutexPumpState);
+    for (int i = 0; i < 4; i++) {
+        pump_states[i] = snap.pumps[i].state;
+        pump_running[i] = snap.pumps[i].isRunning;
     }
     
     // Get suppression active status
-    suppression_active = is_suppression_active();
+    suppression_active = snap.suppressionActive;
     
-    cJSON *root = cJSON_CreateObject();
-    if (!root) return;
-    
-    cJSON_AddStringToObject(root, "macAddress", mac_address);
-    cJSON_AddStringToObject(root, "event", "periodicupdate");
-    cJSON_AddStringToObject(root, "devicetype", "G");
-    cJSON_AddStringToObject(root, "timestamp", get_custom_timestamp());
-    
-    cJSON *payload = cJSON_CreateObject();
-    cJSON_AddItemToObject(root, "payload", payload);
+    json_writer_t w;
+    json_writer_init(&w, periodic_json, sizeof(periodic_json));
+    json_begin_event(&w, "periodicupdate", get_custom_timestamp());
+    json_writer_begin_object(&w, "payload");
     
     // Essential fields
-    cJSON_AddStringToObject(payload, "wifissid", get_current_wifi_ssid());
-    cJSON_AddStringToObject(payload, "password", get_current_wifi_password());
-    cJSON_AddBoolToObject(payload, "waterLockout", lockout);
-    cJSON_AddBoolToObject(payload, "doorOpen", doorOpen);
-    cJSON_AddNumberToObject(payload, "currentProfile", profileNum);
-    cJSON_AddStringToObject(payload, "profileName", profileName);
+    json_writer_string(&w, "wifissid", get_current_wifi_ssid());
+    json_writer_string(&w, "password", get_current_wifi_password());
+    json_writer_bool(&w, "waterLockout", lockout);
+    json_writer_bool(&w, "doorOpen", doorOpen);
+    json_writer_number(&w, "currentProfile", profileNum);
+    json_writer_string(&w, "profileName", profileName);
     
     // ✅ Round to 2 decimal places
-    cJSON_AddNumberToObject(payload, "waterLevel", round(level_s * 100.0) / 100.0);
-    cJSON_AddNumberToObject(payload, "batteryVoltage", round(bat_v * 100.0) / 100.0);
-    cJSON_AddNumberToObject(payload, "solarVoltage", round(sol_v * 100.0) / 100.0);
+    json_writer_number(&w, "waterLevel", round(frame.level * 100.0) / 100.0);
+    json_writer_number(&w, "batteryVoltage", round(frame.batteryVoltage * 100.0) / 100.0);
+    json_writer_number(&w, "solarVoltage", round(frame.solarVoltage * 100.0) / 100.0);
     
-    cJSON_AddBoolToObject(payload, "emergencyStopActive", emergencyStopActive);
-    cJSON_AddBoolToObject(payload, "suppressionActive", suppression_active);
+    json_writer_bool(&w, "emergencyStopActive", emergencyStopActive);
+    json_writer_bool(&w, "suppressionActive", suppression_active);
     
     // ========================================
     // ✅ NEW: GROUPED PUMP DATA STRUCTURE
@@ -7921,40 +8374,100 @@ static void send_system_status(void) {
     const char* pumpNames[4] = {"NorthPump", "SouthPump", "EastPump", "WestPump"};
     
     for (int i = 0; i < 4; i++) {
-        cJSON *pumpObj = cJSON_CreateObject();
-        if (pumpObj) {
-            // IR Value (2 decimal places)
-            cJSON_AddNumberToObject(pumpObj, "IRValue", 
-                round(ir_values[i] * 100.0) / 100.0);
-            
-            // Current Draw (2 decimal places)
-            cJSON_AddNumberToObject(pumpObj, "currentDraw", 
-                round(current_values[i] * 100.0) / 100.0);
-            
-            // ✅ Pump State as String (OFF, AUTO_ACTIVE, MANUAL_ACTIVE, COOLDOWN, DISABLED)
-            cJSON_AddStringToObject(pumpObj, "PumpState", 
-                get_pump_state_string(i));
-            
-            // Current Sensor Fault
-            cJSON_AddBoolToObject(pumpObj, "currentSensorFault", current_faults[i]);
-            
-            // Pump Running Status (boolean)
-            cJSON_AddBoolToObject(pumpObj, "PumpRunning", pump_running[i]);
-            
-            // Add pump object to payload
-            cJSON_AddItemToObject(payload, pumpNames[i], pumpObj);
-        }
+        json_writer_begin_object(&w, pumpNames[i]);
+        
+        // IR Value and Current Draw (2 decimal places)
+        json_writer_number(&w, "IRValue", round(ir_values[i] * 100.0) / 100.0);
+        json_writer_number(&w, "currentDraw", round(current_values[i] * 100.0) / 100.0);
+        
+        // ✅ Pump State as String (OFF, AUTO_ACTIVE, MANUAL_ACTIVE, COOLDOWN, DISABLED)
+        json_writer_string(&w, "PumpState", get_pump_state_string(i));
+        
+        json_writer_bool(&w, "currentSensorFault", current_faults[i]);
+        json_writer_bool(&w, "PumpRunning", pump_running[i]);
+        json_writer_end_object(&w);
     }
     
-    // Create compact JSON string
-    char *json_str = create_compact_json_string(root);
-    if (json_str) {
+    json_writer_end_object(&w);     // payload
+    if (json_end(&w, "Status")) {
         char topic[128];
         snprintf(topic, sizeof(topic), "Request/%s/PeriodicUpdate", mac_address);
-        enqueue_mqtt_publish(topic, json_str);
-        free(json_str);
+        enqueue_mqtt_publish(topic, periodic_json);
+    }
+}
+
+/**
+ * Sensor history export (format in sensor_history.h), requested via
+ * Response/<mac>/HistoryRequest. A tier goes out as chunks that each fit
+ * one publish slot, queued one at a time on the bulk lane by the publish task.
+ */
+static volatile int historyRequestTier = -1;    // Set by the MQTT event handler
+
+static void request_sensor_history(int tier) {
+    if (tier < 0 || tier >= SENSOR_HISTORY_TIERS) {
+        printf("\n[HISTORY] Invalid tier %d", tier);
+        return;
+    }
+    historyRequestTier = tier;
+    if (mqttLaneSignal) {
+        xSemaphoreGive(mqttLaneSignal);
+    }
+}
+
+// Publish task only
+static void serve_history_export(void) {
+    static uint8_t chunk[sizeof(mqttLaneSlots[0].payload)];
+    static int tier = -1;
+    static uint32_t nextRow;
+    static int chunks;
+    
+    // A new request restarts the export
+    int requested = historyRequestTier;
+    if (requested >= 0) {
+        historyRequestTier = -1;
+        tier = requested;
+        nextRow = 0;
+        chunks = 0;
+    }
+    if (tier < 0 || !mqtt_connected || mutexSensorHistory == NULL) {
+        return;
+    }
+    
+    // Next chunk only once the previous one has left the bulk lane
+    xSemaphoreTake(mqttLaneMutex, portMAX_DELAY);
+    bool bulkBusy = mqttLanes.stats[MQTT_LANE_BULK].depth > 0;
+    xSemaphoreGive(mqttLaneMutex);
+    if (bulkBusy) {
+        return;
+    }
+    
+    time_t epoch = 0;
+    if (!time_manager_is_synced() || time_manager_get_epoch(&epoch) != ESP_OK) {
+        epoch = 0;
+    }
+    
+    if (xSemaphoreTake(mutexSensorHistory, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return;     // Sensor task busy, next round
+    }
+    uint32_t startRow = nextRow;
+    size_t len = sensor_history_export_chunk(&sensorHistory, tier, &nextRow,
+                                             xTaskGetTickCount() * portTICK_PERIOD_MS,
+                                             (uint32_t)epoch, chunk, sizeof(chunk));
+    xSemaphoreGive(mutexSensorHistory);
+    
+    if (len == 0) {
+        printf("\n[HISTORY] Tier %d sent in %d chunks", tier, chunks);
+        tier = -1;
+        return;
+    }
+    
+    char topic[128];
+    snprintf(topic, sizeof(topic), "Request/%s/History", mac_address);
+    if (enqueue_mqtt_publish_blob(topic, chunk, len, MQTT_LANE_BULK)) {
+        chunks++;
+    } else {
+        nextRow = startRow;     // Lanes full: the same rows next round
     }
-    cJSON_Delete(root);
 }
 
 // ========================================
@@ -8213,19 +8726,56 @@ static esp_err_t start_provisioning(void)
 // ========================================
 // ALERT SYSTEM FUNCTIONS - OPTIMIZED
 // ========================================
+static void report_door_change(bool open) {
+    static TickType_t door_open_start_time = 0;
+    if (open) {
+        door_open_start_time = xTaskGetTickCount();
+        send_alert_door_status(true, 0);
+    } else {
+        int openDuration = (int)((xTaskGetTickCount() - door_open_start_time) * portTICK_PERIOD_MS / 1000);
+        send_alert_door_status(false, openDuration);
+    }
+    last_door_state = open;
+}
+
+// Runs in the timer service task after fire_system has updated doorOpen
+static void door_alert_on_change(uint32_t changed, uint32_t state, void *arg) {
+    bool open = (state & changed) != 0;
+    if (open != last_door_state) {
+        report_door_change(open);
+    }
+}
+
+// Queue first, so hardware init can already raise alerts; the task starts
+// once storage and the MQTT publisher are up
+static void init_alert_queue(void) {
+    alert_pool_init(&alertPool, alertPoolBlocks, ALERT_POOL_BLOCKS);
+    boot_lock();
+    ram_budget_add_static("Alerts", sizeof(alertPoolBlocks));
+    boot_unlock();
+    alert_coalescer_init(&alertCoalescer);
+    alert_queue = create_static_queue("Alerts", ALERT_QUEUE_SIZE, sizeof(alert_pool_handle_t), alertQueueStorage, &alertQueueBuf);
+    alert_mutex = create_static_mutex("Alerts", &alertMutexBuf);
+}
+
 static void init_alert_system(void) {
     printf("\n[ALERT] Initializing alert system...");
-    
-    alert_queue = xQueueCreate(10, sizeof(Alert));  // Reduced from 20
-    alert_mutex = xSemaphoreCreateMutex();
+    init_alert_journal();
     
     if (alert_queue && alert_mutex) {
-        xTaskCreate(alert_task, "AlertTask", TASK_ALERT_STACK_SIZE, NULL, TASK_PRIORITY_ALERT, &taskAlertHandle);
+        taskAlertHandle = create_static_task("Alerts", alert_task, "AlertTask", alertTaskStack, sizeof(alertTaskStack),
+                                             TASK_PRIORITY_ALERT, &alertTaskTcb, TASK_CORE_ALERT);
         
         last_profile = convert_profile_enum_to_number(currentProfile);
         last_door_state = doorOpen;
         last_water_lockout = waterLockout;
         
+        // Door alerts go out as soon as the debounced edge arrives
+        uint32_t doorMask = get_door_input_mask();
+        if (doorMask != 0) {
+            input_events_subscribe(doorMask, door_alert_on_change, NULL);
+        }
+        
         for (int i = 0; i < 4; i++) {
             last_pump_states[i] = pumps[i].state;
             fire_alerts_active[i] = false;
@@ -8247,10 +8797,10 @@ static void init_alert_system(void) {
 
 static fire_sector_t get_sector_from_index(int sensor_index) {
     switch(sensor_index) {
-        case 0: return SECTOR_NORTH;   // ir_s1
-        case 1: return SECTOR_SOUTH;   // ir_s2
-        case 2: return SECTOR_EAST;    // ir_s3
-        case 3: return SECTOR_WEST;    // ir_s4
+        case 0: return SECTOR_NORTH;   // frame.ir[0]
+        case 1: return SECTOR_SOUTH;   // frame.ir[1]
+        case 2: return SECTOR_EAST;    // frame.ir[2]
+        case 3: return SECTOR_WEST;    // frame.ir[3]
         default: return SECTOR_UNKNOWN;
     }
 }
@@ -8263,6 +8813,9 @@ static fire_sector_t get_sector_from_index(int sensor_index) {
 static void check_state_changes(void) {
     if (!ALERT_SYSTEM_ENABLED) return;
     
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    
     // Check startAllPumps status
     static bool last_start_all_pumps = false;
     static bool pumps_actually_running = false;
@@ -8336,8 +8889,7 @@ static void check_state_changes(void) {
             // Determine activation source and trigger
             if (current_state == PUMP_AUTO_ACTIVE) {
                 trigger = "FIRE_DETECTED";
-                float sensorValues[4] = {ir_s1, ir_s2, ir_s3, ir_s4};
-                sensorTemp = sensorValues[i];
+                sensorTemp = frame.ir[i];
             } else if (current_state == PUMP_MANUAL_ACTIVE) {
                 if (pumps[i].activationSource == ACTIVATION_SOURCE_SHADOW_SINGLE) {
                     activationSource = "SHADOW";
@@ -8394,23 +8946,15 @@ static void check_state_changes(void) {
         }
     }
     
-    // Check door status
-    static TickType_t door_open_start_time = 0;
-    if (doorOpen != last_door_state) {
-        if (doorOpen) {
-            door_open_start_time = xTaskGetTickCount();
-            send_alert_door_status(true, 0);
-        } else {
-            int openDuration = (int)((xTaskGetTickCount() - door_open_start_time) * portTICK_PERIOD_MS / 1000);
-            send_alert_door_status(false, openDuration);
-        }
-        last_door_state = doorOpen;
+    // Check door status (only when the door interrupt is not running)
+    if (get_door_input_mask() == 0 && doorOpen != last_door_state) {
+        report_door_change(doorOpen);
     }
     
     // Check water lockout
     if (waterLockout != last_water_lockout) {
         float threshold = 10.0; // Get from your system config if available
-        send_alert_water_lockout(waterLockout, level_s, threshold);
+        send_alert_water_lockout(waterLockout, frame.level, threshold);
         last_water_lockout = waterLockout;
     }
 }
@@ -8425,15 +8969,13 @@ static void monitor_fire_sectors(void) {
     int current_fire_count = 0;
     
     // Read sensor values
-    if (xSemaphoreTake(mutexSensorData, pdMS_TO_TICKS(100)) == pdTRUE) {
-        sensor_values[0] = ir_s1;
-        sensor_values[1] = ir_s2;
-        sensor_values[2] = ir_s3;
-        sensor_values[3] = ir_s4;
-        xSemaphoreGive(mutexSensorData);
-    } else {
-        printf("[FIRE] Warning: Could not get sensor mutex\n");
-        return;
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    if (frame.seq == 0) {
+        return;  // No acquisition cycle completed yet
+    }
+    for (int i = 0; i < 4; i++) {
+        sensor_values[i] = frame.ir[i];
     }
     
     // Check for fires
@@ -8536,474 +9078,624 @@ static void check_manual_auto_modes(void) {
 // COMPLETE PROCESS_ALERTS() FUNCTION
 // ========================================
 
-static void process_alerts(void) {
-    Alert alert;
+// ========================================
+// ALERT RECORDS
+// ========================================
+#define ALERT_DATA_SIZE(member)     sizeof(((Alert *)0)->data.member)
+
+// Bytes of the data union process_alerts reads for each type
+static size_t alert_data_size(alert_type_t type) {
+    switch (type) {
+        case ALERT_TYPE_PROFILE_CHANGE:         return ALERT_DATA_SIZE(profile);
+        case ALERT_TYPE_EMERGENCY_STOP:         return ALERT_DATA_SIZE(emergencyStop);
+        case ALERT_TYPE_SYSTEM_RESET:           return ALERT_DATA_SIZE(systemReset);
+        case ALERT_TYPE_START_ALL_PUMPS:        return ALERT_DATA_SIZE(startAllPumps);
+        case ALERT_TYPE_PUMP_STATE_CHANGE:      return ALERT_DATA_SIZE(pump);
+        case ALERT_TYPE_PUMP_EXTEND_TIME:       return ALERT_DATA_SIZE(pumpExtend);
+        case ALERT_TYPE_FIRE_DETECTED:
+        case ALERT_TYPE_FIRE_CLEARED:           return ALERT_DATA_SIZE(fire);
+        case ALERT_TYPE_MULTIPLE_FIRES:         return ALERT_DATA_SIZE(multipleFires);
+        case ALERT_TYPE_WATER_LOCKOUT:          return ALERT_DATA_SIZE(waterLockout);
+        case ALERT_TYPE_DOOR_STATUS:            return ALERT_DATA_SIZE(door);
+        case ALERT_TYPE_WIFI_UPDATE:            return ALERT_DATA_SIZE(wifi);
+        case ALERT_TYPE_SENSOR_FAULT:           return ALERT_DATA_SIZE(sensorFault);
+        case ALERT_TYPE_SYSTEM_ERROR:           return ALERT_DATA_SIZE(systemError);
+        case ALERT_TYPE_CONTINUOUS_FEED:        return ALERT_DATA_SIZE(continuousFeed);
+        case ALERT_TYPE_PCA9555_FAIL:
+        case ALERT_TYPE_HARDWARE_CONTROL_FAIL:
+        case ALERT_TYPE_ADC_INIT_FAIL:
+        case ALERT_TYPE_CURRENT_SENSOR_FAULT:
+        case ALERT_TYPE_IR_SENSOR_FAULT:        return ALERT_DATA_SIZE(hardwareFault);
+        case ALERT_TYPE_BATTERY_LOW:
+        case ALERT_TYPE_BATTERY_CRITICAL:
+        case ALERT_TYPE_SOLAR_FAULT:            return ALERT_DATA_SIZE(powerStatus);
+        case ALERT_TYPE_STATE_CORRUPTION:
+        case ALERT_TYPE_TASK_FAILURE:           return ALERT_DATA_SIZE(integrity);
+        default:                                return sizeof(((Alert *)0)->data);
+    }
+}
+
+// Trace first, then the header and used data: the decoder learns the type
+// only after decoding, so the variable-length part goes last
+static void alert_segments(Alert *alert, size_t dataSize, alert_pool_seg_t segs[2]) {
+    segs[0].ptr = &alert->trace;
+    segs[0].len = sizeof(alert->trace);
+    segs[1].ptr = alert;
+    segs[1].len = offsetof(Alert, data) + dataSize;
+}
+
+// Encode an alert into the pool; ALERT_POOL_NONE if the pool is full
+static alert_pool_handle_t store_alert_record(Alert *alert) {
+    alert_pool_seg_t segs[2];
+    alert_segments(alert, alert_data_size(alert->type), segs);
+    size_t size = alert_pool_encoded_size(segs, 2);
+    
+    portENTER_CRITICAL(&alertPoolLock);
+    alert_pool_handle_t handle = alert_pool_alloc(&alertPool, size);
+    portEXIT_CRITICAL(&alertPoolLock);
+    
+    alert_pool_encode(&alertPool, handle, segs, 2);
+    return handle;
+}
+
+static void release_alert_record(alert_pool_handle_t handle) {
+    portENTER_CRITICAL(&alertPoolLock);
+    alert_pool_free(&alertPool, handle);
+    portEXIT_CRITICAL(&alertPoolLock);
+}
+
+// Decode a queued record; the caller still owns its blocks
+static void read_alert_record(alert_pool_handle_t handle, Alert *alert) {
+    memset(alert, 0, sizeof(*alert));
+    alert_pool_seg_t segs[2];
+    alert_segments(alert, sizeof(alert->data), segs);
+    alert_pool_decode(&alertPool, handle, segs, 2);
+}
+
+// Decode a queued record and release its blocks
+static void take_alert_record(alert_pool_handle_t handle, Alert *alert) {
+    read_alert_record(handle, alert);
+    release_alert_record(handle);
+}
+
+// ========================================
+// ALERT JSON SCHEMAS
+// ========================================
+// Type-specific payload members, written after alertType, severity and
+// message. Member order is part of the cloud contract.
+
+typedef void (*alert_payload_writer_t)(json_writer_t *w, const Alert *alert);
+
+typedef struct {
+    alert_type_t type;
+    alert_payload_writer_t write;
+} AlertSchema;
+
+static const char *const alertPumpNames[4] = {"North", "South", "East", "West"};
+
+static void write_profile_change(json_writer_t *w, const Alert *alert) {
+    json_writer_number(w, "previousProfile", alert->data.profile.previousProfile);
+    json_writer_number(w, "currentProfile", alert->data.profile.currentProfile);
+    json_writer_string(w, "profileName", alert->data.profile.profileName);
+}
+
+static void write_emergency_stop(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "action",
+        alert->data.emergencyStop.activated ? "ACTIVATED" : "DEACTIVATED");
+    
+    if (alert->data.emergencyStop.activated) {
+        json_writer_bool(w, "allPumpsStopped", true);
+        json_writer_begin_array(w, "affectedPumps");
+        for (int i = 0; i < alert->data.emergencyStop.affectedPumpCount; i++) {
+            json_writer_begin_object(w, NULL);
+            json_writer_number(w, "pumpId", alert->data.emergencyStop.affectedPumps[i].pumpId);
+            json_writer_string(w, "pumpName", alert->data.emergencyStop.affectedPumps[i].pumpName);
+            json_writer_string(w, "previousState",
+                get_pump_state_string_for_alert(alert->data.emergencyStop.affectedPumps[i].previousState));
+            json_writer_end_object(w);
+        }
+        json_writer_end_array(w);
+    } else {
+        json_writer_string(w, "systemStatus", "OPERATIONAL");
+    }
+}
+
+static void write_system_reset(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "resetType", alert->data.systemReset.resetType);
+    json_writer_string(w, "defaultProfile", alert->data.systemReset.defaultProfile);
+    json_writer_bool(w, "allPumpsReset", alert->data.systemReset.allPumpsReset);
+    json_writer_bool(w, "emergencyStopCleared", alert->data.systemReset.emergencyStopCleared);
+}
+
+static void write_start_all_pumps(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "action",
+        alert->data.startAllPumps.activated ? "ACTIVATED" : "DEACTIVATED");
     
-    while (xQueueReceive(alert_queue, &alert, 0) == pdTRUE) {
-        // Create root JSON object
-        cJSON *root = cJSON_CreateObject();
-        if (!root) continue;
+    if (alert->data.startAllPumps.activated) {
+        json_writer_number(w, "duration", alert->data.startAllPumps.duration);
+        json_writer_begin_array(w, "activatedPumps");
+        for (int i = 0; i < 4; i++) {
+            json_writer_begin_object(w, NULL);
+            json_writer_number(w, "pumpId", i + 1);
+            json_writer_string(w, "pumpName", alertPumpNames[i]);
+            json_writer_end_object(w);
+        }
+        json_writer_end_array(w);
+        json_writer_bool(w, "waterLockout", alert->data.startAllPumps.waterLockout);
+    } else {
+        json_writer_string(w, "reason", alert->data.startAllPumps.reason);
+        json_writer_number(w, "totalRuntime", alert->data.startAllPumps.totalRuntime);
+    }
+}
+
+static void write_pump_state_change(json_writer_t *w, const Alert *alert) {
+    json_writer_number(w, "pumpId", alert->data.pump.pumpId);
+    json_writer_string(w, "pumpName", alert->data.pump.pumpName);
+    json_writer_string(w, "previousState",
+        get_pump_state_string_for_alert(alert->data.pump.previousState));
+    json_writer_string(w, "currentState",
+        get_pump_state_string_for_alert(alert->data.pump.currentState));
+    json_writer_bool(w, "autoEnabled", alert->data.pump.autoEnabled);
+    json_writer_bool(w, "manualEnabled", alert->data.pump.manualEnabled);
+    
+    // State-specific fields
+    if (alert->data.pump.currentState == 1) { // AUTO_ACTIVE
+        json_writer_string(w, "activationMode", "AUTOMATIC");
+        if (strlen(alert->data.pump.trigger) > 0) {
+            json_writer_string(w, "trigger", alert->data.pump.trigger);
+        }
+    } else if (alert->data.pump.currentState == 2) { // MANUAL_ACTIVE
+        json_writer_string(w, "activationMode", "MANUAL");
+        if (strlen(alert->data.pump.activationSource) > 0) {
+            json_writer_string(w, "activationSource", alert->data.pump.activationSource);
+        }
+    } else if (alert->data.pump.currentState == 0) { // OFF
+        if (strlen(alert->data.pump.stopReason) > 0) {
+            json_writer_string(w, "stopReason", alert->data.pump.stopReason);
+        }
+        if (alert->data.pump.totalRuntime > 0) {
+            json_writer_number(w, "totalRuntime", alert->data.pump.totalRuntime);
+        }
+    } else if (alert->data.pump.currentState == 3) { // COOLDOWN
+        json_writer_number(w, "cooldownDuration", alert->data.pump.cooldownDuration);
+        if (alert->data.pump.previousRuntime > 0) {
+            json_writer_number(w, "previousRuntime", alert->data.pump.previousRuntime);
+        }
+    }
+}
+
+static void write_pump_extend_time(json_writer_t *w, const Alert *alert) {
+    json_writer_number(w, "pumpId", alert->data.pumpExtend.pumpId);
+    json_writer_string(w, "pumpName", alert->data.pumpExtend.pumpName);
+    json_writer_number(w, "extensionDuration", alert->data.pumpExtend.extensionDuration);
+    json_writer_number(w, "remainingTime",
+        alert->data.pumpExtend.remainingTime + alert->data.pumpExtend.extensionDuration);
+}
+
+static void write_fire_detected(json_writer_t *w, const Alert *alert) {
+    json_writer_bool(w, "Single Sector", alert->data.fire.fireType == FIRE_TYPE_SINGLE_SECTOR);
+    json_writer_bool(w, "Multiple Sectors", alert->data.fire.fireType == FIRE_TYPE_MULTIPLE_SECTORS);
+    json_writer_bool(w, "Full Sector", alert->data.fire.fireType == FIRE_TYPE_FULL_SYSTEM);
+    
+    // A single-sector fire still goes out as a one-element array
+    json_writer_begin_array(w, "affectedSectors");
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "sector", alert->data.fire.sector);
+    json_writer_number(w, "temperature", alert->data.fire.temperature);
+    json_writer_bool(w, "pumpActive", alert->data.fire.pumpActivated);
+    json_writer_end_object(w);
+    json_writer_end_array(w);
+    
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    json_writer_number(w, "waterLevel", frame.level);
+    json_writer_number(w, "estimatedRuntime", 0);
+}
+
+static void write_fire_cleared(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "sector", alert->data.fire.sector);
+    json_writer_number(w, "sensorId", alert->data.fire.sensorId);
+    json_writer_number(w, "currentTemperature", alert->data.fire.currentTemperature);
+    if (alert->data.fire.duration > 0) {
+        json_writer_number(w, "duration", alert->data.fire.duration);
+    }
+}
+
+static void write_multiple_fires(json_writer_t *w, const Alert *alert) {
+    // Never a single sector, whatever the stored type says
+    json_writer_bool(w, "Single Sector", false);
+    json_writer_bool(w, "Multiple Sectors", alert->data.multipleFires.fireType == FIRE_TYPE_MULTIPLE_SECTORS);
+    json_writer_bool(w, "Full Sector", alert->data.multipleFires.fireType == FIRE_TYPE_FULL_SYSTEM);
+    
+    json_writer_begin_array(w, "affectedSectors");
+    for (int i = 0; i < alert->data.multipleFires.activeFireCount && i < 4; i++) {
+        json_writer_begin_object(w, NULL);
+        json_writer_string(w, "sector", alert->data.multipleFires.affectedSectors[i].sector);
+        json_writer_number(w, "temperature", alert->data.multipleFires.affectedSectors[i].temperature);
+        json_writer_bool(w, "pumpActive", alert->data.multipleFires.affectedSectors[i].pumpActive);
+        json_writer_end_object(w);
+    }
+    json_writer_end_array(w);
+    
+    json_writer_number(w, "waterLevel", alert->data.multipleFires.waterLevel);
+    json_writer_number(w, "estimatedRuntime", 0);
+}
+
+static void write_water_lockout(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "action",
+        alert->data.waterLockout.activated ? "ACTIVATED" : "DEACTIVATED");
+    json_writer_number(w, "currentWaterLevel", alert->data.waterLockout.currentWaterLevel);
+    
+    if (alert->data.waterLockout.activated) {
+        json_writer_number(w, "minThreshold", alert->data.waterLockout.minThreshold);
+        json_writer_bool(w, "allPumpsDisabled", alert->data.waterLockout.allPumpsDisabled);
+        json_writer_bool(w, "continuousFeedActive", alert->data.waterLockout.continuousFeedActive);
+    } else {
+        json_writer_string(w, "systemStatus", alert->data.waterLockout.systemStatus);
+    }
+}
+
+static void write_door_status(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "action", alert->data.door.action);
+    json_writer_bool(w, "doorState", alert->data.door.doorState);
+    
+    if (alert->data.door.opened) {
+        json_writer_bool(w, "securityConcern", alert->data.door.securityConcern);
+    } else if (alert->data.door.wasOpenDuration > 0) {
+        json_writer_number(w, "wasOpenDuration", alert->data.door.wasOpenDuration);
+    }
+}
+
+static void write_wifi_update(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "action", alert->data.wifi.action);
+    
+    if (strcmp(alert->data.wifi.action, "CREDENTIALS_UPDATED") == 0) {
+        json_writer_string(w, "newSSID", alert->data.wifi.newSSID);
+        if (strlen(alert->data.wifi.previousSSID) > 0) {
+            json_writer_string(w, "previousSSID", alert->data.wifi.previousSSID);
+        }
+        json_writer_bool(w, "requiresReboot", alert->data.wifi.requiresReboot);
+        json_writer_bool(w, "stored", alert->data.wifi.stored);
+    } else {
+        // Invalid credentials
+        json_writer_string(w, "errorType", alert->data.wifi.errorType);
+        json_writer_string(w, "errorCode", alert->data.wifi.errorCode);
+        json_writer_begin_object(w, "details");
+        json_writer_number(w, "ssidLength", alert->data.wifi.ssidLength);
+        json_writer_number(w, "passwordLength", alert->data.wifi.passwordLength);
+        json_writer_string(w, "reason", alert->data.wifi.reason);
+        json_writer_end_object(w);
+    }
+}
+
+static void write_sensor_fault(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "sensorType", alert->data.sensorFault.sensorType);
+    json_writer_number(w, "sensorId", alert->data.sensorFault.sensorId);
+    json_writer_string(w, "sectorAffected", alert->data.sensorFault.sectorAffected);
+    json_writer_string(w, "errorCode", alert->data.sensorFault.errorCode);
+    json_writer_number(w, "lastValidReading", alert->data.sensorFault.lastValidReading);
+}
+
+static void write_system_error(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "errorType", alert->data.systemError.errorType);
+    json_writer_string(w, "errorCode", alert->data.systemError.errorCode);
+    if (strlen(alert->data.systemError.details) > 0) {
+        // Free text: dropped if it would push the alert over the limit
+        json_writer_mark_t mark = json_writer_mark(w);
+        json_writer_string(w, "details", alert->data.systemError.details);
+        json_writer_keep(w, &mark);
+    }
+}
+
+static void write_continuous_feed(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "action",
+        alert->data.continuousFeed.activated ? "ACTIVATED" : "DEACTIVATED");
+    json_writer_string(w, "profile", alert->data.continuousFeed.profile);
+    json_writer_bool(w, "waterLockoutDisabled", alert->data.continuousFeed.waterLockoutDisabled);
+    json_writer_bool(w, "unlimitedWaterSupply", alert->data.continuousFeed.unlimitedWaterSupply);
+}
+
+static void write_hardware_fault_common(json_writer_t *w, const Alert *alert, bool alwaysPumps) {
+    json_writer_string(w, "hardwareType", alert->data.hardwareFault.hardwareType);
+    json_writer_number(w, "componentId", alert->data.hardwareFault.componentId);
+    json_writer_string(w, "errorCode", alert->data.hardwareFault.errorCode);
+    json_writer_string(w, "errorMessage", alert->data.hardwareFault.errorMessage);
+    json_writer_bool(w, "systemCritical", alert->data.hardwareFault.systemCritical);
+    if (alwaysPumps || alert->data.hardwareFault.affectedPumpCount > 0) {
+        json_writer_number(w, "affectedPumpCount", alert->data.hardwareFault.affectedPumpCount);
+        json_writer_string(w, "affectedPumps", alert->data.hardwareFault.affectedPumps);
+    }
+}
+
+// PCA9555 failures always list the pumps they cut off, even when none
+static void write_pca9555_fail(json_writer_t *w, const Alert *alert) {
+    write_hardware_fault_common(w, alert, true);
+}
+
+static void write_hardware_fault(json_writer_t *w, const Alert *alert) {
+    write_hardware_fault_common(w, alert, false);
+}
+
+static void write_power_status(json_writer_t *w, const Alert *alert) {
+    json_writer_number(w, "batteryVoltage", alert->data.powerStatus.batteryVoltage);
+    json_writer_number(w, "solarVoltage", alert->data.powerStatus.solarVoltage);
+    json_writer_number(w, "threshold", alert->data.powerStatus.threshold);
+    json_writer_string(w, "powerState", alert->data.powerStatus.powerState);
+    if (alert->data.powerStatus.estimatedRuntime > 0) {
+        json_writer_number(w, "estimatedRuntime", alert->data.powerStatus.estimatedRuntime);
+    }
+    json_writer_bool(w, "chargingActive", alert->data.powerStatus.chargingActive);
+}
+
+static void write_integrity(json_writer_t *w, const Alert *alert) {
+    json_writer_string(w, "integrityType", alert->data.integrity.integrityType);
+    json_writer_string(w, "componentName", alert->data.integrity.componentName);
+    json_writer_number(w, "errorValue", alert->data.integrity.errorValue);
+    if (alert->data.integrity.expectedValue != 0) {
+        json_writer_number(w, "expectedValue", alert->data.integrity.expectedValue);
+    }
+    json_writer_string(w, "action", alert->data.integrity.action);
+}
+
+static const AlertSchema alertSchemas[] = {
+    { ALERT_TYPE_PROFILE_CHANGE,        write_profile_change },
+    { ALERT_TYPE_EMERGENCY_STOP,        write_emergency_stop },
+    { ALERT_TYPE_SYSTEM_RESET,          write_system_reset },
+    { ALERT_TYPE_START_ALL_PUMPS,       write_start_all_pumps },
+    { ALERT_TYPE_PUMP_STATE_CHANGE,     write_pump_state_change },
+    { ALERT_TYPE_PUMP_EXTEND_TIME,      write_pump_extend_time },
+    { ALERT_TYPE_FIRE_DETECTED,         write_fire_detected },
+    { ALERT_TYPE_FIRE_CLEARED,          write_fire_cleared },
+    { ALERT_TYPE_MULTIPLE_FIRES,        write_multiple_fires },
+    { ALERT_TYPE_WATER_LOCKOUT,         write_water_lockout },
+    { ALERT_TYPE_DOOR_STATUS,           write_door_status },
+    { ALERT_TYPE_WIFI_UPDATE,           write_wifi_update },
+    { ALERT_TYPE_SENSOR_FAULT,          write_sensor_fault },
+    { ALERT_TYPE_SYSTEM_ERROR,          write_system_error },
+    { ALERT_TYPE_CONTINUOUS_FEED,       write_continuous_feed },
+    { ALERT_TYPE_PCA9555_FAIL,          write_pca9555_fail },
+    { ALERT_TYPE_HARDWARE_CONTROL_FAIL, write_hardware_fault },
+    { ALERT_TYPE_ADC_INIT_FAIL,         write_hardware_fault },
+    { ALERT_TYPE_CURRENT_SENSOR_FAULT,  write_hardware_fault },
+    { ALERT_TYPE_IR_SENSOR_FAULT,       write_hardware_fault },
+    { ALERT_TYPE_BATTERY_CRITICAL,      write_power_status },
+    { ALERT_TYPE_BATTERY_LOW,           write_power_status },
+    { ALERT_TYPE_SOLAR_FAULT,           write_power_status },
+    { ALERT_TYPE_STATE_CORRUPTION,      write_integrity },
+    { ALERT_TYPE_TASK_FAILURE,          write_integrity },
+};
+
+static void write_alert_payload(json_writer_t *w, const Alert *alert) {
+    for (size_t i = 0; i < sizeof(alertSchemas) / sizeof(alertSchemas[0]); i++) {
+        if (alertSchemas[i].type == alert->type) {
+            alertSchemas[i].write(w, alert);
+            return;
+        }
+    }
+    printf("\n[ALERT] Unknown alert type: %d", alert->type);
+}
+
+// ========================================
+// ALERT COALESCING
+// ========================================
+// Fire and water lockout alerts can flap on noisy readings. The first edge
+// goes out at once; repeats inside the hold-down window are merged into one
+// alert carrying the count and the first/last timestamps.
+
+// Coalescing keys: family in the high byte, instance (sector) in the low byte
+#define COALESCE_FAMILY_FIRE        1
+#define COALESCE_FAMILY_MULTI_FIRE  2
+#define COALESCE_FAMILY_WATER       3
+
+static char coalesceFirstTimestamp[ALERT_COALESCER_SLOTS][30];   // Alert task only
+
+static uint32_t coalesce_sector_key(const char *sector) {
+    static const char *const sectors[4] = {"NORTH", "SOUTH", "EAST", "WEST"};
+    for (uint32_t i = 0; i < 4; i++) {
+        if (strcmp(sector, sectors[i]) == 0) {
+            return i;
+        }
+    }
+    return 0xFF;
+}
+
+// False for alert types that always go straight out
+static bool alert_coalesce_event(const Alert *alert, alert_coalescer_event_t *ev) {
+    ev->rank = 0;
+    switch (alert->type) {
+        case ALERT_TYPE_FIRE_DETECTED:
+        case ALERT_TYPE_FIRE_CLEARED:
+            ev->key = (COALESCE_FAMILY_FIRE << 8) | coalesce_sector_key(alert->data.fire.sector);
+            ev->edge = (alert->type == ALERT_TYPE_FIRE_DETECTED);
+            ev->hold_ms = ALERT_HOLD_FIRE_MS;
+            ev->max_hold_ms = ALERT_HOLD_FIRE_MAX_MS;
+            break;
+        case ALERT_TYPE_MULTIPLE_FIRES:
+            ev->key = COALESCE_FAMILY_MULTI_FIRE << 8;
+            ev->edge = (uint8_t)alert->data.multipleFires.activeFireCount;
+            // Three sectors and full system are both emergencies: more
+            // sectors burning must still go out at once
+            ev->rank = (uint8_t)alert->data.multipleFires.activeFireCount;
+            ev->hold_ms = ALERT_HOLD_FIRE_MS;
+            ev->max_hold_ms = ALERT_HOLD_FIRE_MAX_MS;
+            break;
+        case ALERT_TYPE_WATER_LOCKOUT:
+            ev->key = COALESCE_FAMILY_WATER << 8;
+            ev->edge = alert->data.waterLockout.activated;
+            ev->hold_ms = ALERT_HOLD_WATER_MS;
+            ev->max_hold_ms = ALERT_HOLD_WATER_MAX_MS;
+            break;
+        default:
+            return false;
+    }
+    ev->severity = (uint8_t)alert->severity;
+    return true;
+}
+
+static mqtt_lane_t alert_lane(alert_severity_t severity) {
+    switch (severity) {
+        case ALERT_SEVERITY_EMERGENCY: return MQTT_LANE_EMERGENCY;
+        case ALERT_SEVERITY_CRITICAL:  return MQTT_LANE_CRITICAL;
+        default:                       return MQTT_LANE_NORMAL;
+    }
+}
+
+// SPIFFS copies that could not be written yet. Their journal entry stays
+// unstored, so the watermark cannot pass them and a PUBACK does not free
+// them, until a retry writes the copy or the broker has acknowledged it.
+#define ALERT_STORE_RETRY_SLOTS     2
+
+typedef struct {
+    uint32_t seq;                       // 0 = free
+    char topic[128];
+    char payload[MAX_ALERT_SIZE + 1];
+} alert_store_retry_t;
+
+static alert_store_retry_t alertStoreRetry[ALERT_STORE_RETRY_SLOTS];    // Alert task only
+
+static void hold_alert_copy(uint32_t seq, const char *topic, const char *payload) {
+    for (int i = 0; i < ALERT_STORE_RETRY_SLOTS; i++) {
+        alert_store_retry_t *r = &alertStoreRetry[i];
+        if (r->seq == 0) {
+            r->seq = seq;
+            strncpy(r->topic, topic, sizeof(r->topic) - 1);
+            r->topic[sizeof(r->topic) - 1] = '\0';
+            strncpy(r->payload, payload, sizeof(r->payload) - 1);
+            r->payload[sizeof(r->payload) - 1] = '\0';
+            printf("\n[ALERT] Alert %lu held for another storage attempt", (unsigned long)seq);
+            return;
+        }
+    }
+    // Nowhere to keep it: the live send is its only chance
+    printf("\n[ALERT] ERROR: Alert %lu has no durable copy (%d storage retries pending)",
+           (unsigned long)seq, ALERT_STORE_RETRY_SLOTS);
+    mark_alert_stored(seq);
+}
+
+static void retry_alert_copies(void) {
+    for (int i = 0; i < ALERT_STORE_RETRY_SLOTS; i++) {
+        alert_store_retry_t *r = &alertStoreRetry[i];
+        if (r->seq == 0) continue;
         
-        // Add common fields (same for ALL alerts)
-        cJSON_AddStringToObject(root, "macAddress", mac_address);
-        cJSON_AddStringToObject(root, "event", "alert");
-        cJSON_AddStringToObject(root, "devicetype", "G");
-        cJSON_AddStringToObject(root, "timestamp", alert.timestamp);
+        // Already acknowledged: no copy needed any more
+        if (alert_seq_state(r->seq) == ALERT_JOURNAL_ACKED ||
+            store_alert_to_spiffs_seq(r->topic, r->payload, r->seq) == ESP_OK) {
+            mark_alert_stored(r->seq);
+            r->seq = 0;
+        }
+    }
+}
+
+static void publish_alert(const Alert *alert, const alert_coalescer_emit_t *emit) {
+    static char json_str[JSON_BUFFER_SIZE];     // Alert task only
+    uint32_t seq = open_alert_seq();
+    
+    json_writer_t w;
+    json_writer_init(&w, json_str, sizeof(json_str));
+    json_begin_event(&w, "alert", alert->timestamp);
+    
+    // Common payload fields, then the type's schema
+    json_writer_begin_object(&w, "payload");
+    json_writer_string(&w, "alertType", get_alert_type_string(alert->type));
+    json_writer_string(&w, "severity", get_severity_string(alert->severity));
+    json_writer_string(&w, "message", alert->message);
+    if (seq != 0) {
+        json_writer_number(&w, "seq", seq);     // Lets the cloud drop a replayed duplicate
+    }
+    write_alert_payload(&w, alert);
+    
+    // Merged alerts say how many they stand for; left out rather than
+    // losing the alert if the message would not fit
+    if (emit->occurrences > 1 && emit->slot >= 0) {
+        json_writer_mark_t mark = json_writer_mark(&w);
+        json_writer_number(&w, "occurrences", emit->occurrences);
+        json_writer_number(&w, "flaps", emit->flaps);
+        json_writer_string(&w, "firstTimestamp", coalesceFirstTimestamp[emit->slot]);
+        json_writer_string(&w, "lastTimestamp", alert->timestamp);
+        if (!json_writer_keep(&w, &mark)) {
+            printf("\n[JSON] Alert too large, merge counts left out");
+        }
+        printf("\n[ALERT] %s merged %u occurrences (%u flaps)",
+               get_alert_type_string(alert->type), (unsigned int)emit->occurrences, (unsigned int)emit->flaps);
+    }
+    json_writer_end_object(&w);
+    
+    if (json_end(&w, "Alert")) {
+        // Publish to AWS IoT
+        char topic[128];
+        snprintf(topic, sizeof(topic), "Request/%s/Alerts", mac_address);
         
-        // Create payload object
-        cJSON *payload = cJSON_CreateObject();
-        if (!payload) {
-            cJSON_Delete(root);
-            continue;
+        mqtt_lane_t lane = alert_lane(alert->severity);
+        printf("\n[ALERT] Publishing alert  (%s) to: %s [%s lane]", 
+   		get_alert_type_string(alert->type), topic, mqtt_lane_name(lane));
+        
+        if (seq == 0) {
+            // Journal full: stored only if it cannot be sent, as before
+            if (!enqueue_mqtt_publish_lane(topic, json_str, lane, 1, true, &alert->trace, 0)) {
+                printf("\n[ALERT] Publish queue full, storing alert persistently");
+                store_alert_to_spiffs(topic, json_str);
+            }
+            return;
         }
         
-        // Add common payload fields
-        cJSON_AddStringToObject(payload, "alertType", get_alert_type_string(alert.type));
-        cJSON_AddStringToObject(payload, "severity", get_severity_string(alert.severity));
-        cJSON_AddStringToObject(payload, "message", alert.message);
+        // The publish task sends it ahead of lower lanes and records the latency.
+        // The SPIFFS copy is written after queueing so it does not hold up the
+        // send, and is removed once the broker acknowledges it.
+        bool queued = enqueue_mqtt_publish_lane(topic, json_str, lane, 1, false, &alert->trace, seq);
+        if (store_alert_to_spiffs_seq(topic, json_str, seq) == ESP_OK) {
+            mark_alert_stored(seq);
+        } else {
+            hold_alert_copy(seq, topic, json_str);
+        }
+        if (!queued) {
+            printf("\n[ALERT] Publish queue full, alert %lu left to the backlog replay", (unsigned long)seq);
+            park_alert_seq(seq);
+        }
+    } else {
+        // Too large to send: nothing to deliver
+        mark_alert_stored(seq);
+        park_alert_seq(seq);
+    }
+}
+
+static void process_alerts(void) {
+    static Alert alert;     // Alert task only; keeps the record off its stack
+    alert_pool_handle_t handle;
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    
+    retry_alert_copies();
+    
+    while (xQueueReceive(alert_queue, &handle, 0) == pdTRUE) {
+        read_alert_record(handle, &alert);
+        latency_trace_record(LATENCY_RELAY_TO_QUEUED, alert.trace.relay_us, alert.trace.queued_us);
+        
+        alert_coalescer_emit_t emit = { .slot = -1, .record = handle, .occurrences = 1, .flaps = 0 };
+        alert_coalescer_event_t ev;
+        if (alert_coalesce_event(&alert, &ev)) {
+            alert_pool_handle_t superseded;
+            bool sendNow = alert_coalescer_offer(&alertCoalescer, &ev, handle, now_ms, &superseded, &emit);
+            release_alert_record(superseded);
+            if (!sendNow) {
+                // Held: the coalescer owns the record until its window ends
+                if (emit.occurrences == 1) {
+                    strncpy(coalesceFirstTimestamp[emit.slot], alert.timestamp,
+                            sizeof(coalesceFirstTimestamp[0]) - 1);
+                }
+                continue;
+            }
+        }
         
-        // Add type-specific payload fields
-        switch(alert.type) {
-            
-            // ==========================================
-            // ALERT #1: PROFILE CHANGE
-            // ==========================================
-            case ALERT_TYPE_PROFILE_CHANGE:
-                cJSON_AddNumberToObject(payload, "previousProfile", alert.data.profile.previousProfile);
-                cJSON_AddNumberToObject(payload, "currentProfile", alert.data.profile.currentProfile);
-                cJSON_AddStringToObject(payload, "profileName", alert.data.profile.profileName);
-                break;
-            
-            // ==========================================
-            // ALERT #2-3: EMERGENCY STOP
-            // ==========================================
-            case ALERT_TYPE_EMERGENCY_STOP:
-                cJSON_AddStringToObject(payload, "action", 
-                    alert.data.emergencyStop.activated ? "ACTIVATED" : "DEACTIVATED");
-                
-                if (alert.data.emergencyStop.activated) {
-                    cJSON_AddBoolToObject(payload, "allPumpsStopped", true);
-                    
-                    // Add affected pumps array
-                    cJSON *affectedPumps = cJSON_CreateArray();
-                    for (int i = 0; i < alert.data.emergencyStop.affectedPumpCount; i++) {
-                        cJSON *pump = cJSON_CreateObject();
-                        cJSON_AddNumberToObject(pump, "pumpId", 
-                            alert.data.emergencyStop.affectedPumps[i].pumpId);
-                        cJSON_AddStringToObject(pump, "pumpName", 
-                            alert.data.emergencyStop.affectedPumps[i].pumpName);
-                        cJSON_AddStringToObject(pump, "previousState", 
-                            get_pump_state_string_for_alert(
-                                alert.data.emergencyStop.affectedPumps[i].previousState));
-                        cJSON_AddItemToArray(affectedPumps, pump);
-                    }
-                    cJSON_AddItemToObject(payload, "affectedPumps", affectedPumps);
-                } else {
-                    cJSON_AddStringToObject(payload, "systemStatus", "OPERATIONAL");
-                }
-                break;
-            
-            // ==========================================
-            // ALERT #3: SYSTEM RESET
-            // ==========================================
-            case ALERT_TYPE_SYSTEM_RESET:
-                cJSON_AddStringToObject(payload, "resetType", alert.data.systemReset.resetType);
-                cJSON_AddStringToObject(payload, "defaultProfile", alert.data.systemReset.defaultProfile);
-                cJSON_AddBoolToObject(payload, "allPumpsReset", alert.data.systemReset.allPumpsReset);
-                cJSON_AddBoolToObject(payload, "emergencyStopCleared", 
-                    alert.data.systemReset.emergencyStopCleared);
-                break;
-            
-            // ==========================================
-            // ALERT #4-5: START ALL PUMPS
-            // ==========================================
-            case ALERT_TYPE_START_ALL_PUMPS:
-                cJSON_AddStringToObject(payload, "action", 
-                    alert.data.startAllPumps.activated ? "ACTIVATED" : "DEACTIVATED");
-                
-                if (alert.data.startAllPumps.activated) {
-                    cJSON_AddNumberToObject(payload, "duration", alert.data.startAllPumps.duration);
-                    
-                    // Add activated pumps array
-                    cJSON *activatedPumps = cJSON_CreateArray();
-                    for (int i = 0; i < 4; i++) {
-                        cJSON *pump = cJSON_CreateObject();
-                        cJSON_AddNumberToObject(pump, "pumpId", i + 1);
-                        
-                        // Get pump name
-                        char pumpName[16];
-                        switch(i) {
-                            case 0: strcpy(pumpName, "North"); break;
-                            case 1: strcpy(pumpName, "South"); break;
-                            case 2: strcpy(pumpName, "East"); break;
-                            case 3: strcpy(pumpName, "West"); break;
-                        }
-                        cJSON_AddStringToObject(pump, "pumpName", pumpName);
-                        cJSON_AddItemToArray(activatedPumps, pump);
-                    }
-                    cJSON_AddItemToObject(payload, "activatedPumps", activatedPumps);
-                    cJSON_AddBoolToObject(payload, "waterLockout", alert.data.startAllPumps.waterLockout);
-                } else {
-                    cJSON_AddStringToObject(payload, "reason", alert.data.startAllPumps.reason);
-                    cJSON_AddNumberToObject(payload, "totalRuntime", alert.data.startAllPumps.totalRuntime);
-                }
-                break;
-            
-            // ==========================================
-            // ALERT #6-9: PUMP STATE CHANGE
-            // ==========================================
-            case ALERT_TYPE_PUMP_STATE_CHANGE:
-		    cJSON_AddNumberToObject(payload, "pumpId", alert.data.pump.pumpId);
-		    cJSON_AddStringToObject(payload, "pumpName", alert.data.pump.pumpName);
-		    cJSON_AddStringToObject(payload, "previousState", 
-		        get_pump_state_string_for_alert(alert.data.pump.previousState));
-		    cJSON_AddStringToObject(payload, "currentState", 
-		        get_pump_state_string_for_alert(alert.data.pump.currentState));
-		    
-		    // ✅ NEW: Add auto/manual mode flags
-		    cJSON_AddBoolToObject(payload, "autoEnabled", alert.data.pump.autoEnabled);
-		    cJSON_AddBoolToObject(payload, "manualEnabled", alert.data.pump.manualEnabled);
-		    
-		    // Add state-specific fields
-		    if (alert.data.pump.currentState == 1) { // AUTO_ACTIVE
-		        cJSON_AddStringToObject(payload, "activationMode", "AUTOMATIC");
-		        if (strlen(alert.data.pump.trigger) > 0) {
-		            cJSON_AddStringToObject(payload, "trigger", alert.data.pump.trigger);
-		        }
-		        
-		    } else if (alert.data.pump.currentState == 2) { // MANUAL_ACTIVE
-		        cJSON_AddStringToObject(payload, "activationMode", "MANUAL");
-		        if (strlen(alert.data.pump.activationSource) > 0) {
-		            cJSON_AddStringToObject(payload, "activationSource", 
-		                alert.data.pump.activationSource);
-		        }
-		    } else if (alert.data.pump.currentState == 0) { // OFF
-		        if (strlen(alert.data.pump.stopReason) > 0) {
-		            cJSON_AddStringToObject(payload, "stopReason", 
-		                alert.data.pump.stopReason);
-		        }
-		        if (alert.data.pump.totalRuntime > 0) {
-		            cJSON_AddNumberToObject(payload, "totalRuntime", 
-		                alert.data.pump.totalRuntime);
-		        }
-		    } else if (alert.data.pump.currentState == 3) { // COOLDOWN
-		        cJSON_AddNumberToObject(payload, "cooldownDuration", 
-		            alert.data.pump.cooldownDuration);
-		        if (alert.data.pump.previousRuntime > 0) {
-		            cJSON_AddNumberToObject(payload, "previousRuntime", 
-		                alert.data.pump.previousRuntime);
-		        }
-		    }
-		    break;
-            
-            // ==========================================
-            // ALERT #10: PUMP TIMER EXTENSION
-            // ==========================================
-            case ALERT_TYPE_PUMP_EXTEND_TIME:
-			    cJSON_AddNumberToObject(payload, "pumpId", alert.data.pumpExtend.pumpId);
-			    cJSON_AddStringToObject(payload, "pumpName", alert.data.pumpExtend.pumpName);
-			    cJSON_AddNumberToObject(payload, "extensionDuration", alert.data.pumpExtend.extensionDuration);
-			    cJSON_AddNumberToObject(payload, "remainingTime", alert.data.pumpExtend.remainingTime + alert.data.pumpExtend.extensionDuration );
-                break;
-            
-            // ==========================================
-            // ALERT #11: FIRE DETECTED
-            // ==========================================
-            case ALERT_TYPE_FIRE_DETECTED:
-		    {
-		        // ✅ Determine fire type flags
-		        bool isSingleSector = (alert.data.fire.fireType == FIRE_TYPE_SINGLE_SECTOR);
-		        bool isMultipleSectors = (alert.data.fire.fireType == FIRE_TYPE_MULTIPLE_SECTORS);
-		        bool isFullSector = (alert.data.fire.fireType == FIRE_TYPE_FULL_SYSTEM);
-		        
-		        // Add fire type boolean flags
-		        cJSON_AddBoolToObject(payload, "Single Sector", isSingleSector);
-		        cJSON_AddBoolToObject(payload, "Multiple Sectors", isMultipleSectors);
-		        cJSON_AddBoolToObject(payload, "Full Sector", isFullSector);
-		        
-		        // Create affectedSectors array with single sector
-		        cJSON *affectedSectors = cJSON_CreateArray();
-		        cJSON *sector = cJSON_CreateObject();
-		        cJSON_AddStringToObject(sector, "sector", alert.data.fire.sector);
-		        cJSON_AddNumberToObject(sector, "temperature", alert.data.fire.temperature);
-		        cJSON_AddBoolToObject(sector, "pumpActive", alert.data.fire.pumpActivated);
-		        cJSON_AddItemToArray(affectedSectors, sector);
-		        cJSON_AddItemToObject(payload, "affectedSectors", affectedSectors);
-		        
-		        // Add water level and estimated runtime
-		        cJSON_AddNumberToObject(payload, "waterLevel", level_s);
-		        cJSON_AddNumberToObject(payload, "estimatedRuntime", 0);
-		    }
-		    break;
-		            
-            // ==========================================
-            // ALERT #12: FIRE CLEARED
-            // ==========================================
-            case ALERT_TYPE_FIRE_CLEARED:
-                cJSON_AddStringToObject(payload, "sector", alert.data.fire.sector);
-                cJSON_AddNumberToObject(payload, "sensorId", alert.data.fire.sensorId);
-                cJSON_AddNumberToObject(payload, "currentTemperature", alert.data.fire.currentTemperature);
-                if (alert.data.fire.duration > 0) {
-                    cJSON_AddNumberToObject(payload, "duration", alert.data.fire.duration);
-                }
-                break;
-            
-            // ==========================================
-			// ALERT #13: MULTIPLE FIRES (2-4 SECTORS)
-			// ==========================================
-			case ALERT_TYPE_MULTIPLE_FIRES:
-			    {
-			        // ✅ Determine fire type flags
-			        bool isSingleSector = false;  // Never true for multiple fires
-			        bool isMultipleSectors = (alert.data.multipleFires.fireType == FIRE_TYPE_MULTIPLE_SECTORS);
-			        bool isFullSector = (alert.data.multipleFires.fireType == FIRE_TYPE_FULL_SYSTEM);
-			        
-			        // Add fire type boolean flags
-			        cJSON_AddBoolToObject(payload, "Single Sector", isSingleSector);
-			        cJSON_AddBoolToObject(payload, "Multiple Sectors", isMultipleSectors);
-			        cJSON_AddBoolToObject(payload, "Full Sector", isFullSector);
-			        
-			        // Add affected sectors array
-			        cJSON *affectedSectors = cJSON_CreateArray();
-			        for (int i = 0; i < alert.data.multipleFires.activeFireCount && i < 4; i++) {
-			            cJSON *sector = cJSON_CreateObject();
-			            cJSON_AddStringToObject(sector, "sector", 
-			                alert.data.multipleFires.affectedSectors[i].sector);
-			            cJSON_AddNumberToObject(sector, "temperature", 
-			                alert.data.multipleFires.affectedSectors[i].temperature);
-			            cJSON_AddBoolToObject(sector, "pumpActive", 
-			                alert.data.multipleFires.affectedSectors[i].pumpActive);
-			            cJSON_AddItemToArray(affectedSectors, sector);
-			        }
-			        cJSON_AddItemToObject(payload, "affectedSectors", affectedSectors);
-			        
-			        cJSON_AddNumberToObject(payload, "waterLevel", alert.data.multipleFires.waterLevel);
-			        cJSON_AddNumberToObject(payload, "estimatedRuntime", 0);
-			    }
-			    break;
-            
-            // ==========================================
-            // ALERT #14-15: WATER LOCKOUT
-            // ==========================================
-            case ALERT_TYPE_WATER_LOCKOUT:
-                cJSON_AddStringToObject(payload, "action", 
-                    alert.data.waterLockout.activated ? "ACTIVATED" : "DEACTIVATED");
-                cJSON_AddNumberToObject(payload, "currentWaterLevel", 
-                    alert.data.waterLockout.currentWaterLevel);
-                
-                if (alert.data.waterLockout.activated) {
-                    cJSON_AddNumberToObject(payload, "minThreshold", alert.data.waterLockout.minThreshold);
-                    cJSON_AddBoolToObject(payload, "allPumpsDisabled", 
-                        alert.data.waterLockout.allPumpsDisabled);
-                    cJSON_AddBoolToObject(payload, "continuousFeedActive", 
-                        alert.data.waterLockout.continuousFeedActive);
-                } else {
-                    cJSON_AddStringToObject(payload, "systemStatus", alert.data.waterLockout.systemStatus);
-                }
-                break;
-            
-            // ==========================================
-            // ALERT #16-17:DOOR STATUS
-            // ==========================================
-            case ALERT_TYPE_DOOR_STATUS:
-                cJSON_AddStringToObject(payload, "action", alert.data.door.action);
-                cJSON_AddBoolToObject(payload, "doorState", alert.data.door.doorState);
-                
-                if (alert.data.door.opened) {
-                    cJSON_AddBoolToObject(payload, "securityConcern", alert.data.door.securityConcern);
-                } else {
-                    if (alert.data.door.wasOpenDuration > 0) {
-                        cJSON_AddNumberToObject(payload, "wasOpenDuration", 
-                            alert.data.door.wasOpenDuration);
-                    }
-                }
-                break;
-            
-         
-            // ==========================================
-            // ALERT #21-22: WIFI UPDATE
-            // ==========================================
-            case ALERT_TYPE_WIFI_UPDATE:
-                cJSON_AddStringToObject(payload, "action", alert.data.wifi.action);
-                
-                if (strcmp(alert.data.wifi.action, "CREDENTIALS_UPDATED") == 0) {
-                    cJSON_AddStringToObject(payload, "newSSID", alert.data.wifi.newSSID);
-                    if (strlen(alert.data.wifi.previousSSID) > 0) {
-                        cJSON_AddStringToObject(payload, "previousSSID", alert.data.wifi.previousSSID);
-                    }
-                    cJSON_AddBoolToObject(payload, "requiresReboot", alert.data.wifi.requiresReboot);
-                    cJSON_AddBoolToObject(payload, "stored", alert.data.wifi.stored);
-                } else {
-                    // Invalid credentials
-                    cJSON_AddStringToObject(payload, "errorType", alert.data.wifi.errorType);
-                    cJSON_AddStringToObject(payload, "errorCode", alert.data.wifi.errorCode);
-                    
-                    cJSON *details = cJSON_CreateObject();
-                    cJSON_AddNumberToObject(details, "ssidLength", alert.data.wifi.ssidLength);
-                    cJSON_AddNumberToObject(details, "passwordLength", alert.data.wifi.passwordLength);
-                    cJSON_AddStringToObject(details, "reason", alert.data.wifi.reason);
-                    cJSON_AddItemToObject(payload, "details", details);
-                }
-                break;
-            
-            // ==========================================
-            // ALERT #23: SENSOR FAULT
-            // ==========================================
-            case ALERT_TYPE_SENSOR_FAULT:
-                cJSON_AddStringToObject(payload, "sensorType", alert.data.sensorFault.sensorType);
-                cJSON_AddNumberToObject(payload, "sensorId", alert.data.sensorFault.sensorId);
-                cJSON_AddStringToObject(payload, "sectorAffected", alert.data.sensorFault.sectorAffected);
-                cJSON_AddStringToObject(payload, "errorCode", alert.data.sensorFault.errorCode);
-                cJSON_AddNumberToObject(payload, "lastValidReading", 
-                    alert.data.sensorFault.lastValidReading);
-                break;
-            
-          
-            // ==========================================
-            // ALERT #24: SYSTEM ERROR (GENERIC)
-            // ==========================================
-            case ALERT_TYPE_SYSTEM_ERROR:
-                cJSON_AddStringToObject(payload, "errorType", alert.data.systemError.errorType);
-                cJSON_AddStringToObject(payload, "errorCode", alert.data.systemError.errorCode);
-                if (strlen(alert.data.systemError.details) > 0) {
-                    cJSON_AddStringToObject(payload, "details", alert.data.systemError.details);
-                }
-                break;
-            
-            // ==========================================
-            // ALERT #25: CONTINUOUS FEED
-            // ==========================================
-            case ALERT_TYPE_CONTINUOUS_FEED:
-                cJSON_AddStringToObject(payload, "action", 
-                    alert.data.continuousFeed.activated ? "ACTIVATED" : "DEACTIVATED");
-                cJSON_AddStringToObject(payload, "profile", alert.data.continuousFeed.profile);
-                cJSON_AddBoolToObject(payload, "waterLockoutDisabled", 
-                    alert.data.continuousFeed.waterLockoutDisabled);
-                cJSON_AddBoolToObject(payload, "unlimitedWaterSupply", 
-                    alert.data.continuousFeed.unlimitedWaterSupply);
-                break;
-            
-            // ==========================================
-            // ALERT #26: HARDWARE FAULT ALERTS
-            // ==========================================
-            case ALERT_TYPE_PCA9555_FAIL:
-                cJSON_AddStringToObject(payload, "hardwareType", 
-                    alert.data.hardwareFault.hardwareType);
-                cJSON_AddNumberToObject(payload, "componentId", 
-                    alert.data.hardwareFault.componentId);
-                cJSON_AddStringToObject(payload, "errorCode", 
-                    alert.data.hardwareFault.errorCode);
-                cJSON_AddStringToObject(payload, "errorMessage", 
-                    alert.data.hardwareFault.errorMessage);
-                cJSON_AddBoolToObject(payload, "systemCritical", 
-                    alert.data.hardwareFault.systemCritical);
-                cJSON_AddNumberToObject(payload, "affectedPumpCount", 
-                    alert.data.hardwareFault.affectedPumpCount);
-                cJSON_AddStringToObject(payload, "affectedPumps", 
-                    alert.data.hardwareFault.affectedPumps);
-                break;
-            
-            case ALERT_TYPE_HARDWARE_CONTROL_FAIL:
-            case ALERT_TYPE_ADC_INIT_FAIL:
-            case ALERT_TYPE_CURRENT_SENSOR_FAULT:
-            case ALERT_TYPE_IR_SENSOR_FAULT:
-                // Same structure as PCA9555_FAIL
-                cJSON_AddStringToObject(payload, "hardwareType", 
-                    alert.data.hardwareFault.hardwareType);
-                cJSON_AddNumberToObject(payload, "componentId", 
-                    alert.data.hardwareFault.componentId);
-                cJSON_AddStringToObject(payload, "errorCode", 
-                    alert.data.hardwareFault.errorCode);
-                cJSON_AddStringToObject(payload, "errorMessage", 
-                    alert.data.hardwareFault.errorMessage);
-                cJSON_AddBoolToObject(payload, "systemCritical", 
-                    alert.data.hardwareFault.systemCritical);
-                if (alert.data.hardwareFault.affectedPumpCount > 0) {
-                    cJSON_AddNumberToObject(payload, "affectedPumpCount", 
-                        alert.data.hardwareFault.affectedPumpCount);
-                    cJSON_AddStringToObject(payload, "affectedPumps", 
-                        alert.data.hardwareFault.affectedPumps);
-                }
-                break;
-            
-            // ==========================================
-            // ALERT #27: POWER ALERTS
-            // ==========================================
-            case ALERT_TYPE_BATTERY_CRITICAL:
-            case ALERT_TYPE_BATTERY_LOW:
-            case ALERT_TYPE_SOLAR_FAULT:
-                cJSON_AddNumberToObject(payload, "batteryVoltage", 
-                    alert.data.powerStatus.batteryVoltage);
-                cJSON_AddNumberToObject(payload, "solarVoltage", 
-                    alert.data.powerStatus.solarVoltage);
-                cJSON_AddNumberToObject(payload, "threshold", 
-                    alert.data.powerStatus.threshold);
-                cJSON_AddStringToObject(payload, "powerState", 
-                    alert.data.powerStatus.powerState);
-                if (alert.data.powerStatus.estimatedRuntime > 0) {
-                    cJSON_AddNumberToObject(payload, "estimatedRuntime", 
-                        alert.data.powerStatus.estimatedRuntime);
-                }
-                cJSON_AddBoolToObject(payload, "chargingActive", 
-                    alert.data.powerStatus.chargingActive);
-                break;
-            
-            // ==========================================
-            // ALERT #28: SYSTEM INTEGRITY ALERTS
-            // ==========================================
-            case ALERT_TYPE_STATE_CORRUPTION:
-            case ALERT_TYPE_TASK_FAILURE:
-                cJSON_AddStringToObject(payload, "integrityType", 
-                    alert.data.integrity.integrityType);
-                cJSON_AddStringToObject(payload, "componentName", 
-                    alert.data.integrity.componentName);
-                cJSON_AddNumberToObject(payload, "errorValue", 
-                    alert.data.integrity.errorValue);
-                if (alert.data.integrity.expectedValue != 0) {
-                    cJSON_AddNumberToObject(payload, "expectedValue", 
-                        alert.data.integrity.expectedValue);
-                }
-                cJSON_AddStringToObject(payload, "action", 
-                    alert.data.integrity.action);
-                break;
-            
-            default:
-                printf("\n[ALERT] Unknown alert type: %d", alert.type);
-                break;
-        }
-        
-        // Add payload to root
-        cJSON_AddItemToObject(root, "payload", payload);
-        
-        // Convert to JSON string
-        char *json_str = create_compact_json_string(root);
-        if (json_str) {
-            // Publish to AWS IoT
-            char topic[128];
-            snprintf(topic, sizeof(topic), "Request/%s/Alerts", mac_address);
-            
-            printf("\n[ALERT] Publishing alert  (%s) to: %s", 
-       		get_alert_type_string(alert.type), topic);
-            
-            if (mqtt_connected && mqtt_client) {
-                int msg_id = esp_mqtt_client_publish(mqtt_client, topic, json_str, 0, 1, 0);
-                if (msg_id >= 0) {
-                    printf("\n[ALERT] Published successfully (msg_id: %d)", msg_id);
-                } else {
-		            printf("\n[ALERT] Failed to publish to AWS IoT, storing persistently");
-		            store_alert_to_spiffs(topic, json_str);
-		            enqueue_mqtt_publish(topic, json_str);
-		        }
-            } else {
-			        printf("\n[ALERT] MQTT not connected, storing alert persistently");
-			        store_alert_to_spiffs(topic, json_str);
-			        enqueue_mqtt_publish(topic, json_str);
-			    }
-            
-            free(json_str);
-        }
-        
-        cJSON_Delete(root);
+        release_alert_record(handle);
+        publish_alert(&alert, &emit);
+    }
+    
+    // Held alerts whose window has ended go out once
+    alert_coalescer_emit_t due;
+    while (alert_coalescer_due(&alertCoalescer, now_ms, &due)) {
+        take_alert_record(due.record, &alert);
+        // Held on purpose: keep the wait out of the latency figures
+        memset(&alert.trace, 0, sizeof(alert.trace));
+        publish_alert(&alert, &due);
     }
 }
 
@@ -9035,7 +9727,23 @@ static bool queue_alert(Alert *alert) {
         return false;
     }
     
-    if (xQueueSend(alert_queue, alert, pdMS_TO_TICKS(100)) != pdPASS) {
+    // Recorded by the alert task: several tasks queue alerts, and each
+    // latency stage must have a single writer
+    if (alert->trace.sample_us != 0) {
+        alert->trace.queued_us = esp_timer_get_time();
+    }
+    
+    alert_pool_handle_t handle = store_alert_record(alert);
+    if (handle == ALERT_POOL_NONE) {
+        printf("\n[ALERT] Alert pool full (%u blocks)", (unsigned int)ALERT_POOL_BLOCKS);
+        return false;
+    }
+    
+    // Input callbacks (door) run in the timer service task: waiting on a
+    // full queue there would stall every software timer
+    bool timer_task = xTaskGetCurrentTaskHandle() == xTimerGetTimerDaemonTaskHandle();
+    if (xQueueSend(alert_queue, &handle, timer_task ? 0 : pdMS_TO_TICKS(100)) != pdPASS) {
+        release_alert_record(handle);
         printf("\n[ALERT] Alert queue full");
         return false;
     }
@@ -9050,19 +9758,26 @@ static void check_battery_status(void) {
     static bool battery_low_alert_sent = false;
     static bool battery_critical_alert_sent = false;
     
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    if (frame.seq == 0) {
+        return;
+    }
+    const float batteryVoltage = frame.batteryVoltage;
+    
     // Check battery voltage
-    if (bat_v < 10.5 && !battery_critical_alert_sent) {
-        int estimated_runtime = (int)((bat_v - 10.0) * 30); // Rough estimate
-        send_alert_battery_critical(bat_v, estimated_runtime);
+    if (batteryVoltage < 10.5 && !battery_critical_alert_sent) {
+        int estimated_runtime = (int)((batteryVoltage - 10.0) * 30); // Rough estimate
+        send_alert_battery_critical(batteryVoltage, estimated_runtime);
         battery_critical_alert_sent = true;
-    } else if (bat_v > 11.0) {
+    } else if (batteryVoltage > 11.0) {
         battery_critical_alert_sent = false;
     }
     
-    if (bat_v < 11.5 && bat_v >= 10.5 && !battery_low_alert_sent) {
-        send_alert_battery_low(bat_v, 11.5);
+    if (batteryVoltage < 11.5 && batteryVoltage >= 10.5 && !battery_low_alert_sent) {
+        send_alert_battery_low(batteryVoltage, 11.5);
         battery_low_alert_sent = true;
-    } else if (bat_v > 12.0) {
+    } else if (batteryVoltage > 12.0) {
         battery_low_alert_sent = false;
     }
 }
@@ -9077,11 +9792,13 @@ void send_alert_battery_low(float batteryVoltage, float threshold) {
             "Battery voltage LOW (%.2fV) - Below %.2fV threshold",
             batteryVoltage, threshold);
     
+    SensorFrame frame;
+    sensor_frame_read(&frame);
     alert.data.powerStatus.batteryVoltage = batteryVoltage;
-    alert.data.powerStatus.solarVoltage = sol_v;
+    alert.data.powerStatus.solarVoltage = frame.solarVoltage;
     alert.data.powerStatus.threshold = threshold;
     strcpy(alert.data.powerStatus.powerState, "LOW");
-    alert.data.powerStatus.chargingActive = (sol_v > 5.0);
+    alert.data.powerStatus.chargingActive = (frame.solarVoltage > 5.0);
     
     queue_alert(&alert);
 }
@@ -9346,6 +10063,7 @@ static void send_alert_fire_detected(int sensorIndex, const char* sectorName,
                sizeof(alert.data.fire.pumpName) - 1);
     }
     
+    alert.trace = pumps[sensorIndex].trace;
     queue_alert(&alert);
 }
 
@@ -9407,7 +10125,17 @@ static void send_alert_multiple_fires(int fireCount, float sensorValues[4],
         }
     }
     
-    alert.data.multipleFires.waterLevel = level_s;
+    SensorFrame frame;
+    sensor_frame_read(&frame);
+    alert.data.multipleFires.waterLevel = frame.level;
+    
+    // Trace the response to the earliest of the burning sectors
+    for (int i = 0; i < 4; i++) {
+        if (sensorValues[i] > FIRE_THRESHOLD && pumps[i].trace.sample_us != 0 &&
+            (alert.trace.sample_us == 0 || pumps[i].trace.sample_us < alert.trace.sample_us)) {
+            alert.trace = pumps[i].trace;
+        }
+    }
     
     queue_alert(&alert);
 }
@@ -9619,12 +10347,14 @@ void send_alert_battery_critical(float batteryVoltage, int estimatedRuntime) {
             "CRITICAL: Battery voltage critically low (%.2fV) - System may shutdown!",
             batteryVoltage);
     
+    SensorFrame frame;
+    sensor_frame_read(&frame);
     alert.data.powerStatus.batteryVoltage = batteryVoltage;
-    alert.data.powerStatus.solarVoltage = sol_v;
+    alert.data.powerStatus.solarVoltage = frame.solarVoltage;
     alert.data.powerStatus.threshold = 10.5;  // Critical threshold
     strcpy(alert.data.powerStatus.powerState, "CRITICAL");
     alert.data.powerStatus.estimatedRuntime = estimatedRuntime;
-    alert.data.powerStatus.chargingActive = (sol_v > 5.0);
+    alert.data.powerStatus.chargingActive = (frame.solarVoltage > 5.0);
     
     queue_alert(&alert);
 }
@@ -9643,15 +10373,81 @@ void send_alert_state_corruption(int pumpIndex, int corruptValue) {
             "CRITICAL: Pump %d (%s) state corruption detected!",
             pumpIndex + 1, pumps[pumpIndex].name);
     
-    strcpy(alert.data.integrity.integrityType, "STATE");
-    strncpy(alert.data.integrity.componentName, pumps[pumpIndex].name, 31);
-    alert.data.integrity.errorValue = corruptValue;
-    alert.data.integrity.expectedValue = 0;  // Valid range: 0-4
-    strcpy(alert.data.integrity.action, "RESETTING_PUMP");
+    strcpy(alert.data.integrity.integrityType, "STATE");
+    strncpy(alert.data.integrity.componentName, pumps[pumpIndex].name, 31);
+    alert.data.integrity.errorValue = corruptValue;
+    alert.data.integrity.expectedValue = 0;  // Valid range: 0-4
+    strcpy(alert.data.integrity.action, "RESETTING_PUMP");
+    
+    queue_alert(&alert);
+}
+
+/**
+ * @brief Alert for a safety task missing consecutive loop deadlines
+ */
+static void send_alert_task_deadline_miss(const loop_monitor_t *monitor) {
+    Alert alert = {0};
+    alert.type = ALERT_TYPE_TASK_FAILURE;
+    alert.severity = ALERT_SEVERITY_CRITICAL;
+    strncpy(alert.timestamp, get_custom_timestamp(), sizeof(alert.timestamp) - 1);
+    
+    snprintf(alert.message, sizeof(alert.message),
+            "CRITICAL: %s task missed %lu consecutive deadlines (period %lu ms)",
+            monitor->name, (unsigned long)monitor->consecutive,
+            (unsigned long)(monitor->period_us / 1000));
+    
+    strcpy(alert.data.integrity.integrityType, "TASK");
+    strncpy(alert.data.integrity.componentName, monitor->name, 31);
+    alert.data.integrity.errorValue = (int)(monitor->exec_max_us / 1000);
+    alert.data.integrity.expectedValue = (int)(monitor->period_us / 1000);
+    strcpy(alert.data.integrity.action, "DEADLINE_MISSED");
     
     queue_alert(&alert);
 }
 
+// ========================================
+// LOOP TIMING
+// ========================================
+
+static void loop_begin(LoopId id) {
+    loop_monitor_start(&loopMonitors[id], esp_timer_get_time());
+}
+
+static void loop_finish(LoopId id) {
+    if (loop_monitor_end(&loopMonitors[id], esp_timer_get_time())) {
+        printf("\n[LOOPS] %s missed %d consecutive deadlines\n",
+               loopMonitors[id].name, LOOP_MONITOR_ALERT_MISSES);
+        send_alert_task_deadline_miss(&loopMonitors[id]);
+    }
+}
+
+#ifdef CONFIG_FIRE_TASK_PROFILER
+static TaskStatus_t profilerStatus[TASK_PROFILER_MAX_TASKS];
+
+// One profiler window per monitor iteration
+static void sample_task_profiler(void) {
+    UBaseType_t n = uxTaskGetSystemState(profilerStatus, TASK_PROFILER_MAX_TASKS, NULL);
+    if (n == 0) {
+        printf("\n[PROFILE] More than %d tasks, skipping sample", TASK_PROFILER_MAX_TASKS);
+        return;
+    }
+    for (UBaseType_t i = 0; i < n; i++) {
+        // High-water mark is in bytes on ESP-IDF
+        task_profiler_sample(&taskProfiler, profilerStatus[i].pcTaskName,
+                             profilerStatus[i].ulRunTimeCounter, profilerStatus[i].usStackHighWaterMark);
+    }
+    task_profiler_end_window(&taskProfiler);
+}
+#endif
+
+static void init_loop_monitors(void) {
+    // Event-driven loops use the longest gap they should ever leave
+    loop_monitor_init(&loopMonitors[LOOP_SENSOR], "Sensor", ADC_ACQ_SWEEP_TIMEOUT_MS, true);
+    loop_monitor_init(&loopMonitors[LOOP_CONTROL], "Ctrl", PUMP_SCHEDULE_MAX_WAIT_MS, true);
+    loop_monitor_init(&loopMonitors[LOOP_ALERT], "Alert", 2000, false);
+    loop_monitor_init(&loopMonitors[LOOP_STATE], "State", 2000, false);
+    loop_monitor_init(&loopMonitors[LOOP_MONITOR], "Mon", 8000, false);
+}
 
 static void alert_task(void *parameter) {
     TickType_t lastWakeTime = xTaskGetTickCount();
@@ -9659,6 +10455,11 @@ static void alert_task(void *parameter) {
     printf("\n[ALERT] Alert task started (sensors will be ready in %d seconds)", SENSOR_WARMUP_SECONDS);
     
     while (1) {
+        loop_begin(LOOP_ALERT);
+        
+        // Long-open door warning (and polling if the door interrupt is off)
+        check_door_status();
+        
         // Process state changes
         check_state_changes();
         
@@ -9671,6 +10472,7 @@ static void alert_task(void *parameter) {
         // Process queued alerts
         process_alerts();
         
+        loop_finish(LOOP_ALERT);
         vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(2000));
     }
 }
@@ -9682,288 +10484,522 @@ static void alert_task(void *parameter) {
 void task_serial_monitor(void *parameter) {
     TickType_t lastWakeTime = xTaskGetTickCount();
     for (;;) {
+        loop_begin(LOOP_MONITOR);
         display_system_status();
+        loop_monitor_print(loopMonitors, LOOP_COUNT);
+        if (mqttLaneMutex) {
+            // Copy first so printing does not hold up the publisher
+            mqtt_lanes_t lanes;
+            xSemaphoreTake(mqttLaneMutex, portMAX_DELAY);
+            lanes = mqttLanes;
+            xSemaphoreGive(mqttLaneMutex);
+            mqtt_lanes_print(&lanes);
+        }
+#ifdef CONFIG_FIRE_TASK_PROFILER
+        sample_task_profiler();
+        task_profiler_print(&taskProfiler);
+#endif
+#ifdef CONFIG_FIRE_JITTER_MEASURE
+        print_detect_jitter();
+#endif
+        loop_finish(LOOP_MONITOR);
         vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(8000));
     }
 }
 
 void task_sensor_reading(void *parameter) {
     TickType_t lastWakeTime = xTaskGetTickCount();
-    static int battery_check_counter = 0;
+    TickType_t lastBatteryCheck = lastWakeTime;
+    uint32_t notifiedSeq = 0;
+    uint32_t historySeq = 0;
     for (;;) {
+        // With DMA acquisition this blocks until the next mux sweep completes
 		get_sensor_data();
-        if (xSemaphoreTake(mutexSensorData, pdMS_TO_TICKS(10)) == pdTRUE) {
-            
-            xSemaphoreGive(mutexSensorData);
+        loop_begin(LOOP_SENSOR);
+        
+        // Wake the control task for fire detection on the new frame
+        uint32_t seq = sensor_frame_latest_seq();
+        if (seq != notifiedSeq) {
+            control_notify(CONTROL_EVENT_FRAME);
+            notifiedSeq = seq;
+        }
+        
+        // Record the frame in the on-device history
+        if (seq != historySeq) {
+            SensorFrame frame;
+            sensor_frame_read(&frame);
+            float values[SENSOR_HISTORY_CHANNELS] = {
+                frame.ir[0], frame.ir[1], frame.ir[2], frame.ir[3],
+                frame.level,
+                frame.current[0], frame.current[1], frame.current[2], frame.current[3],
+                frame.batteryVoltage
+            };
+            if (xSemaphoreTake(mutexSensorHistory, pdMS_TO_TICKS(10)) == pdTRUE) {
+                sensor_history_add(&sensorHistory, values, xTaskGetTickCount() * portTICK_PERIOD_MS);
+                xSemaphoreGive(mutexSensorHistory);
+            }
+            historySeq = seq;
         }
         // 🆕 CHECK BATTERY STATUS
         
-        if (++battery_check_counter >= 10) {  // Check every 10 seconds
+        if ((xTaskGetTickCount() - lastBatteryCheck) >= pdMS_TO_TICKS(10000)) {  // Check every 10 seconds
             check_battery_status();
-            battery_check_counter = 0;
+            lastBatteryCheck = xTaskGetTickCount();
         }
         
-        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(1000));
+        loop_finish(LOOP_SENSOR);
+        
+        // Oneshot fallback keeps the original 1 s polling cadence
+        if (!adc_acquisition_is_running()) {
+            vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(1000));
+        }
     }
 }
 
-void task_fire_detection(void *parameter) {
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    for (;;) {
-        bool lockout = false;
-        if (xSemaphoreTake(mutexWaterState, pdMS_TO_TICKS(100)) == pdTRUE) {
-            lockout = waterLockout;
-            xSemaphoreGive(mutexWaterState);
-        }
-        
-        if (!lockout) {
-            if (xSemaphoreTake(mutexSensorData, portMAX_DELAY) == pdTRUE) {
-                if (xSemaphoreTake(mutexPumpState, portMAX_DELAY) == pdTRUE) {
-                    check_automatic_activation();
-                    xSemaphoreGive(mutexPumpState);
-                }
-                xSemaphoreGive(mutexSensorData);
-            }
-        }
-        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(100));
+// ========================================
+// CONTROL TASK
+// ========================================
+// task_control is the only writer of pumps[], water lockout, the profile
+// and emergency stop. Everything else goes through control.h.
+
+// Called by fire_system whenever pump state or a pump deadline changes
+void pump_schedule_kick(void) {
+    control_notify(CONTROL_EVENT_KICK);
+}
+
+static void publish_control_snapshot(void) {
+    ControlSnapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    snap.profile = currentProfile;
+    snap.emergencyStop = emergencyStopActive;
+    snap.waterLockout = waterLockout;
+    snap.continuousFeed = continuousWaterFeed;
+    snap.startAllPumps = startAllPumpsActive;
+    snap.suppressionActive = is_suppression_active();
+    for (int i = 0; i < 4; i++) {
+        snap.pumps[i].state = pumps[i].state;
+        snap.pumps[i].source = pumps[i].activationSource;
+        snap.pumps[i].isRunning = pumps[i].isRunning;
+        snap.pumps[i].timerProtected = pumps[i].timerProtected;
+        snap.pumps[i].timerActive = pumps[i].timerProtected && !is_timer_expired(i);
+        snap.pumps[i].timerRemainingS = get_timer_remaining(i);
     }
+    control_publish(&snap);
 }
 
-void task_pump_management(void *parameter) {
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    
-    // Track previous states to detect changes
-    static PumpState prev_states[4] = {PUMP_OFF, PUMP_OFF, PUMP_OFF, PUMP_OFF};
-    static bool prev_manual_mode[4] = {false, false, false, false};
-    
-    for (;;) {
-        if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(10)) == pdTRUE) {
-            update_pump_states();
-            
-            // Detect pump state changes
-            bool shadow_update_needed = false;
-            
-            for (int i = 0; i < 4; i++) {
-                // Calculate current manualMode state
-                bool current_manual_mode = false;
-                if (pumps[i].state == PUMP_MANUAL_ACTIVE && !startAllPumpsActive) {
-                    if (pumps[i].activationSource == ACTIVATION_SOURCE_SHADOW_SINGLE ||
-                        pumps[i].activationSource == ACTIVATION_SOURCE_MANUAL_SINGLE) {
-                        current_manual_mode = true;
-                    }
-                }
-                
-                // Detect manual mode changes (especially true -> false when timer expires)
-                if (current_manual_mode != prev_manual_mode[i]) {
-                    printf("\n[PUMP] Pump %d manualMode changed: %s -> %s\n", 
-                           i, prev_manual_mode[i] ? "true" : "false",
-                           current_manual_mode ? "true" : "false");
-                    
-                    // Update tracking variable
-                    last_shadow_manual_mode[i] = current_manual_mode;
-                    prev_manual_mode[i] = current_manual_mode;
-                    shadow_update_needed = true;
-                }
-                
-                // Also track general state changes for logging
-                if (pumps[i].state != prev_states[i]) {
-                    printf("\n[PUMP] Pump %d state changed: %d -> %d\n", 
-                           i, prev_states[i], pumps[i].state);
-                    prev_states[i] = pumps[i].state;
-                }
-            }
-            
-            xSemaphoreGive(mutexPumpState);
-            
-            // Trigger shadow update if needed
-            if (shadow_update_needed) {
-                printf("\n[PUMP] Triggering event-driven shadow update\n");
-                vTaskDelay(pdMS_TO_TICKS(100));
-                update_shadow_state();
-            }
-        }
-        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(100));
+#ifdef CONFIG_FIRE_JITTER_MEASURE
+// Sensor frame capture to end of fire detection: [0] normal, [1] OTA running.
+// Written by task_control only, printed by the serial monitor.
+static latency_histogram_t detectJitter[2];
+#endif
+
+static void record_detect_jitter(int64_t frame_us) {
+#ifdef CONFIG_FIRE_JITTER_MEASURE
+    int64_t delta = esp_timer_get_time() - frame_us;
+    if (frame_us > 0 && delta >= 0) {
+        latency_histogram_add(&detectJitter[ota_job_is_active() ? 1 : 0],
+                              delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta);
     }
+#else
+    (void)frame_us;
+#endif
 }
 
-void task_water_lockout(void *parameter) {
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    for (;;) {
-        if (xSemaphoreTake(mutexWaterState, portMAX_DELAY) == pdTRUE) {
-            if (xSemaphoreTake(mutexSensorData, pdMS_TO_TICKS(10)) == pdTRUE) {
-                if (xSemaphoreTake(mutexPumpState, pdMS_TO_TICKS(10)) == pdTRUE) {
-                    check_water_lockout();
-                    xSemaphoreGive(mutexPumpState);
-                }
-                xSemaphoreGive(mutexSensorData);
-            }
-            xSemaphoreGive(mutexWaterState);
+#ifdef CONFIG_FIRE_JITTER_MEASURE
+static void print_detect_jitter(void) {
+#ifdef CONFIG_FIRE_TASK_PINNING
+    printf("\n[JITTER] Frame to detection (ms), pinned: safety CPU%d, network CPU%d\n",
+           TASK_CORE_SAFETY, TASK_CORE_NETWORK);
+#else
+    printf("\n[JITTER] Frame to detection (ms), unpinned\n");
+#endif
+    printf("  %-8s %6s %9s %9s %9s %9s %9s\n", "load", "n", "min", "p50", "p99", "max", "jitter");
+    for (int i = 0; i < 2; i++) {
+        latency_histogram_t h = detectJitter[i];
+        if (h.count == 0) {
+            printf("  %-8s %6s\n", i ? "ota" : "normal", "-");
+            continue;
         }
-        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(500));
+        printf("  %-8s %6lu %9.1f %9.1f %9.1f %9.1f %9.1f\n", i ? "ota" : "normal",
+               (unsigned long)h.count,
+               h.min_us / 1000.0,
+               latency_trace_percentile(&h, 50) / 1000.0,
+               latency_trace_percentile(&h, 99) / 1000.0,
+               h.max_us / 1000.0,
+               (h.max_us - h.min_us) / 1000.0);
     }
 }
+#endif
 
-void task_door_monitoring(void *parameter) {
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    for (;;) {
-        check_door_status();
-        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(500));
-    }
+// Round a millisecond delay up to ticks, and never spin on one already due
+static TickType_t control_wait_ticks(unsigned long ms) {
+    TickType_t ticks = (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    return ticks == 0 ? 1 : ticks;
 }
 
-void task_command_processor(void *parameter) {
-    SystemCommand cmd;
-    for (;;) {
-        if (xQueueReceive(commandQueue, &cmd, portMAX_DELAY) == pdTRUE) {
-            // Check emergency stop before processing any pump commands
-            if (emergencyStopActive && 
-                (cmd.type == CMD_MANUAL_PUMP || 
-                 cmd.type == CMD_MANUAL_ALL_PUMPS ||
-                 cmd.type == CMD_EXTEND_TIME)) {
-                printf("[CMD] Command blocked - Emergency stop active\n");
-                continue;
-            }
-            
-            switch (cmd.type) {
-                case CMD_MANUAL_PUMP:
-                    if (xSemaphoreTake(mutexPumpState, portMAX_DELAY) == pdTRUE) {
-                        if (xSemaphoreTake(mutexWaterState, pdMS_TO_TICKS(10)) == pdTRUE) {
-                            manual_activate_pump(cmd.pumpIndex);
-                            xSemaphoreGive(mutexWaterState);
-                        }
-                        xSemaphoreGive(mutexPumpState);
-                        vTaskDelay(pdMS_TO_TICKS(500));
-                        update_shadow_state();  // Send acknowledgement
-                    }
-                    break;
-                case CMD_MANUAL_ALL_PUMPS:
-                    if (xSemaphoreTake(mutexPumpState, portMAX_DELAY) == pdTRUE) {
-                        if (xSemaphoreTake(mutexWaterState, pdMS_TO_TICKS(10)) == pdTRUE) {
-                            manual_activate_all_pumps();
-                            
-                            // Set startAllPumps as active for local commands too
-                            startAllPumpsActive = true;
-                            startAllPumpsActivationTime = xTaskGetTickCount();
-                            
-                            xSemaphoreGive(mutexWaterState);
-                        }
-                        xSemaphoreGive(mutexPumpState);
-                        vTaskDelay(pdMS_TO_TICKS(500));
-                        update_shadow_state();  // Send acknowledgement
-                    }
-                    break;
-                case CMD_STOP_PUMP:
-                    if (xSemaphoreTake(mutexPumpState, portMAX_DELAY) == pdTRUE) {
-                        manual_stop_pump(cmd.pumpIndex);
-                        
-                        // Check if we should reset startAllPumpsActive
-                        if (startAllPumpsActive) {
-                            bool any_manual_active = false;
-                            for (int i = 0; i < 4; i++) {
-                                if (pumps[i].state == PUMP_MANUAL_ACTIVE) {
-                                    any_manual_active = true;
-                                    break;
-                                }
-                            }
-                            
-                            if (!any_manual_active) {
-                                startAllPumpsActive = false;
-                                printf("\n[CMD] All pumps stopped, resetting startAllPumps to false");
-                            }
-                        }
-                        
-                        xSemaphoreGive(mutexPumpState);
-                        vTaskDelay(pdMS_TO_TICKS(500));
-                        update_shadow_state();  // Send acknowledgement
-                    }
-                    break;
-                case CMD_STOP_ALL_PUMPS:
-                    if (xSemaphoreTake(mutexPumpState, portMAX_DELAY) == pdTRUE) {
-                        emergency_stop_all_pumps(STOP_REASON_MANUAL);
-                        
-                        // Reset startAllPumps when all pumps are stopped
-                        startAllPumpsActive = false;
-                        
-                        xSemaphoreGive(mutexPumpState);
-                        vTaskDelay(pdMS_TO_TICKS(500));
-                        update_shadow_state();  // Send acknowledgement
-                    }
-                    break;
-                case CMD_EXTEND_TIME:
-                    if (xSemaphoreTake(mutexPumpState, portMAX_DELAY) == pdTRUE) {
-                        extend_manual_runtime(cmd.pumpIndex, cmd.value);
-                        xSemaphoreGive(mutexPumpState);
-                        vTaskDelay(pdMS_TO_TICKS(500));
-                        update_shadow_state();  // Send acknowledgement
-                    }
-                    break;
-                case CMD_CHANGE_PROFILE:
-                    if (xSemaphoreTake(mutexSystemState, portMAX_DELAY) == pdTRUE) {
-                        SystemProfile newProfile = convert_profile_number_to_enum(cmd.profileValue);
-                        apply_system_profile(newProfile);
-                        shadow_profile = cmd.profileValue;
-                        printf("[SYSTEM] Profile changed to: %s\n", profiles[newProfile].name);
-                        xSemaphoreGive(mutexSystemState);
-                        vTaskDelay(pdMS_TO_TICKS(500));
-                        update_shadow_state();  // Send acknowledgement
-                    }
-                    break;
-                case CMD_GET_STATUS:
-                    display_system_status();
-                    break;
-                default: break;
+static bool control_apply(const SystemCommand *cmd) {
+    // Check emergency stop before processing any pump commands
+    if (emergencyStopActive &&
+        (cmd->type == CMD_MANUAL_PUMP ||
+         cmd->type == CMD_MANUAL_ALL_PUMPS ||
+         cmd->type == CMD_EXTEND_TIME)) {
+        printf("[CMD] Command blocked - Emergency stop active\n");
+        return false;
+    }
+
+    bool result = true;
+    bool acknowledge = false;   // Local commands report back through the shadow
+
+    switch (cmd->type) {
+        case CMD_MANUAL_PUMP:
+            manual_activate_pump(cmd->pumpIndex);
+            acknowledge = true;
+            break;
+        case CMD_MANUAL_ALL_PUMPS:
+            manual_activate_all_pumps();
+
+            // Set startAllPumps as active for local commands too
+            startAllPumpsActive = true;
+            startAllPumpsActivationTime = xTaskGetTickCount();
+            acknowledge = true;
+            break;
+        case CMD_STOP_PUMP:
+            manual_stop_pump(cmd->pumpIndex);
+
+            // Reset startAllPumpsActive once no pump is left in manual mode
+            check_and_reset_start_all_pumps();
+            acknowledge = true;
+            break;
+        case CMD_STOP_ALL_PUMPS:
+            emergency_stop_all_pumps(STOP_REASON_MANUAL);
+
+            // Reset startAllPumps when all pumps are stopped
+            startAllPumpsActive = false;
+            acknowledge = true;
+            break;
+        case CMD_EXTEND_TIME:
+            extend_manual_runtime(cmd->pumpIndex, cmd->value);
+            acknowledge = true;
+            break;
+        case CMD_CHANGE_PROFILE: {
+            SystemProfile newProfile = convert_profile_number_to_enum(cmd->profileValue);
+            result = (newProfile != currentProfile);
+            if (result) {
+                apply_system_profile(newProfile);
+                shadow_profile = cmd->profileValue;
+                printf("[SYSTEM] Profile changed to: %s\n", profiles[newProfile].name);
+            }
+            acknowledge = true;
+            break;
+        }
+        case CMD_GET_STATUS:
+            display_system_status();
+            break;
+        case CMD_EMERGENCY_STOP:
+            process_shadow_emergency_stop(cmd->value != 0);
+            break;
+        case CMD_SYSTEM_RESET:
+            reset_system_to_defaults();
+            startAllPumpsActive = false;
+            emergencyStopActive = false;
+            break;
+        case CMD_SHADOW_START_ALL:
+            result = shadow_manual_activate_all_pumps();
+            if (result) {
+                startAllPumpsActive = true;
+                startAllPumpsActivationTime = xTaskGetTickCount();
+            }
+            break;
+        case CMD_SHADOW_STOP_ALL:
+            shadow_manual_stop_all_pumps();
+            startAllPumpsActive = false;
+            break;
+        case CMD_SHADOW_STOP_PUMP:
+            result = shadow_manual_stop_pump_override_timer(cmd->pumpIndex);
+            break;
+        case CMD_SHADOW_MANUAL_PUMP:
+            if (startAllPumpsActive) {
+                printf("\n[SHADOW] BLOCKED: Cannot activate %s - startAllPumps active",
+                       pumps[cmd->pumpIndex].name);
+                result = false;
+            } else {
+                result = can_activate_pump_manually(cmd->pumpIndex) &&
+                         shadow_manual_activate_pump(cmd->pumpIndex);
+            }
+            break;
+        case CMD_SHADOW_EXTEND_TIME: {
+            int index = cmd->pumpIndex;
+            unsigned long extensionMs = get_duration_from_code((int)cmd->value);
+            result = (extensionMs > 0 && pumps[index].timerProtected);
+            if (result) {
+                // Get the current remaining time before extending
+                unsigned long remaining = get_timer_remaining(index);
+
+                extend_timer_protection(index, extensionMs);
+                send_alert_pump_extend_time(index, extensionMs / 1000, (int)remaining);
             }
+            break;
         }
+        default:
+            result = false;
+            break;
+    }
+
+    if (acknowledge) {
+        request_shadow_report();
     }
+    return result;
 }
 
-void task_mqtt_publish(void *parameter) {
-    mqtt_publish_message_t msg;
-    vTaskDelay(pdMS_TO_TICKS(5000));
-    
-    printf("\n[MQTT] Publish task started");
+void task_control(void *parameter) {
+    // Track previous states to detect changes
+    static PumpState prev_states[4] = {PUMP_OFF, PUMP_OFF, PUMP_OFF, PUMP_OFF};
+    static bool prev_manual_mode[4] = {false, false, false, false};
+
+    control_set_owner(xTaskGetCurrentTaskHandle());
+
+    TickType_t lastWater = xTaskGetTickCount();
+    TickType_t lastFrame = lastWater;
+    TickType_t fireDue = 0;
+    bool firePending = false;
+    uint32_t lastSeq = 0;
+
+    for (;;) {
+        // Sleep until a command, a sensor frame, a kick, or the nearest of
+        // the pump, flame confirmation and water check deadlines
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = pdMS_TO_TICKS(PUMP_SCHEDULE_MAX_WAIT_MS);
+
+        unsigned long pumpMs = pump_next_deadline_ms();
+        if (pumpMs < PUMP_SCHEDULE_MAX_WAIT_MS) {
+            wait = control_wait_ticks(pumpMs);
+        }
+        TickType_t waterLeft = pdMS_TO_TICKS(CONTROL_WATER_PERIOD_MS) - (now - lastWater);
+        if ((int32_t)waterLeft < (int32_t)wait) {
+            wait = (int32_t)waterLeft > 0 ? waterLeft : 1;
+        }
+        if (firePending) {
+            TickType_t fireLeft = fireDue - now;
+            if ((int32_t)fireLeft < (int32_t)wait) {
+                wait = (int32_t)fireLeft > 0 ? fireLeft : 1;
+            }
+        }
+
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, wait);
+        now = xTaskGetTickCount();
+        loop_begin(LOOP_CONTROL);
+
+        // 1. Commands, in submission order; publish before replying so a
+        //    caller's follow-up snapshot read sees its own change
+        control_request_t req;
+        while (control_receive(&req)) {
+            bool result = control_apply(&req.cmd);
+            publish_control_snapshot();
+            control_complete(&req, result);
+        }
+
+        // 2. Continuous feed and water lockout
+        if ((now - lastWater) >= pdMS_TO_TICKS(CONTROL_WATER_PERIOD_MS)) {
+            detect_continuous_feed();
+            check_water_lockout();
+            lastWater = now;
+        }
+
+        // 3. Fire detection on a new frame, or when a pending flame
+        //    confirmation falls due on data we already have
+        bool newFrame = (events & CONTROL_EVENT_FRAME) != 0;
+        int64_t frameUs = 0;
+        if (newFrame) {
+            SensorFrame frame;
+            sensor_frame_read(&frame);
+            lastSeq = frame.seq;
+            frameUs = frame.timestamp_us;
+            lastFrame = now;
+            update_pump_ir_values(&frame);
+        } else if ((now - lastFrame) >= pdMS_TO_TICKS(FIRE_DETECT_STALE_MS)) {
+            printf("[FIRE] WARNING: No sensor frame for %d ms (last seq %" PRIu32 ")\n",
+                   FIRE_DETECT_STALE_MS, lastSeq);
+            lastFrame = now;
+        }
+        if (newFrame || (firePending && (int32_t)(now - fireDue) >= 0)) {
+            unsigned long fireMs = ULONG_MAX;
+            if (!waterLockout) {
+                check_automatic_activation();
+                fireMs = fire_detection_next_deadline_ms();
+            }
+            firePending = (fireMs != ULONG_MAX);
+            if (firePending) {
+                fireDue = now + control_wait_ticks(fireMs);
+            }
+            if (newFrame) {
+                record_detect_jitter(frameUs);
+            }
+        }
+
+        // 4. Pump deadlines; our own kicks are covered by the next wait
+        update_pump_states();
+        check_and_reset_start_all_pumps();
+        ulTaskNotifyValueClear(NULL, CONTROL_EVENT_KICK);
+
+        // 5. Detect pump state changes
+        bool shadow_update_needed = false;
+
+        for (int i = 0; i < 4; i++) {
+            // Calculate current manualMode state
+            bool current_manual_mode = false;
+            if (pumps[i].state == PUMP_MANUAL_ACTIVE && !startAllPumpsActive) {
+                if (pumps[i].activationSource == ACTIVATION_SOURCE_SHADOW_SINGLE ||
+                    pumps[i].activationSource == ACTIVATION_SOURCE_MANUAL_SINGLE) {
+                    current_manual_mode = true;
+                }
+            }
+
+            // Detect manual mode changes (especially true -> false when timer expires)
+            if (current_manual_mode != prev_manual_mode[i]) {
+                printf("\n[PUMP] Pump %d manualMode changed: %s -> %s\n",
+                       i, prev_manual_mode[i] ? "true" : "false",
+                       current_manual_mode ? "true" : "false");
+
+                // Update tracking variable
+                last_shadow_manual_mode[i] = current_manual_mode;
+                prev_manual_mode[i] = current_manual_mode;
+                shadow_update_needed = true;
+            }
+
+            // Also track general state changes for logging
+            if (pumps[i].state != prev_states[i]) {
+                printf("\n[PUMP] Pump %d state changed: %d -> %d\n",
+                       i, prev_states[i], pumps[i].state);
+                prev_states[i] = pumps[i].state;
+            }
+        }
+
+        // Trigger shadow update if needed (published from task_shadow_report,
+        // never from here: MQTT handlers may be waiting on this task)
+        if (shadow_update_needed) {
+            printf("\n[PUMP] Triggering event-driven shadow update\n");
+            request_shadow_report();
+        }
+
+        // 6. Readers see this pass's state
+        publish_control_snapshot();
+        loop_finish(LOOP_CONTROL);
+    }
+}
+
+// ========================================
+// SHADOW REPORT TASK
+// ========================================
+
+static void request_shadow_report(void) {
+    if (taskShadowReportHandle != NULL) {
+        xTaskNotifyGive(taskShadowReportHandle);
+    }
+}
+
+void task_shadow_report(void *parameter) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Let related changes settle, then report them together
+        vTaskDelay(pdMS_TO_TICKS(SHADOW_REPORT_DELAY_MS));
+        ulTaskNotifyTake(pdTRUE, 0);
+        update_shadow_state();
+    }
+}
+
+/**
+ * @brief Publish queued messages, highest lane first
+ * @param below Only lanes above this one; MQTT_LANE_COUNT for all
+ *
+ * Called by the publish task and between backlog sends, so live alerts
+ * pre-empt the SPIFFS replay. Stops at the first failed publish and leaves
+ * the message at the head of its lane for the next round.
+ */
+static void serve_mqtt_lanes(mqtt_lane_t below) {
+    if (mqttLaneMutex == NULL) return;
     
-    while (1) {
-        if (xQueueReceive(mqtt_publish_queue, &msg, pdMS_TO_TICKS(100))) {
+    for (;;) {
+        mqtt_lane_t lane;
+        xSemaphoreTake(mqttLaneMutex, portMAX_DELAY);
+        int slot = mqtt_lanes_pop(&mqttLanes, below, &lane);
+        xSemaphoreGive(mqttLaneMutex);
+        if (slot < 0) return;
+        
+        // The slot is ours until released
+        mqtt_publish_message_t *msg = &mqttLaneSlots[slot];
+        
+        if (mqtt_connected && mqtt_client) {
+            printf("\n[MQTT] Publishing to: %s", msg->topic);
             
-            if (mqtt_connected && mqtt_client) {
-                printf("\n[MQTT] Publishing to: %s", msg.topic);
+            int msg_id = esp_mqtt_client_publish(mqtt_client, msg->topic, 
+                                                msg->payload, msg->len, msg->qos, 0);
+            
+            if (msg_id < 0) {
+                printf("\n[MQTT] Publish failed (error: %d)", msg_id);
                 
-                int msg_id = esp_mqtt_client_publish(mqtt_client, msg.topic, 
-                                                    msg.payload, 0, 1, 0);
+                // Store to persistent storage on failure (journalled alerts already are)
+                if (msg->persist && msg->retries == 0) {
+                    store_alert_to_spiffs(msg->topic, msg->payload);
+                }
                 
-                if (msg_id < 0) {
-                    printf("\n[MQTT] Publish failed (error: %d)", msg_id);
-                    
-                    // Store to persistent storage on failure
-                    store_alert_to_spiffs(msg.topic, msg.payload);
-                    
-                    // Requeue for retry (limited attempts)
-                    static int requeue_count = 0;
-                    if (requeue_count < 2) {
-                        printf("\n[MQTT] Requeuing message (attempt %d/2)", requeue_count + 1);
-                        xQueueSendToFront(mqtt_publish_queue, &msg, pdMS_TO_TICKS(10));
-                        requeue_count++;
-                    } else {
-                        printf("\n[MQTT] Max requeue attempts reached, keeping in persistent storage");
-                        requeue_count = 0;
-                    }
+                // Requeue for retry (limited attempts)
+                uint32_t parkSeq = 0;
+                xSemaphoreTake(mqttLaneMutex, portMAX_DELAY);
+                if (msg->retries < 2) {
+                    msg->retries++;
+                    printf("\n[MQTT] Requeuing message (attempt %d/2)", msg->retries);
+                    mqtt_lanes_push_front(&mqttLanes, lane, slot);
                 } else {
-                    printf("\n[MQTT] Published successfully (msg_id=%d)", msg_id);
+                    printf("\n[MQTT] Max requeue attempts reached, keeping in persistent storage");
+                    parkSeq = msg->seq;
+                    mqtt_lanes_release(&mqttLanes, slot);
                 }
-            } else {
-                // MQTT not connected, store to persistent storage
-                printf("\n[MQTT] Not connected - storing alert to persistent storage");
-                store_alert_to_spiffs(msg.topic, msg.payload);
+                xSemaphoreGive(mqttLaneMutex);
+                park_alert_seq(parkSeq);
+                return;
             }
+            
+            // Queued by the client only; the journal waits for the PUBACK
+            printf("\n[MQTT] Published successfully (msg_id=%d)", msg_id);
+            mark_alert_sent(msg->seq, msg_id);
+            int64_t published_us = esp_timer_get_time();
+            latency_trace_record(LATENCY_QUEUED_TO_PUBLISHED, msg->queued_us, published_us);
+            latency_trace_record(LATENCY_SAMPLE_TO_PUBLISHED, msg->sample_us, published_us);
+        } else if (msg->persist) {
+            // MQTT not connected, store to persistent storage
+            printf("\n[MQTT] Not connected - storing alert to persistent storage");
+            store_alert_to_spiffs(msg->topic, msg->payload);
+        } else {
+            park_alert_seq(msg->seq);
         }
         
-        // Periodically check for pending alerts when online
+        xSemaphoreTake(mqttLaneMutex, portMAX_DELAY);
+        mqtt_lanes_release(&mqttLanes, slot);
+        xSemaphoreGive(mqttLaneMutex);
+    }
+}
+
+void task_mqtt_publish(void *parameter) {
+    vTaskDelay(pdMS_TO_TICKS(5000));
+    
+    printf("\n[MQTT] Publish task started");
+    
+    while (1) {
+        xSemaphoreTake(mqttLaneSignal, pdMS_TO_TICKS(100));
+        serve_mqtt_lanes(MQTT_LANE_COUNT);
+        settle_alert_journal();
+        serve_history_export();
+        
+        // Check for pending alerts when online: periodically, or when
+        // another task asks (reconnects, state machine checks)
         static TickType_t last_pending_check = 0;
         TickType_t current_time = xTaskGetTickCount();
         
-        if (mqtt_connected && mqtt_client && 
-            (current_time - last_pending_check) > pdMS_TO_TICKS(30000)) {
+        if (mqtt_connected && mqtt_client &&
+            (pendingReplayRequested || (current_time - last_pending_check) > pdMS_TO_TICKS(30000))) {
+            pendingReplayRequested = false;
             last_pending_check = current_time;
             
             // Send pending alerts from storage
@@ -9984,12 +11020,10 @@ void task_mqtt_publish(void *parameter) {
 static void perform_periodic_tasks(void) {
     static TickType_t last_heartbeat = 0;
     static TickType_t last_system_status = 0;
+    static TickType_t last_diagnostics = 0;
     
     TickType_t current_time = xTaskGetTickCount();
     
-    // CHECK AND RESET startAllPumps STATE (this now triggers shadow updates internally)
-    check_and_reset_start_all_pumps();
-    
     // Heartbeat (every 60 seconds)
     if ((current_time - last_heartbeat) > pdMS_TO_TICKS(HEARTBEAT_INTERVAL)) {
         send_heartbeat();
@@ -10001,6 +11035,14 @@ static void perform_periodic_tasks(void) {
         send_system_status();
         last_system_status = current_time;
     }
+    
+    // Task diagnostics (every 5 minutes)
+    if ((current_time - last_diagnostics) > pdMS_TO_TICKS(DIAGNOSTICS_INTERVAL)) {
+        send_diagnostics();
+        send_latency_report();
+        send_task_profile();
+        last_diagnostics = current_time;
+    }
  
 }
 
@@ -10050,6 +11092,7 @@ void task_state_machine(void *parameter) {
     TickType_t lastWakeTime = xTaskGetTickCount();
     
     for (;;) {
+        loop_begin(LOOP_STATE);
         TickType_t current_time = xTaskGetTickCount();
         
         switch (current_state) {
@@ -10325,7 +11368,7 @@ void task_state_machine(void *parameter) {
                                         if (mqtt_connect(thing_name, device_cert_pem, device_private_key) == ESP_OK) {
                                             subscribe_to_topics();
                                             printf("\n[STATE] MQTT reconnected via GSM");
-                                            send_pending_alerts_from_storage();
+                                            request_pending_alert_replay();
                                         }
                                     } else {
                                         printf("\n[STATE] GSM also failed, going to ERROR state");
@@ -10355,7 +11398,7 @@ void task_state_machine(void *parameter) {
                                 if (mqtt_connect(thing_name, device_cert_pem, device_private_key) == ESP_OK) {
                                     subscribe_to_topics();
                                     printf("\n[STATE] MQTT reconnected after WiFi recovery");
-                                    send_pending_alerts_from_storage();
+                                    request_pending_alert_replay();
                                 }
                             }
                         } else {
@@ -10446,7 +11489,7 @@ void task_state_machine(void *parameter) {
                         if (mqtt_connect(thing_name, device_cert_pem, device_private_key) == ESP_OK) {
                             subscribe_to_topics();
                             printf("\n[STATE] MQTT reconnected successfully");
-                            send_pending_alerts_from_storage();
+                            request_pending_alert_replay();
                         } else {
                             printf("\n[STATE] MQTT reconnection failed");
                         }
@@ -10499,6 +11542,7 @@ void task_state_machine(void *parameter) {
                 break;
         }
         
+        loop_finish(LOOP_STATE);
         vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(2000));
     }
 }
@@ -10569,11 +11613,13 @@ void display_system_status(void) {
                stop_reason_str);
     }
     
+    SensorFrame frame;
+    sensor_frame_read(&frame);
     printf("\nSENSOR STATUS:\n");
-    printf("Water Level: %.1f%%\n", level_s);
+    printf("Water Level: %.1f%%\n", frame.level);
     printf("IR Sensors: N=%.1f%%, S=%.1f%%, E=%.1f%%, W=%.1f%%\n", 
-           ir_s1, ir_s2, ir_s3, ir_s4);
-    printf("Battery: %.2fV | Solar: %.2fV\n", bat_v, sol_v);
+           frame.ir[0], frame.ir[1], frame.ir[2], frame.ir[3]);
+    printf("Battery: %.2fV | Solar: %.2fV\n", frame.batteryVoltage, frame.solarVoltage);
     
     // ADDED: Show fire detection type info
     FireDetectionInfo* fireInfo = get_fire_detection_info();
@@ -10591,6 +11637,8 @@ void display_system_status(void) {
         printf("Door open for: %lu seconds\n", openTime);
     }
     
+    latency_trace_print();
+    
     printf("\nOTA STATUS");
         const esp_app_desc_t *app_desc = esp_app_get_description();
         printf("\n  Current Version: %s", app_desc->version);
@@ -10615,36 +11663,91 @@ static void get_mac_address(void) {
 }
 
 // ========================================
-// APPLICATION ENTRY POINT - OPTIMIZED
+// BOOT SEQUENCE
 // ========================================
-void app_main(void) {
-    
-    
-    esp_log_level_set("*", ESP_LOG_INFO);
-    
-    printf("\n[INIT] GUARDIAN FIRE SYSTEM STARTING...\n");
-    // Initialize boot time for sensor warmup
-    boot_time = xTaskGetTickCount();
-    sensors_ready = false;
-    
-    printf("\n[INIT] Sensor warmup period: %d seconds\n", SENSOR_WARMUP_SECONDS);
-    
+// Boot runs as dependency-ordered stages on two workers: app_main and a
+// transient task on the other core. Lower stages win when several are
+// ready, so hardware and the detection and control tasks come up first
+// while storage, WiFi, GSM and provisioning proceed alongside.
+typedef enum {
+    BOOT_HARDWARE = 0,
+    BOOT_SAFETY,
+    BOOT_NVS,
+    BOOT_SPIFFS,
+    BOOT_PUBLISHER,
+    BOOT_ALERTS,
+    BOOT_TIME,
+    BOOT_CREDENTIALS,
+    BOOT_PROVISIONING,
+    BOOT_WIFI,
+    BOOT_GSM,
+    BOOT_NETWORK,
+    BOOT_MONITOR,
+    BOOT_STAGE_COUNT
+} BootStageId;
+
+#define BOOT_WORKER_COUNT   2
+
+static boot_sequencer_t bootSeq;
+static TaskHandle_t bootWorkers[BOOT_WORKER_COUNT];
+static StaticSemaphore_t bootMutexBuf;
+
+static void boot_stage_hardware(void) {
+    init_alert_queue();
+    init_fire_suppression_system();
+}
+
+static void boot_stage_safety(void) {
+    mutexSensorHistory = create_static_mutex("Sensor", &sensorHistoryMutexBuf);
+    sensor_history_init(&sensorHistory);
+    boot_lock();
+    ram_budget_add_static("Sensor", sizeof(sensorHistory));
+    boot_unlock();
+    control_init();
+    publish_control_snapshot();     // Readers see the boot state until task_control runs
     
-    get_mac_address();
+    taskSensorHandle = create_static_task("Sensor", task_sensor_reading, "Sensor", sensorTaskStack, sizeof(sensorTaskStack),
+                                          TASK_PRIORITY_SENSOR, &sensorTaskTcb, TASK_CORE_SENSOR);
+    taskControlHandle = create_static_task("Control", task_control, "Ctrl", controlTaskStack, sizeof(controlTaskStack),
+                                           TASK_PRIORITY_CONTROL, &controlTaskTcb, TASK_CORE_CONTROL);
     
-    // Initialize NVS
+    bootArmedUs = esp_timer_get_time();
+    printf("\n[BOOT] Detection and pump control ARMED at %lld ms\n", (long long)(bootArmedUs / 1000));
+}
+
+static void boot_stage_nvs(void) {
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
         nvs_flash_erase();
         nvs_flash_init();
     }
-    
-    // Initialize time manager
-   time_manager_init();
-      
-    // Initialize SPIFFS
-	spiffs_init();
-	
+}
+
+static void boot_stage_spiffs(void) {
+    spiffs_init();
+}
+
+static void boot_stage_publisher(void) {
+    // Offline publishes are stored in SPIFFS
+    mqtt_lanes_init(&mqttLanes, MQTT_PUBLISH_QUEUE_SIZE);
+    boot_lock();
+    ram_budget_add_static("MQTT", sizeof(mqttLaneSlots) + sizeof(mqttLanes) + sizeof(mqttLaneSignalBuf));
+    boot_unlock();
+    mqttLaneSignal = xSemaphoreCreateBinaryStatic(&mqttLaneSignalBuf);
+    mqttLaneMutex = create_static_mutex("MQTT", &mqttLaneMutexBuf);
+    taskMqttPublishHandle = create_static_task("MQTT", task_mqtt_publish, "Mqtt", mqttPublishTaskStack, sizeof(mqttPublishTaskStack),
+                                               TASK_PRIORITY_MQTT_PUBLISH, &mqttPublishTaskTcb, TASK_CORE_MQTT_PUBLISH);
+}
+
+static void boot_stage_alerts(void) {
+    init_alert_system();
+}
+
+static void boot_stage_time(void) {
+    time_manager_init();
+}
+
+static void boot_stage_credentials(void) {
 	// ✅ CRITICAL: Load WiFi credentials from SPIFFS BEFORE WiFi init
 	printf("\n[BOOT] Loading WiFi credentials from SPIFFS...\n");
 	bool credentials_loaded = load_wifi_credentials_from_spiffs();
@@ -10662,9 +11765,6 @@ void app_main(void) {
 	    spiffs_print_alert_summary();
 	}
 	
-	// Load Thing Name if exists
-	snprintf(thing_name, sizeof(thing_name), "FD_%s_%s", DEVICE_TYPE, mac_address);
-	
 	printf("\n[BOOT] Checking WiFi configuration...");
 	if (wifi_has_custom_credentials()) {
 	    printf("\n[BOOT] Using stored WiFi credentials from SPIFFS");
@@ -10676,8 +11776,10 @@ void app_main(void) {
 	    printf("\n[BOOT] Default Password: %s", WIFI_PASSWORD);
 	}
 	printf("\n[BOOT] Pending Update: %s", wifi_has_pending_update() ? "YES" : "NO");
-    // Create provisioning mutex
-    provisioning_mutex = xSemaphoreCreateMutex();
+}
+
+static void boot_stage_provisioning(void) {
+    provisioning_mutex = create_static_mutex("Provisioning", &provisioningMutexBuf);
     
     // Check provisioning status
     check_provisioning_status();
@@ -10685,45 +11787,151 @@ void app_main(void) {
     if (is_registered) {
         printf("\n[BOOT] Device already registered - will skip registration");
     }
-    
-    // Initialize hardware
-    init_fire_suppression_system();
-    #if GSM_ENABLED
+}
+
+static void boot_stage_wifi(void) {
+    init_wifi();
+}
+
+static void boot_stage_gsm(void) {
+#if GSM_ENABLED
     gsm_manager_init();
     printf("\n[INIT] ========================================");
 #else
     printf("\n[INIT] GSM fallback: DISABLED (compile-time)");
 #endif
+}
+
+static void boot_stage_network(void) {
+    taskStateMachineHandle = create_static_task("State", task_state_machine, "State", stateMachineTaskStack, sizeof(stateMachineTaskStack),
+                                                TASK_PRIORITY_STATE_MACHINE, &stateMachineTaskTcb, TASK_CORE_STATE_MACHINE);
+    taskShadowReportHandle = create_static_task("Shadow", task_shadow_report, "Report", shadowReportTaskStack, sizeof(shadowReportTaskStack),
+                                                TASK_PRIORITY_SHADOW_REPORT, &shadowReportTaskTcb, TASK_CORE_SHADOW_REPORT);
+}
+
+static void boot_stage_monitor(void) {
+    // Last: it samples the profiler the creations above register into
+    taskMonitorHandle = create_static_task("Monitor", task_serial_monitor, "Mon", monitorTaskStack, sizeof(monitorTaskStack),
+                                           TASK_PRIORITY_MONITOR, &monitorTaskTcb, TASK_CORE_MONITOR);
+}
+
+static const boot_stage_t bootStages[BOOT_STAGE_COUNT] = {
+    [BOOT_HARDWARE]     = { "Hardware",     0,                                                    boot_stage_hardware },
+    [BOOT_SAFETY]       = { "Safety",       BOOT_STAGE(BOOT_HARDWARE),                            boot_stage_safety },
+    [BOOT_NVS]          = { "NVS",          0,                                                    boot_stage_nvs },
+    [BOOT_SPIFFS]       = { "SPIFFS",       0,                                                    boot_stage_spiffs },
+    [BOOT_PUBLISHER]    = { "Publisher",    BOOT_STAGE(BOOT_SPIFFS),                              boot_stage_publisher },
+    [BOOT_ALERTS]       = { "Alerts",       BOOT_STAGE(BOOT_SAFETY) | BOOT_STAGE(BOOT_PUBLISHER) |
+                                            BOOT_STAGE(BOOT_NVS),                                 boot_stage_alerts },
+    [BOOT_TIME]         = { "Time",         BOOT_STAGE(BOOT_NVS),                                 boot_stage_time },
+    [BOOT_CREDENTIALS]  = { "Credentials",  BOOT_STAGE(BOOT_SPIFFS),                              boot_stage_credentials },
+    [BOOT_PROVISIONING] = { "Provisioning", BOOT_STAGE(BOOT_NVS) | BOOT_STAGE(BOOT_SPIFFS),       boot_stage_provisioning },
+    // WiFi and GSM both initialise esp_netif and the default event loop, so they run in series
+    [BOOT_WIFI]         = { "WiFi",         BOOT_STAGE(BOOT_NVS) | BOOT_STAGE(BOOT_CREDENTIALS),  boot_stage_wifi },
+    [BOOT_GSM]          = { "GSM",          BOOT_STAGE(BOOT_NVS) | BOOT_STAGE(BOOT_WIFI),         boot_stage_gsm },
+    [BOOT_NETWORK]      = { "Network",      BOOT_STAGE(BOOT_TIME) | BOOT_STAGE(BOOT_PROVISIONING) |
+                                            BOOT_STAGE(BOOT_GSM) | BOOT_STAGE(BOOT_SAFETY),       boot_stage_network },
+    [BOOT_MONITOR]      = { "Monitor",      BOOT_STAGE(BOOT_ALERTS) | BOOT_STAGE(BOOT_NETWORK),   boot_stage_monitor },
+};
+
+// Claim and run stages until none are left; each completion wakes the other worker
+static void boot_run_stages(int worker) {
+    for (;;) {
+        boot_lock();
+        int stage = boot_sequencer_claim(&bootSeq, esp_timer_get_time());
+        bool finished = boot_sequencer_finished(&bootSeq);
+        if (stage < 0 && finished) {
+            bootWorkers[worker] = NULL;
+        }
+        boot_unlock();
+        
+        if (stage < 0) {
+            if (finished) return;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        
+        // Heap per stage is approximate while the other worker runs a stage too
+        uint32_t heapBefore = esp_get_free_heap_size();
+        bootStages[stage].run();
+        
+        boot_lock();
+        boot_sequencer_complete(&bootSeq, stage, esp_timer_get_time());
+        ram_budget_heap_step(bootStages[stage].name, heapBefore, esp_get_free_heap_size());
+        for (int i = 0; i < BOOT_WORKER_COUNT; i++) {
+            if (i != worker && bootWorkers[i] != NULL) {
+                xTaskNotifyGive(bootWorkers[i]);
+            }
+        }
+        boot_unlock();
+    }
+}
+
+static void task_boot_worker(void *parameter) {
+    boot_run_stages((int)(intptr_t)parameter);
+    vTaskDelete(NULL);
+}
+
+// ========================================
+// APPLICATION ENTRY POINT - OPTIMIZED
+// ========================================
+void app_main(void) {
     
-    init_wifi();
     
-    // Initialize RTOS components with optimized sizes
-    mutexSensorData = xSemaphoreCreateMutex();
-    mutexPumpState = xSemaphoreCreateMutex();
-    mutexWaterState = xSemaphoreCreateMutex();
-    mutexSystemState = xSemaphoreCreateMutex();
-    commandQueue = xQueueCreate(10, sizeof(SystemCommand));
-    mqtt_publish_queue = xQueueCreate(10, sizeof(mqtt_publish_message_t));
+    esp_log_level_set("*", ESP_LOG_INFO);
     
-    // Initialize alert system
-    init_alert_system();
+    printf("\n[INIT] GUARDIAN FIRE SYSTEM STARTING...\n");
+    // Initialize boot time for sensor warmup
+    boot_time = xTaskGetTickCount();
+    sensors_ready = false;
     
-    // Create tasks with optimized stack sizes
-    xTaskCreate(task_state_machine, "State", TASK_STATE_MACHINE_STACK_SIZE, NULL, TASK_PRIORITY_STATE_MACHINE, &taskStateMachineHandle);
-    xTaskCreate(task_sensor_reading, "Sensor", TASK_SENSOR_STACK_SIZE, NULL, TASK_PRIORITY_SENSOR, &taskSensorHandle);
-    xTaskCreate(task_fire_detection, "Fire", TASK_FIRE_DETECT_STACK_SIZE, NULL, TASK_PRIORITY_FIRE_DETECT, &taskFireDetectionHandle);
-    xTaskCreate(task_pump_management, "Pump", TASK_PUMP_MGMT_STACK_SIZE, NULL, TASK_PRIORITY_PUMP_MGMT, &taskPumpManagementHandle);
-    xTaskCreate(task_water_lockout, "Water", TASK_WATER_LOCK_STACK_SIZE, NULL, TASK_PRIORITY_WATER_LOCK, &taskWaterLockoutHandle);
-    xTaskCreate(task_command_processor, "Cmd", TASK_CMD_STACK_SIZE, NULL, TASK_PRIORITY_CMD, &taskCommandHandle);
-    xTaskCreate(task_door_monitoring, "Door", TASK_DOOR_STACK_SIZE, NULL, TASK_PRIORITY_DOOR, &taskDoorHandle);
-    xTaskCreate(task_serial_monitor, "Mon", TASK_MONITOR_STACK_SIZE, NULL, TASK_PRIORITY_MONITOR, &taskMonitorHandle);
-    xTaskCreate(task_mqtt_publish, "Mqtt", TASK_MQTT_PUBLISH_STACK_SIZE, NULL, TASK_PRIORITY_MQTT_PUBLISH, &taskMqttPublishHandle);
+    printf("\n[INIT] Sensor warmup period: %d seconds\n", SENSOR_WARMUP_SECONDS);
     
-    printf("[INIT] System Running\n");
+    get_mac_address();
+	snprintf(thing_name, sizeof(thing_name), "FD_%s_%s", DEVICE_TYPE, mac_address);
+    
+    // Loop timing and the task profiler must be ready before the first task runs
+    init_loop_monitors();
+    task_profiler_init(&taskProfiler);
+    task_profiler_register(&taskProfiler, "ota_update", TASK_OTA_STACK_SIZE);     // Created on demand by ota_job.c
+#ifdef CONFIG_FIRE_TASK_PROFILER
+    ram_budget_add_static("Profiler", sizeof(taskProfiler) + sizeof(profilerStatus));
+#endif
+    
+    // Hardware and Safety take timestamps while the Time stage runs on the
+    // other worker: create the time mutex here so neither creates it lazily
+    if (time_manager_ensure_initialized() != ESP_OK) {
+        printf("\n[INIT] Time mutex unavailable");
+    }
+    
+    // Stage times are from esp_timer start, i.e. power-on
+    bootMutex = xSemaphoreCreateMutexStatic(&bootMutexBuf);
+    if (!boot_sequencer_init(&bootSeq, bootStages, BOOT_STAGE_COUNT, 0)) {
+        printf("\n[BOOT] Invalid boot stage table, halting");
+        while (1) {
+            vTaskDelay(pdMS_TO_TICKS(10000));
+        }
+    }
+    
+    bootWorkers[0] = xTaskGetCurrentTaskHandle();
+    if (xTaskCreatePinnedToCore(task_boot_worker, "BootWorker", TASK_BOOT_WORKER_STACK_SIZE, (void *)(intptr_t)1,
+                                TASK_PRIORITY_BOOT_WORKER, &bootWorkers[1], TASK_CORE_BOOT_WORKER) != pdPASS) {
+        printf("\n[BOOT] Boot worker unavailable, booting sequentially");
+        bootWorkers[1] = NULL;
+    }
+    boot_run_stages(0);
+    
+    uint32_t freeHeap = esp_get_free_heap_size();
+    boot_sequencer_print(&bootSeq);
+    ram_budget_print(freeHeap, esp_get_minimum_free_heap_size(), heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+    if (freeHeap < MIN_FREE_HEAP_THRESHOLD) {
+        printf("[RAM] WARNING: Free heap %lu below %d bytes after boot\n", (unsigned long)freeHeap, MIN_FREE_HEAP_THRESHOLD);
+    }
+    
+    printf("[INIT] System Running, armed at %lld ms\n", (long long)(bootArmedUs / 1000));
     
     // Main loop
     while(1) {
         vTaskDelay(pdMS_TO_TICKS(10000));
     }
 }
-
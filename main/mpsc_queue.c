@@ -0,0 +1,79 @@
+/**
+ * @file mpsc_queue.c
+ * @brief Bounded lock-free multi-producer, single-consumer queue
+ */
+
+#include "mpsc_queue.h"
+#include <string.h>
+
+// Slot states, with pos the absolute position of a lap through the ring:
+//   seq == pos          free for the producer claiming pos
+//   seq == pos + 1      written, ready for the consumer
+//   seq == pos + cap    freed by the consumer for the next lap
+
+int mpsc_queue_init(mpsc_queue_t *q, void *items, uint32_t *seqs, uint32_t capacity, size_t item_size)
+{
+    if (q == NULL || items == NULL || seqs == NULL || item_size == 0 ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return -1;
+    }
+    q->items = (uint8_t *)items;
+    q->seqs = seqs;
+    q->mask = capacity - 1;
+    q->item_size = (uint32_t)item_size;
+    q->head = 0;
+    q->tail = 0;
+    q->full = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        q->seqs[i] = i;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return 0;
+}
+
+bool mpsc_queue_push(mpsc_queue_t *q, const void *item)
+{
+    uint32_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&q->seqs[pos & q->mask], __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            // Free slot: claim it (on failure pos is reloaded with the new head)
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer has not freed this slot from the previous lap
+            __atomic_fetch_add(&q->full, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            // Another producer got here first
+            pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(q->items + (size_t)(pos & q->mask) * q->item_size, item, q->item_size);
+    __atomic_store_n(&q->seqs[pos & q->mask], pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool mpsc_queue_pop(mpsc_queue_t *q, void *out)
+{
+    uint32_t pos = q->tail;
+    uint32_t seq = __atomic_load_n(&q->seqs[pos & q->mask], __ATOMIC_ACQUIRE);
+    if ((int32_t)(seq - (pos + 1)) < 0) {
+        return false;
+    }
+
+    memcpy(out, q->items + (size_t)(pos & q->mask) * q->item_size, q->item_size);
+    __atomic_store_n(&q->seqs[pos & q->mask], pos + q->mask + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&q->tail, pos + 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+uint32_t mpsc_queue_count(const mpsc_queue_t *q)
+{
+    uint32_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    return head - __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Bounded lock-free multi-producer, single-consumer queue
+ *
+ * Any number of tasks push fixed-size items; one task pops them. Every
+ * slot carries a sequence number. A producer claims a slot by advancing
+ * the head with compare-and-swap, copies its item in and then publishes
+ * the slot by bumping its sequence. The consumer only reads slots whose
+ * sequence says they are complete. Nobody ever blocks or takes a lock, so
+ * a producer preempted mid-push delays only the items behind it, never
+ * the other producers.
+ *
+ * Capacity must be a power of two. Storage is supplied by the caller so
+ * queues can live in static memory.
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t *items;             // capacity * item_size bytes
+    uint32_t *seqs;             // Per-slot sequence numbers
+    uint32_t mask;              // capacity - 1
+    uint32_t item_size;
+    uint32_t head;              // Next slot to claim (producers)
+    uint32_t tail;              // Next slot to read (consumer only)
+    uint32_t full;              // Pushes refused because the queue was full
+} mpsc_queue_t;
+
+/**
+ * @brief Initialise a queue over caller-owned storage
+ * @param q Queue
+ * @param items capacity * item_size bytes
+ * @param seqs capacity sequence words
+ * @param capacity Slot count, a power of two
+ * @param item_size Bytes per item
+ * @return 0 on success, -1 if capacity is not a power of two or an argument is missing
+ */
+int mpsc_queue_init(mpsc_queue_t *q, void *items, uint32_t *seqs, uint32_t capacity, size_t item_size);
+
+/**
+ * @brief Copy an item in (any task)
+ * @return false if the queue is full
+ */
+bool mpsc_queue_push(mpsc_queue_t *q, const void *item);
+
+/**
+ * @brief Copy the oldest complete item out (consumer task only)
+ * @return false if the queue is empty or the next item is still being written
+ */
+bool mpsc_queue_pop(mpsc_queue_t *q, void *out);
+
+/**
+ * @brief Items pushed but not yet popped (approximate while producers run)
+ */
+uint32_t mpsc_queue_count(const mpsc_queue_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,163 @@
+/**
+ * @file mqtt_lanes.c
+ * @brief Strict-priority lanes over a shared set of outbound message slots
+ */
+
+#include "mqtt_lanes.h"
+#include <stdio.h>
+#include <string.h>
+
+static int fifo_take_head(mqtt_lanes_t *l, mqtt_lane_t lane)
+{
+    mqtt_lane_fifo_t *f = &l->fifo[lane];
+    mqtt_lane_stats_t *st = &l->stats[lane];
+    int slot = f->ring[f->head];
+    f->head = (uint8_t)((f->head + 1) % l->slots);
+    st->depth--;
+    return slot;
+}
+
+// Remove the oldest message of a lane that may be evicted, -1 if none
+static int fifo_take_evictable(mqtt_lanes_t *l, mqtt_lane_t lane)
+{
+    mqtt_lane_fifo_t *f = &l->fifo[lane];
+    mqtt_lane_stats_t *st = &l->stats[lane];
+    for (int i = 0; i < st->depth; i++) {
+        int slot = f->ring[(f->head + i) % l->slots];
+        if (l->keep[slot]) {
+            continue;
+        }
+        // Close the gap, keeping the order of the rest
+        for (int j = i; j < st->depth - 1; j++) {
+            f->ring[(f->head + j) % l->slots] = f->ring[(f->head + j + 1) % l->slots];
+        }
+        st->depth--;
+        return slot;
+    }
+    return -1;
+}
+
+static void fifo_append(mqtt_lanes_t *l, mqtt_lane_t lane, int slot)
+{
+    mqtt_lane_stats_t *st = &l->stats[lane];
+    l->fifo[lane].ring[(l->fifo[lane].head + st->depth) % l->slots] = (uint8_t)slot;
+    st->depth++;
+    if (st->depth > st->max_depth) {
+        st->max_depth = st->depth;
+    }
+}
+
+void mqtt_lanes_init(mqtt_lanes_t *l, int slots)
+{
+    memset(l, 0, sizeof(*l));
+    if (slots > MQTT_LANES_MAX_SLOTS) {
+        slots = MQTT_LANES_MAX_SLOTS;
+    }
+    l->slots = slots > 0 ? slots : 1;
+    for (int i = 0; i < slots; i++) {
+        l->free_list[i] = (uint8_t)(slots - 1 - i);
+    }
+    l->free_count = slots > 0 ? slots : 0;
+}
+
+int mqtt_lanes_push(mqtt_lanes_t *l, mqtt_lane_t lane, bool keep, bool *evicted)
+{
+    *evicted = false;
+    if (lane >= MQTT_LANE_COUNT) {
+        return -1;
+    }
+
+    int slot = -1;
+    if (l->free_count > 0) {
+        slot = l->free_list[--l->free_count];
+    } else {
+        // Lowest telemetry lane below this one gives up its oldest message
+        for (int victim = MQTT_LANE_COUNT - 1; victim > (int)lane && victim >= MQTT_LANE_EVICTABLE; victim--) {
+            slot = fifo_take_evictable(l, (mqtt_lane_t)victim);
+            if (slot >= 0) {
+                l->stats[victim].evicted++;
+                *evicted = true;
+                break;
+            }
+        }
+    }
+
+    if (slot < 0) {
+        l->stats[lane].dropped++;
+        return -1;
+    }
+    l->keep[slot] = keep;
+    fifo_append(l, lane, slot);
+    l->stats[lane].enqueued++;
+    return slot;
+}
+
+void mqtt_lanes_push_front(mqtt_lanes_t *l, mqtt_lane_t lane, int slot)
+{
+    if (lane >= MQTT_LANE_COUNT || slot < 0 || slot >= l->slots) {
+        return;
+    }
+    mqtt_lane_fifo_t *f = &l->fifo[lane];
+    mqtt_lane_stats_t *st = &l->stats[lane];
+    f->head = (uint8_t)((f->head + l->slots - 1) % l->slots);
+    f->ring[f->head] = (uint8_t)slot;
+    st->depth++;
+    st->dequeued--;             // Not delivered after all
+    if (st->depth > st->max_depth) {
+        st->max_depth = st->depth;
+    }
+}
+
+int mqtt_lanes_pop(mqtt_lanes_t *l, mqtt_lane_t below, mqtt_lane_t *lane)
+{
+    for (int i = 0; i < (int)below && i < MQTT_LANE_COUNT; i++) {
+        if (l->stats[i].depth > 0) {
+            *lane = (mqtt_lane_t)i;
+            l->stats[i].dequeued++;
+            return fifo_take_head(l, (mqtt_lane_t)i);
+        }
+    }
+    return -1;
+}
+
+void mqtt_lanes_release(mqtt_lanes_t *l, int slot)
+{
+    if (slot < 0 || slot >= l->slots || l->free_count >= l->slots) {
+        return;
+    }
+    l->free_list[l->free_count++] = (uint8_t)slot;
+}
+
+bool mqtt_lanes_pending_above(const mqtt_lanes_t *l, mqtt_lane_t lane)
+{
+    for (int i = 0; i < (int)lane && i < MQTT_LANE_COUNT; i++) {
+        if (l->stats[i].depth > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *mqtt_lane_name(mqtt_lane_t lane)
+{
+    switch (lane) {
+        case MQTT_LANE_EMERGENCY: return "emergency";
+        case MQTT_LANE_CRITICAL:  return "critical";
+        case MQTT_LANE_NORMAL:    return "normal";
+        case MQTT_LANE_BULK:      return "bulk";
+        default:                  return "unknown";
+    }
+}
+
+void mqtt_lanes_print(const mqtt_lanes_t *l)
+{
+    printf("\n[MQTT] Publish lanes (%d slots, %d free)\n", l->slots, l->free_count);
+    printf("  %-10s %5s %5s %8s %8s %7s %7s\n", "lane", "depth", "max", "in", "out", "dropped", "evicted");
+    for (int i = 0; i < MQTT_LANE_COUNT; i++) {
+        const mqtt_lane_stats_t *st = &l->stats[i];
+        printf("  %-10s %5u %5u %8lu %8lu %7lu %7lu\n", mqtt_lane_name((mqtt_lane_t)i),
+               (unsigned int)st->depth, (unsigned int)st->max_depth,
+               (unsigned long)st->enqueued, (unsigned long)st->dequeued,
+               (unsigned long)st->dropped, (unsigned long)st->evicted);
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file mqtt_lanes.h
+ * @brief Strict-priority lanes over a shared set of outbound message slots
+ *
+ * Outbound messages sit in fixed slots owned by the caller. The lanes only
+ * move slot indices: one FIFO per priority and a free list. The consumer
+ * always takes the oldest message of the highest non-empty lane, so a new
+ * emergency alert goes out before anything queued earlier in a lower lane.
+ *
+ * When every slot is taken, a message can take the slot of the oldest
+ * message in the lowest telemetry lane (normal or bulk) below its own.
+ * Messages pushed with keep set (alerts, anything the caller would store
+ * if it could not be sent) are never evicted, whatever their lane: if
+ * there is nothing to evict, the push fails and the caller keeps the
+ * message itself (SPIFFS).
+ *
+ * Per-lane depth, high-water mark and drop counts are kept for diagnostics.
+ * Not thread-safe: callers serialise access.
+ */
+
+#ifndef MQTT_LANES_H
+#define MQTT_LANES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MQTT_LANES_MAX_SLOTS        32
+
+typedef enum {
+    MQTT_LANE_EMERGENCY = 0,
+    MQTT_LANE_CRITICAL,
+    MQTT_LANE_NORMAL,           // Telemetry (heartbeat, status, shadow), INFO/WARNING alerts
+    MQTT_LANE_BULK,             // Diagnostics and other large, late-tolerant data
+    MQTT_LANE_COUNT
+} mqtt_lane_t;
+
+#define MQTT_LANE_EVICTABLE         MQTT_LANE_NORMAL    // This lane and below give up slots
+
+typedef struct {
+    uint16_t depth;
+    uint16_t max_depth;         // High-water mark
+    uint32_t enqueued;
+    uint32_t dequeued;
+    uint32_t dropped;           // Pushes refused because every slot was taken
+    uint32_t evicted;           // Messages that gave their slot to a higher lane
+} mqtt_lane_stats_t;
+
+typedef struct {
+    uint8_t ring[MQTT_LANES_MAX_SLOTS];
+    uint8_t head;
+} mqtt_lane_fifo_t;
+
+typedef struct {
+    int slots;
+    uint8_t free_list[MQTT_LANES_MAX_SLOTS];
+    int free_count;
+    bool keep[MQTT_LANES_MAX_SLOTS];    // Slot holds a message that must not be evicted
+    mqtt_lane_fifo_t fifo[MQTT_LANE_COUNT];
+    mqtt_lane_stats_t stats[MQTT_LANE_COUNT];
+} mqtt_lanes_t;
+
+/**
+ * @brief Set up lanes over slots 0..slots-1 (at most MQTT_LANES_MAX_SLOTS)
+ */
+void mqtt_lanes_init(mqtt_lanes_t *l, int slots);
+
+/**
+ * @brief Append a message to a lane
+ * @param keep Never give this message's slot to a higher lane
+ * @param evicted Set if the slot was taken from a lower lane's oldest
+ *                evictable message
+ * @return Slot for the caller to fill, or -1 if none could be found
+ */
+int mqtt_lanes_push(mqtt_lanes_t *l, mqtt_lane_t lane, bool keep, bool *evicted);
+
+/**
+ * @brief Put a message back at the head of its lane (retry)
+ */
+void mqtt_lanes_push_front(mqtt_lanes_t *l, mqtt_lane_t lane, int slot);
+
+/**
+ * @brief Take the oldest message of the highest lane above `below`
+ * @param below MQTT_LANE_COUNT for any lane
+ * @return Slot, or -1 if those lanes are empty; the slot stays the
+ *         caller's until mqtt_lanes_release()
+ */
+int mqtt_lanes_pop(mqtt_lanes_t *l, mqtt_lane_t below, mqtt_lane_t *lane);
+
+/**
+ * @brief Return a popped slot to the free list
+ */
+void mqtt_lanes_release(mqtt_lanes_t *l, int slot);
+
+/**
+ * @brief True if any lane above `lane` has a message waiting
+ */
+bool mqtt_lanes_pending_above(const mqtt_lanes_t *l, mqtt_lane_t lane);
+
+const char *mqtt_lane_name(mqtt_lane_t lane);
+
+/**
+ * @brief Print per-lane depth and counters
+ */
+void mqtt_lanes_print(const mqtt_lanes_t *l);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MQTT_LANES_H
@@ -231,7 +231,7 @@ void ota_job_process_message(const char *topic, const char *payload, int length)
     publish_job_status("IN_PROGRESS", "Starting OTA update");
     send_ota_alert("start", current_job.version);
     // Start OTA update task
-    xTaskCreate(ota_task, "ota_update", 16384, NULL, 5, NULL);
+    xTaskCreatePinnedToCore(ota_task, "ota_update", TASK_OTA_STACK_SIZE, NULL, TASK_PRIORITY_OTA, NULL, TASK_CORE_OTA);
 }
 
 // ==================== OTA UPDATE ====================
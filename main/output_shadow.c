@@ -0,0 +1,90 @@
+/**
+ * @file output_shadow.c
+ * @brief Shadow registers for the PCA9555 output ports
+ */
+
+#include "output_shadow.h"
+#include <string.h>
+
+void output_shadow_init(output_shadow_t *s, uint8_t port0, uint8_t port1)
+{
+    memset(s, 0, sizeof(*s));
+    s->desired[0] = s->committed[0] = port0;
+    s->desired[1] = s->committed[1] = port1;
+}
+
+void output_shadow_set(output_shadow_t *s, uint8_t port, uint8_t pin, bool state)
+{
+    if (port >= OUTPUT_SHADOW_PORTS || pin > 7) {
+        return;
+    }
+    if (state) {
+        s->desired[port] |= (uint8_t)(1 << pin);
+    } else {
+        s->desired[port] &= (uint8_t)~(1 << pin);
+    }
+}
+
+void output_shadow_begin(output_shadow_t *s)
+{
+    s->batch_depth++;
+}
+
+bool output_shadow_end(output_shadow_t *s)
+{
+    if (s->batch_depth == 0) {
+        return false;
+    }
+    return --s->batch_depth == 0;
+}
+
+bool output_shadow_batching(const output_shadow_t *s)
+{
+    return s->batch_depth > 0;
+}
+
+bool output_shadow_dirty(const output_shadow_t *s, uint8_t port)
+{
+    return port < OUTPUT_SHADOW_PORTS && s->desired[port] != s->committed[port];
+}
+
+void output_shadow_committed(output_shadow_t *s, uint8_t port, uint8_t value, uint32_t now_ms)
+{
+    if (port >= OUTPUT_SHADOW_PORTS) {
+        return;
+    }
+    s->committed[port] = value;
+    s->commits++;
+
+    // A later commit pushes the read-back out so it sees settled relays
+    s->verify_ports |= (uint8_t)(1 << port);
+    s->verify_due_ms = now_ms + OUTPUT_SHADOW_VERIFY_DELAY_MS;
+}
+
+bool output_shadow_verify_pending(const output_shadow_t *s, uint8_t port)
+{
+    return port < OUTPUT_SHADOW_PORTS && (s->verify_ports & (1 << port)) != 0;
+}
+
+bool output_shadow_verify_due(const output_shadow_t *s, uint8_t port, uint32_t now_ms)
+{
+    return port < OUTPUT_SHADOW_PORTS &&
+           (s->verify_ports & (1 << port)) != 0 &&
+           (int32_t)(now_ms - s->verify_due_ms) >= 0;
+}
+
+uint8_t output_shadow_verify(output_shadow_t *s, uint8_t port, uint8_t readback)
+{
+    if (port >= OUTPUT_SHADOW_PORTS) {
+        return 0;
+    }
+    s->verify_ports &= (uint8_t)~(1 << port);
+
+    uint8_t mismatch = readback ^ s->committed[port];
+    if (mismatch) {
+        s->mismatches++;
+        // Force the next commit to rewrite the port
+        s->committed[port] = readback;
+    }
+    return mismatch;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file output_shadow.h
+ * @brief Shadow registers for the PCA9555 output ports
+ *
+ * Pump relays are driven by staging bits in a RAM copy of both output
+ * ports and committing a whole port in one register write, instead of a
+ * read-modify-write per pin. Calls between output_shadow_begin() and
+ * output_shadow_end() are batched, so switching every pump costs a single
+ * I2C transaction.
+ *
+ * After each commit the pins are verified by one read-back of the port,
+ * deferred by OUTPUT_SHADOW_VERIFY_DELAY_MS so relays can settle and so
+ * the read never sits on the switching path.
+ *
+ * The caller does the I2C and serialises access (the control task owns it).
+ */
+
+#ifndef OUTPUT_SHADOW_H
+#define OUTPUT_SHADOW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OUTPUT_SHADOW_PORTS             2
+#define OUTPUT_SHADOW_VERIFY_DELAY_MS   100     // Relay settle time before read-back
+
+typedef struct {
+    uint8_t desired[OUTPUT_SHADOW_PORTS];       // Staged pin states
+    uint8_t committed[OUTPUT_SHADOW_PORTS];     // Last value written to the chip
+    uint8_t batch_depth;
+    uint8_t verify_ports;                       // Bit per port awaiting read-back
+    uint32_t verify_due_ms;
+    uint32_t commits;                           // Register writes
+    uint32_t mismatches;                        // Read-backs that disagreed
+} output_shadow_t;
+
+/**
+ * @brief Start from known port values (as written at init)
+ */
+void output_shadow_init(output_shadow_t *s, uint8_t port0, uint8_t port1);
+
+/**
+ * @brief Stage one pin
+ */
+void output_shadow_set(output_shadow_t *s, uint8_t port, uint8_t pin, bool state);
+
+/**
+ * @brief Open a batch (nestable)
+ */
+void output_shadow_begin(output_shadow_t *s);
+
+/**
+ * @brief Close a batch
+ * @return true when the outermost batch closed and staged pins should be committed
+ */
+bool output_shadow_end(output_shadow_t *s);
+
+/**
+ * @brief True while a batch is open
+ */
+bool output_shadow_batching(const output_shadow_t *s);
+
+/**
+ * @brief True if a port has staged changes not yet written
+ */
+bool output_shadow_dirty(const output_shadow_t *s, uint8_t port);
+
+/**
+ * @brief Record a successful write of the staged value and schedule its read-back
+ * @param s Shadow
+ * @param port Port written
+ * @param value Value written
+ * @param now_ms Uptime in ms
+ */
+void output_shadow_committed(output_shadow_t *s, uint8_t port, uint8_t value, uint32_t now_ms);
+
+/**
+ * @brief True if a port has a read-back scheduled (due or not)
+ */
+bool output_shadow_verify_pending(const output_shadow_t *s, uint8_t port);
+
+/**
+ * @brief True if a port read-back is due (wrap-safe)
+ */
+bool output_shadow_verify_due(const output_shadow_t *s, uint8_t port, uint32_t now_ms);
+
+/**
+ * @brief Compare a port read-back with what was committed
+ * @param s Shadow
+ * @param port Port read
+ * @param readback Value read from the output register
+ * @return Mask of pins that disagree (0 = verified)
+ */
+uint8_t output_shadow_verify(output_shadow_t *s, uint8_t port, uint8_t readback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OUTPUT_SHADOW_H
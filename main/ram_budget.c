@@ -0,0 +1,97 @@
+/**
+ * @file ram_budget.c
+ * @brief Boot-time RAM budget: static reservations and heap use per subsystem
+ */
+
+#include "ram_budget.h"
+#include <stdio.h>
+#include <string.h>
+
+static ram_budget_entry_t s_entries[RAM_BUDGET_MAX_ENTRIES];
+static int s_count = 0;
+
+static ram_budget_entry_t *entry_for(const char *subsystem)
+{
+    for (int i = 0; i < s_count; i++) {
+        if (strcmp(s_entries[i].subsystem, subsystem) == 0) {
+            return &s_entries[i];
+        }
+    }
+    if (s_count >= RAM_BUDGET_MAX_ENTRIES) {
+        printf("[RAM] WARNING: Budget table full, '%s' not recorded\n", subsystem);
+        return NULL;
+    }
+    ram_budget_entry_t *e = &s_entries[s_count++];
+    e->subsystem = subsystem;
+    e->static_bytes = 0;
+    e->heap_bytes = 0;
+    return e;
+}
+
+void ram_budget_add_static(const char *subsystem, uint32_t bytes)
+{
+    ram_budget_entry_t *e = entry_for(subsystem);
+    if (e) {
+        e->static_bytes += bytes;
+    }
+}
+
+uint32_t ram_budget_heap_step(const char *subsystem, uint32_t free_before, uint32_t free_after)
+{
+    ram_budget_entry_t *e = entry_for(subsystem);
+    // A step that freed memory counts as zero
+    if (e && free_before > free_after) {
+        e->heap_bytes += free_before - free_after;
+    }
+    return free_after;
+}
+
+int ram_budget_count(void)
+{
+    return s_count;
+}
+
+const ram_budget_entry_t *ram_budget_get(int index)
+{
+    return (index >= 0 && index < s_count) ? &s_entries[index] : NULL;
+}
+
+uint32_t ram_budget_total_static(void)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < s_count; i++) {
+        total += s_entries[i].static_bytes;
+    }
+    return total;
+}
+
+uint32_t ram_budget_total_heap(void)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < s_count; i++) {
+        total += s_entries[i].heap_bytes;
+    }
+    return total;
+}
+
+void ram_budget_reset(void)
+{
+    memset(s_entries, 0, sizeof(s_entries));
+    s_count = 0;
+}
+
+void ram_budget_print(uint32_t free_heap, uint32_t min_free_heap, uint32_t largest_block)
+{
+    printf("\n[RAM] Boot RAM budget (bytes)\n");
+    printf("  %-16s %8s %8s\n", "subsystem", "static", "heap");
+    for (int i = 0; i < s_count; i++) {
+        printf("  %-16s %8lu %8lu\n", s_entries[i].subsystem,
+               (unsigned long)s_entries[i].static_bytes,
+               (unsigned long)s_entries[i].heap_bytes);
+    }
+    printf("  %-16s %8lu %8lu\n", "total",
+           (unsigned long)ram_budget_total_static(),
+           (unsigned long)ram_budget_total_heap());
+    printf("  heap free %lu, min free %lu, largest block %lu\n",
+           (unsigned long)free_heap, (unsigned long)min_free_heap, (unsigned long)largest_block);
+}
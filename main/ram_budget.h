@@ -0,0 +1,80 @@
+/**
+ * @file ram_budget.h
+ * @brief Boot-time RAM budget: static reservations and heap use per subsystem
+ *
+ * Long-lived RTOS objects (task stacks, queues, mutexes, timers) are
+ * reserved statically from the sizes in config.h. main.c registers each
+ * reservation under a subsystem name. Around each init step it also
+ * records how much heap the step consumed. The report lists both per
+ * subsystem, so budgets can be tuned from measured data.
+ *
+ * Entries are keyed by name (compared by content); adding to an existing
+ * name accumulates. Written during boot only; callers running boot stages
+ * concurrently serialise their calls.
+ */
+
+#ifndef RAM_BUDGET_H
+#define RAM_BUDGET_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RAM_BUDGET_MAX_ENTRIES      24
+
+typedef struct {
+    const char *subsystem;      // Not copied
+    uint32_t static_bytes;
+    uint32_t heap_bytes;
+} ram_budget_entry_t;
+
+/**
+ * @brief Record a static reservation
+ */
+void ram_budget_add_static(const char *subsystem, uint32_t bytes);
+
+/**
+ * @brief Record heap consumed by an init step
+ * @param subsystem Step name
+ * @param free_before Free heap before the step
+ * @param free_after Free heap after the step
+ * @return free_after, so steps can be chained
+ */
+uint32_t ram_budget_heap_step(const char *subsystem, uint32_t free_before, uint32_t free_after);
+
+/**
+ * @brief Number of subsystems recorded
+ */
+int ram_budget_count(void);
+
+/**
+ * @brief Entry by index, NULL if out of range
+ */
+const ram_budget_entry_t *ram_budget_get(int index);
+
+/**
+ * @brief Sum over all subsystems
+ */
+uint32_t ram_budget_total_static(void);
+uint32_t ram_budget_total_heap(void);
+
+/**
+ * @brief Forget all entries
+ */
+void ram_budget_reset(void);
+
+/**
+ * @brief Print the per-subsystem table and heap state to the serial console
+ * @param free_heap Current free heap
+ * @param min_free_heap Low-water mark of free heap since boot
+ * @param largest_block Largest free heap block (fragmentation indicator)
+ */
+void ram_budget_print(uint32_t free_heap, uint32_t min_free_heap, uint32_t largest_block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RAM_BUDGET_H
@@ -0,0 +1,57 @@
+/**
+ * @file sensor_frame.c
+ * @brief Lock-free double-buffered sensor snapshot (per-buffer seqlock)
+ */
+
+#include "sensor_frame.h"
+#include <string.h>
+
+// The writer always fills the buffer that is NOT currently published, so a
+// reader can only see an odd (in-progress) counter if it lost the race by a
+// full publish cycle; re-reading s_latest then lands on the stable buffer.
+static SensorFrame s_frames[2];
+static uint32_t s_frame_seq[2];
+static uint32_t s_latest = 0;
+static uint32_t s_published = 0;
+
+uint32_t sensor_frame_publish(const SensorFrame *frame)
+{
+    uint32_t idx = __atomic_load_n(&s_latest, __ATOMIC_RELAXED) ^ 1;
+    uint32_t seq = s_frame_seq[idx];
+
+    // Mark the buffer as being written before touching its contents
+    __atomic_store_n(&s_frame_seq[idx], seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    memcpy(&s_frames[idx], frame, sizeof(*frame));
+    s_frames[idx].seq = ++s_published;
+
+    __atomic_store_n(&s_frame_seq[idx], seq + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_latest, idx, __ATOMIC_RELEASE);
+
+    return s_published;
+}
+
+void sensor_frame_read(SensorFrame *out)
+{
+    for (;;) {
+        uint32_t idx = __atomic_load_n(&s_latest, __ATOMIC_ACQUIRE);
+        uint32_t before = __atomic_load_n(&s_frame_seq[idx], __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            continue;
+        }
+
+        memcpy(out, &s_frames[idx], sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&s_frame_seq[idx], __ATOMIC_RELAXED) == before) {
+            return;
+        }
+    }
+}
+
+uint32_t sensor_frame_latest_seq(void)
+{
+    uint32_t idx = __atomic_load_n(&s_latest, __ATOMIC_ACQUIRE);
+    return s_frames[idx].seq;
+}
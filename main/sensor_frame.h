@@ -0,0 +1,58 @@
+/**
+ * @file sensor_frame.h
+ * @brief Versioned sensor snapshot shared between acquisition and consumers
+ *
+ * The sensor task is the only writer. Every other task reads a consistent
+ * copy without taking a lock: frames are double-buffered and each buffer
+ * carries its own sequence counter (odd while being written), so a reader
+ * that races the writer simply retries on the newer buffer. Readers never
+ * block the writer and the writer never blocks readers.
+ */
+
+#ifndef SENSOR_FRAME_H
+#define SENSOR_FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Complete set of conditioned sensor values from one acquisition cycle
+typedef struct {
+    uint32_t seq;               // Frame sequence number (0 = nothing published yet)
+    int64_t timestamp_us;       // esp_timer capture time
+
+    float ir[4];                // Conditioned sector IR in % [N, S, E, W]
+    float irRaw[4];             // Unconditioned sector IR in %
+    float irRate[4];            // Conditioned IR rate of change in %/s
+    float waterLevels[4];       // Per-probe water level in %
+    float level;                // Average water level in %
+    float solarVoltage;
+    float batteryVoltage;
+    float current[4];           // CT1..CT4 true RMS in A
+    float currentPeak[4];       // CT1..CT4 peak in A
+    float currentCrest[4];      // CT1..CT4 crest factor
+    bool currentFault[4];
+
+    float adc1[8];              // Mux A channel voltages
+    float adc2[8];              // Mux B channel voltages
+} SensorFrame;
+
+/**
+ * @brief Publish a new frame (sensor task only)
+ * @param frame Frame contents; seq is assigned here
+ * @return Sequence number given to the frame
+ */
+uint32_t sensor_frame_publish(const SensorFrame *frame);
+
+/**
+ * @brief Copy the latest published frame without blocking
+ * @param out Destination frame (zeroed with seq 0 before the first publish)
+ */
+void sensor_frame_read(SensorFrame *out);
+
+/**
+ * @brief Sequence number of the latest published frame
+ * @return 0 if no frame has been published yet
+ */
+uint32_t sensor_frame_latest_seq(void);
+
+#endif // SENSOR_FRAME_H
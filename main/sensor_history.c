@@ -0,0 +1,283 @@
+/**
+ * @file sensor_history.c
+ * @brief Multi-resolution sensor history for post-incident forensics
+ */
+
+#include "sensor_history.h"
+#include <math.h>
+#include <string.h>
+
+// Tier 0 buckets covered by every tier together; a longer outage wipes the lot
+#define SPAN_T0_BUCKETS ((uint32_t)SENSOR_HISTORY_T2_ROWS * SENSOR_HISTORY_T2_FOLD * SENSOR_HISTORY_T1_FOLD)
+
+int sensor_history_scale(sensor_history_channel_t channel)
+{
+    switch (channel) {
+        case SENSOR_HISTORY_CT1:
+        case SENSOR_HISTORY_CT2:
+        case SENSOR_HISTORY_CT3:
+        case SENSOR_HISTORY_CT4:
+            return SENSOR_HISTORY_SCALE_AMPS;
+        case SENSOR_HISTORY_BATTERY:
+            return SENSOR_HISTORY_SCALE_VOLTS;
+        default:
+            return SENSOR_HISTORY_SCALE_PERCENT;
+    }
+}
+
+void sensor_history_init(sensor_history_t *h)
+{
+    memset(h, 0, sizeof(*h));
+
+    h->tier[0].rows = &h->rows0[0][0];
+    h->tier[0].capacity = SENSOR_HISTORY_T0_ROWS;
+    h->tier[0].period_ms = SENSOR_HISTORY_T0_PERIOD_MS;
+
+    h->tier[1].rows = &h->rows1[0][0];
+    h->tier[1].capacity = SENSOR_HISTORY_T1_ROWS;
+    h->tier[1].fold = SENSOR_HISTORY_T1_FOLD;
+    h->tier[1].period_ms = SENSOR_HISTORY_T0_PERIOD_MS * SENSOR_HISTORY_T1_FOLD;
+
+    h->tier[2].rows = &h->rows2[0][0];
+    h->tier[2].capacity = SENSOR_HISTORY_T2_ROWS;
+    h->tier[2].fold = SENSOR_HISTORY_T2_FOLD;
+    h->tier[2].period_ms = h->tier[1].period_ms * SENSOR_HISTORY_T2_FOLD;
+}
+
+static void close_bucket(sensor_history_t *h, int t, uint32_t end_ms);
+
+static void push_row(sensor_history_t *h, int t, const int16_t row[SENSOR_HISTORY_CHANNELS], uint32_t end_ms)
+{
+    sensor_history_tier_t *tier = &h->tier[t];
+
+    memcpy(&tier->rows[tier->head * SENSOR_HISTORY_CHANNELS], row,
+           SENSOR_HISTORY_CHANNELS * sizeof(int16_t));
+    tier->head = (tier->head + 1) % tier->capacity;
+    if (tier->count < tier->capacity) {
+        tier->count++;
+    }
+    tier->newest_end_ms = end_ms;
+    tier->closed++;
+
+    if (t + 1 >= SENSOR_HISTORY_TIERS) {
+        return;
+    }
+
+    // Fold into the next tier, skipping gaps
+    sensor_history_tier_t *next = &h->tier[t + 1];
+    for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+        if (row[c] != SENSOR_HISTORY_GAP) {
+            next->sum[c] += row[c];
+            next->n[c]++;
+        }
+    }
+    if (++next->folded >= next->fold) {
+        close_bucket(h, t + 1, end_ms);
+    }
+}
+
+static void close_bucket(sensor_history_t *h, int t, uint32_t end_ms)
+{
+    sensor_history_tier_t *tier = &h->tier[t];
+    int16_t row[SENSOR_HISTORY_CHANNELS];
+
+    for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+        if (tier->n[c] == 0) {
+            row[c] = SENSOR_HISTORY_GAP;
+        } else {
+            // Mean rounded to nearest
+            int32_t half = tier->n[c] / 2;
+            int32_t sum = tier->sum[c];
+            row[c] = (int16_t)((sum >= 0 ? sum + half : sum - half) / tier->n[c]);
+        }
+        tier->sum[c] = 0;
+        tier->n[c] = 0;
+    }
+    tier->folded = 0;
+    push_row(h, t, row, end_ms);
+}
+
+static int16_t quantise(float value, int scale)
+{
+    float q = roundf(value * scale);
+    if (q > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (q < -INT16_MAX) {
+        return -INT16_MAX;
+    }
+    return (int16_t)q;
+}
+
+void sensor_history_add(sensor_history_t *h, const float values[SENSOR_HISTORY_CHANNELS], uint32_t now_ms)
+{
+    sensor_history_tier_t *t0 = &h->tier[0];
+
+    if (!h->started) {
+        h->started = true;
+        h->bucket_ms = now_ms;
+    }
+
+    uint32_t elapsed = now_ms - h->bucket_ms;
+    if (elapsed >= t0->period_ms) {
+        uint32_t buckets = elapsed / t0->period_ms;
+        if (buckets > SPAN_T0_BUCKETS) {
+            // Nothing recorded so far would survive the gap
+            sensor_history_init(h);
+            h->started = true;
+            h->bucket_ms = now_ms;
+        } else {
+            // Close the open bucket, then one gap row per silent period
+            for (uint32_t b = 0; b < buckets; b++) {
+                h->bucket_ms += t0->period_ms;
+                close_bucket(h, 0, h->bucket_ms);
+            }
+        }
+    }
+
+    for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+        if (isnan(values[c])) {
+            continue;
+        }
+        t0->sum[c] += quantise(values[c], sensor_history_scale((sensor_history_channel_t)c));
+        t0->n[c]++;
+    }
+}
+
+uint16_t sensor_history_rows(const sensor_history_t *h, int tier)
+{
+    return (tier >= 0 && tier < SENSOR_HISTORY_TIERS) ? h->tier[tier].count : 0;
+}
+
+bool sensor_history_row(const sensor_history_t *h, int tier, uint16_t age,
+                        int16_t out[SENSOR_HISTORY_CHANNELS])
+{
+    if (tier < 0 || tier >= SENSOR_HISTORY_TIERS || age >= h->tier[tier].count) {
+        return false;
+    }
+    const sensor_history_tier_t *t = &h->tier[tier];
+    uint16_t idx = (uint16_t)((t->head + t->capacity - 1 - age) % t->capacity);
+    memcpy(out, &t->rows[idx * SENSOR_HISTORY_CHANNELS], SENSOR_HISTORY_CHANNELS * sizeof(int16_t));
+    return true;
+}
+
+// ========================================
+// EXPORT
+// ========================================
+
+size_t sensor_history_export_bound(const sensor_history_t *h, int tier)
+{
+    // A 17-bit zigzag delta needs at most 3 varint bytes, a lone zero 2
+    return SENSOR_HISTORY_HEADER_BYTES +
+           (size_t)sensor_history_rows(h, tier) * SENSOR_HISTORY_CHANNELS * 3;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p = put_u16(p, (uint16_t)v);
+    return put_u16(p, (uint16_t)(v >> 16));
+}
+
+static uint8_t *put_varint(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// A zero delta is followed by the number of further zero deltas
+static uint8_t *put_zero_run(uint8_t *p, uint32_t zeros)
+{
+    if (zeros == 0) {
+        return p;
+    }
+    *p++ = 0;
+    return put_varint(p, zeros - 1);
+}
+
+// Encode the run of rows that starts skip rows after the oldest one
+static size_t encode_rows(const sensor_history_t *h, int tier, uint16_t skip, uint16_t rows,
+                          uint32_t now_ms, uint32_t epoch_s, uint8_t *out)
+{
+    const sensor_history_tier_t *t = &h->tier[tier];
+    int newer = t->count - skip - rows;     // Held rows newer than the run
+
+    uint8_t *p = out;
+    *p++ = 'F';
+    *p++ = 'H';
+    *p++ = SENSOR_HISTORY_VERSION;
+    *p++ = (uint8_t)tier;
+    *p++ = SENSOR_HISTORY_CHANNELS;
+    *p++ = 0;
+    p = put_u16(p, (uint16_t)(t->period_ms / 1000));
+    p = put_u16(p, rows);
+    p = put_u32(p, rows ? now_ms - t->newest_end_ms + (uint32_t)newer * t->period_ms : 0);
+    p = put_u32(p, epoch_s);
+    p = put_u32(p, t->closed - t->count + skip);
+
+    for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+        int32_t prev = 0;
+        uint32_t zeros = 0;
+        for (int age = t->count - 1 - skip; age >= newer; age--) {
+            uint16_t idx = (uint16_t)((t->head + t->capacity - 1 - age) % t->capacity);
+            int32_t v = t->rows[idx * SENSOR_HISTORY_CHANNELS + c];
+            int32_t d = v - prev;
+            prev = v;
+            if (d == 0) {
+                zeros++;
+                continue;
+            }
+            p = put_zero_run(p, zeros);
+            zeros = 0;
+            p = put_varint(p, ((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+        }
+        p = put_zero_run(p, zeros);
+    }
+    return (size_t)(p - out);
+}
+
+size_t sensor_history_export(const sensor_history_t *h, int tier, uint32_t now_ms,
+                             uint32_t epoch_s, uint8_t *out, size_t out_len)
+{
+    if (tier < 0 || tier >= SENSOR_HISTORY_TIERS || out_len < sensor_history_export_bound(h, tier)) {
+        return 0;
+    }
+    return encode_rows(h, tier, 0, h->tier[tier].count, now_ms, epoch_s, out);
+}
+
+size_t sensor_history_export_chunk(const sensor_history_t *h, int tier, uint32_t *next_row,
+                                   uint32_t now_ms, uint32_t epoch_s, uint8_t *out, size_t out_len)
+{
+    if (tier < 0 || tier >= SENSOR_HISTORY_TIERS || out_len < SENSOR_HISTORY_HEADER_BYTES) {
+        return 0;
+    }
+    const sensor_history_tier_t *t = &h->tier[tier];
+
+    // Start from the oldest row still held; after a reset, from the beginning
+    uint32_t oldest = t->closed - t->count;
+    if (*next_row < oldest || *next_row > t->closed) {
+        *next_row = oldest;
+    }
+    uint16_t skip = (uint16_t)(*next_row - oldest);
+    size_t fit = (out_len - SENSOR_HISTORY_HEADER_BYTES) / (SENSOR_HISTORY_CHANNELS * 3);
+    uint16_t rows = (uint16_t)(t->count - skip);
+    if (rows > fit) {
+        rows = (uint16_t)fit;
+    }
+    if (rows == 0) {
+        return 0;
+    }
+
+    *next_row += rows;
+    return encode_rows(h, tier, skip, rows, now_ms, epoch_s, out);
+}
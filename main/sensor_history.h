@@ -0,0 +1,174 @@
+/**
+ * @file sensor_history.h
+ * @brief Multi-resolution sensor history for post-incident forensics
+ *
+ * Every sensor frame is folded into three fixed int16 ring buffers:
+ *
+ *   tier 0:  1 s buckets,  600 rows (last 10 min)
+ *   tier 1: 10 s buckets,  720 rows (last 2 h)
+ *   tier 2:  1 min buckets, 1440 rows (last 24 h)
+ *
+ * Each row holds the mean of every channel over its bucket. A tier 0 row is
+ * closed when a frame lands in a later second, and every 10th (then 6th)
+ * closed row is folded into the next tier, so appends are O(1) and RAM is
+ * fixed (about 54 KB). Seconds with no frames are stored as gaps.
+ *
+ * Values are fixed point (see SENSOR_HISTORY_SCALE_*), clamped to
+ * +/-32767; INT16_MIN marks a gap.
+ *
+ * Export format (little-endian), one tier or a run of its rows per blob:
+ *   "FH", version, tier, channel count, 0,
+ *   uint16 period_s, uint16 rows, uint32 newest_age_ms, uint32 epoch_s,
+ *   uint32 first_row (rows closed in the tier before the first one here),
+ *   then for each channel (channel-major, oldest row first) the zigzag
+ *   varint of the difference from the previous row (first row from 0).
+ *   A zero difference is followed by a varint count of further zeros, so
+ *   flat stretches cost two bytes.
+ * newest_age_ms is the age of the end of the newest row in the blob;
+ * first_row lets a reader join chunks exported while rows were added.
+ *
+ * Not thread-safe: the caller serialises add and export.
+ */
+
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tier Geometry
+#define SENSOR_HISTORY_TIERS            3
+#define SENSOR_HISTORY_T0_PERIOD_MS     1000
+#define SENSOR_HISTORY_T0_ROWS          600     // 10 min
+#define SENSOR_HISTORY_T1_FOLD          10      // tier 0 rows per tier 1 row
+#define SENSOR_HISTORY_T1_ROWS          720     // 2 h
+#define SENSOR_HISTORY_T2_FOLD          6       // tier 1 rows per tier 2 row
+#define SENSOR_HISTORY_T2_ROWS          1440    // 24 h
+
+// Fixed-point scales (stored = value * scale)
+#define SENSOR_HISTORY_SCALE_PERCENT    100     // 0.01 %
+#define SENSOR_HISTORY_SCALE_AMPS       1000    // mA
+#define SENSOR_HISTORY_SCALE_VOLTS      1000    // mV
+
+#define SENSOR_HISTORY_GAP              INT16_MIN
+#define SENSOR_HISTORY_VERSION          2
+#define SENSOR_HISTORY_HEADER_BYTES     22
+
+// Recorded channels
+typedef enum {
+    SENSOR_HISTORY_IR_N = 0,
+    SENSOR_HISTORY_IR_S,
+    SENSOR_HISTORY_IR_E,
+    SENSOR_HISTORY_IR_W,
+    SENSOR_HISTORY_LEVEL,
+    SENSOR_HISTORY_CT1,
+    SENSOR_HISTORY_CT2,
+    SENSOR_HISTORY_CT3,
+    SENSOR_HISTORY_CT4,
+    SENSOR_HISTORY_BATTERY,
+    SENSOR_HISTORY_CHANNELS
+} sensor_history_channel_t;
+
+// One resolution tier (rows live in sensor_history_t)
+typedef struct {
+    int16_t *rows;                  // [capacity][SENSOR_HISTORY_CHANNELS]
+    uint16_t capacity;
+    uint16_t head;                  // Next row to write
+    uint16_t count;
+    uint16_t fold;                  // Lower-tier rows per row (0 for tier 0)
+    uint32_t period_ms;
+    uint32_t newest_end_ms;         // End of the newest closed row
+    uint32_t closed;                // Rows closed since init
+    int32_t sum[SENSOR_HISTORY_CHANNELS];      // Open bucket
+    uint16_t n[SENSOR_HISTORY_CHANNELS];
+    uint16_t folded;                // Lower-tier rows in the open bucket
+} sensor_history_tier_t;
+
+typedef struct {
+    sensor_history_tier_t tier[SENSOR_HISTORY_TIERS];
+    uint32_t bucket_ms;             // Start of the open tier 0 bucket
+    bool started;
+    int16_t rows0[SENSOR_HISTORY_T0_ROWS][SENSOR_HISTORY_CHANNELS];
+    int16_t rows1[SENSOR_HISTORY_T1_ROWS][SENSOR_HISTORY_CHANNELS];
+    int16_t rows2[SENSOR_HISTORY_T2_ROWS][SENSOR_HISTORY_CHANNELS];
+} sensor_history_t;
+
+/**
+ * @brief Clear all tiers
+ */
+void sensor_history_init(sensor_history_t *h);
+
+/**
+ * @brief Add one frame
+ * @param h History
+ * @param values Engineering values indexed by sensor_history_channel_t
+ *               (NaN skips a channel for this frame)
+ * @param now_ms Uptime in ms (wrap-safe)
+ */
+void sensor_history_add(sensor_history_t *h, const float values[SENSOR_HISTORY_CHANNELS], uint32_t now_ms);
+
+/**
+ * @brief Number of closed rows in a tier
+ */
+uint16_t sensor_history_rows(const sensor_history_t *h, int tier);
+
+/**
+ * @brief Read one closed row
+ * @param h History
+ * @param tier Tier index
+ * @param age 0 = newest row
+ * @param out Stored fixed-point values
+ * @return false if the row does not exist
+ */
+bool sensor_history_row(const sensor_history_t *h, int tier, uint16_t age,
+                        int16_t out[SENSOR_HISTORY_CHANNELS]);
+
+/**
+ * @brief Fixed-point scale of a channel
+ */
+int sensor_history_scale(sensor_history_channel_t channel);
+
+/**
+ * @brief Worst-case export size of a tier in bytes
+ */
+size_t sensor_history_export_bound(const sensor_history_t *h, int tier);
+
+/**
+ * @brief Encode a tier as a compressed blob
+ * @param h History
+ * @param tier Tier index
+ * @param now_ms Uptime now (for newest_age_ms)
+ * @param epoch_s Wall-clock time now, 0 if not synced
+ * @param out Destination buffer
+ * @param out_len Buffer size (sensor_history_export_bound() is always enough)
+ * @return Bytes written, 0 on bad tier or short buffer
+ */
+size_t sensor_history_export(const sensor_history_t *h, int tier, uint32_t now_ms,
+                             uint32_t epoch_s, uint8_t *out, size_t out_len);
+
+/**
+ * @brief Encode the next run of a tier's rows that fits out_len in the worst case
+ * @param h History
+ * @param tier Tier index
+ * @param next_row Row to start from, counted like first_row (start at 0);
+ *                 rows already overwritten are skipped. Advanced past the
+ *                 rows written.
+ * @param now_ms Uptime now (for newest_age_ms)
+ * @param epoch_s Wall-clock time now, 0 if not synced
+ * @param out Destination buffer
+ * @param out_len Buffer size
+ * @return Bytes written, 0 when no rows are left, on bad tier or short buffer
+ */
+size_t sensor_history_export_chunk(const sensor_history_t *h, int tier, uint32_t *next_row,
+                                   uint32_t now_ms, uint32_t epoch_s, uint8_t *out, size_t out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSOR_HISTORY_H
@@ -0,0 +1,95 @@
+/**
+ * @file signal_conditioning.c
+ * @brief Per-channel streaming conditioning for the IR flame inputs
+ */
+
+#include "signal_conditioning.h"
+#include <stddef.h>
+
+static const sigcond_config_t s_default_config = {
+    .median_len = SIGCOND_DEFAULT_MEDIAN,
+    .tau_ms = SIGCOND_DEFAULT_TAU_MS,
+    .rate_tau_ms = SIGCOND_DEFAULT_RATE_TAU_MS,
+};
+
+// Median of the last median_len samples (insertion sort, n <= 7)
+static float window_median(const sigcond_channel_t *ch)
+{
+    uint8_t n = ch->config.median_len;
+    float sorted[SIGCOND_MEDIAN_MAX];
+
+    for (uint8_t i = 0; i < n; i++) {
+        uint8_t idx = (uint8_t)((ch->head + SIGCOND_MEDIAN_MAX - n + i) % SIGCOND_MEDIAN_MAX);
+        float v = ch->window[idx];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    return sorted[n / 2];
+}
+
+// First-order low-pass coefficient for a sample interval
+static float iir_alpha(float dt_ms, uint16_t tau_ms)
+{
+    return tau_ms ? dt_ms / (tau_ms + dt_ms) : 1.0f;
+}
+
+void sigcond_init(sigcond_channel_t *ch, const sigcond_config_t *config)
+{
+    ch->config = config ? *config : s_default_config;
+
+    if (ch->config.median_len < 1) {
+        ch->config.median_len = 1;
+    } else if (ch->config.median_len > SIGCOND_MEDIAN_MAX) {
+        ch->config.median_len = SIGCOND_MEDIAN_MAX;
+    }
+    if ((ch->config.median_len & 1) == 0) {
+        ch->config.median_len--;
+    }
+
+    ch->head = 0;
+    ch->primed = false;
+    ch->filtered = 0;
+    ch->rate = 0;
+    ch->last_us = 0;
+}
+
+void sigcond_update(sigcond_channel_t *ch, float sample, int64_t timestamp_us, sigcond_output_t *out)
+{
+    float dt_ms = (float)(timestamp_us - ch->last_us) / 1000.0f;
+
+    // First sample, or the input went quiet: restart from this sample
+    if (!ch->primed || dt_ms <= 0 || dt_ms > SIGCOND_STALE_MS) {
+        for (int i = 0; i < SIGCOND_MEDIAN_MAX; i++) {
+            ch->window[i] = sample;
+        }
+        ch->head = 0;
+        ch->filtered = sample;
+        ch->rate = 0;
+        ch->last_us = timestamp_us;
+        ch->primed = true;
+
+        out->median = sample;
+        out->value = sample;
+        out->rate = 0;
+        return;
+    }
+
+    ch->window[ch->head] = sample;
+    ch->head = (uint8_t)((ch->head + 1) % SIGCOND_MEDIAN_MAX);
+    float median = window_median(ch);
+
+    float previous = ch->filtered;
+    ch->filtered += iir_alpha(dt_ms, ch->config.tau_ms) * (median - ch->filtered);
+
+    float instant_rate = (ch->filtered - previous) * 1000.0f / dt_ms;
+    ch->rate += iir_alpha(dt_ms, ch->config.rate_tau_ms) * (instant_rate - ch->rate);
+    ch->last_us = timestamp_us;
+
+    out->median = median;
+    out->value = ch->filtered;
+    out->rate = ch->rate;
+}
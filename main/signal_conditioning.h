@@ -0,0 +1,75 @@
+/**
+ * @file signal_conditioning.h
+ * @brief Per-channel streaming conditioning for the IR flame inputs
+ *
+ * Each sample passes through three stages: a median-of-N despiker, a
+ * first-order IIR low-pass and a rate-of-change estimator on the filtered
+ * value. The IIR coefficients are derived from the actual sample interval,
+ * so the same time constants hold for DMA sweeps and the slower oneshot
+ * fallback. All state lives in the caller's sigcond_channel_t and is sized
+ * at compile time - nothing is allocated.
+ */
+
+#ifndef SIGNAL_CONDITIONING_H
+#define SIGNAL_CONDITIONING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Conditioning Configuration
+#define SIGCOND_MEDIAN_MAX          7       // Largest supported median window (odd)
+#define SIGCOND_DEFAULT_MEDIAN      3       // Rejects single-sample spikes
+#define SIGCOND_DEFAULT_TAU_MS      250     // Level low-pass time constant
+#define SIGCOND_DEFAULT_RATE_TAU_MS 400     // Rate-of-change smoothing time constant
+#define SIGCOND_STALE_MS            5000    // Gap after which the channel re-primes
+
+// Per-channel tuning
+typedef struct {
+    uint8_t median_len;         // 1 (bypass) .. SIGCOND_MEDIAN_MAX, odd
+    uint16_t tau_ms;            // 0 bypasses the IIR
+    uint16_t rate_tau_ms;       // 0 leaves the derivative unsmoothed
+} sigcond_config_t;
+
+// Per-channel state
+typedef struct {
+    sigcond_config_t config;
+    float window[SIGCOND_MEDIAN_MAX];
+    uint8_t head;
+    bool primed;
+    float filtered;
+    float rate;
+    int64_t last_us;
+} sigcond_channel_t;
+
+// Conditioned output for one sample
+typedef struct {
+    float median;               // Despiked sample
+    float value;                // Low-passed level
+    float rate;                 // d(value)/dt in units per second
+} sigcond_output_t;
+
+/**
+ * @brief Initialize a channel
+ * @param ch Channel state
+ * @param config Tuning, or NULL for the defaults
+ */
+void sigcond_init(sigcond_channel_t *ch, const sigcond_config_t *config);
+
+/**
+ * @brief Push one sample through the pipeline
+ * @param ch Channel state
+ * @param sample Raw input
+ * @param timestamp_us Capture time in microseconds (monotonic)
+ * @param out Conditioned result
+ */
+void sigcond_update(sigcond_channel_t *ch, float sample, int64_t timestamp_us, sigcond_output_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIGNAL_CONDITIONING_H
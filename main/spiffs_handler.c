@@ -10,9 +10,24 @@
 #include <string.h>
 #include <sys/stat.h>
 #include "time_manager.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 static bool spiffs_initialized = false;
 
+// Several tasks store, remove and retry alerts; every read-change-write of
+// the alerts file holds this so one cannot overwrite another's change
+static SemaphoreHandle_t alerts_mutex = NULL;
+static StaticSemaphore_t alerts_mutex_buf;
+
+static void alerts_lock(void) {
+    xSemaphoreTake(alerts_mutex, portMAX_DELAY);
+}
+
+static void alerts_unlock(void) {
+    xSemaphoreGive(alerts_mutex);
+}
+
 // ========================================
 // HELPER FUNCTIONS
 // ========================================
@@ -52,6 +67,10 @@ esp_err_t spiffs_init(void)
 
     printf("\nInitializing SPIFFS...\n");
 
+    if (alerts_mutex == NULL) {
+        alerts_mutex = xSemaphoreCreateMutexStatic(&alerts_mutex_buf);
+    }
+
     esp_vfs_spiffs_conf_t conf = {
         .base_path = "/spiffs",
         .partition_label = NULL,
@@ -647,6 +666,62 @@ esp_err_t spiffs_clean_wifi_credentials(void)
  * @brief Store an alert in SPIFFS for later transmission
  */
 esp_err_t spiffs_store_alert(const char* topic, const char* payload)
+{
+    return spiffs_store_alert_seq(topic, payload, 0);
+}
+
+static uint32_t alert_field_u32(const cJSON *alert, const char *name)
+{
+    cJSON *obj = cJSON_GetObjectItem(alert, name);
+    return cJSON_IsNumber(obj) ? (uint32_t)obj->valuedouble : 0;
+}
+
+// Storage ids identify entries for removal and retry; array indices shift
+// whenever another task changes the file
+static uint32_t max_alert_id(const cJSON *alerts_array)
+{
+    uint32_t max_id = 0;
+    const cJSON *alert;
+    cJSON_ArrayForEach(alert, alerts_array) {
+        uint32_t id = alert_field_u32(alert, "id");
+        if (id > max_id) {
+            max_id = id;
+        }
+    }
+    return max_id;
+}
+
+static esp_err_t write_alerts_locked(const cJSON *alerts_array)
+{
+    char *json_str = cJSON_PrintUnformatted(alerts_array);
+    if (!json_str) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    FILE *file = fopen(SPIFFS_ALERTS_PATH, "w");
+    if (file == NULL) {
+        free(json_str);
+        printf("Failed to open alerts file for writing\n");
+        return ESP_FAIL;
+    }
+
+    size_t json_len = strlen(json_str);
+    size_t written = fwrite(json_str, 1, json_len, file);
+    fclose(file);
+    free(json_str);
+
+    if (written != json_len) {
+        printf("Failed to write complete alerts file (wrote %d of %d bytes)\n",
+               (int)written, (int)json_len);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Store an alert with its delivery sequence number
+ */
+static esp_err_t store_alert_locked(const char* topic, const char* payload, uint32_t seq)
 {
     if (!spiffs_initialized) {
         printf("SPIFFS not initialized\n");
@@ -722,7 +797,11 @@ esp_err_t spiffs_store_alert(const char* topic, const char* payload)
     // Add alert data
     cJSON_AddStringToObject(new_alert, "topic", topic);
     cJSON_AddStringToObject(new_alert, "payload", payload);
+    cJSON_AddNumberToObject(new_alert, "id", max_alert_id(alerts_array) + 1);
     cJSON_AddNumberToObject(new_alert, "retry_count", 0);
+    if (seq != 0) {
+        cJSON_AddNumberToObject(new_alert, "seq", seq);
+    }
     
     // Add timestamps
     char timestamp[32];
@@ -774,7 +853,7 @@ esp_err_t spiffs_store_alert(const char* topic, const char* payload)
 /**
  * @brief Read all pending alerts from SPIFFS
  */
-cJSON* spiffs_read_pending_alerts(void)
+static cJSON *read_alerts_locked(void)
 {
     if (!spiffs_initialized) {
         printf("SPIFFS not initialized\n");
@@ -806,6 +885,20 @@ cJSON* spiffs_read_pending_alerts(void)
         return cJSON_CreateArray();
     }
 
+    // Entries written before storage ids existed get one now
+    uint32_t next_id = max_alert_id(alerts_array) + 1;
+    bool assigned = false;
+    cJSON *alert;
+    cJSON_ArrayForEach(alert, alerts_array) {
+        if (alert_field_u32(alert, "id") == 0) {
+            cJSON_AddNumberToObject(alert, "id", next_id++);
+            assigned = true;
+        }
+    }
+    if (assigned) {
+        write_alerts_locked(alerts_array);
+    }
+
     int alert_count = cJSON_GetArraySize(alerts_array);
     printf("Read %d pending alerts from storage at %s\n", 
            alert_count, get_custom_timestamp());
@@ -816,14 +909,14 @@ cJSON* spiffs_read_pending_alerts(void)
 /**
  * @brief Increment retry count for an alert
  */
-esp_err_t spiffs_increment_alert_retry(int alert_index)
+static esp_err_t increment_alert_retry_locked(int alert_index)
 {
     if (!spiffs_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
     // Read all alerts
-    cJSON *alerts_array = spiffs_read_pending_alerts();
+    cJSON *alerts_array = read_alerts_locked();
     if (!alerts_array || !cJSON_IsArray(alerts_array)) {
         if (alerts_array) cJSON_Delete(alerts_array);
         return ESP_FAIL;
@@ -893,7 +986,7 @@ esp_err_t spiffs_increment_alert_retry(int alert_index)
 /**
  * @brief Remove sent alerts from storage
  */
-esp_err_t spiffs_remove_sent_alerts(cJSON *sent_indices, int count)
+static esp_err_t remove_sent_alerts_locked(cJSON *sent_indices, int count)
 {
     if (!spiffs_initialized) {
         printf("SPIFFS not initialized\n");
@@ -908,7 +1001,7 @@ esp_err_t spiffs_remove_sent_alerts(cJSON *sent_indices, int count)
     printf("Removing %d sent alerts from storage...\n", count);
 
     // Read all alerts
-    cJSON *all_alerts = spiffs_read_pending_alerts();
+    cJSON *all_alerts = read_alerts_locked();
     if (!all_alerts || !cJSON_IsArray(all_alerts)) {
         printf("Failed to read alerts for removal\n");
         if (all_alerts) cJSON_Delete(all_alerts);
@@ -1010,6 +1103,176 @@ esp_err_t spiffs_remove_sent_alerts(cJSON *sent_indices, int count)
     return ESP_OK;
 }
 
+/**
+ * @brief Remove alerts whose `key` field is one of values
+ */
+static esp_err_t remove_alerts_locked(const char *key, const uint32_t *values, int count, uint32_t *lowest_seq)
+{
+    *lowest_seq = 0;
+    cJSON *alerts_array = read_alerts_locked();
+    if (!alerts_array || !cJSON_IsArray(alerts_array)) {
+        if (alerts_array) cJSON_Delete(alerts_array);
+        return ESP_FAIL;
+    }
+
+    // Drop the matches and find the lowest sequence left
+    int removed = 0;
+    cJSON *alert = alerts_array->child;
+    while (alert) {
+        cJSON *next = alert->next;
+        uint32_t value = alert_field_u32(alert, key);
+        uint32_t alert_seq = alert_field_u32(alert, "seq");
+        bool match = false;
+        for (int i = 0; value != 0 && i < count; i++) {
+            match = match || values[i] == value;
+        }
+        if (match) {
+            cJSON_DetachItemViaPointer(alerts_array, alert);
+            cJSON_Delete(alert);
+            removed++;
+        } else if (alert_seq != 0 && (*lowest_seq == 0 || alert_seq < *lowest_seq)) {
+            *lowest_seq = alert_seq;
+        }
+        alert = next;
+    }
+
+    esp_err_t ret = removed > 0 ? write_alerts_locked(alerts_array) : ESP_OK;
+    cJSON_Delete(alerts_array);
+    if (ret == ESP_OK && removed > 0) {
+        printf("Removed %d alerts from storage at %s\n", removed, get_custom_timestamp());
+    }
+    return ret;
+}
+
+static esp_err_t increment_alert_retries_locked(const char *key, const uint32_t *values, int count)
+{
+    cJSON *alerts_array = read_alerts_locked();
+    if (!alerts_array || !cJSON_IsArray(alerts_array)) {
+        if (alerts_array) cJSON_Delete(alerts_array);
+        return ESP_FAIL;
+    }
+
+    int updated = 0;
+    cJSON *alert;
+    cJSON_ArrayForEach(alert, alerts_array) {
+        uint32_t value = alert_field_u32(alert, key);
+        bool match = false;
+        for (int i = 0; value != 0 && i < count; i++) {
+            match = match || values[i] == value;
+        }
+        if (!match) {
+            continue;
+        }
+        int retry_count = (int)alert_field_u32(alert, "retry_count");
+        cJSON_DeleteItemFromObject(alert, "retry_count");
+        cJSON_AddNumberToObject(alert, "retry_count", retry_count + 1);
+        cJSON_DeleteItemFromObject(alert, "last_retry");
+        cJSON_AddStringToObject(alert, "last_retry", get_custom_timestamp());
+        updated++;
+    }
+
+    esp_err_t ret = updated > 0 ? write_alerts_locked(alerts_array) : ESP_ERR_NOT_FOUND;
+    cJSON_Delete(alerts_array);
+    return ret;
+}
+
+// ========================================
+// LOCKED ENTRY POINTS
+// ========================================
+
+esp_err_t spiffs_store_alert_seq(const char* topic, const char* payload, uint32_t seq)
+{
+    if (!spiffs_initialized) {
+        printf("SPIFFS not initialized\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+    alerts_lock();
+    esp_err_t ret = store_alert_locked(topic, payload, seq);
+    alerts_unlock();
+    return ret;
+}
+
+cJSON* spiffs_read_pending_alerts(void)
+{
+    if (!spiffs_initialized) {
+        printf("SPIFFS not initialized\n");
+        return cJSON_CreateArray();
+    }
+    alerts_lock();
+    cJSON *alerts_array = read_alerts_locked();
+    alerts_unlock();
+    return alerts_array;
+}
+
+esp_err_t spiffs_increment_alert_retry(int alert_index)
+{
+    if (!spiffs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    alerts_lock();
+    esp_err_t ret = increment_alert_retry_locked(alert_index);
+    alerts_unlock();
+    return ret;
+}
+
+esp_err_t spiffs_increment_alert_retry_id(uint32_t id)
+{
+    if (!spiffs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    alerts_lock();
+    esp_err_t ret = increment_alert_retries_locked("id", &id, 1);
+    alerts_unlock();
+    return ret;
+}
+
+esp_err_t spiffs_increment_alert_retry_seqs(const uint32_t *seqs, int count)
+{
+    if (!spiffs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    alerts_lock();
+    esp_err_t ret = increment_alert_retries_locked("seq", seqs, count);
+    alerts_unlock();
+    return ret;
+}
+
+esp_err_t spiffs_remove_sent_alerts(cJSON *sent_indices, int count)
+{
+    if (!spiffs_initialized) {
+        printf("SPIFFS not initialized\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+    alerts_lock();
+    esp_err_t ret = remove_sent_alerts_locked(sent_indices, count);
+    alerts_unlock();
+    return ret;
+}
+
+esp_err_t spiffs_remove_alert_seqs(const uint32_t *seqs, int count, uint32_t *lowest_seq)
+{
+    *lowest_seq = 0;
+    if (!spiffs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    alerts_lock();
+    esp_err_t ret = remove_alerts_locked("seq", seqs, count, lowest_seq);
+    alerts_unlock();
+    return ret;
+}
+
+esp_err_t spiffs_remove_alert_ids(const uint32_t *ids, int count, uint32_t *lowest_seq)
+{
+    *lowest_seq = 0;
+    if (!spiffs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    alerts_lock();
+    esp_err_t ret = remove_alerts_locked("id", ids, count, lowest_seq);
+    alerts_unlock();
+    return ret;
+}
+
 /**
  * @brief Clear all pending alerts from storage
  */
@@ -1023,7 +1286,9 @@ esp_err_t spiffs_clear_all_alerts(void)
     printf("Clearing all pending alerts at %s...\n", get_custom_timestamp());
     
     // Simply delete the alerts file
+    alerts_lock();
     esp_err_t ret = spiffs_delete_file(SPIFFS_ALERTS_PATH);
+    alerts_unlock();
     if (ret == ESP_OK) {
         printf("All alerts cleared successfully\n");
     } else {
@@ -8,6 +8,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "cJSON.h"
 
@@ -20,7 +21,7 @@
 
 // Alert storage constants
 #define MAX_ALERTS_IN_STORAGE 50
-#define MAX_ALERT_SIZE 512
+#define MAX_ALERT_SIZE 1024                 // Matches MAX_JSON_PAYLOAD_SIZE so any alert that can be sent can be stored
 #define MAX_ALERT_RETRIES 3
 
 /**
@@ -162,6 +163,13 @@ esp_err_t spiffs_clean_wifi_credentials(void);
  */
 esp_err_t spiffs_store_alert(const char* topic, const char* payload);
 
+/**
+ * @brief Store an alert with its delivery sequence number
+ * @param seq Alert journal sequence, 0 for untracked messages
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t spiffs_store_alert_seq(const char* topic, const char* payload, uint32_t seq);
+
 /**
  * @brief Read all pending alerts from SPIFFS
  * @return cJSON* Array of pending alerts (must be freed with cJSON_Delete)
@@ -176,6 +184,24 @@ cJSON* spiffs_read_pending_alerts(void);
  */
 esp_err_t spiffs_remove_sent_alerts(cJSON *sent_indices, int count);
 
+/**
+ * @brief Remove alerts by sequence number
+ * @param seqs Sequences to remove (count 0 just reports lowest_seq)
+ * @param count Number of sequences
+ * @param lowest_seq Set to the lowest sequence still stored, 0 if none
+ * @return esp_err_t ESP_OK on success (also if none were stored), error code otherwise
+ */
+esp_err_t spiffs_remove_alert_seqs(const uint32_t *seqs, int count, uint32_t *lowest_seq);
+
+/**
+ * @brief Remove alerts by storage id (the "id" field of each entry)
+ * @param ids Storage ids to remove (count 0 just reports lowest_seq)
+ * @param count Number of ids
+ * @param lowest_seq Set to the lowest sequence still stored, 0 if none
+ * @return esp_err_t ESP_OK on success (also if none were stored), error code otherwise
+ */
+esp_err_t spiffs_remove_alert_ids(const uint32_t *ids, int count, uint32_t *lowest_seq);
+
 /**
  * @brief Clear all pending alerts from storage
  * @return esp_err_t ESP_OK on success, error code otherwise
@@ -220,5 +246,20 @@ void spiffs_print_alert_summary(void);
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
 esp_err_t spiffs_increment_alert_retry(int alert_index);
+
+/**
+ * @brief Increment retry count for the alert with a storage id
+ * @param id Storage id of the alert
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if it is no longer stored
+ */
+esp_err_t spiffs_increment_alert_retry_id(uint32_t id);
+
+/**
+ * @brief Increment retry count for the alerts with the given sequences
+ * @param seqs Alert sequences
+ * @param count Number of sequences
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if none is still stored
+ */
+esp_err_t spiffs_increment_alert_retry_seqs(const uint32_t *seqs, int count);
 const char* get_custom_timestamp(void);
 #endif /* SPIFFS_HANDLER_H */
\ No newline at end of file
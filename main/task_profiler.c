@@ -0,0 +1,122 @@
+/**
+ * @file task_profiler.c
+ * @brief Stack high-water marks, stack size recommendations and CPU share per task
+ */
+
+#include "task_profiler.h"
+#include <stdio.h>
+#include <string.h>
+
+static task_profile_t *find_or_add(task_profiler_t *p, const char *name)
+{
+    for (int i = 0; i < p->count; i++) {
+        if (strncmp(p->tasks[i].name, name, TASK_PROFILER_NAME_LEN - 1) == 0) {
+            return &p->tasks[i];
+        }
+    }
+    if (p->count >= TASK_PROFILER_MAX_TASKS) {
+        return NULL;
+    }
+    task_profile_t *t = &p->tasks[p->count++];
+    memset(t, 0, sizeof(*t));
+    strncpy(t->name, name, TASK_PROFILER_NAME_LEN - 1);
+    return t;
+}
+
+void task_profiler_init(task_profiler_t *p)
+{
+    memset(p, 0, sizeof(*p));
+}
+
+void task_profiler_register(task_profiler_t *p, const char *name, uint32_t stack_size)
+{
+    task_profile_t *t = find_or_add(p, name);
+    if (t) {
+        t->stack_size = stack_size;
+    }
+}
+
+void task_profiler_sample(task_profiler_t *p, const char *name, uint32_t run_counter, uint32_t stack_free)
+{
+    task_profile_t *t = find_or_add(p, name);
+    if (!t) {
+        return;
+    }
+
+    if (!t->sampled || stack_free < t->stack_free_min) {
+        t->stack_free_min = stack_free;
+    }
+    if (t->sampled) {
+        t->run_window += run_counter - t->run_prev;     // Unsigned: survives wrap
+    }
+    t->run_prev = run_counter;
+    t->sampled = true;
+}
+
+void task_profiler_end_window(task_profiler_t *p)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < p->count; i++) {
+        total += p->tasks[i].run_window;
+    }
+
+    for (int i = 0; i < p->count; i++) {
+        task_profile_t *t = &p->tasks[i];
+        t->cpu_permille = total ? (uint16_t)((uint64_t)t->run_window * 1000 / total) : 0;
+        if (t->cpu_permille > t->cpu_peak_permille) {
+            t->cpu_peak_permille = t->cpu_permille;
+        }
+        t->run_window = 0;
+    }
+    p->windows++;
+}
+
+uint32_t task_profiler_recommend(const task_profile_t *t)
+{
+    if (t->stack_size == 0 || !t->sampled || t->stack_free_min > t->stack_size) {
+        return t->stack_size;
+    }
+
+    uint32_t used = t->stack_size - t->stack_free_min;
+    uint32_t margin = used * TASK_PROFILER_MARGIN_PCT / 100;
+    if (margin < TASK_PROFILER_MIN_MARGIN) {
+        margin = TASK_PROFILER_MIN_MARGIN;
+    }
+    uint32_t rec = used + margin;
+    return (rec + TASK_PROFILER_STACK_ROUND - 1) / TASK_PROFILER_STACK_ROUND * TASK_PROFILER_STACK_ROUND;
+}
+
+uint32_t task_profiler_reclaimable(const task_profiler_t *p)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < p->count; i++) {
+        uint32_t rec = task_profiler_recommend(&p->tasks[i]);
+        if (rec < p->tasks[i].stack_size) {
+            total += p->tasks[i].stack_size - rec;
+        }
+    }
+    return total;
+}
+
+void task_profiler_print(const task_profiler_t *p)
+{
+    printf("\n[PROFILE] Task stacks (bytes) and CPU share\n");
+    printf("  %-16s %6s %7s %6s %6s %6s\n", "task", "stack", "minFree", "recom", "cpu%", "peak%");
+
+    for (int i = 0; i < p->count; i++) {
+        const task_profile_t *t = &p->tasks[i];
+        if (t->stack_size) {
+            printf("  %-16s %6lu %7lu %6lu %6.1f %6.1f\n", t->name,
+                   (unsigned long)t->stack_size,
+                   (unsigned long)t->stack_free_min,
+                   (unsigned long)task_profiler_recommend(t),
+                   t->cpu_permille / 10.0, t->cpu_peak_permille / 10.0);
+        } else {
+            printf("  %-16s %6s %7lu %6s %6.1f %6.1f\n", t->name, "-",
+                   (unsigned long)t->stack_free_min, "-",
+                   t->cpu_permille / 10.0, t->cpu_peak_permille / 10.0);
+        }
+    }
+    printf("  Reclaimable by applying recommendations: %lu bytes\n",
+           (unsigned long)task_profiler_reclaimable(p));
+}
@@ -0,0 +1,100 @@
+/**
+ * @file task_profiler.h
+ * @brief Stack high-water marks, stack size recommendations and CPU share per task
+ *
+ * The serial monitor task snapshots every task (uxTaskGetSystemState) once
+ * per window and feeds the figures here. Stack use is tracked as the lowest
+ * free stack seen. For tasks created with a size from config.h this gives a
+ * recommended size with a safety margin. CPU share is the task's share of
+ * the run time all tasks accumulated during the window. On a dual core part
+ * a task that keeps one core busy shows as 50%.
+ *
+ * Tasks are keyed by name (copied). A task that disappears keeps its stack
+ * figures and shows 0% CPU. The profiler has a single writer; readers copy
+ * it and may see one window partly applied.
+ */
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Profiler Configuration
+#define TASK_PROFILER_MAX_TASKS         24      // Application plus ESP-IDF system tasks
+#define TASK_PROFILER_NAME_LEN          16      // CONFIG_FREERTOS_MAX_TASK_NAME_LEN
+#define TASK_PROFILER_MARGIN_PCT        25      // Recommended stack = used + 25%...
+#define TASK_PROFILER_MIN_MARGIN        1024    // ...but at least 1 KB of headroom
+#define TASK_PROFILER_STACK_ROUND       512     // Recommendations are rounded up to this
+
+typedef struct {
+    char name[TASK_PROFILER_NAME_LEN];
+    uint32_t stack_size;        // Configured bytes, 0 if not registered
+    uint32_t stack_free_min;    // Lowest free stack seen, bytes
+    bool sampled;
+    uint32_t run_prev;          // Run time counter at the last sample
+    uint32_t run_window;        // Run time accumulated in the current window
+    uint16_t cpu_permille;      // Share of the last complete window
+    uint16_t cpu_peak_permille;
+} task_profile_t;
+
+typedef struct {
+    task_profile_t tasks[TASK_PROFILER_MAX_TASKS];
+    int count;
+    uint32_t windows;
+} task_profiler_t;
+
+/**
+ * @brief Clear the profiler
+ */
+void task_profiler_init(task_profiler_t *p);
+
+/**
+ * @brief Record the configured stack size of an application task
+ */
+void task_profiler_register(task_profiler_t *p, const char *name, uint32_t stack_size);
+
+/**
+ * @brief Feed one task's figures for the current window
+ * @param p Profiler
+ * @param name Task name
+ * @param run_counter FreeRTOS run time counter (may wrap)
+ * @param stack_free Current stack high-water mark in bytes
+ */
+void task_profiler_sample(task_profiler_t *p, const char *name, uint32_t run_counter, uint32_t stack_free);
+
+/**
+ * @brief Close the window: compute CPU shares and start the next window
+ *
+ * The first sample of a task only sets its baseline, so the first window
+ * after boot reports 0% for every task.
+ */
+void task_profiler_end_window(task_profiler_t *p);
+
+/**
+ * @brief Recommended stack size for a task
+ * @return Used stack plus margin, rounded up; stack_size if not sampled or
+ *         not registered
+ */
+uint32_t task_profiler_recommend(const task_profile_t *t);
+
+/**
+ * @brief Bytes that could be reclaimed by applying every recommendation
+ *        that is smaller than the configured size
+ */
+uint32_t task_profiler_reclaimable(const task_profiler_t *p);
+
+/**
+ * @brief Print a summary table to the serial console
+ */
+void task_profiler_print(const task_profiler_t *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_PROFILER_H
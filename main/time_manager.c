@@ -542,15 +542,18 @@ static void time_sync_task(void *arg)
 static bool network_connected = false;
 static time_network_status_t current_network_type = TIME_NET_NONE;
 static SemaphoreHandle_t network_mutex = NULL;
+static StaticSemaphore_t network_mutex_buf;
 
 // Time sync state
 static bool time_synced = false;
 static SemaphoreHandle_t time_mutex = NULL;
+static StaticSemaphore_t time_mutex_buf;
 static TaskHandle_t sync_task_handle = NULL;
 static bool sync_task_created = false;
 
 // Event group for sync status
 static EventGroupHandle_t time_event_group = NULL;
+static StaticEventGroup_t time_event_group_buf;
 #define TIME_EVENT_SYNC_STARTED  BIT0
 #define TIME_EVENT_SYNC_COMPLETE BIT1
 #define TIME_EVENT_SYNC_FAILED   BIT2
@@ -609,7 +612,7 @@ esp_err_t time_manager_init(void)
 
     // Create mutexes
     if (time_mutex == NULL) {
-        time_mutex = xSemaphoreCreateMutex();
+        time_mutex = xSemaphoreCreateMutexStatic(&time_mutex_buf);
         if (time_mutex == NULL) {
             printf("\n Failed to create time mutex");
             return ESP_FAIL;
@@ -617,7 +620,7 @@ esp_err_t time_manager_init(void)
     }
 
     if (network_mutex == NULL) {
-        network_mutex = xSemaphoreCreateMutex();
+        network_mutex = xSemaphoreCreateMutexStatic(&network_mutex_buf);
         if (network_mutex == NULL) {
             printf("\n Failed to create network mutex");
             return ESP_FAIL;
@@ -625,7 +628,7 @@ esp_err_t time_manager_init(void)
     }
 
     if (time_event_group == NULL) {
-        time_event_group = xEventGroupCreate();
+        time_event_group = xEventGroupCreateStatic(&time_event_group_buf);
         if (time_event_group == NULL) {
             printf("\n Failed to create time event group");
             return ESP_FAIL;
@@ -704,7 +707,7 @@ esp_err_t time_manager_get_timestamp(char *timestamp_out, size_t max_len)
     }
 
     if (time_mutex == NULL) {
-        time_mutex = xSemaphoreCreateMutex();
+        time_mutex = xSemaphoreCreateMutexStatic(&time_mutex_buf);
         if (time_mutex == NULL) {
             snprintf(timestamp_out, max_len, "D:00-00-0000&T:00:00:00Z");
             return ESP_FAIL;
@@ -834,7 +837,7 @@ esp_err_t time_manager_get_epoch(time_t *epoch_out)
 esp_err_t time_manager_ensure_initialized(void)
 {
     if (time_mutex == NULL) {
-        time_mutex = xSemaphoreCreateMutex();
+        time_mutex = xSemaphoreCreateMutexStatic(&time_mutex_buf);
         if (time_mutex == NULL) {
             return ESP_FAIL;
         }
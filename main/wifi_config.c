@@ -10,6 +10,7 @@
 // ========================================
 static unsigned long lastReconnectAttempt = 0;
 static EventGroupHandle_t wifi_event_group;
+static StaticEventGroup_t wifi_event_group_buf;
 static int s_retry_num = 0;
 static bool wifi_connected = false;
 
@@ -501,7 +502,7 @@ void init_wifi(void) {
     }
 
     // Create event group
-    wifi_event_group = xEventGroupCreate();
+    wifi_event_group = xEventGroupCreateStatic(&wifi_event_group_buf);
     if (wifi_event_group == NULL) {
         printf("[WIFI] Failed to create event group\n");
         return;
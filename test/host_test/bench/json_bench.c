@@ -0,0 +1,346 @@
+/**
+ * @file json_bench.c
+ * @brief Compare json_writer against cJSON on firmware-shaped messages
+ *
+ * Builds an alert, a heartbeat, a periodic status update and a shadow
+ * report both ways, checks the bytes match, then reports encode time and
+ * heap calls per message. Exits non-zero on any mismatch.
+ *
+ * Usage: json_bench [-n iterations]
+ */
+
+#include "cJSON.h"
+#include "json_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PAYLOAD_SIZE    1025    // MAX_JSON_PAYLOAD_SIZE plus the NUL
+
+static const char *kMac = "24:0A:C4:12:34:56";
+static const char *kTimestamp = "D:16-10-2026&T:12:00:00Z";
+static const char *kPumpNames[4] = { "North", "South", "East", "West" };
+static const char *kPumpObjects[4] = { "NorthPump", "SouthPump", "EastPump", "WestPump" };
+
+// ========================================
+// ALLOCATION COUNTING
+// ========================================
+
+static unsigned long allocs;
+
+static void *counting_malloc(size_t size)
+{
+    allocs++;
+    return malloc(size);
+}
+
+static void counting_free(void *ptr)
+{
+    free(ptr);
+}
+
+// ========================================
+// MESSAGES
+// ========================================
+
+typedef struct {
+    const char *name;
+    char *(*with_cjson)(void);
+    size_t (*with_writer)(char *buf, size_t size);
+} message_t;
+
+static char *alert_cjson(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "macAddress", kMac);
+    cJSON_AddStringToObject(root, "event", "alert");
+    cJSON_AddStringToObject(root, "devicetype", "G");
+    cJSON_AddStringToObject(root, "timestamp", kTimestamp);
+    cJSON *payload = cJSON_CreateObject();
+    cJSON_AddStringToObject(payload, "alertType", "EMERGENCY_STOP");
+    cJSON_AddStringToObject(payload, "severity", "CRITICAL");
+    cJSON_AddStringToObject(payload, "message", "Emergency stop \"ACTIVATED\" - all pumps stopped");
+    cJSON_AddStringToObject(payload, "action", "ACTIVATED");
+    cJSON_AddBoolToObject(payload, "allPumpsStopped", 1);
+    cJSON *pumps = cJSON_CreateArray();
+    for (int i = 0; i < 4; i++) {
+        cJSON *pump = cJSON_CreateObject();
+        cJSON_AddNumberToObject(pump, "pumpId", i + 1);
+        cJSON_AddStringToObject(pump, "pumpName", kPumpNames[i]);
+        cJSON_AddStringToObject(pump, "previousState", i % 2 ? "AUTO_ACTIVE" : "OFF");
+        cJSON_AddItemToArray(pumps, pump);
+    }
+    cJSON_AddItemToObject(payload, "affectedPumps", pumps);
+    cJSON_AddItemToObject(root, "payload", payload);
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return out;
+}
+
+static size_t alert_writer(char *buf, size_t size)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    json_writer_begin_object(&w, NULL);
+    json_writer_string(&w, "macAddress", kMac);
+    json_writer_string(&w, "event", "alert");
+    json_writer_string(&w, "devicetype", "G");
+    json_writer_string(&w, "timestamp", kTimestamp);
+    json_writer_begin_object(&w, "payload");
+    json_writer_string(&w, "alertType", "EMERGENCY_STOP");
+    json_writer_string(&w, "severity", "CRITICAL");
+    json_writer_string(&w, "message", "Emergency stop \"ACTIVATED\" - all pumps stopped");
+    json_writer_string(&w, "action", "ACTIVATED");
+    json_writer_bool(&w, "allPumpsStopped", true);
+    json_writer_begin_array(&w, "affectedPumps");
+    for (int i = 0; i < 4; i++) {
+        json_writer_begin_object(&w, NULL);
+        json_writer_number(&w, "pumpId", i + 1);
+        json_writer_string(&w, "pumpName", kPumpNames[i]);
+        json_writer_string(&w, "previousState", i % 2 ? "AUTO_ACTIVE" : "OFF");
+        json_writer_end_object(&w);
+    }
+    json_writer_end_array(&w);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
+}
+
+static char *heartbeat_cjson(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "macAddress", kMac);
+    cJSON_AddStringToObject(root, "event", "heartbeat");
+    cJSON_AddStringToObject(root, "devicetype", "G");
+    cJSON_AddStringToObject(root, "timestamp", kTimestamp);
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return out;
+}
+
+static size_t heartbeat_writer(char *buf, size_t size)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    json_writer_begin_object(&w, NULL);
+    json_writer_string(&w, "macAddress", kMac);
+    json_writer_string(&w, "event", "heartbeat");
+    json_writer_string(&w, "devicetype", "G");
+    json_writer_string(&w, "timestamp", kTimestamp);
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
+}
+
+static const float kIr[4] = { 1.2345f, 0.5f, 2.71828f, 0.0f };
+static const float kCurrent[4] = { 3.3f, 0.0f, 4.75f, 0.12f };
+
+static char *status_cjson(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "macAddress", kMac);
+    cJSON_AddStringToObject(root, "event", "periodicupdate");
+    cJSON_AddStringToObject(root, "devicetype", "G");
+    cJSON_AddStringToObject(root, "timestamp", kTimestamp);
+    cJSON *payload = cJSON_CreateObject();
+    cJSON_AddItemToObject(root, "payload", payload);
+    cJSON_AddStringToObject(payload, "wifissid", "FarmNetwork");
+    cJSON_AddStringToObject(payload, "password", "p@ss\\word");
+    cJSON_AddBoolToObject(payload, "waterLockout", 0);
+    cJSON_AddBoolToObject(payload, "doorOpen", 0);
+    cJSON_AddNumberToObject(payload, "currentProfile", 1);
+    cJSON_AddStringToObject(payload, "profileName", "Wildland Standard");
+    cJSON_AddNumberToObject(payload, "waterLevel", 73.46);
+    cJSON_AddNumberToObject(payload, "batteryVoltage", 12.81);
+    cJSON_AddNumberToObject(payload, "solarVoltage", 18.2);
+    cJSON_AddBoolToObject(payload, "emergencyStopActive", 0);
+    cJSON_AddBoolToObject(payload, "suppressionActive", 1);
+    for (int i = 0; i < 4; i++) {
+        cJSON *pump = cJSON_CreateObject();
+        cJSON_AddNumberToObject(pump, "IRValue", kIr[i]);
+        cJSON_AddNumberToObject(pump, "currentDraw", kCurrent[i]);
+        cJSON_AddStringToObject(pump, "PumpState", i == 2 ? "AUTO_ACTIVE" : "OFF");
+        cJSON_AddBoolToObject(pump, "currentSensorFault", 0);
+        cJSON_AddBoolToObject(pump, "PumpRunning", i == 2);
+        cJSON_AddItemToObject(payload, kPumpObjects[i], pump);
+    }
+    cJSON *latency = cJSON_CreateObject();
+    cJSON *stage = cJSON_CreateObject();
+    cJSON_AddNumberToObject(stage, "n", 12);
+    cJSON_AddNumberToObject(stage, "p50Ms", 40);
+    cJSON_AddNumberToObject(stage, "p95Ms", 110);
+    cJSON_AddNumberToObject(stage, "maxMs", 131);
+    cJSON_AddItemToObject(latency, "sampleToPump", stage);
+    cJSON_AddItemToObject(payload, "latency", latency);
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return out;
+}
+
+static size_t status_writer(char *buf, size_t size)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    json_writer_begin_object(&w, NULL);
+    json_writer_string(&w, "macAddress", kMac);
+    json_writer_string(&w, "event", "periodicupdate");
+    json_writer_string(&w, "devicetype", "G");
+    json_writer_string(&w, "timestamp", kTimestamp);
+    json_writer_begin_object(&w, "payload");
+    json_writer_string(&w, "wifissid", "FarmNetwork");
+    json_writer_string(&w, "password", "p@ss\\word");
+    json_writer_bool(&w, "waterLockout", false);
+    json_writer_bool(&w, "doorOpen", false);
+    json_writer_number(&w, "currentProfile", 1);
+    json_writer_string(&w, "profileName", "Wildland Standard");
+    json_writer_number(&w, "waterLevel", 73.46);
+    json_writer_number(&w, "batteryVoltage", 12.81);
+    json_writer_number(&w, "solarVoltage", 18.2);
+    json_writer_bool(&w, "emergencyStopActive", false);
+    json_writer_bool(&w, "suppressionActive", true);
+    for (int i = 0; i < 4; i++) {
+        json_writer_begin_object(&w, kPumpObjects[i]);
+        json_writer_number(&w, "IRValue", kIr[i]);
+        json_writer_number(&w, "currentDraw", kCurrent[i]);
+        json_writer_string(&w, "PumpState", i == 2 ? "AUTO_ACTIVE" : "OFF");
+        json_writer_bool(&w, "currentSensorFault", false);
+        json_writer_bool(&w, "PumpRunning", i == 2);
+        json_writer_end_object(&w);
+    }
+    json_writer_begin_object(&w, "latency");
+    json_writer_begin_object(&w, "sampleToPump");
+    json_writer_number(&w, "n", 12);
+    json_writer_number(&w, "p50Ms", 40);
+    json_writer_number(&w, "p95Ms", 110);
+    json_writer_number(&w, "maxMs", 131);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
+}
+
+static char *shadow_cjson(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON *state = cJSON_AddObjectToObject(root, "state");
+    cJSON *reported = cJSON_AddObjectToObject(state, "reported");
+    cJSON_AddNumberToObject(reported, "currentProfile", 3);
+    cJSON_AddBoolToObject(reported, "emergencyStop", 0);
+    cJSON_AddBoolToObject(reported, "systemReset", 0);
+    cJSON_AddBoolToObject(reported, "startAllPumps", 0);
+    cJSON_AddStringToObject(reported, "wifissid", "FarmNetwork");
+    cJSON_AddStringToObject(reported, "password", "p@ss\\word");
+    for (int i = 0; i < 4; i++) {
+        cJSON *pump = cJSON_CreateObject();
+        cJSON_AddBoolToObject(pump, "manualMode", i == 1);
+        cJSON_AddNumberToObject(pump, "extendTime", i * 30);
+        cJSON_AddBoolToObject(pump, "stopPump", 0);
+        cJSON_AddItemToObject(reported, kPumpObjects[i], pump);
+    }
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return out;
+}
+
+static size_t shadow_writer(char *buf, size_t size)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    json_writer_begin_object(&w, NULL);
+    json_writer_begin_object(&w, "state");
+    json_writer_begin_object(&w, "reported");
+    json_writer_number(&w, "currentProfile", 3);
+    json_writer_bool(&w, "emergencyStop", false);
+    json_writer_bool(&w, "systemReset", false);
+    json_writer_bool(&w, "startAllPumps", false);
+    json_writer_string(&w, "wifissid", "FarmNetwork");
+    json_writer_string(&w, "password", "p@ss\\word");
+    for (int i = 0; i < 4; i++) {
+        json_writer_begin_object(&w, kPumpObjects[i]);
+        json_writer_bool(&w, "manualMode", i == 1);
+        json_writer_number(&w, "extendTime", i * 30);
+        json_writer_bool(&w, "stopPump", false);
+        json_writer_end_object(&w);
+    }
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
+}
+
+static const message_t kMessages[] = {
+    { "alert", alert_cjson, alert_writer },
+    { "heartbeat", heartbeat_cjson, heartbeat_writer },
+    { "status", status_cjson, status_writer },
+    { "shadow", shadow_cjson, shadow_writer },
+};
+
+// ========================================
+// MAIN
+// ========================================
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 20000;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:")) != -1) {
+        if (opt == 'n' && atoi(optarg) > 0) {
+            iterations = atoi(optarg);
+        } else {
+            fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    cJSON_Hooks hooks = { counting_malloc, counting_free };
+    cJSON_InitHooks(&hooks);
+
+    static char buf[PAYLOAD_SIZE];
+    int failures = 0;
+
+    printf("%-10s %6s %12s %12s %10s\n", "message", "bytes", "cjson us", "writer us", "mallocs");
+    for (size_t m = 0; m < sizeof(kMessages) / sizeof(kMessages[0]); m++) {
+        const message_t *msg = &kMessages[m];
+
+        char *expected = msg->with_cjson();
+        size_t len = msg->with_writer(buf, sizeof(buf));
+        if (expected == NULL || len != strlen(expected) || memcmp(buf, expected, len) != 0) {
+            printf("MISMATCH %s\n  cjson:  %s\n  writer: %s\n", msg->name,
+                   expected ? expected : "(null)", buf);
+            failures++;
+        }
+        free(expected);
+
+        allocs = 0;
+        double start = now_us();
+        for (int i = 0; i < iterations; i++) {
+            free(msg->with_cjson());
+        }
+        double cjson_us = (now_us() - start) / iterations;
+        double mallocs = (double)allocs / iterations;
+
+        start = now_us();
+        for (int i = 0; i < iterations; i++) {
+            msg->with_writer(buf, sizeof(buf));
+        }
+        double writer_us = (now_us() - start) / iterations;
+
+        printf("%-10s %6zu %12.3f %12.3f %10.1f\n", msg->name, len, cjson_us, writer_us, mallocs);
+    }
+
+    if (failures) {
+        printf("%d message(s) differ from cJSON\n", failures);
+        return 1;
+    }
+    printf("All messages byte-identical; json_writer makes no heap calls\n");
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include "adc_calibration.h"
+
+// ESP32 line-fitting scheme: mV = ((coeff_a * raw + 32768) >> 16) + coeff_b
+struct LineFit {
+    uint32_t coeff_a;
+    uint32_t coeff_b;
+};
+
+static int line_fit_raw_to_mv(void *ctx, int raw, int *mv)
+{
+    auto *fit = static_cast<LineFit *>(ctx);
+    *mv = (int)(((fit->coeff_a * (uint32_t)raw + 32768) >> 16) + fit->coeff_b);
+    return 0;
+}
+
+static int failing_raw_to_mv(void *, int raw, int *mv)
+{
+    *mv = raw;
+    return raw > 2048 ? -1 : 0;
+}
+
+// The float chain get_sensor_data() used before the tables, in table units
+static double float_path(adc_cal_type_t type, int mv)
+{
+    float v = mv / 1000.0;
+    switch (type) {
+        case ADC_CAL_IR_CENTIPCT:
+            return (v / 3.3) * 100.0 * 100.0;
+        case ADC_CAL_WATER_CENTIPCT: {
+            float levelPercent = (v - 0.7) / (3.0 - 0.7) * 100.0;
+            levelPercent = levelPercent < 0.0 ? 0.0 : (levelPercent > 100.0 ? 100.0 : levelPercent);
+            return levelPercent * 100.0;
+        }
+        case ADC_CAL_PACK_MILLIVOLTS:
+            return ((v * 12.11f) + 0.3f) * 1000.0;
+        default:
+            return mv;
+    }
+}
+
+// One LSB of the float path's input - adc_cali_raw_to_voltage() returns
+// whole millivolts - expressed in each type's output unit
+static double one_lsb(adc_cal_type_t type)
+{
+    switch (type) {
+        case ADC_CAL_IR_CENTIPCT:     return 10000.0 / 3300.0;
+        case ADC_CAL_WATER_CENTIPCT:  return 10000.0 / 2300.0;
+        case ADC_CAL_PACK_MILLIVOLTS: return 12.11;
+        default:                      return 1.0;
+    }
+}
+
+TEST_CASE("Tables match the float path within one LSB", "[adc_calibration]")
+{
+    // Typical 12 dB eFuse curves plus an extreme one
+    LineFit fits[] = {{53047, 142}, {51200, 75}, {56000, 180}};
+
+    for (auto &fit : fits) {
+        REQUIRE(adc_calibration_build(line_fit_raw_to_mv, &fit));
+
+        for (int type = 0; type < ADC_CAL_TYPE_COUNT; type++) {
+            auto t = static_cast<adc_cal_type_t>(type);
+            double tolerance = one_lsb(t);
+
+            for (int raw = 0; raw <= ADC_CAL_RAW_MAX; raw++) {
+                int mv = 0;
+                line_fit_raw_to_mv(&fit, raw, &mv);
+                double expected = float_path(t, mv);
+                int32_t actual = adc_calibration_convert(t, (uint32_t)raw << ADC_CAL_RAW_FRAC_BITS);
+
+                INFO("type " << type << " raw " << raw << " coeff_a " << fit.coeff_a);
+                REQUIRE(std::fabs(actual - expected) <= tolerance);
+            }
+        }
+    }
+}
+
+TEST_CASE("Water level is clamped to 0..100 %", "[adc_calibration]")
+{
+    LineFit fit = {53047, 142};
+    adc_calibration_build(line_fit_raw_to_mv, &fit);
+
+    CHECK(adc_calibration_convert(ADC_CAL_WATER_CENTIPCT, 0) == 0);
+    CHECK(adc_calibration_convert(ADC_CAL_WATER_CENTIPCT, ADC_CAL_RAW_MAX << ADC_CAL_RAW_FRAC_BITS) == 10000);
+    // Inputs above full scale saturate instead of reading past the table
+    CHECK(adc_calibration_convert(ADC_CAL_WATER_CENTIPCT, UINT32_MAX) == 10000);
+}
+
+TEST_CASE("Fractional raw codes interpolate monotonically", "[adc_calibration]")
+{
+    LineFit fit = {53047, 142};
+    adc_calibration_build(line_fit_raw_to_mv, &fit);
+
+    int32_t previous = adc_calibration_convert(ADC_CAL_MILLIVOLTS, 0);
+    for (uint32_t q4 = 1; q4 <= (ADC_CAL_RAW_MAX << ADC_CAL_RAW_FRAC_BITS); q4++) {
+        int32_t value = adc_calibration_convert(ADC_CAL_MILLIVOLTS, q4);
+        REQUIRE(value >= previous);
+        previous = value;
+    }
+    CHECK(adc_calibration_mean_q4(3 * 1000 + 1 * 1001, 4) == (((3 * 1000 + 1001) << 4) + 2) / 4);
+    CHECK(adc_calibration_mean_q4(123, 0) == 0);
+}
+
+TEST_CASE("Missing or failing calibration falls back to VREF", "[adc_calibration]")
+{
+    for (bool use_failing : {false, true}) {
+        bool calibrated = adc_calibration_build(use_failing ? failing_raw_to_mv : nullptr, nullptr);
+        CHECK_FALSE(calibrated);
+
+        for (int raw = 0; raw <= ADC_CAL_RAW_MAX; raw += 7) {
+            double expected = raw * 3300.0 / 4095.0;
+            int32_t actual = adc_calibration_convert(ADC_CAL_MILLIVOLTS, (uint32_t)raw << ADC_CAL_RAW_FRAC_BITS);
+            REQUIRE(std::fabs(actual - expected) <= 1.0);
+        }
+    }
+}
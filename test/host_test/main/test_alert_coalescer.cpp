@@ -0,0 +1,179 @@
+#include <catch2/catch.hpp>
+#include "alert_coalescer.h"
+
+namespace {
+
+enum { CLEARED = 0, DETECTED = 1 };
+enum { INFO = 0, EMERGENCY = 3 };
+
+alert_coalescer_event_t fire(int edge)
+{
+    alert_coalescer_event_t ev;
+    ev.key = 0x100;
+    ev.edge = (uint8_t)edge;
+    ev.severity = edge == DETECTED ? EMERGENCY : INFO;
+    ev.rank = 0;
+    ev.hold_ms = 30000;
+    ev.max_hold_ms = 120000;
+    return ev;
+}
+
+}
+
+TEST_CASE("Alert coalescer: first edge passes, repeats merge into one", "[alert_coalescer]")
+{
+    alert_coalescer_t c;
+    alert_coalescer_init(&c);
+    alert_pool_handle_t superseded;
+    alert_coalescer_emit_t out;
+
+    alert_coalescer_event_t detected = fire(DETECTED);
+    alert_coalescer_event_t cleared = fire(CLEARED);
+
+    REQUIRE(alert_coalescer_offer(&c, &detected, 1, 0, &superseded, &out));
+    CHECK(out.record == 1);
+    CHECK(out.occurrences == 1);
+    CHECK(superseded == ALERT_POOL_NONE);
+
+    // Flicker inside the window: held, newest kept
+    CHECK_FALSE(alert_coalescer_offer(&c, &cleared, 2, 2000, &superseded, &out));
+    CHECK(superseded == ALERT_POOL_NONE);
+    CHECK(out.occurrences == 1);
+    CHECK_FALSE(alert_coalescer_offer(&c, &detected, 3, 4000, &superseded, &out));
+    CHECK(superseded == 2);
+    CHECK_FALSE(alert_coalescer_offer(&c, &cleared, 4, 6000, &superseded, &out));
+    CHECK(superseded == 3);
+    CHECK(out.occurrences == 3);
+    CHECK(alert_coalescer_pending(&c) == 1);
+
+    CHECK_FALSE(alert_coalescer_due(&c, 29999, &out));
+    REQUIRE(alert_coalescer_due(&c, 30000, &out));
+    CHECK(out.record == 4);
+    CHECK(out.occurrences == 3);
+    CHECK(out.flaps == 3);
+    CHECK_FALSE(alert_coalescer_due(&c, 30000, &out));
+    CHECK(alert_coalescer_pending(&c) == 0);
+    CHECK(c.merged == 2);
+}
+
+TEST_CASE("Alert coalescer: escalation is never held", "[alert_coalescer]")
+{
+    alert_coalescer_t c;
+    alert_coalescer_init(&c);
+    alert_pool_handle_t superseded;
+    alert_coalescer_emit_t out;
+
+    alert_coalescer_event_t detected = fire(DETECTED);
+    alert_coalescer_event_t cleared = fire(CLEARED);
+
+    // A clear goes out first, then a fire comes back inside the window
+    REQUIRE(alert_coalescer_offer(&c, &cleared, 1, 0, &superseded, &out));
+    CHECK_FALSE(alert_coalescer_offer(&c, &cleared, 2, 1000, &superseded, &out));
+    REQUIRE(alert_coalescer_offer(&c, &detected, 3, 2000, &superseded, &out));
+    CHECK(out.record == 3);
+    CHECK(out.occurrences == 2);        // Folds in the held clear
+    CHECK(superseded == 2);
+    CHECK(alert_coalescer_pending(&c) == 0);
+
+    // The window restarted at the escalation
+    CHECK_FALSE(alert_coalescer_offer(&c, &detected, 4, 3000, &superseded, &out));
+    CHECK_FALSE(alert_coalescer_due(&c, 31999, &out));
+    REQUIRE(alert_coalescer_due(&c, 32000, &out));
+    CHECK(out.record == 4);
+}
+
+TEST_CASE("Alert coalescer: flapping backs off, quiet resets", "[alert_coalescer]")
+{
+    alert_coalescer_t c;
+    alert_coalescer_init(&c);
+    alert_pool_handle_t superseded;
+    alert_coalescer_emit_t out;
+
+    alert_coalescer_event_t detected = fire(DETECTED);
+    alert_coalescer_event_t cleared = fire(CLEARED);
+    alert_pool_handle_t next = 1;
+
+    REQUIRE(alert_coalescer_offer(&c, &detected, next++, 0, &superseded, &out));
+    alert_coalescer_offer(&c, &cleared, next++, 1000, &superseded, &out);
+    alert_coalescer_offer(&c, &detected, next++, 2000, &superseded, &out);
+    REQUIRE(alert_coalescer_due(&c, 30000, &out));
+    CHECK(c.slots[out.slot].hold_ms == 60000);
+
+    // Keeps flapping: window doubles again, capped at the maximum
+    alert_coalescer_offer(&c, &cleared, next++, 31000, &superseded, &out);
+    alert_coalescer_offer(&c, &detected, next++, 32000, &superseded, &out);
+    CHECK_FALSE(alert_coalescer_due(&c, 89999, &out));
+    REQUIRE(alert_coalescer_due(&c, 90000, &out));
+    CHECK(c.slots[out.slot].hold_ms == 120000);
+    alert_coalescer_offer(&c, &cleared, next++, 91000, &superseded, &out);
+    alert_coalescer_offer(&c, &detected, next++, 92000, &superseded, &out);
+    REQUIRE(alert_coalescer_due(&c, 210000, &out));
+    CHECK(c.slots[out.slot].hold_ms == 120000);
+
+    // A quiet window brings the base length back
+    CHECK_FALSE(alert_coalescer_due(&c, 330000, &out));
+    REQUIRE(alert_coalescer_offer(&c, &cleared, next++, 400000, &superseded, &out));
+    CHECK(c.slots[out.slot].hold_ms == 30000);
+}
+
+TEST_CASE("Alert coalescer: keys are independent and slots recycle", "[alert_coalescer]")
+{
+    alert_coalescer_t c;
+    alert_coalescer_init(&c);
+    alert_pool_handle_t superseded;
+    alert_coalescer_emit_t out;
+
+    alert_coalescer_event_t ev = fire(DETECTED);
+    for (int i = 0; i < ALERT_COALESCER_SLOTS; i++) {
+        ev.key = (uint32_t)i;
+        CHECK(alert_coalescer_offer(&c, &ev, (alert_pool_handle_t)i, 0, &superseded, &out));
+    }
+
+    // All slots in an open window: a new key passes untracked
+    ev.key = 99;
+    CHECK(alert_coalescer_offer(&c, &ev, 50, 1000, &superseded, &out));
+    CHECK(out.slot == -1);
+    CHECK(c.untracked == 1);
+
+    // After the windows end, idle slots are reused
+    CHECK(alert_coalescer_offer(&c, &ev, 51, 40000, &superseded, &out));
+    CHECK(out.slot >= 0);
+    CHECK_FALSE(alert_coalescer_offer(&c, &ev, 52, 41000, &superseded, &out));
+}
+
+TEST_CASE("Alert coalescer: higher rank at equal severity is never held", "[alert_coalescer]")
+{
+    alert_coalescer_t c;
+    alert_coalescer_init(&c);
+    alert_pool_handle_t superseded;
+    alert_coalescer_emit_t out;
+
+    // Multiple fires: every count is an emergency, the count is the rank
+    alert_coalescer_event_t sectors[5];
+    for (int n = 2; n <= 4; n++) {
+        sectors[n] = fire(DETECTED);
+        sectors[n].edge = (uint8_t)n;
+        sectors[n].rank = (uint8_t)n;
+    }
+
+    // Flapping between two and three sectors backs the window off
+    alert_pool_handle_t next = 1;
+    REQUIRE(alert_coalescer_offer(&c, &sectors[3], next++, 0, &superseded, &out));
+    CHECK_FALSE(alert_coalescer_offer(&c, &sectors[2], next++, 1000, &superseded, &out));
+    CHECK_FALSE(alert_coalescer_offer(&c, &sectors[3], next++, 2000, &superseded, &out));
+    CHECK_FALSE(alert_coalescer_offer(&c, &sectors[2], next++, 3000, &superseded, &out));
+    REQUIRE(alert_coalescer_due(&c, 30000, &out));
+    CHECK(c.slots[out.slot].hold_ms == 60000);
+
+    // Sent rank is now two: three is an escalation, then full system is too
+    REQUIRE(alert_coalescer_offer(&c, &sectors[3], next++, 31000, &superseded, &out));
+    CHECK_FALSE(alert_coalescer_offer(&c, &sectors[2], next++, 32000, &superseded, &out));
+    alert_pool_handle_t full = next++;
+    REQUIRE(alert_coalescer_offer(&c, &sectors[4], full, 33000, &superseded, &out));
+    CHECK(out.record == full);
+    CHECK(out.occurrences == 2);
+    CHECK(superseded == full - 1);
+
+    // Back down to three at the same severity is held
+    CHECK_FALSE(alert_coalescer_offer(&c, &sectors[3], next++, 34000, &superseded, &out));
+}
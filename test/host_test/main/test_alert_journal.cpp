@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+#include "alert_journal.h"
+
+TEST_CASE("Alert journal: only a PUBACK completes an alert", "[alert_journal]")
+{
+    alert_journal_t j;
+    alert_journal_init(&j, 0, 0);
+    bool reserve;
+
+    uint32_t seq = alert_journal_open(&j, &reserve);
+    REQUIRE(seq == 1);
+    CHECK(reserve);
+    CHECK(j.reserved_seq == 1 + ALERT_JOURNAL_SEQ_BLOCK);
+    CHECK(alert_journal_state(&j, seq) == ALERT_JOURNAL_PENDING);
+
+    alert_journal_stored(&j, seq);
+    alert_journal_sent(&j, seq, 42, 1000);
+    CHECK(alert_journal_state(&j, seq) == ALERT_JOURNAL_IN_FLIGHT);
+    CHECK(alert_journal_take_acked(&j) == 0);
+
+    CHECK_FALSE(alert_journal_acked(&j, 41));
+    CHECK(alert_journal_acked(&j, 42));
+    CHECK(alert_journal_take_acked(&j) == seq);
+    CHECK(alert_journal_state(&j, seq) == ALERT_JOURNAL_FREE);
+
+    CHECK(alert_journal_settle(&j, 0));
+    CHECK(j.acked_seq == 1);
+    CHECK_FALSE(alert_journal_settle(&j, 0));
+}
+
+TEST_CASE("Alert journal: removal waits for the stored copy", "[alert_journal]")
+{
+    alert_journal_t j;
+    alert_journal_init(&j, 0, 0);
+    bool reserve;
+
+    uint32_t seq = alert_journal_open(&j, &reserve);
+    alert_journal_sent(&j, seq, 7, 0);
+    alert_journal_acked(&j, 7);
+    CHECK(alert_journal_take_acked(&j) == 0);
+    CHECK_FALSE(alert_journal_settle(&j, 0));
+
+    alert_journal_stored(&j, seq);
+    CHECK(alert_journal_take_acked(&j) == seq);
+}
+
+TEST_CASE("Alert journal: parked alerts go to the replay, watermark waits", "[alert_journal]")
+{
+    alert_journal_t j;
+    alert_journal_init(&j, 0, 0);
+    bool reserve;
+
+    uint32_t a = alert_journal_open(&j, &reserve);
+    uint32_t b = alert_journal_open(&j, &reserve);
+    CHECK_FALSE(reserve);
+
+    // Offline: a is parked before its copy is written and stays tracked
+    alert_journal_park(&j, a);
+    CHECK(alert_journal_state(&j, a) == ALERT_JOURNAL_PARKED);
+    alert_journal_stored(&j, a);
+    CHECK(alert_journal_state(&j, a) == ALERT_JOURNAL_FREE);
+
+    // b times out waiting for its PUBACK
+    alert_journal_stored(&j, b);
+    alert_journal_sent(&j, b, 9, 1000);
+    uint32_t replayed[ALERT_JOURNAL_SLOTS];
+    int replayed_count;
+    CHECK(alert_journal_expire(&j, 30999, 30000, replayed, &replayed_count) == 0);
+    CHECK(alert_journal_expire(&j, 31000, 30000, replayed, &replayed_count) == 1);
+    CHECK(replayed_count == 0);
+    CHECK(alert_journal_state(&j, b) == ALERT_JOURNAL_FREE);
+    CHECK_FALSE(alert_journal_acked(&j, 9));
+
+    // Both still in SPIFFS: the watermark must not pass them
+    CHECK_FALSE(alert_journal_settle(&j, a));
+    CHECK(j.acked_seq == 0);
+
+    // Replay sends a again under the same sequence
+    REQUIRE(alert_journal_track(&j, a));
+    CHECK_FALSE(alert_journal_track(&j, a));
+    alert_journal_sent(&j, a, 11, 40000);
+    alert_journal_acked(&j, 11);
+    CHECK(alert_journal_take_acked(&j) == a);
+    CHECK(alert_journal_settle(&j, b));
+    CHECK(j.acked_seq == a);
+
+    // The replay of b gets no PUBACK either: reported as a failed retry
+    REQUIRE(alert_journal_track(&j, b));
+    alert_journal_sent(&j, b, 12, 41000);
+    CHECK(alert_journal_expire(&j, 71000, 30000, replayed, &replayed_count) == 1);
+    REQUIRE(replayed_count == 1);
+    CHECK(replayed[0] == b);
+    CHECK(alert_journal_state(&j, b) == ALERT_JOURNAL_FREE);
+}
+
+TEST_CASE("Alert journal: early PUBACK, reboot and full journal", "[alert_journal]")
+{
+    alert_journal_t j;
+    alert_journal_init(&j, 0, 0);
+    bool reserve;
+
+    // PUBACK handled before the publisher recorded the msg_id
+    uint32_t seq = alert_journal_open(&j, &reserve);
+    CHECK_FALSE(alert_journal_acked(&j, 5));
+    alert_journal_sent(&j, seq, 5, 0);
+    CHECK(alert_journal_state(&j, seq) == ALERT_JOURNAL_ACKED);
+
+    // After a reboot numbering resumes past the reserved block
+    alert_journal_init(&j, 33, 20);
+    CHECK(alert_journal_open(&j, &reserve) == 33);
+    CHECK(reserve);
+    alert_journal_init(&j, 0, 20);
+    CHECK(alert_journal_open(&j, &reserve) == 21);
+
+    // A stored copy from before an NVS reset moves numbering past it
+    alert_journal_init(&j, 0, 0);
+    REQUIRE(alert_journal_track(&j, 50));
+    CHECK(alert_journal_open(&j, &reserve) == 51);
+    CHECK(reserve);
+
+    alert_journal_init(&j, 0, 0);
+    for (int i = 0; i < ALERT_JOURNAL_SLOTS; i++) {
+        CHECK(alert_journal_open(&j, &reserve) != 0);
+    }
+    CHECK(alert_journal_open(&j, &reserve) == 0);
+    CHECK(j.full == 1);
+    CHECK(alert_journal_tracked(&j) == ALERT_JOURNAL_SLOTS);
+}
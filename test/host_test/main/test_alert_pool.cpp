@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <vector>
+#include "alert_pool.h"
+
+namespace {
+
+struct Record {
+    int type;
+    char message[128];
+    char timestamp[30];
+    uint8_t payload[200];
+    int64_t trace[4];
+};
+
+}
+
+TEST_CASE("Alert pool: zero-padded records round-trip in a few blocks", "[alert_pool]")
+{
+    static alert_pool_block_t blocks[32];
+    alert_pool_t pool;
+    alert_pool_init(&pool, blocks, 32);
+
+    Record in = {};
+    in.type = 7;
+    strcpy(in.message, "FIRE DETECTED in NORTH sector - Pump activated");
+    strcpy(in.timestamp, "D:16-10-2026&T:12:00:00Z");
+    for (int i = 0; i < 40; i++) {
+        in.payload[i] = (uint8_t)(i * 7 + 1);
+    }
+    in.payload[10] = 0;     // Short zero runs stay inside the literal
+    in.payload[11] = 0;
+    in.trace[0] = 123456789;
+
+    // Store the header plus 64 payload bytes, then the trace; skip the rest
+    size_t prefix = offsetof(Record, payload) + 64;
+    alert_pool_seg_t segs[2] = {
+        { &in, prefix },
+        { in.trace, sizeof(in.trace) },
+    };
+    size_t encoded = alert_pool_encoded_size(segs, 2);
+    CHECK(encoded < 160);
+
+    alert_pool_handle_t h = alert_pool_alloc(&pool, encoded);
+    REQUIRE(h != ALERT_POOL_NONE);
+    CHECK(pool.free_count == 32 - (encoded + ALERT_POOL_BLOCK_DATA - 1) / ALERT_POOL_BLOCK_DATA);
+    alert_pool_encode(&pool, h, segs, 2);
+
+    Record out;
+    memset(&out, 0, sizeof(out));
+    alert_pool_seg_t outSegs[2] = {
+        { &out, prefix },
+        { out.trace, sizeof(out.trace) },
+    };
+    CHECK(alert_pool_decode(&pool, h, outSegs, 2) == prefix + sizeof(in.trace));
+    CHECK(memcmp(&in, &out, prefix) == 0);
+    CHECK(out.trace[0] == 123456789);
+    CHECK(out.payload[64] == 0);
+
+    alert_pool_free(&pool, h);
+    CHECK(pool.free_count == 32);
+}
+
+TEST_CASE("Alert pool: random data and long runs round-trip", "[alert_pool]")
+{
+    static alert_pool_block_t blocks[64];
+    alert_pool_t pool;
+    alert_pool_init(&pool, blocks, 64);
+
+    std::vector<uint8_t> data(900);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < data.size(); i++) {
+        seed = seed * 1103515245u + 12345u;
+        // Mix of literal bytes, short and long zero runs
+        data[i] = (i % 300 < 150) ? (uint8_t)(seed >> 24) : ((i % 7 == 0) ? 0x55 : 0);
+    }
+    data[899] = 0;
+
+    alert_pool_seg_t seg = { data.data(), data.size() };
+    size_t encoded = alert_pool_encoded_size(&seg, 1);
+    alert_pool_handle_t h = alert_pool_alloc(&pool, encoded);
+    REQUIRE(h != ALERT_POOL_NONE);
+    alert_pool_encode(&pool, h, &seg, 1);
+
+    std::vector<uint8_t> out(data.size(), 0xEE);
+    alert_pool_seg_t outSeg = { out.data(), out.size() };
+    CHECK(alert_pool_decode(&pool, h, &outSeg, 1) == data.size());
+    CHECK(out == data);
+}
+
+TEST_CASE("Alert pool: exhaustion, reuse and low-water mark", "[alert_pool]")
+{
+    static alert_pool_block_t blocks[10];
+    alert_pool_t pool;
+    alert_pool_init(&pool, blocks, 10);
+
+    alert_pool_handle_t a = alert_pool_alloc(&pool, ALERT_POOL_BLOCK_DATA * 4);
+    alert_pool_handle_t b = alert_pool_alloc(&pool, ALERT_POOL_BLOCK_DATA * 5 + 1);   // 6 blocks
+    REQUIRE(a != ALERT_POOL_NONE);
+    REQUIRE(b != ALERT_POOL_NONE);
+    CHECK(pool.free_count == 0);
+
+    CHECK(alert_pool_alloc(&pool, 1) == ALERT_POOL_NONE);
+    CHECK(pool.failed == 1);
+
+    alert_pool_free(&pool, a);
+    CHECK(pool.free_count == 4);
+    alert_pool_handle_t c = alert_pool_alloc(&pool, ALERT_POOL_BLOCK_DATA * 4);
+    CHECK(c != ALERT_POOL_NONE);
+
+    alert_pool_free(&pool, b);
+    alert_pool_free(&pool, c);
+    alert_pool_free(&pool, ALERT_POOL_NONE);    // Ignored
+    CHECK(pool.free_count == 10);
+    CHECK(pool.min_free == 0);
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+#include "boot_sequencer.h"
+
+enum { HW = 0, SAFETY, NVS, WIFI, NET, STAGES };
+
+static const boot_stage_t kStages[STAGES] = {
+    { "Hardware", 0, nullptr },
+    { "Safety", BOOT_STAGE(HW), nullptr },
+    { "NVS", 0, nullptr },
+    { "WiFi", BOOT_STAGE(NVS), nullptr },
+    { "Network", BOOT_STAGE(WIFI) | BOOT_STAGE(SAFETY), nullptr },
+};
+
+TEST_CASE("Boot sequencer: two workers keep the safety chain first", "[boot_sequencer]")
+{
+    boot_sequencer_t seq;
+    REQUIRE(boot_sequencer_init(&seq, kStages, STAGES, 1000));
+
+    // Worker A takes hardware, worker B the first independent stage
+    CHECK(boot_sequencer_claim(&seq, 1000) == HW);
+    CHECK(boot_sequencer_claim(&seq, 1000) == NVS);
+    CHECK(boot_sequencer_claim(&seq, 1000) == -1);       // Everything else blocked
+
+    // Hardware done: safety is claimed before WiFi even though NVS is also done
+    boot_sequencer_complete(&seq, NVS, 3000);
+    boot_sequencer_complete(&seq, HW, 4000);
+    CHECK(boot_sequencer_claim(&seq, 4000) == SAFETY);
+    CHECK(boot_sequencer_claim(&seq, 4000) == WIFI);
+    CHECK(boot_sequencer_claim(&seq, 4000) == -1);
+
+    boot_sequencer_complete(&seq, SAFETY, 6000);
+    CHECK(boot_sequencer_claim(&seq, 6000) == -1);       // Network still waits on WiFi
+    CHECK_FALSE(boot_sequencer_finished(&seq));
+
+    boot_sequencer_complete(&seq, WIFI, 50000);
+    CHECK(boot_sequencer_claim(&seq, 50000) == NET);
+    boot_sequencer_complete(&seq, NET, 51000);
+    CHECK(boot_sequencer_finished(&seq));
+    CHECK(boot_sequencer_claim(&seq, 51000) == -1);
+
+    CHECK(boot_sequencer_done_after_us(&seq, SAFETY) == 5000);
+    CHECK(boot_sequencer_done_after_us(&seq, NET) == 50000);
+}
+
+TEST_CASE("Boot sequencer: incomplete stages report -1", "[boot_sequencer]")
+{
+    boot_sequencer_t seq;
+    REQUIRE(boot_sequencer_init(&seq, kStages, STAGES, 0));
+    CHECK(boot_sequencer_done_after_us(&seq, HW) == -1);
+    CHECK(boot_sequencer_done_after_us(&seq, STAGES) == -1);
+}
+
+TEST_CASE("Boot sequencer: rejects cycles and unknown stages", "[boot_sequencer]")
+{
+    boot_sequencer_t seq;
+
+    const boot_stage_t cycle[3] = {
+        { "A", 0, nullptr },
+        { "B", BOOT_STAGE(2), nullptr },
+        { "C", BOOT_STAGE(1), nullptr },
+    };
+    CHECK_FALSE(boot_sequencer_init(&seq, cycle, 3, 0));
+
+    const boot_stage_t self[1] = { { "A", BOOT_STAGE(0), nullptr } };
+    CHECK_FALSE(boot_sequencer_init(&seq, self, 1, 0));
+
+    const boot_stage_t missing[2] = {
+        { "A", 0, nullptr },
+        { "B", BOOT_STAGE(5), nullptr },
+    };
+    CHECK_FALSE(boot_sequencer_init(&seq, missing, 2, 0));
+
+    CHECK_FALSE(boot_sequencer_init(&seq, kStages, 0, 0));
+}
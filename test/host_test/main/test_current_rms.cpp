@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include "current_rms.h"
+
+// 12-bit codes of a biased sine, whole cycles
+static current_rms_acc_t sine_block(double bias, double amplitude, int samples, int cycles)
+{
+    current_rms_acc_t acc;
+    current_rms_reset(&acc);
+    for (int i = 0; i < samples; i++) {
+        double x = bias + amplitude * std::sin(2.0 * M_PI * cycles * i / samples);
+        current_rms_add(&acc, (uint16_t)std::lround(x));
+    }
+    return acc;
+}
+
+TEST_CASE("Sine RMS is independent of the DC bias", "[current_rms]")
+{
+    for (double bias : {1800.0, 2048.0, 2300.0}) {
+        current_rms_acc_t acc = sine_block(bias, 1000.0, 1280, 5);
+        current_rms_t result;
+
+        REQUIRE(current_rms_compute(&acc, 1.0f, &result));
+        INFO("bias " << bias);
+        CHECK(result.bias_codes == Approx(bias).margin(0.5));
+        CHECK(result.rms == Approx(1000.0 / std::sqrt(2.0)).epsilon(0.001));
+        CHECK(result.peak == Approx(1000.0).margin(1.0));
+        CHECK(result.crest == Approx(std::sqrt(2.0)).epsilon(0.002));
+    }
+}
+
+TEST_CASE("Gain scales RMS and peak but not crest", "[current_rms]")
+{
+    current_rms_acc_t acc = sine_block(2048.0, 500.0, 640, 4);
+    current_rms_t unit, scaled;
+
+    current_rms_compute(&acc, 1.0f, &unit);
+    current_rms_compute(&acc, 0.05f, &scaled);
+    CHECK(scaled.rms == Approx(unit.rms * 0.05f));
+    CHECK(scaled.peak == Approx(unit.peak * 0.05f));
+    CHECK(scaled.crest == Approx(unit.crest));
+}
+
+TEST_CASE("Square wave and single spikes", "[current_rms]")
+{
+    current_rms_acc_t acc;
+    current_rms_t result;
+
+    // Square wave: RMS equals peak
+    current_rms_reset(&acc);
+    for (int i = 0; i < 1000; i++) {
+        current_rms_add(&acc, (i & 1) ? 2548 : 1548);
+    }
+    REQUIRE(current_rms_compute(&acc, 1.0f, &result));
+    CHECK(result.rms == Approx(500.0));
+    CHECK(result.crest == Approx(1.0));
+
+    // One spike barely moves the RMS, unlike a peak-to-peak estimate
+    current_rms_reset(&acc);
+    for (int i = 0; i < 1000; i++) {
+        current_rms_add(&acc, i == 500 ? 4095 : 2048);
+    }
+    REQUIRE(current_rms_compute(&acc, 1.0f, &result));
+    CHECK(result.rms < 70.0f);
+    CHECK(result.peak == Approx(4095 - 2048).margin(3.0));
+}
+
+TEST_CASE("Quiet and short blocks", "[current_rms]")
+{
+    current_rms_acc_t acc;
+    current_rms_t result;
+
+    // Flat input: no current and no crest factor below the noise floor
+    current_rms_reset(&acc);
+    for (int i = 0; i < 500; i++) {
+        current_rms_add(&acc, 2048);
+    }
+    REQUIRE(current_rms_compute(&acc, 0.03f, &result));
+    CHECK(result.rms == 0.0f);
+    CHECK(result.peak == 0.0f);
+    CHECK(result.crest == 0.0f);
+
+    current_rms_reset(&acc);
+    for (int i = 0; i < CURRENT_RMS_MIN_SAMPLES - 1; i++) {
+        current_rms_add(&acc, 4095);
+    }
+    CHECK_FALSE(current_rms_compute(&acc, 1.0f, &result));
+    CHECK(result.rms == 0.0f);
+}
+
+TEST_CASE("Full-scale blocks do not overflow", "[current_rms]")
+{
+    // Largest block a 16-bit sample count allows, alternating rail to rail
+    current_rms_acc_t acc;
+    current_rms_t result;
+
+    current_rms_reset(&acc);
+    for (int i = 0; i < 65535 - 1; i++) {
+        current_rms_add(&acc, (i & 1) ? 4095 : 0);
+    }
+    REQUIRE(current_rms_compute(&acc, 1.0f, &result));
+    CHECK(result.rms == Approx(4095 / 2.0).epsilon(0.0001));
+    CHECK(result.bias_codes == Approx(4095 / 2.0));
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch.hpp>
+#include "fire_detector.h"
+
+static const fire_detector_params_t PERSISTENCE = {
+    FIRE_DETECT_PERSISTENCE, 50.0f, 2000, 0, 0, 0, 0, 0
+};
+
+// Industrial-Hydrocarbon tuning
+static const fire_detector_params_t FUSED = {
+    FIRE_DETECT_FUSED, 50.0f, 2000, 300, 80.0f, 4.0f, 1.5f, 1.5f
+};
+
+// Run a sector at a constant input until it confirms; returns elapsed ms or -1
+static int time_to_confirm(const fire_detector_params_t &params, float level, float rate,
+                           int corroborating, uint32_t step_ms = 100)
+{
+    fire_detector_sector_t sector;
+    fire_detector_reset(&sector);
+
+    for (uint32_t t = 0; t <= 10000; t += step_ms) {
+        if (fire_detector_update(&sector, &params, level, rate, corroborating, t) ==
+            FIRE_DETECT_EVENT_CONFIRMED) {
+            return (int)t;
+        }
+    }
+    return -1;
+}
+
+TEST_CASE("Persistence mode keeps the fixed window", "[fire_detector]")
+{
+    CHECK(time_to_confirm(PERSISTENCE, 60.0f, 0.0f, 0) == 2000);
+    // Rate and neighbours are ignored
+    CHECK(time_to_confirm(PERSISTENCE, 100.0f, 500.0f, 2) == 2000);
+}
+
+TEST_CASE("Fused mode: slow drift still needs the full window", "[fire_detector]")
+{
+    CHECK(time_to_confirm(FUSED, 50.5f, 1.0f, 0) >= 1900);
+}
+
+TEST_CASE("Fused mode: steep rise on two sectors confirms in a few hundred ms", "[fire_detector]")
+{
+    int t = time_to_confirm(FUSED, 85.0f, 150.0f, 1);
+    CHECK(t >= 300);
+    CHECK(t <= 400);
+    // Floor holds whatever the evidence
+    CHECK(time_to_confirm(FUSED, 100.0f, 1000.0f, 2, 10) == 300);
+}
+
+TEST_CASE("Confidence rate reflects each kind of evidence", "[fire_detector]")
+{
+    float base = fire_detector_confidence_rate(&FUSED, 50.0f, 0.0f, 0);
+    CHECK(base == Approx(1.0f / 2000));
+    CHECK(fire_detector_confidence_rate(&FUSED, 75.0f, 0.0f, 0) > base);
+    CHECK(fire_detector_confidence_rate(&FUSED, 50.0f, 40.0f, 0) > base);
+    CHECK(fire_detector_confidence_rate(&FUSED, 50.0f, 0.0f, 1) > base);
+    // Falling IR earns nothing
+    CHECK(fire_detector_confidence_rate(&FUSED, 50.0f, -40.0f, 0) == Approx(base));
+}
+
+TEST_CASE("Neighbours are the adjacent sectors", "[fire_detector]")
+{
+    //                 N      S      E      W
+    float levels[] = {80.0f, 10.0f, 70.0f, 10.0f};
+    CHECK(fire_detector_corroboration(levels, 0, 50.0f) == 1);    // N sees E
+    CHECK(fire_detector_corroboration(levels, 1, 50.0f) == 1);    // S sees E
+    CHECK(fire_detector_corroboration(levels, 2, 50.0f) == 1);    // E sees N
+    CHECK(fire_detector_corroboration(levels, 3, 50.0f) == 1);    // W sees N
+    levels[1] = 90.0f;
+    CHECK(fire_detector_corroboration(levels, 2, 50.0f) == 2);
+    CHECK(fire_detector_corroboration(levels, 0, 50.0f) == 1);    // S is opposite N
+    CHECK(fire_detector_corroboration(levels, 7, 50.0f) == 0);
+}
+
+TEST_CASE("Events follow the confirmation lifecycle", "[fire_detector]")
+{
+    fire_detector_sector_t sector;
+    fire_detector_reset(&sector);
+
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 10.0f, 0, 0, 0) == FIRE_DETECT_EVENT_NONE);
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, 100) == FIRE_DETECT_EVENT_STARTED);
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, 1100) == FIRE_DETECT_EVENT_NONE);
+    CHECK(sector.confidence == Approx(0.5f));
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 10.0f, 0, 0, 1200) == FIRE_DETECT_EVENT_LOST);
+    CHECK_FALSE(sector.validating);
+
+    fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, 5000);
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, 7000) == FIRE_DETECT_EVENT_CONFIRMED);
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, 7100) == FIRE_DETECT_EVENT_NONE);
+    CHECK(sector.confirmed);
+    // Losing a confirmed flame is not "lost before confirmation"
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 10.0f, 0, 0, 7200) == FIRE_DETECT_EVENT_NONE);
+    CHECK_FALSE(sector.confirmed);
+}
+
+TEST_CASE("Millisecond tick wrap does not break confirmation", "[fire_detector]")
+{
+    fire_detector_sector_t sector;
+    fire_detector_reset(&sector);
+
+    uint32_t t = UINT32_MAX - 500;
+    fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, t);
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, t + 1000) == FIRE_DETECT_EVENT_NONE);
+    CHECK(fire_detector_update(&sector, &PERSISTENCE, 60.0f, 0, 0, t + 2000) == FIRE_DETECT_EVENT_CONFIRMED);
+}
+
+TEST_CASE("Confirmation deadline matches the update that confirms", "[fire_detector]")
+{
+    fire_detector_sector_t sector;
+    fire_detector_reset(&sector);
+
+    CHECK(fire_detector_ms_to_confirm(&sector, &FUSED, 85.0f, 0.0f, 0, 0) == UINT32_MAX);
+
+    fire_detector_update(&sector, &FUSED, 85.0f, 150.0f, 1, 1000);
+    uint32_t remaining = fire_detector_ms_to_confirm(&sector, &FUSED, 85.0f, 150.0f, 1, 1100);
+    CHECK(remaining == 200);
+
+    // One millisecond early is not enough, on the deadline is
+    fire_detector_sector_t early = sector;
+    CHECK(fire_detector_update(&early, &FUSED, 85.0f, 150.0f, 1, 1100 + remaining - 1) ==
+          FIRE_DETECT_EVENT_NONE);
+    CHECK(fire_detector_update(&sector, &FUSED, 85.0f, 150.0f, 1, 1100 + remaining) ==
+          FIRE_DETECT_EVENT_CONFIRMED);
+    CHECK(fire_detector_ms_to_confirm(&sector, &FUSED, 85.0f, 150.0f, 1, 1400) == UINT32_MAX);
+
+    // Below threshold there is no deadline to wake for
+    fire_detector_sector_t quiet;
+    fire_detector_reset(&quiet);
+    fire_detector_update(&quiet, &PERSISTENCE, 60.0f, 0, 0, 0);
+    CHECK(fire_detector_ms_to_confirm(&quiet, &PERSISTENCE, 60.0f, 0, 0, 500) == 1500);
+    CHECK(fire_detector_ms_to_confirm(&quiet, &PERSISTENCE, 40.0f, 0, 0, 500) == UINT32_MAX);
+}
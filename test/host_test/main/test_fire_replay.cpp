@@ -0,0 +1,367 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "fire_replay.h"
+#include "host_platform.h"
+#include "output_shadow.h"
+
+// Constant-input trace: IR per sector and level, sampled every step_ms
+static fire_trace_t make_trace(uint32_t duration_ms, uint32_t step_ms,
+                               const std::vector<float> &ir, float level)
+{
+    fire_trace_t trace = {};
+    for (uint32_t t = 0; t <= duration_ms; t += step_ms) {
+        fire_trace_sample_t s = {t, {ir[0], ir[1], ir[2], ir[3]}, level};
+        fire_trace_append(&trace, &s);
+    }
+    return trace;
+}
+
+// Overwrite one sector's IR over [from_ms, to_ms)
+static void set_ir(fire_trace_t *trace, int sector, uint32_t from_ms, uint32_t to_ms, float ir)
+{
+    for (size_t i = 0; i < trace->count; i++) {
+        if (trace->samples[i].t_ms >= from_ms && trace->samples[i].t_ms < to_ms) {
+            trace->samples[i].ir[sector] = ir;
+        }
+    }
+}
+
+static void set_level(fire_trace_t *trace, uint32_t from_ms, uint32_t to_ms, float level)
+{
+    for (size_t i = 0; i < trace->count; i++) {
+        if (trace->samples[i].t_ms >= from_ms && trace->samples[i].t_ms < to_ms) {
+            trace->samples[i].level = level;
+        }
+    }
+}
+
+static fire_replay_result_t result;
+
+static const fire_replay_result_t &replay(const fire_trace_t &trace, SystemProfile profile = WILDLAND_STANDARD,
+                                          uint32_t tail_ms = 0)
+{
+    fire_replay_config_t config;
+    fire_replay_default_config(&config);
+    config.profile = profile;
+    config.tail_ms = tail_ms;
+    REQUIRE(fire_replay_run(&trace, &config, &result) == 0);
+    return result;
+}
+
+TEST_CASE("Replay: persistence profile confirms after the fixed window", "[fire_replay]")
+{
+    fire_trace_t trace = make_trace(20000, 100, {10, 10, 10, 10}, 75);
+    set_ir(&trace, 0, 5000, 15000, 90);
+
+    const fire_replay_result_t &r = replay(trace);
+    const fire_replay_transition_t *on = fire_replay_find(&r, 0, PUMP_AUTO_ACTIVE);
+    REQUIRE(on != nullptr);
+    // Conditioning lag + 2 s confirmation + relay settle
+    CHECK(on->t_ms >= 7000);
+    CHECK(on->t_ms <= 7600);
+    CHECK(host_pca_output(1) == (1 << 3));      // North relay
+    for (int i = 1; i < 4; i++) {
+        CHECK(fire_replay_find(&r, i, PUMP_AUTO_ACTIVE) == nullptr);
+    }
+    fire_trace_free(&trace);
+}
+
+TEST_CASE("Replay: fused profile confirms a flash fire sooner", "[fire_replay]")
+{
+    fire_trace_t trace = make_trace(10000, 500, {10, 10, 10, 10}, 75);
+    set_ir(&trace, 0, 2000, 10000, 95);
+    set_ir(&trace, 2, 2000, 10000, 95);
+
+    uint32_t standard = fire_replay_find(&replay(trace, WILDLAND_STANDARD), 0, PUMP_AUTO_ACTIVE)->t_ms;
+    const fire_replay_transition_t *fused = fire_replay_find(&replay(trace, INDUSTRIAL_HYDROCARBON), 0,
+                                                             PUMP_AUTO_ACTIVE);
+    REQUIRE(fused != nullptr);
+    CHECK(fused->t_ms + 1000 < standard);
+    // Confirmation deadlines wake the fire task between frames
+    CHECK(result.deadline_wakes > 0);
+    fire_trace_free(&trace);
+}
+
+TEST_CASE("Replay: no-flame timeout and max run cap stop auto pumps", "[fire_replay]")
+{
+    SECTION("Flame gone for 60 s") {
+        fire_trace_t trace = make_trace(80000, 500, {10, 10, 10, 10}, 75);
+        set_ir(&trace, 1, 1000, 8000, 90);
+
+        // Critical-Asset: 60 s NFT, run cap far beyond the trace
+        const fire_replay_result_t &r = replay(trace, CRITICAL_ASSET);
+        const fire_replay_transition_t *on = fire_replay_find(&r, 1, PUMP_AUTO_ACTIVE);
+        const fire_replay_transition_t *off = fire_replay_find(&r, 1, PUMP_OFF);
+        REQUIRE(on != nullptr);
+        REQUIRE(off != nullptr);
+        CHECK(off->t_ms >= 8000 + 60000 - 1000);
+        CHECK(off->t_ms <= 8000 + 60000 + 1000);
+        fire_trace_free(&trace);
+    }
+
+    SECTION("Sector cap, cooldown, re-arm") {
+        fire_trace_t trace = make_trace(70000, 500, {10, 10, 10, 10}, 75);
+        set_ir(&trace, 1, 1000, 70000, 90);
+
+        const fire_replay_result_t &r = replay(trace);
+        const fire_replay_transition_t *on = fire_replay_find(&r, 1, PUMP_AUTO_ACTIVE);
+        const fire_replay_transition_t *cool = fire_replay_find(&r, 1, PUMP_COOLDOWN);
+        REQUIRE(on != nullptr);
+        REQUIRE(cool != nullptr);
+        CHECK(cool->t_ms - on->t_ms >= profiles[WILDLAND_STANDARD].maxRunCapSector);
+        CHECK(cool->t_ms - on->t_ms <= profiles[WILDLAND_STANDARD].maxRunCapSector + 200);
+
+        const fire_replay_transition_t *rearmed = fire_replay_find(&r, 1, PUMP_OFF);
+        REQUIRE(rearmed != nullptr);
+        CHECK(rearmed->t_ms - cool->t_ms >= 15000);
+        CHECK(rearmed->t_ms - cool->t_ms <= 30100);
+        fire_trace_free(&trace);
+    }
+}
+
+TEST_CASE("Replay: continuous feed profile lifts the run cap", "[fire_replay]")
+{
+    fire_trace_t trace = make_trace(60000, 500, {10, 10, 10, 10}, 75);
+    set_ir(&trace, 1, 1000, 60000, 90);
+
+    const fire_replay_result_t &r = replay(trace, CONTINUOUS_FEED);
+    REQUIRE(fire_replay_find(&r, 1, PUMP_AUTO_ACTIVE) != nullptr);
+    CHECK(fire_replay_find(&r, 1, PUMP_COOLDOWN) == nullptr);
+    CHECK(pumps[1].state == PUMP_AUTO_ACTIVE);
+    fire_trace_free(&trace);
+}
+
+TEST_CASE("Replay: water lockout stops pumps and blocks activation until stable", "[fire_replay]")
+{
+    fire_trace_t trace = make_trace(40000, 500, {10, 10, 10, 10}, 75);
+    set_ir(&trace, 0, 1000, 40000, 90);
+    set_level(&trace, 8000, 20000, 10);
+    set_level(&trace, 20000, 40000, 60);
+
+    const fire_replay_result_t &r = replay(trace);
+    REQUIRE(r.transition_count >= 3);
+    CHECK(r.transitions[0].to == PUMP_AUTO_ACTIVE);
+    CHECK(r.transitions[1].to == PUMP_OFF);
+    CHECK(r.transitions[1].t_ms >= 8000);
+    CHECK(r.transitions[1].t_ms <= 8600);
+
+    // Re-armed only after 5 s of stable water, then re-confirmed
+    CHECK(r.transitions[2].to == PUMP_AUTO_ACTIVE);
+    CHECK(r.transitions[2].t_ms >= 20000 + 5000 + 2000);
+    fire_trace_free(&trace);
+}
+
+struct manual_run {
+    size_t at_sample;
+    unsigned long duration_ms;
+    bool extended;
+};
+
+static void start_manual(size_t index, void *ctx)
+{
+    manual_run *run = static_cast<manual_run *>(ctx);
+    if (index == run->at_sample) {
+        shadow_manual_activate_pump_with_duration(2, run->duration_ms);
+    }
+    if (run->extended && index == run->at_sample + 10) {
+        extend_timer_protection(2, EXTEND_30S);
+    }
+}
+
+TEST_CASE("Replay: timer protection holds a manual pump for its duration", "[fire_replay]")
+{
+    fire_trace_t trace = make_trace(90000, 1000, {10, 10, 10, 10}, 75);
+    fire_replay_config_t config;
+    fire_replay_default_config(&config);
+    config.on_sample = start_manual;
+
+    SECTION("Expires on time") {
+        manual_run run = {5, 30000, false};
+        config.ctx = &run;
+        REQUIRE(fire_replay_run(&trace, &config, &result) == 0);
+        const fire_replay_transition_t *on = fire_replay_find(&result, 2, PUMP_MANUAL_ACTIVE);
+        const fire_replay_transition_t *off = fire_replay_find(&result, 2, PUMP_OFF);
+        REQUIRE(on != nullptr);
+        REQUIRE(off != nullptr);
+        CHECK(off->t_ms - on->t_ms >= 30000);
+        CHECK(off->t_ms - on->t_ms <= 30300);
+    }
+
+    SECTION("Extension pushes the deadline out") {
+        manual_run run = {5, 30000, true};
+        config.ctx = &run;
+        REQUIRE(fire_replay_run(&trace, &config, &result) == 0);
+        const fire_replay_transition_t *on = fire_replay_find(&result, 2, PUMP_MANUAL_ACTIVE);
+        const fire_replay_transition_t *off = fire_replay_find(&result, 2, PUMP_OFF);
+        REQUIRE(off != nullptr);
+        CHECK(off->t_ms - on->t_ms >= 60000);
+        CHECK(off->t_ms - on->t_ms <= 60300);
+    }
+
+    SECTION("Water lockout overrides the timer") {
+        manual_run run = {5, 120000, false};
+        config.ctx = &run;
+        set_level(&trace, 20000, 90001, 10);
+        REQUIRE(fire_replay_run(&trace, &config, &result) == 0);
+        const fire_replay_transition_t *off = fire_replay_find(&result, 2, PUMP_OFF);
+        REQUIRE(off != nullptr);
+        CHECK(off->t_ms >= 20000);
+        CHECK(off->t_ms <= 20600);
+        CHECK_FALSE(pumps[2].timerProtected);
+    }
+    fire_trace_free(&trace);
+}
+
+TEST_CASE("Replay: pump deadlines fire on time without polling", "[fire_replay]")
+{
+    fire_trace_t trace = make_trace(90000, 1000, {10, 10, 10, 10}, 75);
+    fire_replay_config_t config;
+    fire_replay_default_config(&config);
+    config.on_sample = start_manual;
+    manual_run run = {5, 30000, false};
+    config.ctx = &run;
+    REQUIRE(fire_replay_run(&trace, &config, &result) == 0);
+
+    // The start command wakes the pump task and the timer end is its next deadline
+    const fire_replay_transition_t *on = fire_replay_find(&result, 2, PUMP_MANUAL_ACTIVE);
+    const fire_replay_transition_t *off = fire_replay_find(&result, 2, PUMP_OFF);
+    REQUIRE(on != nullptr);
+    REQUIRE(off != nullptr);
+    CHECK(on->t_ms == 5000);
+    CHECK(off->t_ms - on->t_ms == 30000);
+
+    // Otherwise only the guard interval and the relay read-backs wake it
+    printf("[REPLAY] %lu pump wakes over %lu s\n", (unsigned long)result.pump_wakes,
+           (unsigned long)(result.simulated_ms / 1000));
+    CHECK(result.pump_wakes <= 90000 / PUMP_SCHEDULE_MAX_WAIT_MS + 10);
+    fire_trace_free(&trace);
+}
+
+TEST_CASE("Replay: recorded CSV traces", "[fire_replay]")
+{
+    SECTION("North flare with a single-sample glint") {
+        fire_trace_t trace = {};
+        REQUIRE(fire_trace_load_csv(TRACE_DIR "/north_flare.csv", &trace) == 0);
+        REQUIRE(trace.count == 181);
+
+        const fire_replay_result_t &r = replay(trace, CRITICAL_ASSET);
+        const fire_replay_transition_t *on = fire_replay_find(&r, 0, PUMP_AUTO_ACTIVE);
+        const fire_replay_transition_t *off = fire_replay_find(&r, 0, PUMP_OFF);
+        REQUIRE(on != nullptr);
+        REQUIRE(off != nullptr);
+        CHECK(on->t_ms >= 11000);
+        CHECK(on->t_ms <= 14000);
+        CHECK(off->t_ms >= 18000 + 60000 - 1000);
+        // The East glint is rejected by the median filter
+        CHECK(fire_replay_find(&r, 2, PUMP_AUTO_ACTIVE) == nullptr);
+        CHECK(r.transition_count == 2);
+        fire_trace_free(&trace);
+    }
+
+    SECTION("Tank drains under a sustained fire") {
+        fire_trace_t trace = {};
+        REQUIRE(fire_trace_load_csv(TRACE_DIR "/low_water.csv", &trace) == 0);
+
+        const fire_replay_result_t &r = replay(trace);
+        REQUIRE(r.transition_count >= 3);
+        CHECK(r.transitions[0].pump == 1);
+        CHECK(r.transitions[0].to == PUMP_AUTO_ACTIVE);
+        CHECK(r.transitions[1].to == PUMP_OFF);
+        CHECK(r.transitions[1].t_ms >= 16000);
+        CHECK(r.transitions[1].t_ms <= 19000);
+        CHECK(r.transitions[2].to == PUMP_AUTO_ACTIVE);
+        CHECK(r.transitions[2].t_ms >= 45000);
+        fire_trace_free(&trace);
+    }
+}
+
+TEST_CASE("Replay is deterministic and binary traces round-trip", "[fire_replay]")
+{
+    fire_trace_t trace = {};
+    REQUIRE(fire_trace_load_csv(TRACE_DIR "/low_water.csv", &trace) == 0);
+
+    std::string path = "replay_roundtrip.bin";
+    REQUIRE(fire_trace_save_binary(path.c_str(), &trace) == 0);
+    fire_trace_t loaded = {};
+    REQUIRE(fire_trace_load_binary(path.c_str(), &loaded) == 0);
+    std::remove(path.c_str());
+    REQUIRE(loaded.count == trace.count);
+
+    replay(trace);
+    std::vector<fire_replay_transition_t> first(result.transitions,
+                                                result.transitions + result.transition_count);
+    replay(loaded, WILDLAND_STANDARD);
+    REQUIRE(result.transition_count == first.size());
+    for (size_t i = 0; i < first.size(); i++) {
+        CHECK(result.transitions[i].t_ms == first[i].t_ms);
+        CHECK(result.transitions[i].pump == first[i].pump);
+        CHECK(result.transitions[i].to == first[i].to);
+    }
+
+    fire_trace_t unordered = {};
+    fire_trace_sample_t a = {1000, {0, 0, 0, 0}, 50};
+    fire_trace_sample_t b = {500, {0, 0, 0, 0}, 50};
+    CHECK(fire_trace_append(&unordered, &a) == 0);
+    CHECK(fire_trace_append(&unordered, &b) == -1);
+    CHECK(fire_trace_load_csv(TRACE_DIR "/missing.csv", &unordered) == -1);
+
+    fire_trace_free(&unordered);
+    fire_trace_free(&loaded);
+    fire_trace_free(&trace);
+}
+
+TEST_CASE("Replay: all pumps switch in one relay write", "[fire_replay]")
+{
+    fire_trace_t trace = make_trace(2000, 500, {10, 10, 10, 10}, 75);
+    replay(trace);
+
+    uint32_t writes = host_pca_writes();
+    manual_activate_all_pumps();
+    CHECK(host_pca_writes() == writes + 1);
+    CHECK(host_pca_output(1) == 0x0F);
+
+    // Read-back runs on the control tick once the relays have settled
+    vTaskDelay(pdMS_TO_TICKS(OUTPUT_SHADOW_VERIFY_DELAY_MS));
+    update_pump_states();
+    for (int i = 0; i < 4; i++) {
+        CHECK(pumps[i].isRunning);
+    }
+    CHECK(host_alerts()->hardware_control_fail == 0);
+
+    // Timer-protected pumps only stop on a forced reset
+    writes = host_pca_writes();
+    reset_system_to_defaults();
+    CHECK(host_pca_writes() == writes + 1);
+    CHECK(host_pca_output(1) == 0x00);
+
+    // A failed write stays staged and is retried on the next tick
+    host_pca_fail_writes(1);
+    manual_activate_pump(1);
+    CHECK(host_pca_output(1) == 0x00);
+    CHECK(pumps[1].state == PUMP_MANUAL_ACTIVE);
+    update_pump_states();
+    CHECK(host_pca_output(1) == (1 << 2));      // South relay
+    CHECK(pumps[1].isRunning);
+
+    fire_trace_free(&trace);
+}
+
+TEST_CASE("Replay throughput", "[fire_replay][benchmark]")
+{
+    // Six hours at 1 Hz with a flare every 30 minutes
+    fire_trace_t trace = make_trace(6 * 3600 * 1000, 1000, {10, 10, 10, 10}, 75);
+    for (uint32_t t = 0; t < 6 * 3600 * 1000; t += 1800 * 1000) {
+        set_ir(&trace, (t / 1800000) % 4, t + 60000, t + 90000, 90);
+    }
+
+    const fire_replay_result_t &r = replay(trace, WILDLAND_HIGH_WIND);
+    printf("[REPLAY] %.1f simulated h in %.3f s = %.0f simulated h/s (%lu transitions)\n",
+           r.simulated_ms / 3600000.0, r.wall_s, r.sim_hours_per_s,
+           (unsigned long)r.transition_count);
+    CHECK(r.frames == trace.count);
+    CHECK(r.transition_count >= 12 * 2);
+    CHECK(r.sim_hours_per_s > 0);
+    fire_trace_free(&trace);
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+#include "input_dispatch.h"
+
+namespace {
+
+struct Seen {
+    int calls = 0;
+    uint32_t changed = 0;
+    uint32_t state = 0;
+    int order = 0;
+};
+
+int g_order = 0;
+
+void record(uint32_t changed, uint32_t state, void *arg)
+{
+    Seen *s = static_cast<Seen *>(arg);
+    s->calls++;
+    s->changed = changed;
+    s->state = state;
+    s->order = ++g_order;
+}
+
+} // namespace
+
+TEST_CASE("Input dispatch: only subscribers whose bits changed are called", "[input_dispatch]")
+{
+    input_dispatch_t d;
+    input_dispatch_init(&d);
+    Seen door, pca;
+    REQUIRE(input_dispatch_subscribe(&d, 1u << 16, record, &door) == 0);
+    REQUIRE(input_dispatch_subscribe(&d, 0x00FF, record, &pca) == 0);
+
+    CHECK(input_dispatch_update(&d, 1u << 16, 1u << 16) == (1u << 16));
+    CHECK(door.calls == 1);
+    CHECK(door.changed == (1u << 16));
+    CHECK(pca.calls == 0);
+
+    // Same level again is not an event
+    CHECK(input_dispatch_update(&d, 1u << 16, 1u << 16) == 0);
+    CHECK(door.calls == 1);
+    CHECK(d.events == 1);
+
+    // A PCA update only touches its own bits and reports the whole state
+    CHECK(input_dispatch_update(&d, 0xFFFF, 0x0012) == 0x0012);
+    CHECK(pca.calls == 1);
+    CHECK(pca.changed == 0x0012);
+    CHECK(pca.state == ((1u << 16) | 0x0012));
+    CHECK(door.calls == 1);
+}
+
+TEST_CASE("Input dispatch: bits outside the update mask are left alone", "[input_dispatch]")
+{
+    input_dispatch_t d;
+    input_dispatch_init(&d);
+    input_dispatch_seed(&d, 0xFFFF, 0x0001);
+
+    CHECK(input_dispatch_update(&d, 1u << 16, 0xFFFFFFFFu) == (1u << 16));
+    CHECK(d.state == ((1u << 16) | 0x0001));
+}
+
+TEST_CASE("Input dispatch: seeding does not notify", "[input_dispatch]")
+{
+    input_dispatch_t d;
+    input_dispatch_init(&d);
+    Seen s;
+    input_dispatch_subscribe(&d, 0xFFFFFFFFu, record, &s);
+
+    input_dispatch_seed(&d, 1u << 16, 1u << 16);
+    CHECK(s.calls == 0);
+    CHECK(d.state == (1u << 16));
+    CHECK(input_dispatch_update(&d, 1u << 16, 1u << 16) == 0);
+}
+
+TEST_CASE("Input dispatch: registration order and table limits", "[input_dispatch]")
+{
+    input_dispatch_t d;
+    input_dispatch_init(&d);
+    Seen first, second;
+    CHECK(input_dispatch_subscribe(&d, 0x1, nullptr, nullptr) == -1);
+    input_dispatch_subscribe(&d, 0x1, record, &first);
+    input_dispatch_subscribe(&d, 0x1, record, &second);
+
+    g_order = 0;
+    input_dispatch_update(&d, 0x1, 0x1);
+    CHECK(first.order == 1);
+    CHECK(second.order == 2);
+
+    Seen spare;
+    for (int i = 2; i < INPUT_DISPATCH_MAX_SUBSCRIBERS; i++) {
+        CHECK(input_dispatch_subscribe(&d, 0x2, record, &spare) == 0);
+    }
+    CHECK(input_dispatch_subscribe(&d, 0x2, record, &spare) == -1);
+}
@@ -0,0 +1,167 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include "json_writer.h"
+
+namespace {
+
+std::string number(double value)
+{
+    char buf[64];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_array(&w, nullptr);
+    json_writer_number(&w, nullptr, value);
+    json_writer_end_array(&w);
+    REQUIRE(json_writer_finish(&w) > 0);
+    std::string s(buf);
+    return s.substr(1, s.size() - 2);
+}
+
+}
+
+TEST_CASE("JSON writer: nested members in write order", "[json_writer]")
+{
+    char buf[256];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+
+    json_writer_begin_object(&w, nullptr);
+    json_writer_string(&w, "macAddress", "AA:BB");
+    json_writer_begin_object(&w, "payload");
+    json_writer_bool(&w, "allPumpsStopped", true);
+    json_writer_begin_array(&w, "affectedPumps");
+    for (int i = 1; i <= 2; i++) {
+        json_writer_begin_object(&w, nullptr);
+        json_writer_number(&w, "pumpId", i);
+        json_writer_bool(&w, "active", false);
+        json_writer_end_object(&w);
+    }
+    json_writer_end_array(&w);
+    json_writer_begin_array(&w, "empty");
+    json_writer_end_array(&w);
+    json_writer_begin_object(&w, "none");
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+
+    const char *expected =
+        "{\"macAddress\":\"AA:BB\",\"payload\":{\"allPumpsStopped\":true,"
+        "\"affectedPumps\":[{\"pumpId\":1,\"active\":false},{\"pumpId\":2,\"active\":false}],"
+        "\"empty\":[],\"none\":{}}}";
+    CHECK(json_writer_finish(&w) == strlen(expected));
+    CHECK(std::string(buf) == expected);
+}
+
+TEST_CASE("JSON writer: strings escape like cJSON", "[json_writer]")
+{
+    char buf[128];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w, nullptr);
+    json_writer_string(&w, "k\"ey", "a\"b\\c/d\b\f\n\r\t\x01\x1f\xc3\xa9");
+    json_writer_string(&w, "skipped", nullptr);     // NULL value adds nothing
+    json_writer_string(&w, "empty", "");
+    json_writer_end_object(&w);
+
+    REQUIRE(json_writer_finish(&w) > 0);
+    CHECK(std::string(buf) ==
+          "{\"k\\\"ey\":\"a\\\"b\\\\c/d\\b\\f\\n\\r\\t\\u0001\\u001f\xc3\xa9\",\"empty\":\"\"}");
+}
+
+TEST_CASE("JSON writer: numbers format like cJSON", "[json_writer]")
+{
+    CHECK(number(0) == "0");
+    CHECK(number(-0.0) == "0");
+    CHECK(number(42) == "42");
+    CHECK(number(-17) == "-17");
+    CHECK(number(23.45) == "23.45");
+    CHECK(number(0.1) == "0.1");
+    CHECK(number(12.5f) == "12.5");
+    CHECK(number(3.3f) == "3.2999999523162842");     // float widened to double
+    CHECK(number(1e20) == "1e+20");
+    CHECK(number(2147483647.0) == "2147483647");
+    CHECK(number(4294967295.0) == "4294967295");    // Past INT_MAX: %g path
+    CHECK(number(-2147483648.0) == "-2147483648");
+    CHECK(number(NAN) == "null");
+    CHECK(number(INFINITY) == "null");
+}
+
+TEST_CASE("JSON writer: overflow is detected and sized", "[json_writer]")
+{
+    char buf[16];
+    memset(buf, 'x', sizeof(buf));
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w, nullptr);
+    json_writer_string(&w, "message", "much too long for the buffer");
+    json_writer_end_object(&w);
+
+    CHECK(json_writer_finish(&w) == 0);
+    CHECK(w.truncated);
+    CHECK(json_writer_needed(&w) == strlen("{\"message\":\"much too long for the buffer\"}"));
+    CHECK(strlen(buf) < sizeof(buf));               // Prefix stays terminated
+
+    // Exactly fitting output (15 chars + NUL) is not truncated
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w, nullptr);
+    json_writer_string(&w, "k", "0123456");
+    json_writer_end_object(&w);
+    CHECK(json_writer_finish(&w) == 15);
+    CHECK(std::string(buf) == "{\"k\":\"0123456\"}");
+}
+
+TEST_CASE("JSON writer: unbalanced documents are rejected", "[json_writer]")
+{
+    char buf[32];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w, nullptr);
+    json_writer_begin_object(&w, "open");
+    json_writer_end_object(&w);
+    CHECK(json_writer_finish(&w) == 0);
+
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_end_object(&w);
+    CHECK(json_writer_finish(&w) == 0);
+}
+
+TEST_CASE("JSON writer: optional sections are dropped when they do not fit", "[json_writer]")
+{
+    char buf[32];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w, nullptr);
+    json_writer_number(&w, "a", 1);
+
+    json_writer_mark_t mark = json_writer_mark(&w);
+    json_writer_begin_object(&w, "extra");
+    json_writer_string(&w, "note", "far too long to fit here");
+    json_writer_end_object(&w);
+    CHECK_FALSE(json_writer_keep(&w, &mark));
+    CHECK_FALSE(w.truncated);
+
+    json_writer_number(&w, "b", 2);
+    json_writer_end_object(&w);
+    CHECK(json_writer_finish(&w) > 0);
+    CHECK(std::string(buf) == "{\"a\":1,\"b\":2}");
+
+    // A section that fits, with room left to close, is kept
+    json_writer_init(&w, buf, sizeof(buf));
+    json_writer_begin_object(&w, nullptr);
+    mark = json_writer_mark(&w);
+    json_writer_string(&w, "note", "short");
+    CHECK(json_writer_keep(&w, &mark));
+    json_writer_end_object(&w);
+    CHECK(std::string(buf) == "{\"note\":\"short\"}");
+
+    // Exactly full leaves no room for the closing bracket
+    json_writer_init(&w, buf, 16);
+    json_writer_begin_object(&w, nullptr);
+    mark = json_writer_mark(&w);
+    json_writer_string(&w, "k", "01234567");
+    CHECK_FALSE(json_writer_keep(&w, &mark));
+    json_writer_end_object(&w);
+    CHECK(std::string(buf) == "{}");
+}
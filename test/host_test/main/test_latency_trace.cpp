@@ -0,0 +1,92 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include "latency_trace.h"
+
+TEST_CASE("Intervals land in log2 buckets", "[latency_trace]")
+{
+    latency_trace_reset();
+    latency_histogram_t h;
+
+    latency_trace_record(LATENCY_CONFIRM_TO_RELAY, 1000, 1000 + 10);        // < 64 us
+    latency_trace_record(LATENCY_CONFIRM_TO_RELAY, 1000, 1000 + 64);        // [64, 128)
+    latency_trace_record(LATENCY_CONFIRM_TO_RELAY, 1000, 1000 + 300000);    // [2^18, 2^19)
+    latency_trace_get(LATENCY_CONFIRM_TO_RELAY, &h);
+
+    CHECK(h.count == 3);
+    CHECK(h.min_us == 10);
+    CHECK(h.max_us == 300000);
+    CHECK(h.sum_us == 300074);
+    CHECK(h.buckets[0] == 1);
+    CHECK(h.buckets[1] == 1);
+    CHECK(h.buckets[18 - LATENCY_MIN_SHIFT + 1] == 1);
+}
+
+TEST_CASE("Missing or reversed trace points are ignored", "[latency_trace]")
+{
+    latency_trace_reset();
+    latency_histogram_t h;
+
+    latency_trace_record(LATENCY_SAMPLE_TO_RELAY, 0, 5000);        // Start never reached
+    latency_trace_record(LATENCY_SAMPLE_TO_RELAY, 5000, 0);        // End never reached
+    latency_trace_record(LATENCY_SAMPLE_TO_RELAY, 5000, 4000);     // Clock went backwards
+    latency_trace_record(LATENCY_STAGE_COUNT, 1, 2);
+    latency_trace_get(LATENCY_SAMPLE_TO_RELAY, &h);
+    CHECK(h.count == 0);
+
+    // Overlong intervals saturate into the last bucket
+    latency_trace_record(LATENCY_SAMPLE_TO_PUBLISHED, 1, 1 + (int64_t)1e12);
+    latency_trace_get(LATENCY_SAMPLE_TO_PUBLISHED, &h);
+    CHECK(h.buckets[LATENCY_BUCKETS - 1] == 1);
+    CHECK(h.max_us == UINT32_MAX);
+}
+
+TEST_CASE("Percentiles are bucket upper bounds clamped to the max", "[latency_trace]")
+{
+    latency_trace_reset();
+    latency_histogram_t h;
+
+    // 90 fast responses around 300 ms, 10 slow ones around 1.5 s
+    for (int i = 0; i < 90; i++) {
+        latency_trace_record(LATENCY_SAMPLE_TO_CONFIRM, 1, 1 + 300000 + i);
+    }
+    for (int i = 0; i < 10; i++) {
+        latency_trace_record(LATENCY_SAMPLE_TO_CONFIRM, 1, 1 + 1500000 + i);
+    }
+    latency_trace_get(LATENCY_SAMPLE_TO_CONFIRM, &h);
+
+    uint32_t p50 = latency_trace_percentile(&h, 50);
+    uint32_t p95 = latency_trace_percentile(&h, 95);
+    CHECK(p50 >= 300000);
+    CHECK(p50 < 2 * 300000);
+    CHECK(p95 >= 1500000);
+    CHECK(p95 <= h.max_us);
+    CHECK(latency_trace_percentile(&h, 100) == h.max_us);
+
+    latency_histogram_t empty = {};
+    CHECK(latency_trace_percentile(&empty, 50) == 0);
+}
+
+TEST_CASE("Stage names are stable report keys", "[latency_trace]")
+{
+    CHECK(std::string(latency_trace_stage_name(LATENCY_SAMPLE_TO_RELAY)) == "sampleToRelay");
+    CHECK(std::string(latency_trace_stage_name(LATENCY_STAGE_COUNT)) == "unknown");
+}
+
+TEST_CASE("Standalone histograms use the same buckets", "[latency_trace]")
+{
+    latency_trace_reset();
+    latency_histogram_t h = {};
+
+    latency_histogram_add(&h, 40);
+    latency_histogram_add(&h, 5000);
+    CHECK(h.count == 2);
+    CHECK(h.min_us == 40);
+    CHECK(h.max_us == 5000);
+    CHECK(h.buckets[0] == 1);
+    CHECK(latency_trace_percentile(&h, 100) == 5000);
+
+    // Stage histograms are untouched
+    latency_histogram_t stage;
+    latency_trace_get(LATENCY_SAMPLE_TO_CONFIRM, &stage);
+    CHECK(stage.count == 0);
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+#include "loop_monitor.h"
+
+namespace {
+
+// Run one iteration starting at start_ms after boot and lasting exec_ms
+// (time 0 itself means "not started")
+bool iterate(loop_monitor_t *m, int64_t start_ms, int64_t exec_ms)
+{
+    int64_t start_us = (1000 + start_ms) * 1000;
+    loop_monitor_start(m, start_us);
+    return loop_monitor_end(m, start_us + exec_ms * 1000);
+}
+
+} // namespace
+
+TEST_CASE("Loop monitor: on-time loops record execution only", "[loop_monitor]")
+{
+    loop_monitor_t m;
+    loop_monitor_init(&m, "Alert", 2000, false);
+    CHECK(m.slack_us == 200000);
+
+    for (int i = 0; i < 5; i++) {
+        CHECK_FALSE(iterate(&m, 1000 + i * 2000, 10 + i));
+    }
+    CHECK(m.iterations == 5);
+    CHECK(m.exec_max_us == 14000);
+    CHECK(loop_monitor_avg_exec_us(&m) == 12000);
+    CHECK(m.overruns == 0);
+    CHECK(m.late_starts == 0);
+    CHECK(m.interval_max_us == 2000000);
+    CHECK(m.lateness.count == 4);              // No gap before the first iteration
+    CHECK(m.lateness.max_us == 0);
+}
+
+TEST_CASE("Loop monitor: overruns and late starts are misses", "[loop_monitor]")
+{
+    loop_monitor_t m;
+    loop_monitor_init(&m, "Sensor", 1000, false);
+
+    iterate(&m, 0, 5);
+    iterate(&m, 1000, 1500);                   // Overrun
+    CHECK(m.overruns == 1);
+    iterate(&m, 2500, 5);                      // 1500 ms gap: late by 500 ms
+    CHECK(m.late_starts == 1);
+    CHECK(m.lateness.max_us == 500000);
+    CHECK(m.consecutive == 2);
+    iterate(&m, 3550, 5);                      // 50 ms late is within the 100 ms slack
+    CHECK(m.late_starts == 1);
+    CHECK(m.consecutive == 0);
+    CHECK(m.consecutive_max == 2);
+
+    // Short periods still get a two-tick slack
+    loop_monitor_t fast;
+    loop_monitor_init(&fast, "Fast", 100, false);
+    CHECK(fast.slack_us == LOOP_MONITOR_MIN_SLACK_US);
+}
+
+TEST_CASE("Loop monitor: safety tasks alert once per run of misses", "[loop_monitor]")
+{
+    loop_monitor_t m;
+    loop_monitor_init(&m, "Ctrl", 1000, true);
+
+    int alerts = 0;
+    int64_t t = 0;
+    for (int i = 0; i < LOOP_MONITOR_ALERT_MISSES + 3; i++) {
+        alerts += iterate(&m, t, 1050);        // Overruns, but starts within the slack
+        t += 1050;
+    }
+    CHECK(alerts == 1);
+
+    // A clean iteration ends the run; the next run alerts again
+    alerts += iterate(&m, t, 5);
+    t += 1000;
+    for (int i = 0; i < LOOP_MONITOR_ALERT_MISSES; i++) {
+        alerts += iterate(&m, t, 1050);
+        t += 1050;
+    }
+    CHECK(alerts == 2);
+
+    // Non-safety monitors never alert
+    loop_monitor_t quiet;
+    loop_monitor_init(&quiet, "Mon", 100, false);
+    bool any = false;
+    for (int i = 0; i < 10; i++) {
+        any |= iterate(&quiet, i * 200, 150);
+    }
+    CHECK_FALSE(any);
+    CHECK(quiet.overruns == 10);
+}
@@ -0,0 +1,2 @@
+#define CATCH_CONFIG_MAIN // This tells the catch header to generate a main
+#include <catch2/catch.hpp>
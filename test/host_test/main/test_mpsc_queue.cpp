@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+#include "mpsc_queue.h"
+
+namespace {
+
+struct Item {
+    uint32_t producer;
+    uint32_t n;
+};
+
+} // namespace
+
+TEST_CASE("MPSC queue: FIFO order, full and empty", "[mpsc_queue]")
+{
+    Item items[4];
+    uint32_t seqs[4];
+    mpsc_queue_t q;
+    REQUIRE(mpsc_queue_init(&q, items, seqs, 4, sizeof(Item)) == 0);
+
+    Item out;
+    CHECK_FALSE(mpsc_queue_pop(&q, &out));
+
+    for (uint32_t i = 0; i < 4; i++) {
+        Item in = {0, i};
+        CHECK(mpsc_queue_push(&q, &in));
+    }
+    Item extra = {0, 99};
+    CHECK_FALSE(mpsc_queue_push(&q, &extra));
+    CHECK(q.full == 1);
+    CHECK(mpsc_queue_count(&q) == 4);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        REQUIRE(mpsc_queue_pop(&q, &out));
+        CHECK(out.n == i);
+    }
+    CHECK_FALSE(mpsc_queue_pop(&q, &out));
+
+    // Slots are reused across laps of the ring
+    for (uint32_t lap = 0; lap < 10; lap++) {
+        Item in = {1, lap};
+        REQUIRE(mpsc_queue_push(&q, &in));
+        REQUIRE(mpsc_queue_pop(&q, &out));
+        CHECK(out.n == lap);
+    }
+}
+
+TEST_CASE("MPSC queue: rejects bad geometry", "[mpsc_queue]")
+{
+    Item items[6];
+    uint32_t seqs[6];
+    mpsc_queue_t q;
+    CHECK(mpsc_queue_init(&q, items, seqs, 6, sizeof(Item)) == -1);
+    CHECK(mpsc_queue_init(&q, items, seqs, 0, sizeof(Item)) == -1);
+    CHECK(mpsc_queue_init(&q, nullptr, seqs, 4, sizeof(Item)) == -1);
+}
+
+TEST_CASE("MPSC queue: concurrent producers lose and duplicate nothing", "[mpsc_queue]")
+{
+    constexpr uint32_t kProducers = 4;
+    constexpr uint32_t kPerProducer = 20000;
+    Item items[16];
+    uint32_t seqs[16];
+    mpsc_queue_t q;
+    REQUIRE(mpsc_queue_init(&q, items, seqs, 16, sizeof(Item)) == 0);
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; p++) {
+        producers.emplace_back([&q, p] {
+            for (uint32_t n = 0; n < kPerProducer; n++) {
+                Item in = {p, n};
+                while (!mpsc_queue_push(&q, &in)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each producer's items must arrive complete and in its own order
+    std::vector<uint32_t> next(kProducers, 0);
+    uint32_t received = 0;
+    bool ordered = true;
+    while (received < kProducers * kPerProducer) {
+        Item out;
+        if (!mpsc_queue_pop(&q, &out)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Keep draining on a mismatch so no producer is left spinning on a full queue
+        if (out.producer >= kProducers || out.n != next[out.producer]) {
+            ordered = false;
+        } else {
+            next[out.producer]++;
+        }
+        received++;
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+
+    CHECK(ordered);
+    CHECK(received == kProducers * kPerProducer);
+    Item out;
+    CHECK_FALSE(mpsc_queue_pop(&q, &out));
+}
@@ -0,0 +1,133 @@
+#include <catch2/catch.hpp>
+#include "mqtt_lanes.h"
+
+TEST_CASE("MQTT lanes: highest lane first, FIFO within a lane", "[mqtt_lanes]")
+{
+    mqtt_lanes_t l;
+    mqtt_lanes_init(&l, 8);
+    bool evicted;
+
+    int bulk = mqtt_lanes_push(&l, MQTT_LANE_BULK, false, &evicted);
+    int normal1 = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+    int normal2 = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+    int emergency = mqtt_lanes_push(&l, MQTT_LANE_EMERGENCY, true, &evicted);
+    CHECK_FALSE(evicted);
+    CHECK(l.stats[MQTT_LANE_NORMAL].depth == 2);
+
+    mqtt_lane_t lane;
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == emergency);
+    CHECK(lane == MQTT_LANE_EMERGENCY);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == normal1);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == normal2);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == bulk);
+    CHECK(lane == MQTT_LANE_BULK);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == -1);
+
+    CHECK(l.stats[MQTT_LANE_NORMAL].max_depth == 2);
+    CHECK(l.stats[MQTT_LANE_NORMAL].dequeued == 2);
+}
+
+TEST_CASE("MQTT lanes: pop below a lane and pending above", "[mqtt_lanes]")
+{
+    mqtt_lanes_t l;
+    mqtt_lanes_init(&l, 4);
+    bool evicted;
+    mqtt_lane_t lane;
+
+    int bulk = mqtt_lanes_push(&l, MQTT_LANE_BULK, false, &evicted);
+    CHECK_FALSE(mqtt_lanes_pending_above(&l, MQTT_LANE_BULK));
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_BULK, &lane) == -1);
+
+    int critical = mqtt_lanes_push(&l, MQTT_LANE_CRITICAL, true, &evicted);
+    CHECK(mqtt_lanes_pending_above(&l, MQTT_LANE_BULK));
+    CHECK_FALSE(mqtt_lanes_pending_above(&l, MQTT_LANE_CRITICAL));
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_BULK, &lane) == critical);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_BULK, &lane) == -1);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == bulk);
+}
+
+TEST_CASE("MQTT lanes: full slots evict telemetry, never alerts", "[mqtt_lanes]")
+{
+    mqtt_lanes_t l;
+    mqtt_lanes_init(&l, 3);
+    bool evicted;
+    mqtt_lane_t lane;
+
+    int normal = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+    int bulk1 = mqtt_lanes_push(&l, MQTT_LANE_BULK, false, &evicted);
+    int bulk2 = mqtt_lanes_push(&l, MQTT_LANE_BULK, false, &evicted);
+    (void)bulk2;
+
+    // Bulk goes first, oldest message first
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_EMERGENCY, true, &evicted) == bulk1);
+    CHECK(evicted);
+    CHECK(l.stats[MQTT_LANE_BULK].evicted == 1);
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_CRITICAL, true, &evicted) == bulk2);
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_CRITICAL, true, &evicted) == normal);
+    CHECK(l.stats[MQTT_LANE_NORMAL].evicted == 1);
+
+    // Only alerts left: another alert is refused, not swapped in
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_EMERGENCY, true, &evicted) == -1);
+    CHECK_FALSE(evicted);
+    CHECK(l.stats[MQTT_LANE_EMERGENCY].dropped == 1);
+
+    // A lane cannot evict its own or a higher lane
+    mqtt_lanes_init(&l, 1);
+    mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted) == -1);
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_BULK, false, &evicted) == -1);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == 0);
+}
+
+TEST_CASE("MQTT lanes: retry goes back to the head of its lane", "[mqtt_lanes]")
+{
+    mqtt_lanes_t l;
+    mqtt_lanes_init(&l, 4);
+    bool evicted;
+    mqtt_lane_t lane;
+
+    int first = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+    int second = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+
+    REQUIRE(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == first);
+    mqtt_lanes_push_front(&l, lane, first);
+    CHECK(l.stats[MQTT_LANE_NORMAL].dequeued == 0);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == first);
+    mqtt_lanes_release(&l, first);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == second);
+    mqtt_lanes_release(&l, second);
+    CHECK(l.free_count == 4);
+}
+
+TEST_CASE("MQTT lanes: kept messages in telemetry lanes are never evicted", "[mqtt_lanes]")
+{
+    mqtt_lanes_t l;
+    mqtt_lanes_init(&l, 4);
+    bool evicted;
+    mqtt_lane_t lane;
+
+    // An INFO alert and a persisted message share the lanes with telemetry
+    int alert = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, true, &evicted);
+    int status = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+    int persisted = mqtt_lanes_push(&l, MQTT_LANE_BULK, true, &evicted);
+    int heartbeat = mqtt_lanes_push(&l, MQTT_LANE_NORMAL, false, &evicted);
+
+    // Bulk holds only a kept message: the normal lane gives up its oldest
+    // evictable one, skipping the alert at its head
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_EMERGENCY, true, &evicted) == status);
+    CHECK(evicted);
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_CRITICAL, true, &evicted) == heartbeat);
+    CHECK(l.stats[MQTT_LANE_NORMAL].evicted == 2);
+
+    // Nothing evictable is left
+    CHECK(mqtt_lanes_push(&l, MQTT_LANE_EMERGENCY, true, &evicted) == -1);
+    CHECK_FALSE(evicted);
+    CHECK(l.stats[MQTT_LANE_BULK].evicted == 0);
+
+    // The kept messages are still delivered, in order
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) != -1);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) != -1);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == alert);
+    CHECK(lane == MQTT_LANE_NORMAL);
+    CHECK(mqtt_lanes_pop(&l, MQTT_LANE_COUNT, &lane) == persisted);
+}
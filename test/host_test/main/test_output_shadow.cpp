@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+#include "output_shadow.h"
+
+TEST_CASE("Shadow: pins stage until committed", "[output_shadow]")
+{
+    output_shadow_t s;
+    output_shadow_init(&s, 0x00, 0x00);
+    CHECK_FALSE(output_shadow_dirty(&s, 1));
+
+    output_shadow_set(&s, 1, 3, true);
+    output_shadow_set(&s, 1, 0, true);
+    CHECK(s.desired[1] == 0x09);
+    CHECK(output_shadow_dirty(&s, 1));
+    CHECK_FALSE(output_shadow_dirty(&s, 0));
+
+    output_shadow_committed(&s, 1, s.desired[1], 1000);
+    CHECK_FALSE(output_shadow_dirty(&s, 1));
+    CHECK(s.commits == 1);
+
+    // Setting a pin back and forth before a commit is not a change
+    output_shadow_set(&s, 1, 3, false);
+    output_shadow_set(&s, 1, 3, true);
+    CHECK_FALSE(output_shadow_dirty(&s, 1));
+
+    // Out of range is ignored
+    output_shadow_set(&s, 2, 0, true);
+    output_shadow_set(&s, 0, 8, true);
+    CHECK(s.desired[0] == 0x00);
+}
+
+TEST_CASE("Shadow: batches nest and only the outermost end commits", "[output_shadow]")
+{
+    output_shadow_t s;
+    output_shadow_init(&s, 0x00, 0x00);
+    CHECK_FALSE(output_shadow_batching(&s));
+
+    output_shadow_begin(&s);
+    output_shadow_begin(&s);
+    CHECK(output_shadow_batching(&s));
+    CHECK_FALSE(output_shadow_end(&s));
+    CHECK(output_shadow_batching(&s));
+    CHECK(output_shadow_end(&s));
+    CHECK_FALSE(output_shadow_batching(&s));
+
+    // Unbalanced end is harmless
+    CHECK_FALSE(output_shadow_end(&s));
+}
+
+TEST_CASE("Shadow: read-back is deferred after the last commit", "[output_shadow]")
+{
+    output_shadow_t s;
+    output_shadow_init(&s, 0x00, 0x00);
+    CHECK_FALSE(output_shadow_verify_due(&s, 1, 0));
+    CHECK_FALSE(output_shadow_verify_pending(&s, 1));
+
+    output_shadow_set(&s, 1, 2, true);
+    output_shadow_committed(&s, 1, s.desired[1], 1000);
+    CHECK(output_shadow_verify_pending(&s, 1));
+    CHECK_FALSE(output_shadow_verify_due(&s, 1, 1000 + OUTPUT_SHADOW_VERIFY_DELAY_MS - 1));
+
+    // A second commit inside the window pushes the read-back out
+    output_shadow_set(&s, 1, 1, true);
+    output_shadow_committed(&s, 1, s.desired[1], 1050);
+    CHECK_FALSE(output_shadow_verify_due(&s, 1, 1100));
+    CHECK(output_shadow_verify_due(&s, 1, 1050 + OUTPUT_SHADOW_VERIFY_DELAY_MS));
+    CHECK_FALSE(output_shadow_verify_due(&s, 0, 2000));
+
+    CHECK(output_shadow_verify(&s, 1, 0x06) == 0);
+    CHECK_FALSE(output_shadow_verify_due(&s, 1, 5000));
+    CHECK_FALSE(output_shadow_verify_pending(&s, 1));
+    CHECK(s.mismatches == 0);
+}
+
+TEST_CASE("Shadow: wrap-safe deadline", "[output_shadow]")
+{
+    output_shadow_t s;
+    output_shadow_init(&s, 0x00, 0x00);
+    output_shadow_set(&s, 1, 0, true);
+    output_shadow_committed(&s, 1, s.desired[1], UINT32_MAX - 20);
+    CHECK_FALSE(output_shadow_verify_due(&s, 1, UINT32_MAX));
+    CHECK(output_shadow_verify_due(&s, 1, OUTPUT_SHADOW_VERIFY_DELAY_MS));
+}
+
+TEST_CASE("Shadow: a disagreeing read-back marks the port for rewrite", "[output_shadow]")
+{
+    output_shadow_t s;
+    output_shadow_init(&s, 0x00, 0x00);
+    output_shadow_set(&s, 1, 3, true);
+    output_shadow_set(&s, 1, 2, true);
+    output_shadow_committed(&s, 1, s.desired[1], 0);
+
+    // South relay did not latch
+    CHECK(output_shadow_verify(&s, 1, 0x08) == 0x04);
+    CHECK(s.mismatches == 1);
+    CHECK(output_shadow_dirty(&s, 1));
+    CHECK(s.desired[1] == 0x0C);
+}
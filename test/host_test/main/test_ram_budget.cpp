@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <string>
+#include "ram_budget.h"
+
+TEST_CASE("RAM budget: entries accumulate by subsystem name", "[ram_budget]")
+{
+    ram_budget_reset();
+
+    // Names are compared by content, not pointer
+    std::string tasks = "Tasks";
+    ram_budget_add_static("Tasks", 8192);
+    ram_budget_add_static(tasks.c_str(), 4096);
+    ram_budget_add_static("Queues", 11520);
+
+    REQUIRE(ram_budget_count() == 2);
+    CHECK(ram_budget_get(0)->static_bytes == 12288);
+    CHECK(ram_budget_get(1)->static_bytes == 11520);
+    CHECK(ram_budget_get(2) == nullptr);
+    CHECK(ram_budget_get(-1) == nullptr);
+    CHECK(ram_budget_total_static() == 23808);
+}
+
+TEST_CASE("RAM budget: heap steps chain and ignore growth", "[ram_budget]")
+{
+    ram_budget_reset();
+
+    uint32_t free_heap = 200000;
+    free_heap = ram_budget_heap_step("WiFi", free_heap, 150000);
+    free_heap = ram_budget_heap_step("Hardware", free_heap, 149000);
+    free_heap = ram_budget_heap_step("Tasks", free_heap, 149500);   // Freed memory
+    CHECK(free_heap == 149500);
+
+    REQUIRE(ram_budget_count() == 3);
+    CHECK(ram_budget_get(0)->heap_bytes == 50000);
+    CHECK(ram_budget_get(1)->heap_bytes == 1000);
+    CHECK(ram_budget_get(2)->heap_bytes == 0);
+    CHECK(ram_budget_total_heap() == 51000);
+    CHECK(ram_budget_total_static() == 0);
+}
+
+TEST_CASE("RAM budget: a full table drops new names but keeps old ones", "[ram_budget]")
+{
+    ram_budget_reset();
+    static const char *names[RAM_BUDGET_MAX_ENTRIES + 1];
+    static char storage[RAM_BUDGET_MAX_ENTRIES + 1][8];
+    for (int i = 0; i <= RAM_BUDGET_MAX_ENTRIES; i++) {
+        snprintf(storage[i], sizeof(storage[i]), "s%d", i);
+        names[i] = storage[i];
+        ram_budget_add_static(names[i], 1);
+    }
+    CHECK(ram_budget_count() == RAM_BUDGET_MAX_ENTRIES);
+    CHECK(ram_budget_total_static() == RAM_BUDGET_MAX_ENTRIES);
+
+    ram_budget_add_static(names[0], 10);
+    CHECK(ram_budget_get(0)->static_bytes == 11);
+}
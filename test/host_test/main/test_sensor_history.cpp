@@ -0,0 +1,280 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "sensor_history.h"
+
+static std::unique_ptr<sensor_history_t> make_history()
+{
+    std::unique_ptr<sensor_history_t> h(new sensor_history_t);
+    sensor_history_init(h.get());
+    return h;
+}
+
+static void fill(float *values, float v)
+{
+    for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+        values[c] = v;
+    }
+}
+
+static bool varint(const uint8_t *p, size_t len, size_t &i, uint32_t &v)
+{
+    v = 0;
+    int shift = 0;
+    do {
+        if (i >= len) {
+            return false;
+        }
+        v |= (uint32_t)(p[i] & 0x7f) << shift;
+        shift += 7;
+    } while (p[i++] & 0x80);
+    return true;
+}
+
+// Decode one exported blob back into rows [row][channel]
+static bool decode(const uint8_t *p, size_t len, int &tier, uint32_t &age_ms,
+                   std::vector<std::vector<int16_t>> &rows)
+{
+    if (len < SENSOR_HISTORY_HEADER_BYTES || p[0] != 'F' || p[1] != 'H' ||
+        p[2] != SENSOR_HISTORY_VERSION || p[4] != SENSOR_HISTORY_CHANNELS) {
+        return false;
+    }
+    tier = p[3];
+    uint16_t count = p[8] | (p[9] << 8);
+    age_ms = p[10] | (p[11] << 8) | (p[12] << 16) | ((uint32_t)p[13] << 24);
+    rows.assign(count, std::vector<int16_t>(SENSOR_HISTORY_CHANNELS));
+
+    size_t i = SENSOR_HISTORY_HEADER_BYTES;
+    for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+        int32_t prev = 0;
+        uint32_t zeros = 0;
+        for (uint16_t r = 0; r < count; r++) {
+            if (zeros > 0) {
+                zeros--;
+                rows[r][c] = (int16_t)prev;
+                continue;
+            }
+            uint32_t z;
+            if (!varint(p, len, i, z)) {
+                return false;
+            }
+            if (z == 0 && !varint(p, len, i, zeros)) {
+                return false;
+            }
+            prev += (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+            rows[r][c] = (int16_t)prev;
+        }
+        if (zeros > 0) {
+            return false;
+        }
+    }
+    return i == len;
+}
+
+TEST_CASE("History: tier 0 stores the mean of each second", "[sensor_history]")
+{
+    auto h = make_history();
+    float v[SENSOR_HISTORY_CHANNELS];
+
+    // Ten frames per second, IR rising 1 % per frame
+    for (uint32_t t = 0; t < 3000; t += 100) {
+        fill(v, 0);
+        v[SENSOR_HISTORY_IR_N] = t / 100.0f;
+        v[SENSOR_HISTORY_CT1] = 2.5f;
+        v[SENSOR_HISTORY_BATTERY] = 12.6f;
+        sensor_history_add(h.get(), v, 5000 + t);
+    }
+    // The third second is still open
+    REQUIRE(sensor_history_rows(h.get(), 0) == 2);
+
+    int16_t row[SENSOR_HISTORY_CHANNELS];
+    REQUIRE(sensor_history_row(h.get(), 0, 0, row));
+    CHECK(row[SENSOR_HISTORY_IR_N] == 1450);        // mean of 10..19 % in 0.01 %
+    CHECK(row[SENSOR_HISTORY_CT1] == 2500);         // mA
+    CHECK(row[SENSOR_HISTORY_BATTERY] == 12600);    // mV
+    REQUIRE(sensor_history_row(h.get(), 0, 1, row));
+    CHECK(row[SENSOR_HISTORY_IR_N] == 450);
+    CHECK_FALSE(sensor_history_row(h.get(), 0, 2, row));
+}
+
+TEST_CASE("History: tiers fold 10 s and 1 min buckets", "[sensor_history]")
+{
+    auto h = make_history();
+    float v[SENSOR_HISTORY_CHANNELS];
+
+    // One frame per second for 3 minutes, level = minute index
+    for (uint32_t s = 0; s <= 180; s++) {
+        fill(v, (float)(s / 60));
+        sensor_history_add(h.get(), v, s * 1000);
+    }
+    CHECK(sensor_history_rows(h.get(), 0) == 180);
+    CHECK(sensor_history_rows(h.get(), 1) == 18);
+    CHECK(sensor_history_rows(h.get(), 2) == 3);
+
+    int16_t row[SENSOR_HISTORY_CHANNELS];
+    for (int age = 0; age < 3; age++) {
+        REQUIRE(sensor_history_row(h.get(), 2, age, row));
+        CHECK(row[SENSOR_HISTORY_LEVEL] == (2 - age) * 100);
+    }
+}
+
+TEST_CASE("History: silent seconds become gaps and are skipped when folding", "[sensor_history]")
+{
+    auto h = make_history();
+    float v[SENSOR_HISTORY_CHANNELS];
+    fill(v, 20);
+
+    sensor_history_add(h.get(), v, 0);
+    sensor_history_add(h.get(), v, 4500);       // Seconds 1..3 silent
+    REQUIRE(sensor_history_rows(h.get(), 0) == 4);
+
+    int16_t row[SENSOR_HISTORY_CHANNELS];
+    for (int age = 0; age < 3; age++) {
+        REQUIRE(sensor_history_row(h.get(), 0, age, row));
+        CHECK(row[SENSOR_HISTORY_IR_S] == SENSOR_HISTORY_GAP);
+    }
+
+    // A NaN channel is missing from its bucket only
+    v[SENSOR_HISTORY_BATTERY] = NAN;
+    for (uint32_t t = 5000; t <= 10000; t += 1000) {
+        sensor_history_add(h.get(), v, t);
+    }
+    REQUIRE(sensor_history_rows(h.get(), 1) == 1);
+    REQUIRE(sensor_history_row(h.get(), 1, 0, row));
+    CHECK(row[SENSOR_HISTORY_IR_S] == 2000);
+    CHECK(row[SENSOR_HISTORY_BATTERY] == 20000);     // Seconds 0 and 4 only
+    REQUIRE(sensor_history_row(h.get(), 0, 0, row));
+    CHECK(row[SENSOR_HISTORY_BATTERY] == SENSOR_HISTORY_GAP);
+
+    // An outage longer than 24 h starts afresh
+    sensor_history_add(h.get(), v, 10000 + 25u * 3600 * 1000);
+    CHECK(sensor_history_rows(h.get(), 0) == 0);
+    CHECK(sensor_history_rows(h.get(), 2) == 0);
+}
+
+TEST_CASE("History: rings wrap at their fixed capacity", "[sensor_history]")
+{
+    auto h = make_history();
+    float v[SENSOR_HISTORY_CHANNELS];
+
+    uint32_t start = UINT32_MAX - 300 * 1000;   // Uptime wraps on the way
+    for (uint32_t s = 0; s <= 2 * 3600 + 5; s++) {
+        fill(v, (float)(s % 1000) / 10.0f);
+        sensor_history_add(h.get(), v, start + s * 1000);
+    }
+    CHECK(sensor_history_rows(h.get(), 0) == SENSOR_HISTORY_T0_ROWS);
+    CHECK(sensor_history_rows(h.get(), 1) == SENSOR_HISTORY_T1_ROWS);
+
+    int16_t row[SENSOR_HISTORY_CHANNELS];
+    REQUIRE(sensor_history_row(h.get(), 0, 0, row));
+    CHECK(row[SENSOR_HISTORY_IR_E] == (int16_t)(((2 * 3600 + 4) % 1000) * 10));
+    REQUIRE(sensor_history_row(h.get(), 0, SENSOR_HISTORY_T0_ROWS - 1, row));
+    CHECK(row[SENSOR_HISTORY_IR_E] == (int16_t)(((2 * 3600 + 5 - SENSOR_HISTORY_T0_ROWS) % 1000) * 10));
+}
+
+TEST_CASE("History: export round-trips and compresses slow signals", "[sensor_history]")
+{
+    auto h = make_history();
+    float v[SENSOR_HISTORY_CHANNELS];
+
+    for (uint32_t s = 0; s < 700; s++) {
+        fill(v, 0);
+        v[SENSOR_HISTORY_IR_N] = 10.0f + (s % 7) * 0.01f;
+        v[SENSOR_HISTORY_LEVEL] = 80.0f - s * 0.01f;
+        v[SENSOR_HISTORY_CT2] = s > 600 ? 4.2f : 0.0f;
+        v[SENSOR_HISTORY_BATTERY] = s == 300 ? NAN : 12.8f;
+        sensor_history_add(h.get(), v, s * 1000);
+    }
+    sensor_history_add(h.get(), v, 700 * 1000 + 400);
+
+    size_t bound = sensor_history_export_bound(h.get(), 0);
+    std::vector<uint8_t> blob(bound);
+    uint8_t tiny[8];
+    CHECK(sensor_history_export(h.get(), 0, 700 * 1000 + 900, 0, tiny, sizeof(tiny)) == 0);
+    CHECK(sensor_history_export(h.get(), 3, 0, 0, blob.data(), blob.size()) == 0);
+
+    size_t len = sensor_history_export(h.get(), 0, 700 * 1000 + 900, 1700000000u, blob.data(), blob.size());
+    REQUIRE(len > 0);
+    // Raw int16 rows would be 12000 bytes
+    CHECK(len < 12000 / 4);
+
+    int tier;
+    uint32_t age_ms;
+    std::vector<std::vector<int16_t>> rows;
+    REQUIRE(decode(blob.data(), len, tier, age_ms, rows));
+    CHECK(tier == 0);
+    CHECK(age_ms == 900);
+    REQUIRE(rows.size() == SENSOR_HISTORY_T0_ROWS);
+    for (size_t r = 0; r < rows.size(); r++) {
+        int16_t expected[SENSOR_HISTORY_CHANNELS];
+        REQUIRE(sensor_history_row(h.get(), 0, (uint16_t)(rows.size() - 1 - r), expected));
+        for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+            CHECK(rows[r][c] == expected[c]);
+        }
+    }
+
+    // Clamped values survive too
+    fill(v, 1000);
+    sensor_history_add(h.get(), v, 702 * 1000);
+    sensor_history_add(h.get(), v, 703 * 1000);
+    len = sensor_history_export(h.get(), 0, 703 * 1000, 0, blob.data(), blob.size());
+    REQUIRE(decode(blob.data(), len, tier, age_ms, rows));
+    CHECK(rows.back()[SENSOR_HISTORY_CT1] == INT16_MAX);
+}
+
+TEST_CASE("History: chunked export joins up while rows are added", "[sensor_history]")
+{
+    auto h = make_history();
+    float v[SENSOR_HISTORY_CHANNELS];
+
+    for (uint32_t s = 0; s < 700; s++) {
+        fill(v, 0);
+        v[SENSOR_HISTORY_IR_N] = (s % 50) * 0.5f;
+        v[SENSOR_HISTORY_CT3] = (s * 37 % 101) * 0.1f;
+        sensor_history_add(h.get(), v, s * 1000);
+    }
+
+    // 100 rows of the worst case per chunk
+    std::vector<uint8_t> chunk(SENSOR_HISTORY_HEADER_BYTES + 100 * SENSOR_HISTORY_CHANNELS * 3);
+    uint8_t tiny[SENSOR_HISTORY_HEADER_BYTES + 4];
+    uint32_t next = 0;
+    CHECK(sensor_history_export_chunk(h.get(), 0, &next, 0, 0, tiny, sizeof(tiny)) == 0);
+
+    // Rows 0..98 were overwritten: the export starts at the oldest held
+    std::vector<std::vector<int16_t>> joined;
+    uint32_t expected_first = 699 - SENSOR_HISTORY_T0_ROWS;
+    int chunks = 0;
+    for (;;) {
+        size_t len = sensor_history_export_chunk(h.get(), 0, &next, 700 * 1000, 0, chunk.data(), chunk.size());
+        if (len == 0) {
+            break;
+        }
+        int tier;
+        uint32_t age_ms;
+        std::vector<std::vector<int16_t>> rows;
+        REQUIRE(decode(chunk.data(), len, tier, age_ms, rows));
+        uint32_t first = chunk[18] | (chunk[19] << 8) | (chunk[20] << 16) | ((uint32_t)chunk[21] << 24);
+        CHECK(first == expected_first + joined.size());
+        CHECK(rows.size() <= 100);
+        joined.insert(joined.end(), rows.begin(), rows.end());
+        chunks++;
+
+        // A new row arrives between chunks and pushes the oldest out
+        if (chunks == 2) {
+            sensor_history_add(h.get(), v, 700 * 1000);
+            expected_first++;
+            joined.erase(joined.begin());
+        }
+    }
+    CHECK(chunks == 7);
+    CHECK(next == 700);
+    REQUIRE(joined.size() == SENSOR_HISTORY_T0_ROWS);
+    for (size_t r = 0; r < joined.size(); r++) {
+        int16_t expected[SENSOR_HISTORY_CHANNELS];
+        REQUIRE(sensor_history_row(h.get(), 0, (uint16_t)(joined.size() - 1 - r), expected));
+        for (int c = 0; c < SENSOR_HISTORY_CHANNELS; c++) {
+            CHECK(joined[r][c] == expected[c]);
+        }
+    }
+}
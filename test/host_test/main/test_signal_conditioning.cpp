@@ -0,0 +1,111 @@
+#include <catch2/catch.hpp>
+#include "signal_conditioning.h"
+
+static const int64_t SWEEP_US = 218000;    // DMA sweep period
+
+TEST_CASE("First sample primes the channel", "[signal_conditioning]")
+{
+    sigcond_channel_t ch;
+    sigcond_output_t out;
+
+    sigcond_init(&ch, NULL);
+    sigcond_update(&ch, 42.0f, 1000, &out);
+    CHECK(out.median == 42.0f);
+    CHECK(out.value == 42.0f);
+    CHECK(out.rate == 0.0f);
+}
+
+TEST_CASE("A single-sample spike never reaches the filtered level", "[signal_conditioning]")
+{
+    sigcond_channel_t ch;
+    sigcond_output_t out;
+    int64_t t = 0;
+
+    sigcond_init(&ch, NULL);
+    for (int i = 0; i < 20; i++) {
+        sigcond_update(&ch, 10.0f, t += SWEEP_US, &out);
+    }
+    sigcond_update(&ch, 95.0f, t += SWEEP_US, &out);
+    CHECK(out.median == 10.0f);
+    CHECK(out.value == Approx(10.0f));
+
+    sigcond_update(&ch, 10.0f, t += SWEEP_US, &out);
+    CHECK(out.value == Approx(10.0f));
+    CHECK(out.rate == Approx(0.0f).margin(1e-3));
+}
+
+TEST_CASE("A sustained step passes with rising rate", "[signal_conditioning]")
+{
+    sigcond_channel_t ch;
+    sigcond_output_t out;
+    int64_t t = 0;
+
+    sigcond_init(&ch, NULL);
+    for (int i = 0; i < 10; i++) {
+        sigcond_update(&ch, 10.0f, t += SWEEP_US, &out);
+    }
+
+    float previous = out.value;
+    bool sawRise = false;
+    for (int i = 0; i < 15; i++) {
+        sigcond_update(&ch, 90.0f, t += SWEEP_US, &out);
+        CHECK(out.value >= previous);
+        sawRise |= out.rate > 50.0f;
+        previous = out.value;
+    }
+    CHECK(sawRise);
+    CHECK(out.value == Approx(90.0f).margin(0.5));
+}
+
+TEST_CASE("Time constants hold across sample rates", "[signal_conditioning]")
+{
+    // After one time constant a step has covered ~63 % at any rate
+    for (int64_t period : {SWEEP_US / 4, SWEEP_US / 8}) {
+        sigcond_config_t config = {1, 1000, 0};
+        sigcond_channel_t ch;
+        sigcond_output_t out;
+        int64_t t = period;
+
+        sigcond_init(&ch, &config);
+        sigcond_update(&ch, 0.0f, t, &out);
+        while (t < period + 1000000) {
+            sigcond_update(&ch, 100.0f, t += period, &out);
+        }
+        INFO("period " << period);
+        CHECK(out.value == Approx(63.2f).margin(4.0f));
+    }
+}
+
+TEST_CASE("Ramp rate is estimated in units per second", "[signal_conditioning]")
+{
+    sigcond_channel_t ch;
+    sigcond_output_t out;
+    int64_t t = 0;
+
+    sigcond_init(&ch, NULL);
+    for (int i = 0; i < 60; i++) {
+        t += SWEEP_US;
+        sigcond_update(&ch, 20.0f * (float)t / 1e6f, t, &out);
+    }
+    CHECK(out.rate == Approx(20.0f).epsilon(0.02));
+}
+
+TEST_CASE("Config is sanitised and stale input re-primes", "[signal_conditioning]")
+{
+    sigcond_config_t even = {4, 0, 0};
+    sigcond_config_t huge = {200, 0, 0};
+    sigcond_channel_t ch;
+    sigcond_output_t out;
+
+    sigcond_init(&ch, &even);
+    CHECK(ch.config.median_len == 3);
+    sigcond_init(&ch, &huge);
+    CHECK(ch.config.median_len == SIGCOND_MEDIAN_MAX);
+
+    sigcond_init(&ch, NULL);
+    sigcond_update(&ch, 10.0f, 1000, &out);
+    sigcond_update(&ch, 10.0f, 1000 + SWEEP_US, &out);
+    sigcond_update(&ch, 70.0f, 1000 + SWEEP_US + (SIGCOND_STALE_MS + 1) * 1000LL, &out);
+    CHECK(out.value == 70.0f);
+    CHECK(out.rate == 0.0f);
+}
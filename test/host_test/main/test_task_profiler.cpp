@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include "task_profiler.h"
+
+TEST_CASE("Task profiler: stack high-water mark and recommendation", "[task_profiler]")
+{
+    task_profiler_t p;
+    task_profiler_init(&p);
+    task_profiler_register(&p, "Sensor", 8192);
+
+    // Not sampled yet: keep the configured size
+    CHECK(task_profiler_recommend(&p.tasks[0]) == 8192);
+
+    task_profiler_sample(&p, "Sensor", 0, 6000);
+    task_profiler_sample(&p, "Sensor", 0, 5200);
+    task_profiler_sample(&p, "Sensor", 0, 5800);     // Lowest mark wins
+    CHECK(p.tasks[0].stack_free_min == 5200);
+
+    // Used 2992 + 1024 minimum margin = 4016 -> 4096
+    CHECK(task_profiler_recommend(&p.tasks[0]) == 4096);
+    CHECK(task_profiler_reclaimable(&p) == 4096);
+
+    // Large use takes the percentage margin: 7000 used + 1750 = 8750 -> 9216
+    task_profiler_register(&p, "Ctrl", 8192);
+    task_profiler_sample(&p, "Ctrl", 0, 1192);
+    CHECK(task_profiler_recommend(&p.tasks[1]) == 9216);
+    CHECK(task_profiler_reclaimable(&p) == 4096);    // Growth is not reclaimable
+
+    // Unregistered system task: no recommendation
+    task_profiler_sample(&p, "IDLE0", 0, 900);
+    CHECK(p.count == 3);
+    CHECK(task_profiler_recommend(&p.tasks[2]) == 0);
+}
+
+TEST_CASE("Task profiler: CPU share per window", "[task_profiler]")
+{
+    task_profiler_t p;
+    task_profiler_init(&p);
+
+    // First window only sets baselines
+    task_profiler_sample(&p, "A", 1000, 100);
+    task_profiler_sample(&p, "B", 5000, 100);
+    task_profiler_end_window(&p);
+    CHECK(p.tasks[0].cpu_permille == 0);
+    CHECK(p.tasks[1].cpu_permille == 0);
+
+    task_profiler_sample(&p, "A", 1000 + 300, 100);
+    task_profiler_sample(&p, "B", 5000 + 700, 100);
+    task_profiler_end_window(&p);
+    CHECK(p.tasks[0].cpu_permille == 300);
+    CHECK(p.tasks[1].cpu_permille == 700);
+
+    // Counter wrap; B disappears and reports 0
+    p.tasks[0].run_prev = UINT32_MAX - 99;
+    task_profiler_sample(&p, "A", 100, 100);
+    task_profiler_sample(&p, "C", 0, 100);
+    task_profiler_end_window(&p);
+    CHECK(p.tasks[0].cpu_permille == 1000);
+    CHECK(p.tasks[1].cpu_permille == 0);
+    CHECK(p.tasks[1].cpu_peak_permille == 700);
+    CHECK(p.windows == 3);
+}
+
+TEST_CASE("Task profiler: long names are truncated and still match", "[task_profiler]")
+{
+    task_profiler_t p;
+    task_profiler_init(&p);
+    task_profiler_register(&p, "a_very_long_task_name", 4096);
+    task_profiler_sample(&p, "a_very_long_task_name", 0, 2048);
+    CHECK(p.count == 1);
+    CHECK(std::string(p.tasks[0].name) == "a_very_long_tas");
+}
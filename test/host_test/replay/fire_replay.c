@@ -0,0 +1,352 @@
+/**
+ * @file fire_replay.c
+ * @brief Deterministic replay of recorded sensor traces through fire_system.c
+ */
+
+#include "fire_replay.h"
+#include "host_platform.h"
+#include "sensor_frame.h"
+#include "signal_conditioning.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char s_binary_magic[4] = {'F', 'K', 'T', 'R'};
+
+// ========================================
+// TRACES
+// ========================================
+
+void fire_replay_default_config(fire_replay_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->profile = WILDLAND_STANDARD;
+    config->seed = 1;
+    config->quiet = true;
+}
+
+int fire_trace_append(fire_trace_t *trace, const fire_trace_sample_t *sample)
+{
+    if (trace->count > 0 && sample->t_ms < trace->samples[trace->count - 1].t_ms) {
+        return -1;
+    }
+    if (trace->count == trace->capacity) {
+        size_t capacity = trace->capacity ? trace->capacity * 2 : 256;
+        fire_trace_sample_t *grown = realloc(trace->samples, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return -1;
+        }
+        trace->samples = grown;
+        trace->capacity = capacity;
+    }
+    trace->samples[trace->count++] = *sample;
+    return 0;
+}
+
+int fire_trace_load_csv(const char *path, fire_trace_t *trace)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+
+    char line[256];
+    int ret = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        // Header, comments and blank lines
+        if (line[0] < '0' || line[0] > '9') {
+            continue;
+        }
+        fire_trace_sample_t sample;
+        unsigned long t_ms;
+        if (sscanf(line, "%lu,%f,%f,%f,%f,%f", &t_ms, &sample.ir[0], &sample.ir[1],
+                   &sample.ir[2], &sample.ir[3], &sample.level) != 6 ||
+            t_ms > UINT32_MAX) {
+            ret = -1;
+            break;
+        }
+        sample.t_ms = (uint32_t)t_ms;
+        if (fire_trace_append(trace, &sample) != 0) {
+            ret = -1;
+            break;
+        }
+    }
+    fclose(f);
+    return ret;
+}
+
+int fire_trace_load_binary(const char *path, fire_trace_t *trace)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return -1;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    int ret = 0;
+    if (fread(magic, sizeof(magic), 1, f) != 1 || memcmp(magic, s_binary_magic, sizeof(magic)) != 0 ||
+        fread(&version, sizeof(version), 1, f) != 1 || version != FIRE_TRACE_BINARY_VERSION ||
+        fread(&count, sizeof(count), 1, f) != 1) {
+        ret = -1;
+    }
+    for (uint32_t i = 0; ret == 0 && i < count; i++) {
+        fire_trace_sample_t sample;
+        if (fread(&sample, sizeof(sample), 1, f) != 1 || fire_trace_append(trace, &sample) != 0) {
+            ret = -1;
+        }
+    }
+    fclose(f);
+    return ret;
+}
+
+int fire_trace_save_binary(const char *path, const fire_trace_t *trace)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        return -1;
+    }
+
+    uint32_t version = FIRE_TRACE_BINARY_VERSION;
+    uint32_t count = (uint32_t)trace->count;
+    int ret = 0;
+    if (fwrite(s_binary_magic, sizeof(s_binary_magic), 1, f) != 1 ||
+        fwrite(&version, sizeof(version), 1, f) != 1 ||
+        fwrite(&count, sizeof(count), 1, f) != 1 ||
+        (count > 0 && fwrite(trace->samples, sizeof(*trace->samples), count, f) != count)) {
+        ret = -1;
+    }
+    if (fclose(f) != 0) {
+        ret = -1;
+    }
+    return ret;
+}
+
+void fire_trace_free(fire_trace_t *trace)
+{
+    free(trace->samples);
+    memset(trace, 0, sizeof(*trace));
+}
+
+// ========================================
+// REPLAY
+// ========================================
+
+typedef struct {
+    fire_replay_result_t *result;
+    PumpState last[4];
+} replay_observer_t;
+
+static uint32_t trace_now_ms(void)
+{
+    return (uint32_t)(host_clock_now_us() / 1000 - FIRE_REPLAY_BOOT_MS);
+}
+
+static void record_transitions(replay_observer_t *obs)
+{
+    for (int i = 0; i < 4; i++) {
+        if (pumps[i].state == obs->last[i]) {
+            continue;
+        }
+        fire_replay_result_t *r = obs->result;
+        if (r->transition_count < FIRE_REPLAY_MAX_TRANSITIONS) {
+            r->transitions[r->transition_count++] = (fire_replay_transition_t){
+                .t_ms = trace_now_ms(),
+                .pump = (uint8_t)i,
+                .from = obs->last[i],
+                .to = pumps[i].state
+            };
+        } else {
+            r->dropped_transitions++;
+        }
+        obs->last[i] = pumps[i].state;
+    }
+}
+
+static void reset_fire_system(const fire_replay_config_t *config)
+{
+    host_platform_reset((int64_t)FIRE_REPLAY_BOOT_MS * 1000);
+    srand(config->seed);
+
+    initialize_arrays();
+    reset_system_to_defaults();
+    pca9555_init(&pca_dev, PCA9555_I2C_ADDRESS, PCA9555_I2C_PORT,
+                 PCA9555_I2C_SDA_GPIO, PCA9555_I2C_SCL_GPIO);
+    if (config->profile != WILDLAND_STANDARD) {
+        apply_system_profile(config->profile);
+    }
+}
+
+// Fire task body: new frame (if any), then evaluate unless locked out
+static unsigned long run_fire_detection(const SensorFrame *frame)
+{
+    if (frame != NULL) {
+        update_pump_ir_values(frame);
+    }
+    if (waterLockout) {
+        return ULONG_MAX;
+    }
+    check_automatic_activation();
+    return fire_detection_next_deadline_ms();
+}
+
+static double monotonic_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int fire_replay_run(const fire_trace_t *trace, const fire_replay_config_t *config,
+                    fire_replay_result_t *result)
+{
+    fire_replay_config_t defaults;
+    if (config == NULL) {
+        fire_replay_default_config(&defaults);
+        config = &defaults;
+    }
+    memset(result, 0, sizeof(*result));
+    if (trace->count == 0) {
+        return -1;
+    }
+
+    // Firmware console output would dominate the run time
+    int saved_stdout = -1;
+    if (config->quiet) {
+        fflush(stdout);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            saved_stdout = dup(STDOUT_FILENO);
+            dup2(devnull, STDOUT_FILENO);
+            close(devnull);
+        }
+    }
+
+    double start_s = monotonic_s();
+    reset_fire_system(config);
+
+    sigcond_channel_t conditioning[4];
+    for (int i = 0; i < 4; i++) {
+        sigcond_init(&conditioning[i], NULL);
+    }
+
+    replay_observer_t obs = { .result = result };
+    for (int i = 0; i < 4; i++) {
+        obs.last[i] = pumps[i].state;
+    }
+
+    const uint64_t end_ms = (uint64_t)trace->samples[trace->count - 1].t_ms + config->tail_ms;
+    size_t next_sample = 0;
+    uint64_t next_pump_ms = 0;
+    uint64_t next_water_ms = 0;
+    uint64_t fire_due_ms = UINT64_MAX;
+
+    for (;;) {
+        uint64_t sample_ms = next_sample < trace->count ? trace->samples[next_sample].t_ms : UINT64_MAX;
+        uint64_t t = sample_ms;
+        if (next_water_ms < t) t = next_water_ms;
+        if (next_pump_ms < t) t = next_pump_ms;
+        if (fire_due_ms < t) t = fire_due_ms;
+        if (t > end_ms) {
+            break;
+        }
+        host_clock_advance_to(((int64_t)FIRE_REPLAY_BOOT_MS + (int64_t)t) * 1000);
+
+        // Sensor task, then the tasks it wakes, in firmware priority order
+        bool fire_wake = false;
+        SensorFrame frame;
+        bool published = false;
+        if (t == sample_ms) {
+            const fire_trace_sample_t *s = &trace->samples[next_sample];
+            if (config->on_sample != NULL) {
+                config->on_sample(next_sample, config->ctx);
+            }
+            memset(&frame, 0, sizeof(frame));
+            frame.timestamp_us = host_clock_now_us();
+            for (int i = 0; i < 4; i++) {
+                sigcond_output_t out;
+                sigcond_update(&conditioning[i], s->ir[i], frame.timestamp_us, &out);
+                frame.ir[i] = out.value;
+                frame.irRaw[i] = s->ir[i];
+                frame.irRate[i] = out.rate;
+                frame.waterLevels[i] = s->level;
+            }
+            frame.level = s->level;
+            sensor_frame_publish(&frame);
+            result->frames++;
+            published = true;
+            fire_wake = true;
+            next_sample++;
+        } else if (t == fire_due_ms) {
+            result->deadline_wakes++;
+            fire_wake = true;
+        }
+        if (fire_wake) {
+            unsigned long deadline = run_fire_detection(published ? &frame : NULL);
+            fire_due_ms = deadline == ULONG_MAX ? UINT64_MAX : trace_now_ms() + (uint64_t)(deadline ? deadline : 1);
+            record_transitions(&obs);
+        }
+
+        if (t == next_water_ms) {
+            detect_continuous_feed();
+            check_water_lockout();
+            record_transitions(&obs);
+            next_water_ms += FIRE_REPLAY_WATER_PERIOD_MS;
+        }
+        // Pump task: woken by its deadline or by a kick from the work above
+        if (t == next_pump_ms || host_pump_kick_take()) {
+            update_pump_states();
+            record_transitions(&obs);
+            result->pump_wakes++;
+
+            // Self-kicks are covered by the deadline, as in task_control
+            host_pump_kick_take();
+            unsigned long deadline = pump_next_deadline_ms();
+            if (deadline > PUMP_SCHEDULE_MAX_WAIT_MS) {
+                deadline = PUMP_SCHEDULE_MAX_WAIT_MS;
+            }
+            unsigned long ticks = (deadline + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+            next_pump_ms = t + (ticks ? ticks : 1) * portTICK_PERIOD_MS;
+        }
+    }
+
+    result->simulated_ms = end_ms;
+    result->relay_writes = host_pca_writes();
+    result->wall_s = monotonic_s() - start_s;
+    result->sim_hours_per_s = result->wall_s > 0 ? (end_ms / 3600000.0) / result->wall_s : 0;
+
+    if (saved_stdout >= 0) {
+        fflush(stdout);
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+    }
+    return 0;
+}
+
+const fire_replay_transition_t *fire_replay_find(const fire_replay_result_t *result,
+                                                 int pump, PumpState to)
+{
+    for (size_t i = 0; i < result->transition_count; i++) {
+        if (result->transitions[i].pump == pump && result->transitions[i].to == to) {
+            return &result->transitions[i];
+        }
+    }
+    return NULL;
+}
+
+const char *fire_replay_state_name(PumpState state)
+{
+    switch (state) {
+        case PUMP_OFF:            return "OFF";
+        case PUMP_AUTO_ACTIVE:    return "AUTO";
+        case PUMP_MANUAL_ACTIVE:  return "MANUAL";
+        case PUMP_COOLDOWN:       return "COOLDOWN";
+        case PUMP_DISABLED:       return "DISABLED";
+        default:                  return "?";
+    }
+}
@@ -0,0 +1,152 @@
+/**
+ * @file fire_replay.h
+ * @brief Deterministic replay of recorded sensor traces through fire_system.c
+ *
+ * A trace is a list of timestamped raw readings (sector IR and water
+ * level). Replay runs them through the firmware's IR conditioning, publishes
+ * each one as a SensorFrame and then drives the same decision functions the
+ * firmware tasks call, at the same cadences, on a virtual clock:
+ *
+ *   - fire detection on every frame and on its own confirmation deadline
+ *     (update_pump_ir_values + check_automatic_activation)
+ *   - water lockout every 500 ms (detect_continuous_feed + check_water_lockout)
+ *   - pump management on its next deadline, when kicked, or every
+ *     PUMP_SCHEDULE_MAX_WAIT_MS (update_pump_states)
+ *
+ * Every pump state change is recorded so tests can assert on the sequence,
+ * and the wall time is measured so profile logic can be benchmarked in
+ * simulated hours per second.
+ *
+ * Trace files
+ *   CSV:    t_ms,ir_n,ir_s,ir_e,ir_w,level  (header and '#' lines skipped)
+ *   Binary: "FKTR" magic, uint32 version, uint32 count, then count packed
+ *           fire_trace_sample_t records, all little-endian
+ */
+
+#ifndef FIRE_REPLAY_H
+#define FIRE_REPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// fire_system.h has no C++ guard of its own
+#include "fire_system.h"
+
+// Replay Configuration
+#define FIRE_REPLAY_BOOT_MS             10000   // Virtual uptime at trace t = 0
+#define FIRE_REPLAY_WATER_PERIOD_MS     500     // CONTROL_WATER_PERIOD_MS in task_control
+#define FIRE_REPLAY_MAX_TRANSITIONS     256
+#define FIRE_TRACE_BINARY_VERSION       1
+
+// One recorded sensor reading
+typedef struct {
+    uint32_t t_ms;              // Time since trace start
+    float ir[4];                // Raw sector IR in % [N, S, E, W]
+    float level;                // Average water level in %
+} fire_trace_sample_t;
+
+// Growable sample list
+typedef struct {
+    fire_trace_sample_t *samples;
+    size_t count;
+    size_t capacity;
+} fire_trace_t;
+
+// Replay settings
+typedef struct {
+    SystemProfile profile;
+    uint32_t tail_ms;           // Keep running after the last sample (held)
+    uint32_t seed;              // rand() seed for cooldown durations
+    bool quiet;                 // Discard firmware console output
+    void (*on_sample)(size_t index, void *ctx);     // Called before each sample is published
+    void *ctx;
+} fire_replay_config_t;
+
+// One observed pump state change
+typedef struct {
+    uint32_t t_ms;              // Trace time of the change
+    uint8_t pump;
+    PumpState from;
+    PumpState to;
+} fire_replay_transition_t;
+
+// Replay outcome
+typedef struct {
+    fire_replay_transition_t transitions[FIRE_REPLAY_MAX_TRANSITIONS];
+    size_t transition_count;
+    uint32_t dropped_transitions;   // Changes beyond FIRE_REPLAY_MAX_TRANSITIONS
+    uint32_t frames;                // Frames published
+    uint32_t deadline_wakes;        // Fire task wakes with no new frame
+    uint32_t pump_wakes;            // update_pump_states() runs
+    uint32_t relay_writes;          // PCA9555 output writes
+    uint64_t simulated_ms;
+    double wall_s;
+    double sim_hours_per_s;
+} fire_replay_result_t;
+
+/**
+ * @brief Default settings (Wildland-Standard, quiet, no tail)
+ */
+void fire_replay_default_config(fire_replay_config_t *config);
+
+/**
+ * @brief Append one sample (t_ms must not go backwards)
+ * @return 0 on success, -1 on bad ordering or allocation failure
+ */
+int fire_trace_append(fire_trace_t *trace, const fire_trace_sample_t *sample);
+
+/**
+ * @brief Load a CSV trace
+ * @return 0 on success, -1 on I/O or parse error
+ */
+int fire_trace_load_csv(const char *path, fire_trace_t *trace);
+
+/**
+ * @brief Load a binary trace
+ * @return 0 on success, -1 on I/O or format error
+ */
+int fire_trace_load_binary(const char *path, fire_trace_t *trace);
+
+/**
+ * @brief Save a trace in the binary format
+ * @return 0 on success, -1 on I/O error
+ */
+int fire_trace_save_binary(const char *path, const fire_trace_t *trace);
+
+/**
+ * @brief Release a trace's samples
+ */
+void fire_trace_free(fire_trace_t *trace);
+
+/**
+ * @brief Reset fire_system.c and the host platform, then replay a trace
+ * @param trace Samples to replay
+ * @param config Settings (NULL for defaults)
+ * @param result Transitions and statistics
+ * @return 0 on success, -1 if the trace is empty
+ */
+int fire_replay_run(const fire_trace_t *trace, const fire_replay_config_t *config,
+                    fire_replay_result_t *result);
+
+/**
+ * @brief First recorded transition of a pump into a state
+ * @return Transition, or NULL if it never happened
+ */
+const fire_replay_transition_t *fire_replay_find(const fire_replay_result_t *result,
+                                                 int pump, PumpState to);
+
+/**
+ * @brief Short state name for reports
+ */
+const char *fire_replay_state_name(PumpState state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIRE_REPLAY_H
@@ -0,0 +1,355 @@
+/**
+ * @file host_platform.c
+ * @brief Virtual clock and fake peripherals behind the host stubs
+ */
+
+#include "host_platform.h"
+#include "adc_acquisition.h"
+#include "clsPCA9555.h"
+#include "driver/gpio.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "input_events.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static int64_t s_now_us = 1;
+static int s_gpio_level[GPIO_NUM_MAX];
+static uint8_t s_pca_output[2];
+static uint32_t s_pca_writes = 0;
+static uint32_t s_pca_fail_writes = 0;
+static host_alert_counts_t s_alerts;
+static bool s_pump_kicked = false;
+
+// ========================================
+// HARNESS CONTROL
+// ========================================
+
+void host_platform_reset(int64_t start_us)
+{
+    s_now_us = start_us > 0 ? start_us : 1;
+    memset(s_gpio_level, 0, sizeof(s_gpio_level));
+    memset(s_pca_output, 0, sizeof(s_pca_output));
+    s_pca_writes = 0;
+    s_pca_fail_writes = 0;
+    memset(&s_alerts, 0, sizeof(s_alerts));
+    s_pump_kicked = false;
+}
+
+int64_t host_clock_now_us(void)
+{
+    return s_now_us;
+}
+
+void host_clock_advance_to(int64_t now_us)
+{
+    if (now_us > s_now_us) {
+        s_now_us = now_us;
+    }
+}
+
+void host_gpio_set_level(int gpio, int level)
+{
+    if (gpio >= 0 && gpio < GPIO_NUM_MAX) {
+        s_gpio_level[gpio] = level;
+    }
+}
+
+int host_gpio_level(int gpio)
+{
+    return (gpio >= 0 && gpio < GPIO_NUM_MAX) ? s_gpio_level[gpio] : 0;
+}
+
+uint8_t host_pca_output(int port)
+{
+    return (port == 0 || port == 1) ? s_pca_output[port] : 0;
+}
+
+uint32_t host_pca_writes(void)
+{
+    return s_pca_writes;
+}
+
+void host_pca_fail_writes(uint32_t count)
+{
+    s_pca_fail_writes = count;
+}
+
+const host_alert_counts_t *host_alerts(void)
+{
+    return &s_alerts;
+}
+
+// ========================================
+// FREERTOS / ESP_TIMER
+// ========================================
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(s_now_us / (portTICK_PERIOD_MS * 1000));
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    s_now_us += (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        default:                    return "ESP_ERR_UNKNOWN";
+    }
+}
+
+// ========================================
+// GPIO
+// ========================================
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return config ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    host_gpio_set_level(gpio_num, level ? 1 : 0);
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    return host_gpio_level(gpio_num);
+}
+
+// ========================================
+// PCA9555 (faked at its API)
+// ========================================
+
+static esp_err_t pca_write(uint8_t port, uint8_t value)
+{
+    if (s_pca_fail_writes > 0) {
+        s_pca_fail_writes--;
+        return ESP_FAIL;
+    }
+    s_pca_output[port & 1] = value;
+    s_pca_writes++;
+    return ESP_OK;
+}
+
+esp_err_t pca9555_init(pca9555_t *dev, uint8_t address, i2c_port_t i2c_port,
+                       gpio_num_t sda_gpio, gpio_num_t scl_gpio)
+{
+    (void)sda_gpio;
+    (void)scl_gpio;
+    dev->address = address;
+    dev->i2c_port = i2c_port;
+    dev->initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t pca9555_configure_all_outputs(pca9555_t *dev)
+{
+    return dev->initialized ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t pca9555_set_port0_output(pca9555_t *dev, uint8_t value)
+{
+    (void)dev;
+    return pca_write(0, value);
+}
+
+esp_err_t pca9555_set_port1_output(pca9555_t *dev, uint8_t value)
+{
+    (void)dev;
+    return pca_write(1, value);
+}
+
+esp_err_t pca9555_set_outputs(pca9555_t *dev, uint8_t port0, uint8_t port1)
+{
+    (void)dev;
+    esp_err_t ret = pca_write(0, port0);
+    if (ret == ESP_OK) {
+        // One burst transaction on the chip
+        s_pca_output[1] = port1;
+    }
+    return ret;
+}
+
+esp_err_t pca9555_read_port1_output(pca9555_t *dev, uint8_t *value)
+{
+    (void)dev;
+    *value = s_pca_output[1];
+    return ESP_OK;
+}
+
+esp_err_t pca9555_set_pin_state(pca9555_t *dev, uint8_t port, uint8_t pin, bool state)
+{
+    (void)dev;
+    if (port > 1 || pin > 7) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t value = s_pca_output[port];
+    value = state ? (value | (1 << pin)) : (value & ~(1 << pin));
+    return pca_write(port, value);
+}
+
+// ========================================
+// INPUT INTERRUPTS (not available on the host, door falls back to polling)
+// ========================================
+
+esp_err_t input_events_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t input_events_add_gpio(gpio_num_t gpio, bool active_low, uint32_t *bit_out)
+{
+    (void)gpio;
+    (void)active_low;
+    (void)bit_out;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t input_events_add_pca9555(pca9555_t *dev, gpio_num_t int_gpio)
+{
+    (void)dev;
+    (void)int_gpio;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t input_events_subscribe(uint32_t mask, input_event_cb_t cb, void *arg)
+{
+    (void)mask;
+    (void)cb;
+    (void)arg;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+uint32_t input_events_state(void)
+{
+    return 0;
+}
+
+// ========================================
+// ADC (not available on the host)
+// ========================================
+
+esp_err_t adc_acquisition_init(int s0, int s1, int s2)
+{
+    (void)s0;
+    (void)s1;
+    (void)s2;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool adc_acquisition_is_running(void)
+{
+    return false;
+}
+
+esp_err_t adc_acquisition_wait_sweep(adc_sweep_t *out, uint32_t timeout_ms)
+{
+    (void)out;
+    (void)timeout_ms;
+    return ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t adc_oneshot_new_unit(const adc_oneshot_unit_init_cfg_t *cfg, adc_oneshot_unit_handle_t *ret_unit)
+{
+    (void)cfg;
+    *ret_unit = NULL;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_oneshot_config_channel(adc_oneshot_unit_handle_t handle, adc_channel_t channel,
+                                     const adc_oneshot_chan_cfg_t *config)
+{
+    (void)handle;
+    (void)channel;
+    (void)config;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw)
+{
+    (void)handle;
+    (void)chan;
+    *out_raw = 0;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int *voltage)
+{
+    (void)handle;
+    *voltage = raw;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_cali_create_scheme_line_fitting(const adc_cali_line_fitting_config_t *config,
+                                              adc_cali_handle_t *ret_handle)
+{
+    (void)config;
+    *ret_handle = NULL;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_cali_delete_scheme_line_fitting(adc_cali_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+// ========================================
+// MAIN.C ALERT HOOKS
+// ========================================
+
+void send_alert_pca9555_fail(const char *error, const char *detail)
+{
+    (void)error;
+    (void)detail;
+    s_alerts.pca9555_fail++;
+}
+
+void send_alert_hardware_control_fail(int index, const char *code)
+{
+    (void)index;
+    (void)code;
+    s_alerts.hardware_control_fail++;
+}
+
+void send_alert_current_sensor_fault(int index, float current)
+{
+    (void)index;
+    (void)current;
+    s_alerts.current_sensor_fault++;
+}
+
+void send_alert_state_corruption(int index, int state)
+{
+    (void)index;
+    (void)state;
+    s_alerts.state_corruption++;
+}
+
+void pump_schedule_kick(void)
+{
+    s_pump_kicked = true;
+}
+
+bool host_pump_kick_take(void)
+{
+    bool kicked = s_pump_kicked;
+    s_pump_kicked = false;
+    return kicked;
+}
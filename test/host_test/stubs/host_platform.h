@@ -0,0 +1,85 @@
+/**
+ * @file host_platform.h
+ * @brief Virtual clock and fake peripherals behind the host stubs
+ *
+ * fire_system.c is built unmodified against the stub headers in include/.
+ * Time only moves when the harness advances it (or firmware code calls
+ * vTaskDelay), so every replay is deterministic. The PCA9555 is faked at
+ * its API and keeps the output registers, GPIO keeps one level per pin and
+ * the ADC drivers always report themselves unavailable.
+ */
+
+#ifndef HOST_PLATFORM_H
+#define HOST_PLATFORM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Alerts fire_system.c raised through the main.c hooks
+typedef struct {
+    uint32_t pca9555_fail;
+    uint32_t hardware_control_fail;
+    uint32_t current_sensor_fault;
+    uint32_t state_corruption;
+} host_alert_counts_t;
+
+/**
+ * @brief Reset clock, GPIO, PCA9555 and alert counters
+ * @param start_us Initial virtual time (must be > 0, 0 means "never" to the tracer)
+ */
+void host_platform_reset(int64_t start_us);
+
+/**
+ * @brief Current virtual time in microseconds
+ */
+int64_t host_clock_now_us(void);
+
+/**
+ * @brief Move virtual time forward (never backwards)
+ */
+void host_clock_advance_to(int64_t now_us);
+
+/**
+ * @brief Drive a pin level seen by gpio_get_level()
+ */
+void host_gpio_set_level(int gpio, int level);
+
+/**
+ * @brief Current level of a pin (last driven or written)
+ */
+int host_gpio_level(int gpio);
+
+/**
+ * @brief PCA9555 output register for a port (pump relays are port 1)
+ */
+uint8_t host_pca_output(int port);
+
+/**
+ * @brief Number of PCA9555 output register writes since reset
+ */
+uint32_t host_pca_writes(void);
+
+/**
+ * @brief Make the next N PCA9555 writes fail with ESP_FAIL
+ */
+void host_pca_fail_writes(uint32_t count);
+
+/**
+ * @brief Alerts raised since reset
+ */
+const host_alert_counts_t *host_alerts(void);
+
+/**
+ * @brief True if fire_system.c woke the pump task since the last call (clears it)
+ */
+bool host_pump_kick_take(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_PLATFORM_H
@@ -0,0 +1,16 @@
+/**
+ * @file i2c.h
+ * @brief Host stand-in for the legacy I2C driver types
+ *
+ * Only the types clsPCA9555.h needs; the PCA9555 itself is faked at its
+ * API in host_platform.c.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+typedef int i2c_port_t;
+
+#define I2C_NUM_0               0
+#define I2C_NUM_1               1
@@ -0,0 +1,14 @@
+/**
+ * @file i2c_master.h
+ * @brief Host stand-in for the i2c_master bus driver types
+ *
+ * Only the types clsPCA9555.h needs; the PCA9555 itself is faked at its
+ * API in host_platform.c.
+ */
+
+#pragma once
+
+#include "driver/i2c.h"
+
+typedef struct i2c_master_bus_t *i2c_master_bus_handle_t;
+typedef struct i2c_master_dev_t *i2c_master_dev_handle_t;
@@ -0,0 +1,25 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in for the FreeRTOS types fire_system.c uses
+ *
+ * Ticks run at CONFIG_FREERTOS_HZ=100 like the firmware. Time is virtual
+ * and only moves when the replay harness (or a vTaskDelay) advances it.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  pdTRUE
+#define portMAX_DELAY           0xffffffffUL
+#define configTICK_RATE_HZ      100
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
@@ -0,0 +1,21 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for the FreeRTOS task API (virtual clock)
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+
+#define taskYIELD() do { } while (0)
+
+#ifdef __cplusplus
+}
+#endif
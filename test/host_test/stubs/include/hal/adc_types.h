@@ -0,0 +1,16 @@
+/**
+ * @file adc_types.h
+ * @brief Host stand-in for the ADC HAL types
+ */
+
+#pragma once
+
+typedef enum { ADC_UNIT_1, ADC_UNIT_2 } adc_unit_t;
+typedef enum {
+    ADC_CHANNEL_0, ADC_CHANNEL_1, ADC_CHANNEL_2, ADC_CHANNEL_3,
+    ADC_CHANNEL_4, ADC_CHANNEL_5, ADC_CHANNEL_6, ADC_CHANNEL_7
+} adc_channel_t;
+typedef enum { ADC_ATTEN_DB_0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_12 } adc_atten_t;
+typedef enum { ADC_BITWIDTH_DEFAULT = 0, ADC_BITWIDTH_12 = 12 } adc_bitwidth_t;
+typedef enum { ADC_ULP_MODE_DISABLE } adc_ulp_mode_t;
+typedef enum { ADC_RTC_CLK_SRC_DEFAULT } adc_clk_src_t;